@@ -0,0 +1,171 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+/*! \file Benchmark.h
+    \brief Minimal microbenchmark runner for the C++ kernels.
+
+    Registered benchmarks are calibrated to a minimum wall-clock time, run
+    for several repetitions, and reported as the best observed time per
+    iteration together with the process peak RSS observed after the run.
+    Results can be written as JSON in the same shape as Google Benchmark's
+    console output so that existing regression-tracking tooling can consume
+    them without modification.
+*/
+
+namespace freud { namespace benchmark {
+
+//! Timing result of one benchmark.
+struct Result
+{
+    std::string name;
+    size_t iterations;         //!< Iterations per repetition after calibration.
+    double real_time_ns;       //!< Best time per iteration over all repetitions.
+    double items_per_second;   //!< Throughput in the benchmark's item unit.
+    size_t peak_rss_bytes;     //!< Process peak RSS right after this benchmark.
+};
+
+//! Process peak resident set size in bytes.
+/*! The kernel only exposes the high-water mark, not a per-interval value, so
+ *  the runner samples it after each benchmark: a jump between consecutive
+ *  results attributes the growth to the benchmark that just ran (benchmarks
+ *  run in registration order).
+ */
+inline size_t peakRSSBytes()
+{
+#if defined(_WIN32)
+    return 0;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // Linux reports ru_maxrss in kilobytes.
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+//! Holds the registered benchmarks and runs them in registration order.
+class Registry
+{
+public:
+    //! Register one benchmark.
+    /*! \param name Slash-separated benchmark name, e.g. "locality/AABBQuery".
+     *  \param items_per_iteration Number of work items (points, bonds, bins)
+     *         one call of body processes, used for the throughput report.
+     *  \param body Callable running one iteration of the benchmark.
+     */
+    void add(std::string name, size_t items_per_iteration, std::function<void()> body)
+    {
+        m_benchmarks.emplace_back(Entry {std::move(name), items_per_iteration, std::move(body)});
+    }
+
+    //! Run every registered benchmark whose name contains filter.
+    /*! Each benchmark is warmed up once, calibrated so that one repetition
+     *  runs for at least min_time seconds, and then timed for repetitions
+     *  rounds, keeping the fastest time per iteration.
+     */
+    std::vector<Result> run(std::ostream& console, const std::string& filter, double min_time,
+                            unsigned int repetitions) const
+    {
+        std::vector<Result> results;
+        for (const auto& benchmark : m_benchmarks)
+        {
+            if (benchmark.name.find(filter) == std::string::npos)
+            {
+                continue;
+            }
+            benchmark.body();
+            size_t iterations = 1;
+            double elapsed = timeIterations(benchmark.body, iterations);
+            while (elapsed < min_time)
+            {
+                // Grow geometrically, overshooting the target slightly so
+                // that the loop settles quickly for fast bodies.
+                const double scale = 1.4 * min_time / std::max(elapsed, 1e-9);
+                iterations = std::max(iterations + 1, size_t(double(iterations) * scale));
+                elapsed = timeIterations(benchmark.body, iterations);
+            }
+            double best = elapsed;
+            for (unsigned int rep = 1; rep < repetitions; ++rep)
+            {
+                best = std::min(best, timeIterations(benchmark.body, iterations));
+            }
+            Result result;
+            result.name = benchmark.name;
+            result.iterations = iterations;
+            result.real_time_ns = 1e9 * best / double(iterations);
+            result.items_per_second
+                = double(benchmark.items_per_iteration) * double(iterations) / best;
+            result.peak_rss_bytes = peakRSSBytes();
+            console << result.name << ": " << result.real_time_ns << " ns/iter, "
+                    << result.items_per_second << " items/s (" << result.iterations
+                    << " iterations, peak RSS " << result.peak_rss_bytes / (1024 * 1024) << " MiB)"
+                    << std::endl;
+            results.push_back(result);
+        }
+        return results;
+    }
+
+    //! Write results as JSON in Google Benchmark's output shape.
+    static void writeJson(std::ostream& stream, const std::vector<Result>& results)
+    {
+        stream << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            stream << "    {\n"
+                   << "      \"name\": \"" << result.name << "\",\n"
+                   << "      \"run_type\": \"iteration\",\n"
+                   << "      \"iterations\": " << result.iterations << ",\n"
+                   << "      \"real_time\": " << result.real_time_ns << ",\n"
+                   << "      \"time_unit\": \"ns\",\n"
+                   << "      \"items_per_second\": " << result.items_per_second << ",\n"
+                   << "      \"peak_rss_bytes\": " << result.peak_rss_bytes << "\n"
+                   << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        stream << "  ]\n}\n";
+    }
+
+private:
+    struct Entry
+    {
+        std::string name;
+        size_t items_per_iteration;
+        std::function<void()> body;
+    };
+
+    //! Time iterations calls of body in seconds.
+    static double timeIterations(const std::function<void()>& body, size_t iterations)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            body();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    std::vector<Entry> m_benchmarks;
+};
+
+}; }; // end namespace freud::benchmark
+
+#endif // BENCHMARK_H
@@ -0,0 +1,180 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef CONFIGURATIONS_H
+#define CONFIGURATIONS_H
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Box.h"
+#include "VectorMath.h"
+
+/*! \file Configurations.h
+    \brief Deterministic synthetic configurations for the benchmarks.
+
+    Uniform random points miss the density heterogeneity that drives the
+    scaling behavior of the neighbor finding and binning kernels, so the
+    benchmarks also run over structured configurations: thermalized crystals,
+    phase-separated droplets, and 2D hexatic layers. Every generator is
+    seeded, so a given (generator, size, seed) triple produces the same
+    configuration on every run and results stay diffable between releases.
+*/
+
+namespace freud { namespace benchmark {
+
+//! A box and the points filling it.
+struct Configuration
+{
+    box::Box box;
+    std::vector<vec3<float>> points;
+};
+
+//! Cubic crystal with Gaussian thermal noise.
+/*! Tiles the given unit-cell basis (in fractional cell coordinates) over
+ *  enough cells to reach at least n_target points at the requested number
+ *  density, then displaces each point by a Gaussian of width
+ *  noise * cell spacing.
+ */
+inline Configuration thermalCrystal(const std::vector<vec3<float>>& basis, unsigned int n_target,
+                                    float density, float noise, unsigned int seed)
+{
+    const auto atoms_per_cell = static_cast<float>(basis.size());
+    const auto cells = static_cast<unsigned int>(
+        std::ceil(std::cbrt(static_cast<float>(n_target) / atoms_per_cell)));
+    const float spacing = std::cbrt(atoms_per_cell / density);
+    const float length = spacing * static_cast<float>(cells);
+
+    Configuration configuration;
+    configuration.box = box::Box(length, length, length);
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> displacement(0.0F, noise * spacing);
+    for (unsigned int i = 0; i < cells; ++i)
+    {
+        for (unsigned int j = 0; j < cells; ++j)
+        {
+            for (unsigned int k = 0; k < cells; ++k)
+            {
+                for (const auto& site : basis)
+                {
+                    const vec3<float> position(
+                        (static_cast<float>(i) + site.x) * spacing - 0.5F * length,
+                        (static_cast<float>(j) + site.y) * spacing - 0.5F * length,
+                        (static_cast<float>(k) + site.z) * spacing - 0.5F * length);
+                    configuration.points.push_back(configuration.box.wrap(
+                        position
+                        + vec3<float>(displacement(rng), displacement(rng), displacement(rng))));
+                }
+            }
+        }
+    }
+    return configuration;
+}
+
+//! FCC crystal with thermal noise at the given number density.
+inline Configuration fccCrystal(unsigned int n_target, float density, float noise, unsigned int seed)
+{
+    const std::vector<vec3<float>> basis {vec3<float>(0.0F, 0.0F, 0.0F),
+                                          vec3<float>(0.0F, 0.5F, 0.5F),
+                                          vec3<float>(0.5F, 0.0F, 0.5F),
+                                          vec3<float>(0.5F, 0.5F, 0.0F)};
+    return thermalCrystal(basis, n_target, density, noise, seed);
+}
+
+//! BCC crystal with thermal noise at the given number density.
+inline Configuration bccCrystal(unsigned int n_target, float density, float noise, unsigned int seed)
+{
+    const std::vector<vec3<float>> basis {vec3<float>(0.0F, 0.0F, 0.0F),
+                                          vec3<float>(0.5F, 0.5F, 0.5F)};
+    return thermalCrystal(basis, n_target, density, noise, seed);
+}
+
+//! Phase-separated droplets in a dilute gas.
+/*! Places n_droplets dense spherical droplets on a deterministic grid of
+ *  centers and assigns them dense_fraction of the points, uniformly within
+ *  each droplet; the remainder fills the box as a uniform gas. The overall
+ *  number density is density, so the droplet interiors are far denser than
+ *  the surrounding gas -- the worst case for uniform-grid neighbor finding.
+ */
+inline Configuration droplets(unsigned int n_target, float density, unsigned int n_droplets,
+                              float dense_fraction, unsigned int seed)
+{
+    const float length = std::cbrt(static_cast<float>(n_target) / density);
+
+    Configuration configuration;
+    configuration.box = box::Box(length, length, length);
+    configuration.points.reserve(n_target);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(-0.5F * length, 0.5F * length);
+
+    // Centers on a cubic grid with one grid cell per droplet, offset to the
+    // cell centers so the droplets stay apart.
+    const auto grid = static_cast<unsigned int>(std::ceil(std::cbrt(static_cast<float>(n_droplets))));
+    const float cell = length / static_cast<float>(grid);
+    // Each droplet is a liquid-density sphere holding its share of the dense
+    // points.
+    const float droplet_points
+        = dense_fraction * static_cast<float>(n_target) / static_cast<float>(n_droplets);
+    const float droplet_radius = std::cbrt(droplet_points * 3.0F / (4.0F * float(M_PI)));
+    std::normal_distribution<float> gauss(0.0F, 1.0F);
+    std::uniform_real_distribution<float> unit(0.0F, 1.0F);
+
+    const auto n_dense = static_cast<unsigned int>(dense_fraction * static_cast<float>(n_target));
+    for (unsigned int i = 0; i < n_dense; ++i)
+    {
+        const unsigned int droplet = i % n_droplets;
+        const vec3<float> center(
+            (static_cast<float>(droplet % grid) + 0.5F) * cell - 0.5F * length,
+            (static_cast<float>((droplet / grid) % grid) + 0.5F) * cell - 0.5F * length,
+            (static_cast<float>(droplet / (grid * grid)) + 0.5F) * cell - 0.5F * length);
+        // Uniform within the sphere: a Gaussian direction with a cube-root
+        // radial law.
+        vec3<float> direction(gauss(rng), gauss(rng), gauss(rng));
+        direction = direction / std::sqrt(dot(direction, direction));
+        const float radius = droplet_radius * std::cbrt(unit(rng));
+        configuration.points.push_back(configuration.box.wrap(center + radius * direction));
+    }
+    for (unsigned int i = n_dense; i < n_target; ++i)
+    {
+        configuration.points.emplace_back(uniform(rng), uniform(rng), uniform(rng));
+    }
+    return configuration;
+}
+
+//! 2D triangular (hexatic) layer with Gaussian thermal noise.
+inline Configuration hexaticLayer(unsigned int n_target, float density, float noise, unsigned int seed)
+{
+    // A triangular lattice with spacing a holds one point per
+    // a^2 * sqrt(3) / 2 of area.
+    const float row_factor = 0.5F * std::sqrt(3.0F);
+    const float spacing = 1.0F / std::sqrt(density * row_factor);
+    const auto columns = static_cast<unsigned int>(
+        std::ceil(std::sqrt(static_cast<float>(n_target) * row_factor)));
+    const auto rows = static_cast<unsigned int>(
+        std::ceil(static_cast<float>(n_target) / static_cast<float>(columns)));
+    const float length_x = spacing * static_cast<float>(columns);
+    const float length_y = spacing * row_factor * static_cast<float>(rows);
+
+    Configuration configuration;
+    configuration.box = box::Box(length_x, length_y, 0, 0, 0, 0, true);
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> displacement(0.0F, noise * spacing);
+    for (unsigned int row = 0; row < rows; ++row)
+    {
+        const float offset = (row % 2 == 0) ? 0.0F : 0.5F * spacing;
+        for (unsigned int column = 0; column < columns; ++column)
+        {
+            const vec3<float> position(
+                static_cast<float>(column) * spacing + offset - 0.5F * length_x,
+                static_cast<float>(row) * spacing * row_factor - 0.5F * length_y, 0.0F);
+            configuration.points.push_back(configuration.box.wrap(
+                position + vec3<float>(displacement(rng), displacement(rng), 0.0F)));
+        }
+    }
+    return configuration;
+}
+
+}; }; // end namespace freud::benchmark
+
+#endif // CONFIGURATIONS_H
@@ -0,0 +1,280 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "Benchmark.h"
+#include "Box.h"
+#include "Configurations.h"
+#include "HexaticTranslational.h"
+#include "Histogram.h"
+#include "LinkCell.h"
+#include "PMFTR12.h"
+#include "PMFTXYZ.h"
+#include "RDF.h"
+#include "Steinhardt.h"
+
+/*! \file freud_benchmarks.cc
+    \brief Microbenchmarks for the core C++ kernels.
+
+    These measure the kernels directly, without the Python bindings, so that
+    regressions in the C++ hot loops are visible and candidate optimizations
+    can be profiled in isolation. Run with --json=FILE to record results for
+    regression tracking across commits; --filter=SUBSTRING selects a subset.
+*/
+
+namespace {
+
+//! Uniform random points filling most of a cubic (or square) box.
+std::vector<vec3<float>> makePoints(unsigned int n, float extent, bool is2D, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5F * extent, 0.5F * extent);
+    std::vector<vec3<float>> points;
+    points.reserve(n);
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        points.emplace_back(dist(rng), dist(rng), is2D ? 0.0F : dist(rng));
+    }
+    return points;
+}
+
+//! Uniform random unit quaternions.
+std::vector<quat<float>> makeOrientations(unsigned int n, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0F, 1.0F);
+    std::vector<quat<float>> orientations;
+    orientations.reserve(n);
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        quat<float> q(1.0F + dist(rng), vec3<float>(dist(rng), dist(rng), dist(rng)));
+        orientations.push_back(q * (1.0F / std::sqrt(norm2(q))));
+    }
+    return orientations;
+}
+
+//! Consume a neighbor query iterator, returning the number of bonds found.
+size_t drainQuery(const freud::locality::NeighborQuery& nq, const vec3<float>* query_points,
+                  unsigned int n_query_points, freud::locality::QueryArgs qargs)
+{
+    size_t bonds = 0;
+    auto iterator = nq.query(query_points, n_query_points, qargs);
+    for (auto bond = iterator->next(); !iterator->end(); bond = iterator->next())
+    {
+        ++bonds;
+    }
+    return bonds;
+}
+
+}; // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace freud;
+
+    std::string filter;
+    std::string json_path;
+    double min_time = 0.25;
+    unsigned int repetitions = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (arg.rfind("--filter=", 0) == 0)
+        {
+            filter = arg.substr(9);
+        }
+        else if (arg.rfind("--json=", 0) == 0)
+        {
+            json_path = arg.substr(7);
+        }
+        else if (arg.rfind("--min_time=", 0) == 0)
+        {
+            min_time = std::atof(arg.substr(11).c_str());
+        }
+        else if (arg.rfind("--repetitions=", 0) == 0)
+        {
+            repetitions = std::atoi(arg.substr(14).c_str());
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter=SUBSTRING] [--json=FILE] [--min_time=SECONDS]"
+                         " [--repetitions=N]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    benchmark::Registry registry;
+
+    // Box::wrap over a block of points; items are points.
+    const box::Box box3(30, 30, 30);
+    const auto wrap_points = makePoints(1 << 20, 90.0F, false, 1);
+    std::vector<vec3<float>> wrapped(wrap_points.size());
+    registry.add("box/wrap", wrap_points.size(), [&] {
+        for (size_t i = 0; i < wrap_points.size(); ++i)
+        {
+            wrapped[i] = box3.wrap(wrap_points[i]);
+        }
+    });
+
+    // Single-threaded neighbor iteration through the AABB tree and the cell
+    // list over identical systems; items are points queried.
+    const unsigned int n_query = 20000;
+    const auto query_points = makePoints(n_query, 28.0F, false, 2);
+    locality::QueryArgs ball_args;
+    ball_args.mode = locality::QueryType::ball;
+    ball_args.r_max = 1.5;
+    ball_args.exclude_ii = true;
+    const locality::AABBQuery aabb(box3, query_points.data(), n_query);
+    registry.add("locality/AABBQuery_query", n_query, [&] {
+        if (drainQuery(aabb, query_points.data(), n_query, ball_args) == 0)
+        {
+            std::abort();
+        }
+    });
+    const locality::LinkCell link_cell(box3, query_points.data(), n_query, 1.5F);
+    registry.add("locality/LinkCell_query", n_query, [&] {
+        if (drainQuery(link_cell, query_points.data(), n_query, ball_args) == 0)
+        {
+            std::abort();
+        }
+    });
+
+    // Histogram accumulation through a thread-local copy and the reduction
+    // over thread-local copies; items are samples and bins respectively.
+    const auto histogram_axes
+        = util::Axes {std::make_shared<util::RegularAxis>(32, 0.0F, 1.0F),
+                      std::make_shared<util::RegularAxis>(32, 0.0F, 1.0F),
+                      std::make_shared<util::RegularAxis>(32, 0.0F, 1.0F)};
+    util::Histogram<unsigned int> histogram(histogram_axes);
+    util::Histogram<unsigned int>::ThreadLocalHistogram local_histograms(histogram);
+    const auto samples = makePoints(1 << 18, 1.0F, false, 3);
+    registry.add("util/Histogram_accumulate", samples.size(), [&] {
+        auto& local = local_histograms.local();
+        for (const auto& sample : samples)
+        {
+            local(sample.x + 0.5F, sample.y + 0.5F, sample.z + 0.5F);
+        }
+    });
+    registry.add("util/Histogram_reduce", histogram.size(), [&] {
+        histogram.prepare(histogram.shape());
+        histogram.reduceOverThreads(local_histograms);
+    });
+
+    // Steinhardt q6 including the qlm spherical harmonic accumulation; items
+    // are points.
+    const unsigned int n_steinhardt = 5000;
+    const auto steinhardt_points = makePoints(n_steinhardt, 28.0F, false, 4);
+    const locality::AABBQuery steinhardt_query(box3, steinhardt_points.data(), n_steinhardt);
+    order::Steinhardt steinhardt(6);
+    registry.add("order/Steinhardt_q6", n_steinhardt, [&] {
+        steinhardt.compute(nullptr, &steinhardt_query, ball_args);
+    });
+
+    // The PMFT accumulation kernels; items are points per frame.
+    std::mt19937 angle_rng(5);
+    std::uniform_real_distribution<float> angle_dist(0.0F, constants::TWO_PI);
+    std::vector<float> angles(n_query);
+    std::vector<float> query_angles(n_query);
+    for (unsigned int i = 0; i < n_query; ++i)
+    {
+        angles[i] = angle_dist(angle_rng);
+        query_angles[i] = angle_dist(angle_rng);
+    }
+    const box::Box box2(30, 30, 0, 0, 0, 0, true);
+    const auto points_2d = makePoints(n_query, 28.0F, true, 6);
+    const locality::AABBQuery query_2d(box2, points_2d.data(), n_query);
+    pmft::PMFTR12 pmft_r12(1.5F, 20, 24, 24);
+    registry.add("pmft/PMFTR12_accumulate", n_query, [&] {
+        pmft_r12.accumulate(&query_2d, angles.data(), points_2d.data(), query_angles.data(), n_query,
+                            nullptr, ball_args);
+    });
+    const auto orientations = makeOrientations(n_query, 7);
+    const quat<float> identity(1.0F, vec3<float>(0, 0, 0));
+    pmft::PMFTXYZ pmft_xyz(1.5F, 1.5F, 1.5F, 20, 20, 20, vec3<float>(0, 0, 0));
+    registry.add("pmft/PMFTXYZ_accumulate", n_query, [&] {
+        pmft_xyz.accumulate(&aabb, orientations.data(), query_points.data(), n_query, &identity, 1,
+                            nullptr, ball_args);
+    });
+
+    // Structured-configuration sweeps: the same computes over configurations
+    // whose density heterogeneity differs, at two sizes each, so scaling
+    // regressions that uniform random points hide show up in the sweep. The
+    // generators are seeded, so reruns measure identical configurations.
+    struct SweepCase
+    {
+        std::string name;
+        benchmark::Configuration configuration;
+    };
+    // A deque keeps the configurations' addresses stable as cases are added;
+    // the registered lambdas capture references into it.
+    auto sweep_cases = std::make_shared<std::deque<SweepCase>>();
+    for (const unsigned int n : {8192U, 65536U})
+    {
+        const std::string size_suffix = "/N=" + std::to_string(n);
+        sweep_cases->push_back({"fcc" + size_suffix, benchmark::fccCrystal(n, 1.0F, 0.1F, 10)});
+        sweep_cases->push_back({"bcc" + size_suffix, benchmark::bccCrystal(n, 1.0F, 0.1F, 11)});
+        sweep_cases->push_back({"droplets" + size_suffix, benchmark::droplets(n, 0.2F, 8, 0.8F, 12)});
+    }
+    for (const auto& sweep_case : *sweep_cases)
+    {
+        const auto& configuration = sweep_case.configuration;
+        const auto n_points = static_cast<unsigned int>(configuration.points.size());
+        auto query = std::make_shared<locality::AABBQuery>(configuration.box,
+                                                           configuration.points.data(), n_points);
+        auto rdf = std::make_shared<density::RDF>(50, 4.0F);
+        locality::QueryArgs sweep_args;
+        sweep_args.mode = locality::QueryType::ball;
+        sweep_args.r_max = 4.0;
+        sweep_args.exclude_ii = true;
+        registry.add("sweep/locality/AABBQuery/" + sweep_case.name, n_points,
+                     [&configuration, query, n_points, sweep_args] {
+                         if (drainQuery(*query, configuration.points.data(), n_points, sweep_args)
+                             == 0)
+                         {
+                             std::abort();
+                         }
+                     });
+        registry.add("sweep/density/RDF/" + sweep_case.name, n_points,
+                     [&configuration, query, rdf, n_points, sweep_args] {
+                         rdf->accumulate(query.get(), configuration.points.data(), n_points, nullptr,
+                                         sweep_args);
+                     });
+    }
+    for (const unsigned int n : {8192U, 65536U})
+    {
+        sweep_cases->push_back(
+            {"hexatic/N=" + std::to_string(n), benchmark::hexaticLayer(n, 1.0F, 0.08F, 13)});
+        const auto& configuration = sweep_cases->back().configuration;
+        const auto n_points = static_cast<unsigned int>(configuration.points.size());
+        auto query = std::make_shared<locality::AABBQuery>(configuration.box,
+                                                           configuration.points.data(), n_points);
+        auto hexatic = std::make_shared<order::Hexatic>(6, false);
+        locality::QueryArgs hexatic_args;
+        hexatic_args.mode = locality::QueryType::nearest;
+        hexatic_args.num_neighbors = 6;
+        hexatic_args.exclude_ii = true;
+        registry.add("sweep/order/Hexatic/" + sweep_cases->back().name, n_points,
+                     [query, hexatic, hexatic_args] {
+                         hexatic->compute(nullptr, query.get(), hexatic_args);
+                     });
+    }
+
+    const auto results = registry.run(std::cout, filter, min_time, repetitions);
+    if (!json_path.empty())
+    {
+        std::ofstream json_stream(json_path);
+        benchmark::Registry::writeJson(json_stream, results);
+    }
+    return results.empty() ? 1 : 0;
+}
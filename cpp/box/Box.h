@@ -6,10 +6,15 @@
 
 #include "utils.h"
 #include <algorithm>
+#include <cmath>
 #include <complex>
 #include <sstream>
 #include <stdexcept>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #include "VectorMath.h"
 
 /*! \file Box.h
@@ -48,6 +53,7 @@ public:
         setL(0, 0, 0);
         m_periodic = vec3<bool>(true, true, true);
         m_xy = m_xz = m_yz = 0;
+        updateCache();
     }
 
     //! Construct a square/cubic box
@@ -57,6 +63,7 @@ public:
         setL(L, L, L);
         m_periodic = vec3<bool>(true, true, true);
         m_xy = m_xz = m_yz = 0;
+        updateCache();
     }
 
     //! Construct an orthorhombic box
@@ -66,6 +73,7 @@ public:
         setL(Lx, Ly, Lz);
         m_periodic = vec3<bool>(true, true, true);
         m_xy = m_xz = m_yz = 0;
+        updateCache();
     }
 
     //! Construct a triclinic box
@@ -77,6 +85,7 @@ public:
         m_xy = xy;
         m_xz = xz;
         m_yz = yz;
+        updateCache();
     }
 
     inline bool operator==(const Box& b) const
@@ -115,6 +124,7 @@ public:
 
         m_hi = m_L / float(2.0);
         m_lo = -m_hi;
+        updateCache();
     }
 
     //! Set whether box is 2D
@@ -123,6 +133,7 @@ public:
         m_2d = _2d;
         m_L.z = 0;
         m_Linv.z = 0;
+        updateCache();
     }
 
     //! Returns whether box is two dimensional
@@ -183,18 +194,62 @@ public:
     void setTiltFactorXY(float xy)
     {
         m_xy = xy;
+        updateCache();
     }
 
     //! Set tilt factor xz
     void setTiltFactorXZ(float xz)
     {
         m_xz = xz;
+        updateCache();
     }
 
     //! Set tilt factor yz
     void setTiltFactorYZ(float yz)
     {
         m_yz = yz;
+        updateCache();
+    }
+
+    //! Returns whether all tilt factors are zero
+    /*! Orthorhombic boxes admit much cheaper boundary condition handling
+     *  because the box matrix is diagonal, so several routines below select a
+     *  fast path based on this check. The answer is resolved once per
+     *  geometry change rather than per call.
+     */
+    bool isOrthorhombic() const
+    {
+        return m_orthorhombic;
+    }
+
+    //! Get row i of the box (cartesian) matrix h.
+    /*! The columns of h are the lattice vectors, so h * f for a fractional
+     *  coordinate f gives the corresponding absolute coordinate relative to
+     *  the box's lower corner. The rows are cached at construction for
+     *  kernels that transform many vectors at once.
+     *  \param i Row index (0 <= i < 3).
+     */
+    vec3<float> getBoxMatrixRow(unsigned int i) const
+    {
+        if (i >= 3)
+        {
+            throw std::out_of_range("Box matrix row index requested does not exist.");
+        }
+        return m_cart_rows[i];
+    }
+
+    //! Get row i of the inverse box (fractional-coordinate) matrix h^-1.
+    /*! h^-1 * (v - lower corner) gives the fractional coordinate of v; in 2D
+     *  boxes the z row is zero. Cached at construction like the box matrix.
+     *  \param i Row index (0 <= i < 3).
+     */
+    vec3<float> getInverseBoxMatrixRow(unsigned int i) const
+    {
+        if (i >= 3)
+        {
+            throw std::out_of_range("Box matrix row index requested does not exist.");
+        }
+        return m_frac_rows[i];
     }
 
     //! Get the volume of the box (area in 2D)
@@ -224,6 +279,25 @@ public:
         return v;
     }
 
+    //! Convert fractional coordinates into absolute coordinates at double precision.
+    /*! Overload for computations that carry long-range quantities in double,
+     *  where the float round trip through fractional coordinates loses too
+     *  many digits in large or strongly tilted boxes. The box parameters are
+     *  promoted from their float storage, so the result is the double
+     *  evaluation of the same arithmetic as the float overload.
+     */
+    vec3<double> makeAbsolute(const vec3<double>& f) const
+    {
+        vec3<double> v = vec3<double>(m_lo) + f * vec3<double>(m_L);
+        v.x += double(m_xy) * v.y + double(m_xz) * v.z;
+        v.y += double(m_yz) * v.z;
+        if (m_2d)
+        {
+            v.z = 0.0;
+        }
+        return v;
+    }
+
     //! Convert fractional coordinates into absolute coordinates in place
     /*! \param vecs Vectors of fractional coordinates between 0 and 1 within
      *         parallelepipedal box
@@ -232,6 +306,13 @@ public:
      */
     void makeAbsolute(const vec3<float>* vecs, unsigned int Nvecs, vec3<float>* out) const
     {
+        if (isOrthorhombic())
+        {
+            util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
+                makeAbsoluteOrthorhombicRange(vecs, begin, end, out);
+            });
+            return;
+        }
         util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
             {
@@ -247,7 +328,7 @@ public:
     vec3<float> makeFractional(const vec3<float>& v) const
     {
         vec3<float> delta = v - m_lo;
-        delta.x -= (m_xz - m_yz * m_xy) * v.z + m_xy * v.y;
+        delta.x -= m_tilt_coeff * v.z + m_xy * v.y;
         delta.y -= m_yz * v.z;
         delta = delta / m_L;
 
@@ -258,6 +339,25 @@ public:
         return delta;
     }
 
+    //! Convert a point's coordinate from absolute to fractional box coordinates at double precision.
+    /*! The subtraction of the tilt contributions cancels catastrophically in
+     *  float for points many box lengths from the origin, so accumulations
+     *  that unwrap trajectories or sum over images should use this overload.
+     */
+    vec3<double> makeFractional(const vec3<double>& v) const
+    {
+        vec3<double> delta = v - vec3<double>(m_lo);
+        delta.x -= (double(m_xz) - double(m_yz) * double(m_xy)) * v.z + double(m_xy) * v.y;
+        delta.y -= double(m_yz) * v.z;
+        delta = delta / vec3<double>(m_L);
+
+        if (m_2d)
+        {
+            delta.z = 0.0;
+        }
+        return delta;
+    }
+
     //! Convert point coordinates from absolute to fractional box coordinates.
     /*! \param vecs Vectors to convert
      *  \param Nvecs Number of vectors
@@ -296,6 +396,13 @@ public:
      */
     void getImages(vec3<float>* vecs, unsigned int Nvecs, vec3<int>* res) const
     {
+        if (isOrthorhombic())
+        {
+            util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
+                getImagesOrthorhombicRange(vecs, begin, end, res);
+            });
+            return;
+        }
         util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
             {
@@ -310,10 +417,23 @@ public:
      */
     vec3<float> wrap(const vec3<float>& v) const
     {
-        // Return quickly if the box is aperiodic
-        if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+        // The kernel is selected once per geometry or periodicity change, so
+        // the per-call cost is a single jump on the cached selector.
+        switch (m_wrap_kernel)
         {
+        case WrapKernel::aperiodic:
             return v;
+        case WrapKernel::orthorhombic:
+            // Orthorhombic boxes avoid the fractional coordinate round trip
+            // (and its divisions) entirely.
+            return wrapOrthorhombic(v);
+        case WrapKernel::orthorhombic2D:
+            return wrapOrthorhombic2D(v);
+        case WrapKernel::shear2D:
+            return wrapShear2D(v);
+        case WrapKernel::triclinic:
+        default:
+            break;
         }
 
         vec3<float> v_frac = makeFractional(v);
@@ -332,6 +452,34 @@ public:
         return makeAbsolute(v_frac);
     }
 
+    //! Wrap a double-precision vector back into the box.
+    /*! Always takes the general fractional-coordinate path so that the full
+     *  double arithmetic is preserved; callers that hold positions in double
+     *  do so because they care about the extra digits, not the divisions.
+     */
+    vec3<double> wrap(const vec3<double>& v) const
+    {
+        if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+        {
+            return v;
+        }
+
+        vec3<double> v_frac = makeFractional(v);
+        if (m_periodic.x)
+        {
+            v_frac.x = util::modulusPositive(v_frac.x, 1.0);
+        }
+        if (m_periodic.y)
+        {
+            v_frac.y = util::modulusPositive(v_frac.y, 1.0);
+        }
+        if (m_periodic.z)
+        {
+            v_frac.z = util::modulusPositive(v_frac.z, 1.0);
+        }
+        return makeAbsolute(v_frac);
+    }
+
     //! Wrap vectors back into the box in place
     /*! \param vecs Vectors to wrap, updated to the minimum image obeying the periodic settings
      *  \param Nvecs Number of vectors
@@ -339,6 +487,13 @@ public:
      */
     void wrap(const vec3<float>* vecs, unsigned int Nvecs, vec3<float>* out) const
     {
+        if (m_wrap_kernel == WrapKernel::orthorhombic || m_wrap_kernel == WrapKernel::orthorhombic2D)
+        {
+            util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
+                wrapOrthorhombicRange(vecs, begin, end, out);
+            });
+            return;
+        }
         util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
             {
@@ -355,6 +510,13 @@ public:
     */
     void unwrap(const vec3<float>* vecs, const vec3<int>* images, unsigned int Nvecs, vec3<float>* out) const
     {
+        if (isOrthorhombic())
+        {
+            util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
+                unwrapOrthorhombicRange(vecs, images, begin, end, out);
+            });
+            return;
+        }
         util::forLoopWrapper(0, Nvecs, [&](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
             {
@@ -378,22 +540,26 @@ public:
     {
         // This roughly follows the implementation in
         // https://en.wikipedia.org/wiki/Center_of_mass#Systems_with_periodic_boundary_conditions
-        float total_mass(0);
-        vec3<std::complex<float>> xi_mean;
+        // The sums run in double: a float accumulator loses mass-weighted
+        // phase information once the running total dwarfs each contribution,
+        // which visibly shifts the result for large systems.
+        double total_mass(0);
+        vec3<std::complex<double>> xi_mean;
 
         for (size_t i = 0; i < Nvecs; ++i)
         {
-            vec3<float> phase(constants::TWO_PI * makeFractional(vecs[i]));
-            vec3<std::complex<float>> xi(std::polar(float(1.0), phase.x), std::polar(float(1.0), phase.y),
-                                         std::polar(float(1.0), phase.z));
-            float mass = (masses != nullptr) ? masses[i] : float(1.0);
+            vec3<double> phase(double(constants::TWO_PI) * makeFractional(vec3<double>(vecs[i])));
+            vec3<std::complex<double>> xi(std::polar(1.0, phase.x), std::polar(1.0, phase.y),
+                                          std::polar(1.0, phase.z));
+            double mass = (masses != nullptr) ? double(masses[i]) : 1.0;
             total_mass += mass;
-            xi_mean += std::complex<float>(mass, 0) * xi;
+            xi_mean += std::complex<double>(mass, 0) * xi;
         }
-        xi_mean /= std::complex<float>(total_mass, 0);
+        xi_mean /= std::complex<double>(total_mass, 0);
 
-        return wrap(makeAbsolute(vec3<float>(std::arg(xi_mean.x), std::arg(xi_mean.y), std::arg(xi_mean.z))
-                                 / constants::TWO_PI));
+        return vec3<float>(wrap(makeAbsolute(vec3<double>(std::arg(xi_mean.x), std::arg(xi_mean.y),
+                                                          std::arg(xi_mean.z))
+                                             / double(constants::TWO_PI))));
     }
 
     //! Subtract center of mass from vectors
@@ -531,29 +697,34 @@ public:
     void setPeriodic(vec3<bool> periodic)
     {
         m_periodic = periodic;
+        updateCache();
     }
 
     void setPeriodic(bool x, bool y, bool z)
     {
         m_periodic = vec3<bool>(x, y, z);
+        updateCache();
     }
 
     //! Set the periodic flag along x
     void setPeriodicX(bool x)
     {
         m_periodic = vec3<bool>(x, m_periodic.y, m_periodic.z);
+        updateCache();
     }
 
     //! Set the periodic flag along y
     void setPeriodicY(bool y)
     {
         m_periodic = vec3<bool>(m_periodic.x, y, m_periodic.z);
+        updateCache();
     }
 
     //! Set the periodic flag along z
     void setPeriodicZ(bool z)
     {
         m_periodic = vec3<bool>(m_periodic.x, m_periodic.y, z);
+        updateCache();
     }
 
     //! Get the periodic flags
@@ -597,15 +768,282 @@ public:
     }
 
 private:
+    //! Branch-free minimum-image wrap for orthorhombic boxes.
+    /*! With a diagonal box matrix, wrapping reduces to removing an integer
+     *  number of box lengths per dimension. Aperiodic dimensions zero out
+     *  their correction term rather than branching, so one instruction
+     *  sequence serves every periodicity setting. Note that in 2D boxes
+     *  m_Linv.z is zero, so the z correction vanishes there as well.
+     */
+    vec3<float> wrapOrthorhombic(const vec3<float>& v) const
+    {
+        vec3<float> w(v.x - m_wrap_corr.x * std::floor((v.x - m_lo.x) * m_Linv.x),
+                      v.y - m_wrap_corr.y * std::floor((v.y - m_lo.y) * m_Linv.y),
+                      v.z - m_wrap_corr.z * std::floor((v.z - m_lo.z) * m_Linv.z));
+        if (m_2d)
+        {
+            w.z = float(0.0);
+        }
+        return w;
+    }
+
+    //! Minimum-image wrap for orthorhombic 2D boxes.
+    /*! The x and y arithmetic matches wrapOrthorhombic() exactly; the z
+     *  component is constant zero in a 2D box, so its floor and correction
+     *  drop out of this per-bond hot path entirely.
+     */
+    vec3<float> wrapOrthorhombic2D(const vec3<float>& v) const
+    {
+        return {v.x - m_wrap_corr.x * std::floor((v.x - m_lo.x) * m_Linv.x),
+                v.y - m_wrap_corr.y * std::floor((v.y - m_lo.y) * m_Linv.y), float(0.0)};
+    }
+
+    //! Minimum-image wrap for 2D boxes with an xy shear.
+    /*! Specializes the fractional coordinate round trip to the only tilt
+     *  factor a 2D box can meaningfully carry. Selected when xz and yz are
+     *  zero, which makes every z term in makeFractional() and makeAbsolute()
+     *  vanish; the surviving x and y operations run in the same order as the
+     *  general path, so the results are bit-identical to it.
+     */
+    vec3<float> wrapShear2D(const vec3<float>& v) const
+    {
+        float f_x = ((v.x - m_lo.x) - m_xy * v.y) / m_L.x;
+        float f_y = (v.y - m_lo.y) / m_L.y;
+        if (m_periodic.x)
+        {
+            f_x = util::modulusPositive(f_x, float(1.0));
+        }
+        if (m_periodic.y)
+        {
+            f_y = util::modulusPositive(f_y, float(1.0));
+        }
+        const float w_y = m_lo.y + f_y * m_L.y;
+        return {m_lo.x + f_x * m_L.x + m_xy * w_y, w_y, float(0.0)};
+    }
+
+#if defined(__AVX__)
+    //! Broadcast a per-component constant across a 24-float SIMD tile.
+    /*! vec3<float> arrays are stored as x, y, z, x, y, z, ..., so eight
+     *  vectors (24 floats) form the smallest block whose component pattern
+     *  tiles whole 8-float registers. The three registers produced here line
+     *  up component constants against three consecutive packed loads.
+     */
+    static void broadcastComponents(const vec3<float>& c, __m256 regs[3])
+    {
+        alignas(32) float pattern[24];
+        for (unsigned int i = 0; i < 24; ++i)
+        {
+            pattern[i] = (i % 3 == 0) ? c.x : ((i % 3 == 1) ? c.y : c.z);
+        }
+        regs[0] = _mm256_load_ps(pattern);
+        regs[1] = _mm256_load_ps(pattern + 8);
+        regs[2] = _mm256_load_ps(pattern + 16);
+    }
+#endif
+
+    //! Wrap a range of vectors in an orthorhombic box.
+    /*! Used by the array version of wrap(). The SIMD path applies the same
+     *  formula as wrapOrthorhombic() to eight vectors at a time; the trailing
+     *  remainder falls through to the scalar code.
+     */
+    void wrapOrthorhombicRange(const vec3<float>* vecs, size_t begin, size_t end, vec3<float>* out) const
+    {
+        size_t i = begin;
+#if defined(__AVX__)
+        __m256 corr[3];
+        __m256 lo[3];
+        __m256 linv[3];
+        __m256 keep[3];
+        broadcastComponents(vec3<float>(m_periodic.x ? m_L.x : float(0.0),
+                                        m_periodic.y ? m_L.y : float(0.0),
+                                        m_periodic.z ? m_L.z : float(0.0)),
+                            corr);
+        broadcastComponents(m_lo, lo);
+        broadcastComponents(m_Linv, linv);
+        broadcastComponents(vec3<float>(1.0, 1.0, m_2d ? 0.0 : 1.0), keep);
+        const float* in_f = &vecs[0].x;
+        float* out_f = &out[0].x;
+        for (; i + 8 <= end; i += 8)
+        {
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const __m256 v = _mm256_loadu_ps(in_f + 3 * i + 8 * r);
+                const __m256 f = _mm256_mul_ps(_mm256_sub_ps(v, lo[r]), linv[r]);
+                __m256 w = _mm256_sub_ps(v, _mm256_mul_ps(corr[r], _mm256_floor_ps(f)));
+                w = _mm256_mul_ps(w, keep[r]);
+                _mm256_storeu_ps(out_f + 3 * i + 8 * r, w);
+            }
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            out[i] = wrapOrthorhombic(vecs[i]);
+        }
+    }
+
+    //! Convert a range of fractional coordinates in an orthorhombic box.
+    void makeAbsoluteOrthorhombicRange(const vec3<float>* vecs, size_t begin, size_t end,
+                                       vec3<float>* out) const
+    {
+        size_t i = begin;
+#if defined(__AVX__)
+        __m256 lo[3];
+        __m256 length[3];
+        broadcastComponents(m_lo, lo);
+        broadcastComponents(m_L, length);
+        const float* in_f = &vecs[0].x;
+        float* out_f = &out[0].x;
+        // In 2D boxes both m_lo.z and m_L.z are zero, so the z component comes
+        // out zero just as in the scalar code.
+        for (; i + 8 <= end; i += 8)
+        {
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const __m256 f = _mm256_loadu_ps(in_f + 3 * i + 8 * r);
+                const __m256 v = _mm256_add_ps(lo[r], _mm256_mul_ps(f, length[r]));
+                _mm256_storeu_ps(out_f + 3 * i + 8 * r, v);
+            }
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            out[i] = makeAbsolute(vecs[i]);
+        }
+    }
+
+    //! Compute periodic images for a range of vectors in an orthorhombic box.
+    void getImagesOrthorhombicRange(const vec3<float>* vecs, size_t begin, size_t end, vec3<int>* res) const
+    {
+        size_t i = begin;
+#if defined(__AVX__)
+        __m256 lo[3];
+        __m256 linv[3];
+        __m256 keep[3];
+        broadcastComponents(m_lo, lo);
+        broadcastComponents(m_Linv, linv);
+        broadcastComponents(vec3<float>(1.0, 1.0, m_2d ? 0.0 : 1.0), keep);
+        const __m256 half = _mm256_set1_ps(0.5F);
+        const __m256 sign_mask = _mm256_set1_ps(-0.0F);
+        const float* in_f = &vecs[0].x;
+        int* res_i = &res[0].x;
+        for (; i + 8 <= end; i += 8)
+        {
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const __m256 v = _mm256_loadu_ps(in_f + 3 * i + 8 * r);
+                const __m256 frac = _mm256_mul_ps(_mm256_sub_ps(v, lo[r]), linv[r]);
+                const __m256 f = _mm256_mul_ps(_mm256_sub_ps(frac, half), keep[r]);
+                // Round half away from zero by adding +/- 0.5 and truncating,
+                // matching the scalar getImage().
+                const __m256 adjust = _mm256_or_ps(half, _mm256_and_ps(f, sign_mask));
+                const __m256i image = _mm256_cvttps_epi32(_mm256_add_ps(f, adjust));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(res_i + 3 * i + 8 * r), image);
+            }
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            getImage(vecs[i], res[i]);
+        }
+    }
+
+    //! Unwrap a range of vectors in an orthorhombic box.
+    void unwrapOrthorhombicRange(const vec3<float>* vecs, const vec3<int>* images, size_t begin, size_t end,
+                                 vec3<float>* out) const
+    {
+        size_t i = begin;
+#if defined(__AVX__)
+        __m256 length[3];
+        broadcastComponents(m_L, length);
+        const float* in_f = &vecs[0].x;
+        const int* img_i = &images[0].x;
+        float* out_f = &out[0].x;
+        // The diagonal box matrix makes each lattice vector axis-aligned, and
+        // m_L.z is zero in 2D, so the z image shift drops out there.
+        for (; i + 8 <= end; i += 8)
+        {
+            for (unsigned int r = 0; r < 3; ++r)
+            {
+                const __m256 v = _mm256_loadu_ps(in_f + 3 * i + 8 * r);
+                const __m256 image = _mm256_cvtepi32_ps(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(img_i + 3 * i + 8 * r)));
+                const __m256 w = _mm256_add_ps(v, _mm256_mul_ps(image, length[r]));
+                _mm256_storeu_ps(out_f + 3 * i + 8 * r, w);
+            }
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            out[i] = vecs[i] + vec3<float>(m_L.x * float(images[i].x), m_L.y * float(images[i].y),
+                                           m_2d ? float(0.0) : m_L.z * float(images[i].z));
+        }
+    }
+
+    //! Which wrap() implementation the current geometry and periodicity allow.
+    enum class WrapKernel
+    {
+        aperiodic,      //!< No periodic dimensions; wrap() is the identity.
+        orthorhombic,   //!< Diagonal box matrix; floor-based wrap.
+        orthorhombic2D, //!< Diagonal 2D box; floor-based wrap without z.
+        shear2D,        //!< 2D box with only an xy tilt; no z arithmetic.
+        triclinic       //!< General case; fractional coordinate round trip.
+    };
+
+    //! Refresh the derived quantities cached from the box parameters.
+    /*! Every setter that changes the box lengths, tilt factors,
+     *  dimensionality, or periodic flags ends with this call, so the cached
+     *  values can be read unconditionally on the hot paths. The cached rows
+     *  are the box matrix h = [[Lx, xy*Ly, xz*Lz], [0, Ly, yz*Lz], [0, 0, Lz]]
+     *  and its inverse; makeFractional() applies the inverse rows with the
+     *  original operation order so binning stays bit-identical.
+     */
+    void updateCache()
+    {
+        m_tilt_coeff = m_xz - m_yz * m_xy;
+        m_orthorhombic = (m_xy == float(0.0)) && (m_xz == float(0.0)) && (m_yz == float(0.0));
+        if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+        {
+            m_wrap_kernel = WrapKernel::aperiodic;
+        }
+        else if (m_orthorhombic)
+        {
+            m_wrap_kernel = m_2d ? WrapKernel::orthorhombic2D : WrapKernel::orthorhombic;
+        }
+        else if (m_2d && m_xz == float(0.0) && m_yz == float(0.0))
+        {
+            m_wrap_kernel = WrapKernel::shear2D;
+        }
+        else
+        {
+            m_wrap_kernel = WrapKernel::triclinic;
+        }
+        m_wrap_corr = vec3<float>(m_periodic.x ? m_L.x : float(0.0), m_periodic.y ? m_L.y : float(0.0),
+                                  m_periodic.z ? m_L.z : float(0.0));
+        m_cart_rows[0] = vec3<float>(m_L.x, m_xy * m_L.y, m_xz * m_L.z);
+        m_cart_rows[1] = vec3<float>(0.0, m_L.y, m_yz * m_L.z);
+        m_cart_rows[2] = vec3<float>(0.0, 0.0, m_L.z);
+        m_frac_rows[0] = vec3<float>(m_Linv.x, -m_xy * m_Linv.x, (m_yz * m_xy - m_xz) * m_Linv.x);
+        m_frac_rows[1] = vec3<float>(0.0, m_Linv.y, -m_yz * m_Linv.y);
+        m_frac_rows[2] = vec3<float>(0.0, 0.0, m_Linv.z);
+    }
+
     vec3<float> m_lo;      //!< Minimum coords in the box
     vec3<float> m_hi;      //!< Maximum coords in the box
     vec3<float> m_L;       //!< L precomputed (used to avoid subtractions in boundary conditions)
     vec3<float> m_Linv;    //!< 1/L precomputed (used to avoid divisions in boundary conditions)
-    float m_xy;            //!< xy tilt factor
-    float m_xz;            //!< xz tilt factor
-    float m_yz;            //!< yz tilt factor
-    vec3<bool> m_periodic; //!< 0/1 to determine if the box is periodic in each direction
-    bool m_2d;             //!< Specify whether box is 2D.
+    float m_xy {0};        //!< xy tilt factor
+    float m_xz {0};        //!< xz tilt factor
+    float m_yz {0};        //!< yz tilt factor
+    vec3<bool> m_periodic {true, true, true}; //!< 0/1 to determine if the box is periodic in each direction
+    bool m_2d {false};                        //!< Specify whether box is 2D.
+
+    // Derived quantities refreshed by updateCache() whenever a setter runs.
+    float m_tilt_coeff {0};       //!< xz - yz * xy, the z coefficient in makeFractional()
+    bool m_orthorhombic {true};   //!< Whether all tilt factors are zero
+    WrapKernel m_wrap_kernel {WrapKernel::orthorhombic}; //!< Branch-resolved wrap() selector
+    vec3<float> m_wrap_corr;      //!< Per-dimension box length, zeroed where aperiodic
+    vec3<float> m_cart_rows[3];   //!< Rows of the box matrix h
+    vec3<float> m_frac_rows[3];   //!< Rows of the inverse box matrix
 };
 
 }; }; // end namespace freud::box
@@ -2,16 +2,24 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <numeric>
 
 #include "Cluster.h"
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
 #include "dset/dset.h"
+#include "utils.h"
 
 //! Finds clusters using a network of neighbors.
 namespace freud { namespace cluster {
 
+namespace {
+//! Number of points per block in the parallel relabeling passes.
+constexpr size_t LABEL_BLOCK_SIZE = 4096;
+}; // namespace
+
 void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
                       freud::locality::QueryArgs qargs, const unsigned int* keys)
 {
@@ -19,7 +27,7 @@ void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::loc
     m_cluster_idx.prepare(num_points);
     DisjointSets dj(num_points);
 
-    freud::locality::loopOverNeighbors(
+    freud::locality::loopOverNeighborsStatic(
         nq, nq->getPoints(), num_points, qargs, nlist,
         [&dj](const freud::locality::NeighborBond& neighbor_bond) {
             // Merge the two sets using the disjoint set
@@ -33,74 +41,181 @@ void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::loc
     // Next, we renumber clusters from zero to num_clusters-1.
     // These new cluster indexes are then sorted by cluster size from largest
     // to smallest, with equally-sized clusters sorted based on their minimum
-    // point index.
-    std::vector<size_t> cluster_label(num_points, num_points);
-    std::vector<size_t> cluster_label_count(num_points);
-    std::vector<size_t> cluster_min_id(num_points, num_points);
+    // point index. That final ordering is independent of how the clusters are
+    // enumerated here (the size/min-index sort key is unique per cluster), so
+    // the relabeling passes below are free to assign the intermediate labels
+    // in parallel.
+
+    // Flatten every point to its root once, in parallel, and count the
+    // cluster representatives per block to seed the label prefix sum. The
+    // blocks are fixed-size rather than taken from the scheduler so that the
+    // prefix sum is deterministic.
+    const size_t n_blocks = (size_t(num_points) + LABEL_BLOCK_SIZE - 1) / LABEL_BLOCK_SIZE;
+    std::vector<uint32_t> roots(num_points);
+    std::vector<size_t> block_offsets(n_blocks);
+    util::forLoopWrapper(0, n_blocks, [&](size_t block_begin, size_t block_end) {
+        for (size_t block = block_begin; block < block_end; ++block)
+        {
+            const size_t begin = block * LABEL_BLOCK_SIZE;
+            const size_t end = std::min(begin + LABEL_BLOCK_SIZE, size_t(num_points));
+            size_t num_representatives = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                roots[i] = dj.find(i);
+                if (roots[i] == i)
+                {
+                    ++num_representatives;
+                }
+            }
+            block_offsets[block] = num_representatives;
+        }
+    });
 
-    // Loop over every point.
-    m_num_clusters = 0;
-    for (size_t i = 0; i < num_points; i++)
+    // Serial exclusive scan over the (few) per-block counts.
+    size_t total_clusters = 0;
+    for (size_t block = 0; block < n_blocks; ++block)
     {
-        size_t s = dj.find(i);
+        const size_t block_count = block_offsets[block];
+        block_offsets[block] = total_clusters;
+        total_clusters += block_count;
+    }
+    m_num_clusters = total_clusters;
 
-        // Label this cluster if we haven't seen it yet.
-        if (cluster_label[s] == num_points)
+    // Assign each cluster a dense label, ordered by representative index.
+    std::vector<uint32_t> dense_label(num_points);
+    util::forLoopWrapper(0, n_blocks, [&](size_t block_begin, size_t block_end) {
+        for (size_t block = block_begin; block < block_end; ++block)
         {
-            // Label this cluster uniquely.
-            cluster_label[s] = m_num_clusters;
-            // Track the smallest point index in this cluster.
-            cluster_min_id[cluster_label[s]] = i;
-            // Increment the count of unique clusters.
-            m_num_clusters++;
+            const size_t begin = block * LABEL_BLOCK_SIZE;
+            const size_t end = std::min(begin + LABEL_BLOCK_SIZE, size_t(num_points));
+            size_t next_label = block_offsets[block];
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (roots[i] == i)
+                {
+                    dense_label[i] = next_label++;
+                }
+            }
         }
+    });
 
-        // Increment the counter for this cluster label.
-        cluster_label_count[cluster_label[s]]++;
-    }
-
-    // Resize label counts and min ids to the number of unique clusters found.
-    cluster_label_count.resize(m_num_clusters);
-    cluster_label_count.shrink_to_fit();
-    cluster_min_id.resize(m_num_clusters);
-    cluster_min_id.shrink_to_fit();
+    // Accumulate each cluster's size and minimum point index concurrently;
+    // both reductions are commutative, so the result does not depend on the
+    // thread schedule.
+    // All per-cluster index tables are 32-bit: point counts and minimum ids
+    // are bounded by num_points, and the narrower entries halve the traffic
+    // of the gather-heavy per-point passes below.
+    std::vector<std::atomic<uint32_t>> counts(m_num_clusters);
+    std::vector<std::atomic<uint32_t>> min_ids(m_num_clusters);
+    util::forLoopWrapper(0, m_num_clusters, [&](size_t begin, size_t end) {
+        for (size_t label = begin; label < end; ++label)
+        {
+            counts[label].store(0, std::memory_order_relaxed);
+            min_ids[label].store(num_points, std::memory_order_relaxed);
+        }
+    });
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const size_t label = dense_label[roots[i]];
+            const auto point = static_cast<uint32_t>(i);
+            counts[label].fetch_add(1, std::memory_order_relaxed);
+            uint32_t expected = min_ids[label].load(std::memory_order_relaxed);
+            while (point < expected
+                   && !min_ids[label].compare_exchange_weak(expected, point, std::memory_order_relaxed))
+            {}
+        }
+    });
+    std::vector<uint32_t> cluster_label_count(m_num_clusters);
+    std::vector<uint32_t> cluster_min_id(m_num_clusters);
+    util::forLoopWrapper(0, m_num_clusters, [&](size_t begin, size_t end) {
+        for (size_t label = begin; label < end; ++label)
+        {
+            cluster_label_count[label] = counts[label].load(std::memory_order_relaxed);
+            cluster_min_id[label] = min_ids[label].load(std::memory_order_relaxed);
+        }
+    });
 
     // Get a permutation that reorders clusters, largest to smallest.
-    std::vector<size_t> cluster_reindex = sort_indexes_inverse(cluster_label_count, cluster_min_id);
+    std::vector<uint32_t> cluster_reindex = sort_indexes_inverse(cluster_label_count, cluster_min_id);
+
+    // Write the final ids in parallel using the flattened roots.
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_cluster_idx[i] = cluster_reindex[dense_label[roots[i]]];
+        }
+    });
 
     // Clear the cluster keys
     m_cluster_keys = std::vector<std::vector<unsigned int>>(m_num_clusters, std::vector<unsigned int>());
 
-    /* Loop over all points, set their cluster ids and add them to a list of
-     * sets. Each set contains all the keys that are part of that cluster. If
-     * no keys are provided, the keys use point ids. Get the computed list
-     * with getClusterKeys().
+    /* Loop over all points and add them to a list of sets. Each set contains
+     * all the keys that are part of that cluster. If no keys are provided,
+     * the keys use point ids. Get the computed list with getClusterKeys().
+     * The key lists are in ascending point order, so this pass stays serial;
+     * the exact reservations keep it down to one memory-bound sweep.
      */
+    for (size_t label = 0; label < m_num_clusters; ++label)
+    {
+        m_cluster_keys[cluster_reindex[label]].reserve(cluster_label_count[label]);
+    }
     for (size_t i = 0; i < num_points; i++)
     {
-        size_t s = dj.find(i);
-        size_t cluster_idx = cluster_reindex[cluster_label[s]];
-        m_cluster_idx[i] = cluster_idx;
         unsigned int key = i;
         if (keys != nullptr)
         {
             key = keys[i];
         }
-        m_cluster_keys[cluster_idx].push_back(key);
+        m_cluster_keys[m_cluster_idx[i]].push_back(key);
+    }
+
+    // Accumulate the multi-frame statistics: this frame's cluster sizes are
+    // added to the running size histogram and its largest cluster appended
+    // to the per-frame series. Both persist across compute calls until
+    // reset() so that trajectory-wide distributions never need the
+    // per-point ids to leave C++.
+    size_t largest_size = 0;
+    for (size_t label = 0; label < m_num_clusters; ++label)
+    {
+        largest_size = std::max(largest_size, size_t(cluster_label_count[label]));
     }
+    if (m_cluster_size_histogram.size() <= largest_size)
+    {
+        m_cluster_size_histogram.resize(largest_size + 1);
+    }
+    for (size_t label = 0; label < m_num_clusters; ++label)
+    {
+        m_cluster_size_histogram[cluster_label_count[label]]++;
+    }
+    m_largest_cluster_sizes.push_back(static_cast<unsigned int>(largest_size));
+}
+
+void Cluster::computeAsync(const freud::locality::NeighborQuery* nq,
+                           const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs,
+                           const unsigned int* keys)
+{
+    m_async.launch([this, nq, nlist, qargs, keys]() { compute(nq, nlist, qargs, keys); });
+}
+
+void Cluster::reset()
+{
+    m_async.wait();
+    m_cluster_size_histogram.clear();
+    m_largest_cluster_sizes.clear();
 }
 
 // Returns inverse permutation of cluster indexes, sorted from largest to smallest.
 // Adapted from https://stackoverflow.com/questions/1577475/c-sorting-and-keeping-track-of-indexes
-std::vector<size_t> Cluster::sort_indexes_inverse(const std::vector<size_t>& counts,
-                                                  const std::vector<size_t>& min_ids)
+std::vector<uint32_t> Cluster::sort_indexes_inverse(const std::vector<uint32_t>& counts,
+                                                    const std::vector<uint32_t>& min_ids)
 {
     // Initialize original index locations.
-    std::vector<size_t> idx(counts.size());
+    std::vector<uint32_t> idx(counts.size());
     std::iota(idx.begin(), idx.end(), 0);
 
     // Sort indexes based on comparing values in counts, min_ids.
-    std::sort(idx.begin(), idx.end(), [&counts, &min_ids](size_t i1, size_t i2) {
+    std::sort(idx.begin(), idx.end(), [&counts, &min_ids](uint32_t i1, uint32_t i2) {
         if (counts[i1] != counts[i2])
         {
             // If the counts are unequal, return the largest cluster first.
@@ -112,10 +227,10 @@ std::vector<size_t> Cluster::sort_indexes_inverse(const std::vector<size_t>& cou
     });
 
     // Invert the permutation.
-    std::vector<size_t> inv_idx(idx.size());
+    std::vector<uint32_t> inv_idx(idx.size());
     for (size_t i = 0; i < idx.size(); i++)
     {
-        inv_idx[idx[i]] = i;
+        inv_idx[idx[i]] = static_cast<uint32_t>(i);
     }
     return inv_idx;
 }
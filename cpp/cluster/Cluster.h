@@ -4,12 +4,14 @@
 #ifndef CLUSTER_H
 #define CLUSTER_H
 
+#include <cstdint>
 #include <vector>
 
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
 #include "VectorMath.h"
+#include "async_dispatch.h"
 
 /*! \file Cluster.h
     \brief Routines for clustering points.
@@ -47,21 +49,63 @@ public:
     void compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
                  freud::locality::QueryArgs qargs, const unsigned int* keys = nullptr);
 
+    //! Compute the point clusters asynchronously in the shared compute arena.
+    /*! Returns immediately; every getter blocks until the compute completes,
+     *  so results may be requested at any time. The caller must keep nq,
+     *  nlist, and keys alive until then — typically until the next getter
+     *  call or synchronize().
+     */
+    void computeAsync(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
+                      freud::locality::QueryArgs qargs, const unsigned int* keys = nullptr);
+
+    //! Block until any asynchronously enqueued compute has finished.
+    void synchronize() const
+    {
+        m_async.wait();
+    }
+
+    //! Reset the accumulated multi-frame cluster statistics.
+    void reset();
+
     //! Get the total number of clusters.
     unsigned int getNumClusters() const
     {
+        m_async.wait();
         return m_num_clusters;
     }
 
+    //! Get the histogram of cluster sizes accumulated over frames.
+    /*! Entry s counts how many clusters of size s were found across all
+     *  calls to compute since the last reset, so trajectory-wide size
+     *  distributions can be tallied without shipping the per-point cluster
+     *  ids out of C++ every frame.
+     */
+    const std::vector<size_t>& getClusterSizeHistogram() const
+    {
+        m_async.wait();
+        return m_cluster_size_histogram;
+    }
+
+    //! Get the largest cluster size found in each frame.
+    /*! One entry per call to compute since the last reset, in call order.
+     */
+    const std::vector<unsigned int>& getLargestClusterSizes() const
+    {
+        m_async.wait();
+        return m_largest_cluster_sizes;
+    }
+
     //! Get a reference to the cluster ids.
     const util::ManagedArray<unsigned int>& getClusterIdx() const
     {
+        m_async.wait();
         return m_cluster_idx;
     }
 
     //! Get a reference to the cluster keys.
     const std::vector<std::vector<unsigned int>>& getClusterKeys() const
     {
+        m_async.wait();
         return m_cluster_keys;
     }
 
@@ -69,12 +113,21 @@ private:
     unsigned int m_num_clusters;                           //!< Number of clusters found
     util::ManagedArray<unsigned int> m_cluster_idx;        //!< Cluster index for each point
     std::vector<std::vector<unsigned int>> m_cluster_keys; //!< List of keys in each cluster
+    std::vector<size_t> m_cluster_size_histogram; //!< Cluster counts by size, accumulated over frames
+    std::vector<unsigned int> m_largest_cluster_sizes; //!< Largest cluster size found in each frame
+
+    //! Completion of an asynchronously enqueued compute; mutable so that
+    //! const getters can synchronize.
+    mutable parallel::AsyncHandle m_async;
 
     // Returns inverse permutation of cluster indices, sorted from largest to
     // smallest. Adapted from
     // https://stackoverflow.com/questions/1577475/c-sorting-and-keeping-track-of-indexes
-    static std::vector<size_t> sort_indexes_inverse(const std::vector<size_t>& counts,
-                                                    const std::vector<size_t>& min_ids);
+    // Indices are 32-bit like all point and cluster ids in freud (which caps
+    // systems at 2^32 points); the narrower tables halve the memory traffic
+    // of the per-point relabeling passes.
+    static std::vector<uint32_t> sort_indexes_inverse(const std::vector<uint32_t>& counts,
+                                                      const std::vector<uint32_t>& min_ids);
 };
 
 }; }; // end namespace freud::cluster
@@ -1,10 +1,12 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
-#include <vector>
+#include <algorithm>
+#include <complex>
 
 #include "ClusterProperties.h"
-#include "NeighborComputeFunctional.h"
+#include "ThreadStorage.h"
+#include "utils.h"
 
 /*! \file ClusterProperties.cc
     \brief Routines for computing properties of point clusters.
@@ -19,6 +21,13 @@ namespace freud { namespace cluster {
     of mass of the cluster as well as the gyration tensor. These can be
     accessed after the call to compute with getClusterCenters() and
     getClusterGyrations().
+
+    Both moments are accumulated in thread-local per-cluster buffers that are
+    reduced per cluster afterwards, so no per-cluster point lists are built.
+    The gyration tensor needs a second pass over the points: the center of a
+    cluster under periodic boundary conditions is the circular mean of its
+    member positions, and the wrapped displacement of each member is only
+    defined once that mean is known.
 */
 
 void ClusterProperties::compute(const freud::locality::NeighborQuery* nq, const unsigned int* cluster_idx)
@@ -33,60 +42,96 @@ void ClusterProperties::compute(const freud::locality::NeighborQuery* nq, const
     m_cluster_gyrations.prepare({num_clusters, 3, 3});
     m_cluster_sizes.prepare(num_clusters);
 
-    // Create a vector to store cluster points, used to compute center of mass
-    std::vector<std::vector<vec3<float>>> cluster_points(num_clusters, std::vector<vec3<float>>());
-
-    // Start by determining the center of mass of each cluster. Since we are
-    // given an array of points, the easiest way to do this is to loop over
-    // all points and add the appropriate information to m_cluster_centers as
-    // we go.
-    for (unsigned int i = 0; i < nq->getNPoints(); i++)
-    {
-        const unsigned int c = cluster_idx[i];
-        cluster_points[c].push_back((*nq)[i]);
-        m_cluster_sizes[c]++;
-    }
-
-    // Now that we have located all of the cluster vectors, compute the centers
-    for (unsigned int c = 0; c < num_clusters; c++)
-    {
-        m_cluster_centers[c] = nq->getBox().centerOfMass(cluster_points[c].data(), m_cluster_sizes[c]);
-    }
+    const box::Box& box = nq->getBox();
+
+    // Accumulate the cluster sizes and the per-dimension phase factors of
+    // every member position; the center of mass of each cluster is the
+    // circular mean of those phases, following Box::centerOfMass.
+    util::ThreadStorage<unsigned int> local_sizes(num_clusters);
+    util::ThreadStorage<std::complex<float>> local_phases({num_clusters, 3});
+    util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
+        auto& sizes = local_sizes.local();
+        auto& phases = local_phases.local();
+        for (size_t i = begin; i < end; i++)
+        {
+            const unsigned int c = cluster_idx[i];
+            sizes[c]++;
+            const vec3<float> phase(constants::TWO_PI * box.makeFractional((*nq)[i]));
+            phases(c, 0) += std::polar(float(1.0), phase.x);
+            phases(c, 1) += std::polar(float(1.0), phase.y);
+            phases(c, 2) += std::polar(float(1.0), phase.z);
+        }
+    });
+
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++)
+        {
+            unsigned int size(0);
+            vec3<std::complex<float>> xi_mean;
+            for (auto it = local_sizes.begin(); it != local_sizes.end(); ++it)
+            {
+                size += (*it)[c];
+            }
+            for (auto it = local_phases.begin(); it != local_phases.end(); ++it)
+            {
+                xi_mean.x += (*it)(c, 0);
+                xi_mean.y += (*it)(c, 1);
+                xi_mean.z += (*it)(c, 2);
+            }
+            xi_mean /= std::complex<float>(static_cast<float>(size), 0);
+            m_cluster_sizes[c] = size;
+            m_cluster_centers[c] = box.wrap(
+                box.makeAbsolute(vec3<float>(std::arg(xi_mean.x), std::arg(xi_mean.y), std::arg(xi_mean.z))
+                                 / constants::TWO_PI));
+        }
+    });
 
     // Now that we have determined the centers of mass for each cluster, tally
-    // up the gyration tensor. This has to be done in a loop over the points.
-    for (unsigned int i = 0; i < nq->getNPoints(); i++)
-    {
-        unsigned int c = cluster_idx[i];
-        vec3<float> pos = (*nq)[i];
-        vec3<float> delta = nq->getBox().wrap(pos - m_cluster_centers[c]);
-
-        // get the start pointer for our 3x3 matrix
-        m_cluster_gyrations(c, 0, 0) += delta.x * delta.x;
-        m_cluster_gyrations(c, 0, 1) += delta.x * delta.y;
-        m_cluster_gyrations(c, 0, 2) += delta.x * delta.z;
-        m_cluster_gyrations(c, 1, 0) += delta.y * delta.x;
-        m_cluster_gyrations(c, 1, 1) += delta.y * delta.y;
-        m_cluster_gyrations(c, 1, 2) += delta.y * delta.z;
-        m_cluster_gyrations(c, 2, 0) += delta.z * delta.x;
-        m_cluster_gyrations(c, 2, 1) += delta.z * delta.y;
-        m_cluster_gyrations(c, 2, 2) += delta.z * delta.z;
-    }
-
-    // Normalize by the cluster size.
-    for (unsigned int c = 0; c < num_clusters; c++)
-    {
-        auto s = static_cast<float>(m_cluster_sizes[c]);
-        m_cluster_gyrations(c, 0, 0) /= s;
-        m_cluster_gyrations(c, 0, 1) /= s;
-        m_cluster_gyrations(c, 0, 2) /= s;
-        m_cluster_gyrations(c, 1, 0) /= s;
-        m_cluster_gyrations(c, 1, 1) /= s;
-        m_cluster_gyrations(c, 1, 2) /= s;
-        m_cluster_gyrations(c, 2, 0) /= s;
-        m_cluster_gyrations(c, 2, 1) /= s;
-        m_cluster_gyrations(c, 2, 2) /= s;
-    }
+    // up the gyration tensor from the wrapped displacements. Only the six
+    // unique entries of the symmetric tensor are accumulated.
+    util::ThreadStorage<float> local_gyrations({num_clusters, 6});
+    util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
+        auto& gyrations = local_gyrations.local();
+        for (size_t i = begin; i < end; i++)
+        {
+            const unsigned int c = cluster_idx[i];
+            const vec3<float> pos = (*nq)[i];
+            const vec3<float> delta = box.wrap(pos - m_cluster_centers[c]);
+
+            gyrations(c, 0) += delta.x * delta.x;
+            gyrations(c, 1) += delta.x * delta.y;
+            gyrations(c, 2) += delta.x * delta.z;
+            gyrations(c, 3) += delta.y * delta.y;
+            gyrations(c, 4) += delta.y * delta.z;
+            gyrations(c, 5) += delta.z * delta.z;
+        }
+    });
+
+    // Reduce over the threads, normalize by the cluster size, and mirror the
+    // unique entries into the full tensor.
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++)
+        {
+            float unique[6] = {0, 0, 0, 0, 0, 0};
+            for (auto it = local_gyrations.begin(); it != local_gyrations.end(); ++it)
+            {
+                for (unsigned int k = 0; k < 6; k++)
+                {
+                    unique[k] += (*it)(c, k);
+                }
+            }
+            const auto s = static_cast<float>(m_cluster_sizes[c]);
+            m_cluster_gyrations(c, 0, 0) = unique[0] / s;
+            m_cluster_gyrations(c, 0, 1) = unique[1] / s;
+            m_cluster_gyrations(c, 0, 2) = unique[2] / s;
+            m_cluster_gyrations(c, 1, 0) = unique[1] / s;
+            m_cluster_gyrations(c, 1, 1) = unique[3] / s;
+            m_cluster_gyrations(c, 1, 2) = unique[4] / s;
+            m_cluster_gyrations(c, 2, 0) = unique[2] / s;
+            m_cluster_gyrations(c, 2, 1) = unique[4] / s;
+            m_cluster_gyrations(c, 2, 2) = unique[5] / s;
+        }
+    });
 }
 
 }; }; // end namespace freud::cluster
@@ -1,11 +1,15 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <complex>
 #include <stdexcept>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
 #include "CorrelationFunction.h"
 #include "NeighborBond.h"
@@ -40,6 +44,29 @@ CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max) : Bo
     m_local_correlation_function = CFThreadHistogram(m_correlation_function);
 }
 
+template<typename T>
+CorrelationFunction<T>::CorrelationFunction(const std::vector<float>& bin_edges) : BondHistogramCompute()
+{
+    if (bin_edges.size() < 2)
+    {
+        throw std::invalid_argument("CorrelationFunction requires at least two bin edges.");
+    }
+    if (bin_edges.front() < 0)
+    {
+        throw std::invalid_argument("CorrelationFunction requires that bin edges be non-negative.");
+    }
+
+    // The lookup table axis handles arbitrary strictly increasing spacings
+    // (validated in its constructor) at the same per-bond cost as a regular
+    // axis. Both histograms share the axes as in the regular constructor.
+    const auto axes = util::Axes {std::make_shared<util::LookupTableAxis>(bin_edges)};
+    m_histogram = util::Histogram<unsigned int>(axes);
+    m_local_histograms = util::Histogram<unsigned int>::ThreadLocalHistogram(m_histogram);
+
+    m_correlation_function = util::Histogram<T>(axes);
+    m_local_correlation_function = CFThreadHistogram(m_correlation_function);
+}
+
 //! \internal
 //! helper function to reduce the thread specific arrays into one array
 template<typename T> void CorrelationFunction<T>::reduce()
@@ -65,6 +92,10 @@ template<typename T> void CorrelationFunction<T>::reset()
     // Zero the correlation function in addition to the bin counts that are
     // reset by the parent.
     m_local_correlation_function.reset();
+    for (auto& partial : m_partials)
+    {
+        partial->reset();
+    }
 }
 
 // Define an overloaded pair of product functions to deal with complex conjugation if necessary.
@@ -78,6 +109,172 @@ inline double product(double x, double y)
     return x * y;
 }
 
+namespace {
+//! Number of bonds staged per scratch block in the fused neighbor list path.
+constexpr size_t BLOCK_SIZE = 256;
+
+//! Bin a staged block of bond distances, marking out-of-range lanes with -1.
+/*! Mirrors RegularAxis::bin() for an axis starting at zero (same inverse bin
+ * width and truncation); the top-edge clamp is applied by the caller at
+ * scatter time so that a lane can be rejected and clamped from the same
+ * integer result.
+ */
+inline void binDistanceBlock(const float* distances, size_t count, float r_max, float inverse_bin_width,
+                             int* bins)
+{
+    size_t i = 0;
+#if defined(__AVX__)
+    const __m256 vzero = _mm256_setzero_ps();
+    const __m256 vmax = _mm256_set1_ps(r_max);
+    const __m256 vinv = _mm256_set1_ps(inverse_bin_width);
+    const __m256 vsentinel = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 d = _mm256_loadu_ps(distances + i);
+        const __m256 in_range
+            = _mm256_and_ps(_mm256_cmp_ps(d, vzero, _CMP_GE_OQ), _mm256_cmp_ps(d, vmax, _CMP_LT_OQ));
+        const __m256 binsf = _mm256_castsi256_ps(_mm256_cvttps_epi32(_mm256_mul_ps(d, vinv)));
+        _mm256_storeu_ps(reinterpret_cast<float*>(bins + i), _mm256_blendv_ps(vsentinel, binsf, in_range));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const float d = distances[i];
+        bins[i] = (d >= 0 && d < r_max) ? int(d * inverse_bin_width) : -1;
+    }
+}
+
+//! Multiply conj(x) * y over split re/im scratch arrays.
+inline void productBlock(const double* xr, const double* xi, const double* yr, const double* yi, double* pr,
+                         double* pi, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d a = _mm256_load_pd(xr + i);
+        const __m256d b = _mm256_load_pd(xi + i);
+        const __m256d c = _mm256_load_pd(yr + i);
+        const __m256d d = _mm256_load_pd(yi + i);
+        _mm256_store_pd(pr + i, _mm256_add_pd(_mm256_mul_pd(a, c), _mm256_mul_pd(b, d)));
+        _mm256_store_pd(pi + i, _mm256_sub_pd(_mm256_mul_pd(a, d), _mm256_mul_pd(b, c)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        pr[i] = xr[i] * yr[i] + xi[i] * yi[i];
+        pi[i] = xr[i] * yi[i] - xi[i] * yr[i];
+    }
+}
+
+//! Multiply x * y over scratch arrays.
+inline void productBlock(const double* x, const double* y, double* p, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm256_store_pd(p + i, _mm256_mul_pd(_mm256_load_pd(x + i), _mm256_load_pd(y + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        p[i] = x[i] * y[i];
+    }
+}
+
+//! Accumulate a range of neighbor list bonds into thread local histograms (complex values).
+/*! Each block of bonds is staged into split re/im scratch so the conjugated
+ * products run in SIMD, distances are binned with the fused index kernel,
+ * and the results are scattered serially per lane (increments to arbitrary
+ * bins cannot be vectorized without conflict detection).
+ */
+inline void accumulateProductBlocks(const std::complex<double>* values,
+                                    const std::complex<double>* query_values, const unsigned int* neighbors,
+                                    const float* distances, size_t begin, size_t end, float r_max,
+                                    float inverse_bin_width, size_t nbins,
+                                    util::Histogram<unsigned int>& counts,
+                                    util::Histogram<std::complex<double>>& correlation)
+{
+    alignas(32) double xr[BLOCK_SIZE];
+    alignas(32) double xi[BLOCK_SIZE];
+    alignas(32) double yr[BLOCK_SIZE];
+    alignas(32) double yi[BLOCK_SIZE];
+    alignas(32) double pr[BLOCK_SIZE];
+    alignas(32) double pi[BLOCK_SIZE];
+    alignas(32) int bins[BLOCK_SIZE];
+    for (size_t start = begin; start < end; start += BLOCK_SIZE)
+    {
+        const size_t count = std::min(BLOCK_SIZE, end - start);
+        for (size_t c = 0; c < count; ++c)
+        {
+            const std::complex<double>& x = values[neighbors[2 * (start + c) + 1]];
+            const std::complex<double>& y = query_values[neighbors[2 * (start + c)]];
+            xr[c] = x.real();
+            xi[c] = x.imag();
+            yr[c] = y.real();
+            yi[c] = y.imag();
+        }
+        productBlock(xr, xi, yr, yi, pr, pi, count);
+        binDistanceBlock(distances + start, count, r_max, inverse_bin_width, bins);
+        for (size_t c = 0; c < count; ++c)
+        {
+            if (bins[c] < 0)
+            {
+                continue;
+            }
+            size_t bin_i = bins[c];
+            // Avoid rounding leading to overflow.
+            if (bin_i == nbins)
+            {
+                --bin_i;
+            }
+            counts.increment(bin_i);
+            correlation.increment(bin_i, std::complex<double>(pr[c], pi[c]));
+        }
+    }
+}
+
+//! Accumulate a range of neighbor list bonds into thread local histograms (real values).
+inline void accumulateProductBlocks(const double* values, const double* query_values,
+                                    const unsigned int* neighbors, const float* distances, size_t begin,
+                                    size_t end, float r_max, float inverse_bin_width, size_t nbins,
+                                    util::Histogram<unsigned int>& counts,
+                                    util::Histogram<double>& correlation)
+{
+    alignas(32) double x[BLOCK_SIZE];
+    alignas(32) double y[BLOCK_SIZE];
+    alignas(32) double p[BLOCK_SIZE];
+    alignas(32) int bins[BLOCK_SIZE];
+    for (size_t start = begin; start < end; start += BLOCK_SIZE)
+    {
+        const size_t count = std::min(BLOCK_SIZE, end - start);
+        for (size_t c = 0; c < count; ++c)
+        {
+            x[c] = values[neighbors[2 * (start + c) + 1]];
+            y[c] = query_values[neighbors[2 * (start + c)]];
+        }
+        productBlock(x, y, p, count);
+        binDistanceBlock(distances + start, count, r_max, inverse_bin_width, bins);
+        for (size_t c = 0; c < count; ++c)
+        {
+            if (bins[c] < 0)
+            {
+                continue;
+            }
+            size_t bin_i = bins[c];
+            // Avoid rounding leading to overflow.
+            if (bin_i == nbins)
+            {
+                --bin_i;
+            }
+            counts.increment(bin_i);
+            correlation.increment(bin_i, p[c]);
+        }
+    }
+}
+}; // namespace
+
 template<typename T>
 void CorrelationFunction<T>::accumulate(const freud::locality::NeighborQuery* neighbor_query, const T* values,
                                         const vec3<float>* query_points, const T* query_values,
@@ -85,15 +282,121 @@ void CorrelationFunction<T>::accumulate(const freud::locality::NeighborQuery* ne
                                         const freud::locality::NeighborList* nlist,
                                         freud::locality::QueryArgs qargs)
 {
-    accumulateGeneral(
-        neighbor_query, query_points, n_query_points, nlist, qargs,
-        [&](const freud::locality::NeighborBond& neighbor_bond) {
-            size_t value_bin = m_histogram.bin({neighbor_bond.distance});
-            m_local_histograms.increment(value_bin);
-            m_local_correlation_function.increment(
-                value_bin,
-                product(values[neighbor_bond.point_idx], query_values[neighbor_bond.query_point_idx]));
-        });
+    if (nlist != nullptr)
+    {
+        // An explicit neighbor list stores its bond indices and distances as
+        // contiguous blocks, so bypass the per-bond NeighborBond plumbing and
+        // run the blocked SIMD kernel over chunks of the list, each chunk
+        // scattering into the executing thread's local histograms.
+        m_box = neighbor_query->getBox();
+        const float* distances = nlist->getDistances().get();
+        const unsigned int* neighbors = nlist->getNeighbors().get();
+        const auto* axis = dynamic_cast<const util::RegularAxis*>(m_histogram.getAxes()[0].get());
+        if (axis != nullptr)
+        {
+            const float r_max = axis->getMax();
+            const float inverse_bin_width = axis->getInverseBinWidth();
+            const size_t nbins = axis->size();
+            util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+                accumulateProductBlocks(values, query_values, neighbors, distances, begin, end, r_max,
+                                        inverse_bin_width, nbins, m_local_histograms.local(),
+                                        m_local_correlation_function.local());
+            });
+        }
+        else
+        {
+            // Nonuniform axes bin each bond through their constant-time
+            // lookup table instead of the fused kernel.
+            util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+                auto& counts = m_local_histograms.local();
+                auto& correlation = m_local_correlation_function.local();
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const size_t value_bin = m_histogram.bin({distances[i]});
+                    counts.increment(value_bin);
+                    correlation.increment(
+                        value_bin, product(values[neighbors[2 * i + 1]], query_values[neighbors[2 * i]]));
+                }
+            });
+        }
+        m_frame_counter++;
+        m_n_points = neighbor_query->getNPoints();
+        m_n_query_points = n_query_points;
+        m_reduce = true;
+    }
+    else
+    {
+        accumulateGeneral(
+            neighbor_query, query_points, n_query_points, nlist, qargs,
+            [&](const freud::locality::NeighborBond& neighbor_bond) {
+                size_t value_bin = m_histogram.bin({neighbor_bond.distance});
+                m_local_histograms.increment(value_bin);
+                m_local_correlation_function.increment(
+                    value_bin,
+                    product(values[neighbor_bond.point_idx], query_values[neighbor_bond.query_point_idx]));
+            });
+    }
+}
+
+template<typename T>
+void CorrelationFunction<T>::accumulate(const freud::locality::NeighborQuery* neighbor_query,
+                                        const T* values, const vec3<float>* query_points,
+                                        const T* query_values, unsigned int n_query_points,
+                                        const freud::locality::NeighborList* nlist,
+                                        freud::locality::QueryArgs qargs,
+                                        const unsigned int* query_point_types,
+                                        const unsigned int* point_types, unsigned int n_types)
+{
+    if (n_types == 0)
+    {
+        throw std::invalid_argument("Partial correlation functions require a nonzero number of types.");
+    }
+
+    if (m_partials.empty())
+    {
+        // Construct one partial per unordered type pair with this object's
+        // binning; each accumulates and reduces independently.
+        m_n_types = n_types;
+        const auto r_max = m_histogram.getBinEdges()[0].back();
+        const auto bins = static_cast<unsigned int>(getAxisSizes()[0]);
+        const auto n_pairs = size_t(n_types) * (n_types + 1) / 2;
+        for (size_t i = 0; i < n_pairs; i++)
+        {
+            m_partials.push_back(std::unique_ptr<CorrelationFunction<T>>(
+                new CorrelationFunction<T>(bins, r_max)));
+        }
+    }
+    else if (m_n_types != n_types)
+    {
+        throw std::invalid_argument("The number of types passed to CorrelationFunction has changed. "
+                                    "Call reset to start a new accumulation.");
+    }
+
+    // One traversal scatters each bond's product into the total correlation
+    // function and into its unordered type pair's. The per-bond path is used
+    // even with an explicit neighbor list because the pair assignment needs
+    // each bond's endpoint indices.
+    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                      [&](const freud::locality::NeighborBond& neighbor_bond) {
+                          const size_t value_bin = m_histogram.bin({neighbor_bond.distance});
+                          const T bond_product = product(values[neighbor_bond.point_idx],
+                                                         query_values[neighbor_bond.query_point_idx]);
+                          m_local_histograms.increment(value_bin);
+                          m_local_correlation_function.increment(value_bin, bond_product);
+                          auto& partial
+                              = *m_partials[pairIndex(query_point_types[neighbor_bond.query_point_idx],
+                                                      point_types[neighbor_bond.point_idx], n_types)];
+                          partial.m_local_histograms.increment(value_bin);
+                          partial.m_local_correlation_function.increment(value_bin, bond_product);
+                      });
+    for (auto& partial : m_partials)
+    {
+        partial->m_box = m_box;
+        partial->m_frame_counter = m_frame_counter;
+        partial->m_n_points = m_n_points;
+        partial->m_n_query_points = m_n_query_points;
+        partial->m_reduce = true;
+    }
 }
 
 template class CorrelationFunction<std::complex<double>>;
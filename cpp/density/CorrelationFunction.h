@@ -11,6 +11,10 @@
 #include "NeighborList.h"
 #include "NeighborQuery.h"
 #include "VectorMath.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 /*! \file CorrelationFunction.h
     \brief Generic pairwise correlation functions.
@@ -49,6 +53,14 @@ public:
     //! Constructor
     CorrelationFunction(unsigned int bins, float r_max);
 
+    //! Constructor from explicit bin edges.
+    /*! Accepts arbitrarily (e.g. logarithmically) spaced, strictly increasing
+     * edges; binning runs through the constant-time lookup table of
+     * util::LookupTableAxis, so nonuniform bins cost the same per bond as
+     * linear ones.
+     */
+    explicit CorrelationFunction(const std::vector<float>& bin_edges);
+
     //! Destructor
     ~CorrelationFunction() override = default;
 
@@ -60,6 +72,37 @@ public:
                     const vec3<float>* query_points, const T* query_values, unsigned int n_query_points,
                     const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
 
+    //! Accumulate the total and all per-type-pair correlation functions in one pass.
+    /*! Each bond's value product is accumulated into the total correlation
+     * function and into the correlation function of the unordered pair of its
+     * endpoints' types, so one neighbor traversal produces every species
+     * pair's <p*q>(r) instead of one traversal per pair. The number of types
+     * must not change between accumulated frames.
+     * \param query_point_types Per-query-point type ids in [0, n_types).
+     * \param point_types Per-point type ids in [0, n_types).
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const T* values,
+                    const vec3<float>* query_points, const T* query_values, unsigned int n_query_points,
+                    const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs,
+                    const unsigned int* query_point_types, const unsigned int* point_types,
+                    unsigned int n_types);
+
+    //! Get the number of types used for partial correlation functions.
+    unsigned int getNumTypes() const
+    {
+        return m_n_types;
+    }
+
+    //! Get the last computed partial correlation function for the type pair (a, b).
+    const util::ManagedArray<T>& getPartialCorrelation(unsigned int type_a, unsigned int type_b)
+    {
+        if (type_a >= m_n_types || type_b >= m_n_types)
+        {
+            throw std::out_of_range("Type index exceeds the number of accumulated types.");
+        }
+        return m_partials[pairIndex(type_a, type_b, m_n_types)]->getCorrelation();
+    }
+
     //! \internal
     //! helper function to reduce the thread specific arrays into one array
     void reduce() override;
@@ -74,8 +117,18 @@ private:
     // Typedef thread local histogram type for use in code.
     using CFThreadHistogram = typename util::Histogram<T>::ThreadLocalHistogram;
 
+    //! Linear index of the unordered type pair (a, b) among all pairs.
+    static size_t pairIndex(unsigned int type_a, unsigned int type_b, unsigned int n_types)
+    {
+        const size_t a = std::min(type_a, type_b);
+        const size_t b = std::max(type_a, type_b);
+        return a * n_types - a * (a - 1) / 2 + (b - a);
+    }
+
     util::Histogram<T> m_correlation_function;      //!< The correlation function
     CFThreadHistogram m_local_correlation_function; //!< Thread local copy of the correlation function
+    unsigned int m_n_types {0}; //!< Number of types for partial correlation functions.
+    std::vector<std::unique_ptr<CorrelationFunction<T>>> m_partials; //!< Per-type-pair partials.
 };
 
 }; }; // end namespace freud::density
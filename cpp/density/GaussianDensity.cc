@@ -1,8 +1,10 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "GaussianDensity.h"
 
@@ -12,19 +14,82 @@
 
 namespace freud { namespace density {
 
-GaussianDensity::GaussianDensity(vec3<unsigned int> width, float r_max, float sigma)
-    : m_box(), m_width(width), m_r_max(r_max), m_sigma(sigma), m_has_computed(false)
+GaussianDensity::GaussianDensity(vec3<unsigned int> width, float r_max, float sigma, bool separable,
+                                 float incremental_tolerance)
+    : m_box(), m_width(width), m_r_max(r_max), m_sigma(sigma), m_separable(separable),
+      m_incremental_tolerance(incremental_tolerance), m_has_computed(false)
 {
     if (r_max <= 0)
     {
         throw std::invalid_argument("GaussianDensity requires r_max to be positive.");
     }
+    if (incremental_tolerance < 0)
+    {
+        throw std::invalid_argument("GaussianDensity requires incremental_tolerance to be non-negative.");
+    }
+}
+
+namespace {
+//! Convolve a 3D grid with a 1D kernel along one axis.
+/*! The grid is treated as a flat array; for a cell at linear index m, its
+ *  coordinate along the convolved axis is (m / stride) % length. Periodic
+ *  axes wrap their samples, aperiodic axes treat cells outside the grid as
+ *  zero (matching the scatter engine, which rejects out-of-box bins).
+ */
+void convolveAxis(const float* in, float* out, size_t total, size_t length, size_t stride,
+                  const std::vector<float>& taps, bool periodic)
+{
+    const int cut = (static_cast<int>(taps.size()) - 1) / 2;
+    const int ilength = static_cast<int>(length);
+    util::forLoopWrapper(0, total, [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; ++m)
+        {
+            const int a = static_cast<int>((m / stride) % length);
+            const size_t base = m - static_cast<size_t>(a) * stride;
+            float acc(0);
+            for (int d = -cut; d <= cut; d++)
+            {
+                int s = a + d;
+                if (periodic)
+                {
+                    s = ((s % ilength) + ilength) % ilength;
+                }
+                else if (s < 0 || s >= ilength)
+                {
+                    continue;
+                }
+                acc += taps[cut + d] * in[base + static_cast<size_t>(s) * stride];
+            }
+            out[m] = acc;
+        }
+    });
+}
+
+//! Build the truncated, normalized 1D Gaussian taps for one axis.
+std::vector<float> makeTaps(int cut, float grid_size, float sigmasq, float normalization_base)
+{
+    std::vector<float> taps(2 * cut + 1);
+    for (int d = -cut; d <= cut; d++)
+    {
+        const float x = grid_size * static_cast<float>(d);
+        taps[cut + d] = normalization_base * std::exp(-x * x / (float(2.0) * sigmasq));
+    }
+    return taps;
 }
+}; // namespace
 
 //! Get a reference to the last computed Density
-const util::ManagedArray<float>& GaussianDensity::getDensity() const
+const util::ManagedArray<float>& GaussianDensity::getDensity()
 {
-    return m_density_array;
+    return reduceAndReturn(m_density_array);
+}
+
+void GaussianDensity::reset()
+{
+    m_frame_counter = 0;
+    m_reduce = true;
+    m_prev_points.clear();
+    m_prev_values.clear();
 }
 
 //! Get width.
@@ -35,6 +100,14 @@ vec3<unsigned int> GaussianDensity::getWidth()
 
 //! Compute the density array.
 void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const float* values)
+{
+    // A single-frame compute is an accumulation over a fresh average.
+    reset();
+    accumulate(nq, values);
+}
+
+//! Accumulate one frame into the running average.
+void GaussianDensity::accumulate(const freud::locality::NeighborQuery* nq, const float* values)
 {
     // set the number of dimensions for the calculation the first time it is done
     if (!m_has_computed || nq->getBox().is2D() == m_box.is2D())
@@ -49,8 +122,6 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
                                     "number of dimensions.");
     }
 
-    auto n_points = nq->getNPoints();
-
     // if the user gives a single number for width, but the nq box is 2D, and
     // we want a 2D calculation
     if (m_box.is2D())
@@ -58,8 +129,45 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
         m_width.z = 1;
     }
 
-    m_density_array.prepare({m_width.x, m_width.y, m_width.z});
-    util::ThreadStorage<float> local_bin_counts({m_width.x, m_width.y, m_width.z});
+    // The previous frame's grid can be updated in place only when something
+    // was deposited, the system is the same size, and the box (and with it
+    // the grid geometry) is unchanged.
+    const bool incremental = m_incremental_tolerance > 0 && !m_separable
+        && size_t(nq->getNPoints()) == m_prev_points.size() && nq->getBox() == m_prev_box;
+
+    if (m_separable)
+    {
+        computeSeparable(nq, values);
+    }
+    else
+    {
+        computeFrame(nq, values, incremental);
+    }
+
+    // Add this frame's grid to the running sum.
+    if (m_frame_counter == 0)
+    {
+        m_density_sum.prepare({m_width.x, m_width.y, m_width.z});
+    }
+    float* sum = m_density_sum.get();
+    const float* frame = m_frame_grid.get();
+    util::forLoopWrapper(0, m_density_sum.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            sum[i] += frame[i];
+        }
+    });
+    m_frame_counter++;
+    m_reduce = true;
+}
+
+//! Compute this frame's grid with the direct per-particle scatter.
+void GaussianDensity::computeFrame(const freud::locality::NeighborQuery* nq, const float* values,
+                                   bool incremental)
+{
+    auto n_points = nq->getNPoints();
+
+    m_local_bin_counts.resize({m_width.x, m_width.y, m_width.z});
 
     // set up some constants first
     const float Lx = m_box.getLx();
@@ -81,82 +189,274 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, const fl
     const float dimensions = m_box.is2D() ? float(2.0) : float(3.0);
     const float normalization = std::pow(normalization_base, dimensions);
 
-    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
-        // for each reference point
-        for (size_t idx = begin; idx < end; ++idx)
-        {
-            const vec3<float> point = (*nq)[idx];
-            const float value = (values != nullptr) ? values[idx] : 1.0f;
+    // Deposit one particle's truncated Gaussian stencil onto a grid. A
+    // negative value removes a previously deposited stencil.
+    auto deposit = [&](util::ManagedArray<float>& grid, const vec3<float>& point, float value) {
+        // Find which bin the particle is in
+        int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
+        int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
+        int bin_z = int((point.z + Lz / float(2.0)) / grid_size_z);
 
-            // Find which bin the particle is in
-            int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
-            int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
-            int bin_z = int((point.z + Lz / float(2.0)) / grid_size_z);
+        // In 2D, only loop over the z=0 plane
+        if (m_box.is2D())
+        {
+            bin_z = 0;
+        }
 
-            // In 2D, only loop over the z=0 plane
-            if (m_box.is2D())
+        // Reject bins that are outside the box in aperiodic directions
+        // Only evaluate over bins that are within the cutoff
+        for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+        {
+            if (!periodic.z && (k < 0 || k >= int(m_width.z)))
             {
-                bin_z = 0;
+                continue;
             }
+            const float dz = (grid_size_z * static_cast<float>(k)) + (grid_size_z / float(2.0)) - point.z
+                - (Lz / float(2.0));
 
-            // Reject bins that are outside the box in aperiodic directions
-            // Only evaluate over bins that are within the cutoff
-            for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+            for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
             {
-                if (!periodic.z && (k < 0 || k >= int(m_width.z)))
+                if (!periodic.y && (j < 0 || j >= int(m_width.y)))
                 {
                     continue;
                 }
-                const float dz = (grid_size_z * static_cast<float>(k)) + (grid_size_z / float(2.0)) - point.z
-                    - (Lz / float(2.0));
+                const float dy = (grid_size_y * static_cast<float>(j)) + (grid_size_y / float(2.0))
+                    - point.y - (Ly / float(2.0));
 
-                for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
+                for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
                 {
-                    if (!periodic.y && (j < 0 || j >= int(m_width.y)))
+                    if (!periodic.x && (i < 0 || i >= int(m_width.x)))
                     {
                         continue;
                     }
-                    const float dy = (grid_size_y * static_cast<float>(j)) + (grid_size_y / float(2.0))
-                        - point.y - (Ly / float(2.0));
+                    const float dx = (grid_size_x * static_cast<float>(i)) + (grid_size_x / float(2.0))
+                        - point.x - (Lx / float(2.0));
+
+                    // Calculate the distance from the particle to the grid cell
+                    const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
 
-                    for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
+                    const float r_sq = dot(delta, delta);
+
+                    // Check to see if this distance is within the specified r_max
+                    if (r_sq < r_max_sq)
                     {
-                        if (!periodic.x && (i < 0 || i >= int(m_width.x)))
-                        {
-                            continue;
-                        }
-                        const float dx = (grid_size_x * static_cast<float>(i)) + (grid_size_x / float(2.0))
-                            - point.x - (Lx / float(2.0));
+                        // Evaluate the gaussian
+                        const float gaussian
+                            = value * normalization * std::exp(-r_sq / (float(2.0) * sigmasq));
+
+                        // Assure that out of range indices are corrected for storage
+                        // in the array i.e. bin -1 is actually bin 29 for nbins = 30
+                        const unsigned int ni = (i + m_width.x) % m_width.x;
+                        const unsigned int nj = (j + m_width.y) % m_width.y;
+                        const unsigned int nk = (k + m_width.z) % m_width.z;
+
+                        // Store the gaussian contribution
+                        grid(ni, nj, nk) += gaussian;
+                    }
+                }
+            }
+        }
+    };
+
+    if (incremental)
+    {
+        // Collect the particles whose deposit is out of date.
+        const float tolerance_sq = m_incremental_tolerance * m_incremental_tolerance;
+        util::ThreadBufferPool<size_t> moved_pool;
+        util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+            auto& local_moved = moved_pool.local();
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                const vec3<float> point = (*nq)[idx];
+                const float value = (values != nullptr) ? values[idx] : 1.0f;
+                const vec3<float> delta = m_box.wrap(point - m_prev_points[idx]);
+                if (dot(delta, delta) > tolerance_sq || value != m_prev_values[idx])
+                {
+                    local_moved.push_back(idx);
+                }
+            }
+        });
+        std::vector<size_t> moved;
+        moved_pool.gatherInto(moved);
+
+        // Subtract each stale stencil and add the fresh one; particles below
+        // the tolerance keep their previous deposit.
+        util::forLoopWrapper(0, moved.size(), [&](size_t begin, size_t end) {
+            auto& local = m_local_bin_counts.local();
+            for (size_t i = begin; i < end; ++i)
+            {
+                const size_t idx = moved[i];
+                const vec3<float> point = (*nq)[idx];
+                const float value = (values != nullptr) ? values[idx] : 1.0f;
+                deposit(local, m_prev_points[idx], -m_prev_values[idx]);
+                deposit(local, point, value);
+                m_prev_points[idx] = point;
+                m_prev_values[idx] = value;
+            }
+        });
+        if (!moved.empty())
+        {
+            // reduceInto adds into its target, so this applies the delta
+            // onto the grid kept from the previous frame.
+            m_local_bin_counts.reduceInto(m_frame_grid);
+        }
+    }
+    else
+    {
+        m_frame_grid.prepare({m_width.x, m_width.y, m_width.z});
+        util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+            auto& local = m_local_bin_counts.local();
+            // for each reference point
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                const vec3<float> point = (*nq)[idx];
+                const float value = (values != nullptr) ? values[idx] : 1.0f;
+                deposit(local, point, value);
+            }
+        });
+
+        // Parallel reduction over thread storage
+        m_local_bin_counts.reduceInto(m_frame_grid);
+
+        if (m_incremental_tolerance > 0)
+        {
+            // Remember what was deposited for the next frame's delta update.
+            m_prev_box = m_box;
+            m_prev_points.resize(n_points);
+            m_prev_values.resize(n_points);
+            util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+                for (size_t idx = begin; idx < end; ++idx)
+                {
+                    m_prev_points[idx] = (*nq)[idx];
+                    m_prev_values[idx] = (values != nullptr) ? values[idx] : 1.0f;
+                }
+            });
+        }
+    }
+}
 
-                        // Calculate the distance from the particle to the grid cell
-                        const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
+void GaussianDensity::computeSeparable(const freud::locality::NeighborQuery* nq, const float* values)
+{
+    const auto n_points = nq->getNPoints();
+    const bool is2D = m_box.is2D();
 
-                        const float r_sq = dot(delta, delta);
+    m_frame_grid.prepare({m_width.x, m_width.y, m_width.z});
+    m_local_bin_counts.resize({m_width.x, m_width.y, m_width.z});
 
-                        // Check to see if this distance is within the specified r_max
-                        if (r_sq < r_max_sq)
+    const float Lx = m_box.getLx();
+    const float Ly = m_box.getLy();
+    const float Lz = m_box.getLz();
+    const vec3<bool> periodic = m_box.getPeriodic();
+
+    const float grid_size_x = Lx / static_cast<float>(m_width.x);
+    const float grid_size_y = Ly / static_cast<float>(m_width.y);
+    const float grid_size_z = is2D ? 0 : Lz / static_cast<float>(m_width.z);
+
+    const int width_x = static_cast<int>(m_width.x);
+    const int width_y = static_cast<int>(m_width.y);
+    const int width_z = static_cast<int>(m_width.z);
+
+    // Deposit each particle's value onto the grid with cloud-in-cell
+    // weights, splitting it between the two nearest cell centers per axis.
+    // Cell centers sit at (i + 0.5) * grid_size - L/2, so the grid coordinate
+    // below has them at integer values.
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        auto& local = m_local_bin_counts.local();
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const vec3<float> point = (*nq)[idx];
+            const float value = (values != nullptr) ? values[idx] : 1.0f;
+
+            const float gx = (point.x + Lx / float(2.0)) / grid_size_x - float(0.5);
+            const float gy = (point.y + Ly / float(2.0)) / grid_size_y - float(0.5);
+            const float gz = is2D ? 0 : (point.z + Lz / float(2.0)) / grid_size_z - float(0.5);
+
+            const int bin_x = static_cast<int>(std::floor(gx));
+            const int bin_y = static_cast<int>(std::floor(gy));
+            const int bin_z = is2D ? 0 : static_cast<int>(std::floor(gz));
+            const float frac_x = gx - static_cast<float>(bin_x);
+            const float frac_y = gy - static_cast<float>(bin_y);
+            const float frac_z = is2D ? 0 : gz - static_cast<float>(bin_z);
+
+            const float weight_x[2] = {float(1.0) - frac_x, frac_x};
+            const float weight_y[2] = {float(1.0) - frac_y, frac_y};
+            const float weight_z[2] = {float(1.0) - frac_z, frac_z};
+            const int corners_z = is2D ? 1 : 2;
+
+            for (int ck = 0; ck < corners_z; ck++)
+            {
+                int k = bin_z + ck;
+                // Reject cells that are outside the box in aperiodic directions
+                if (!periodic.z && (k < 0 || k >= width_z))
+                {
+                    continue;
+                }
+                for (int cj = 0; cj < 2; cj++)
+                {
+                    int j = bin_y + cj;
+                    if (!periodic.y && (j < 0 || j >= width_y))
+                    {
+                        continue;
+                    }
+                    for (int ci = 0; ci < 2; ci++)
+                    {
+                        int i = bin_x + ci;
+                        if (!periodic.x && (i < 0 || i >= width_x))
                         {
-                            // Evaluate the gaussian
-                            const float gaussian
-                                = value * normalization * std::exp(-r_sq / (float(2.0) * sigmasq));
-
-                            // Assure that out of range indices are corrected for storage
-                            // in the array i.e. bin -1 is actually bin 29 for nbins = 30
-                            const unsigned int ni = (i + m_width.x) % m_width.x;
-                            const unsigned int nj = (j + m_width.y) % m_width.y;
-                            const unsigned int nk = (k + m_width.z) % m_width.z;
-
-                            // Store the gaussian contribution
-                            local_bin_counts.local()(ni, nj, nk) += gaussian;
+                            continue;
                         }
+                        const unsigned int ni = (i + width_x) % width_x;
+                        const unsigned int nj = (j + width_y) % width_y;
+                        const unsigned int nk = (k + width_z) % width_z;
+                        local(ni, nj, nk) += value * weight_x[ci] * weight_y[cj] * weight_z[ck];
                     }
                 }
             }
         }
     });
+    m_local_bin_counts.reduceInto(m_frame_grid);
 
-    // Parallel reduction over thread storage
-    local_bin_counts.reduceInto(m_density_array);
+    // Smear the deposited grid with one truncated 1D Gaussian pass per axis.
+    // The product of the per-axis kernels reproduces the full Gaussian with
+    // its dimensional normalization.
+    const float sigmasq = m_sigma * m_sigma;
+    const float normalization_base = float(1.0) / std::sqrt(constants::TWO_PI * sigmasq);
+    const int bin_cut_x = int(m_r_max / grid_size_x);
+    const int bin_cut_y = int(m_r_max / grid_size_y);
+    const int bin_cut_z = is2D ? 0 : int(m_r_max / grid_size_z);
+
+    const size_t total = size_t(m_width.x) * m_width.y * m_width.z;
+    const size_t stride_x = size_t(m_width.y) * m_width.z;
+    const size_t stride_z = 1;
+    const auto stride_y = size_t(m_width.z);
+
+    std::vector<float> buffer(total);
+    float* density = m_frame_grid.get();
+    convolveAxis(density, buffer.data(), total, m_width.x, stride_x,
+                 makeTaps(bin_cut_x, grid_size_x, sigmasq, normalization_base), periodic.x);
+    convolveAxis(buffer.data(), density, total, m_width.y, stride_y,
+                 makeTaps(bin_cut_y, grid_size_y, sigmasq, normalization_base), periodic.y);
+    if (!is2D)
+    {
+        convolveAxis(density, buffer.data(), total, m_width.z, stride_z,
+                     makeTaps(bin_cut_z, grid_size_z, sigmasq, normalization_base), periodic.z);
+        std::copy(buffer.begin(), buffer.end(), density);
+    }
+}
+
+void GaussianDensity::reduce()
+{
+    m_density_array.prepare({m_width.x, m_width.y, m_width.z});
+
+    const float prefactor = float(1.0) / static_cast<float>(m_frame_counter);
+    const float* sum = m_density_sum.get();
+    float* out = m_density_array.get();
+    util::forLoopWrapper(0, m_density_array.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            out[i] = sum[i] * prefactor;
+        }
+    });
 }
 
 }; }; // end namespace freud::density
@@ -1,6 +1,10 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #include "LocalDensity.h"
 #include "NeighborComputeFunctional.h"
 
@@ -8,6 +12,75 @@
     \brief Routines for computing local density around a point.
 */
 
+namespace {
+
+#if defined(__AVX__)
+//! Sum the 8 lanes of an AVX register.
+inline float horizontalSum(__m256 v)
+{
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+    return _mm_cvtss_f32(lo);
+}
+#endif
+
+//! Sum the smoothed neighbor weights over one particle's distance slice.
+/*! A neighbor fully inside the r_max sphere counts 1; one whose diameter
+ *  straddles the surface counts the fraction of it estimated to lie inside,
+ *  1 + (r_max - (distance + diameter / 2)) / diameter. This is not
+ *  particularly accurate for a single particle, but works well on average
+ *  for lots of them: it smooths out the neighbor count distributions and
+ *  avoids noisy spikes that obscure data.
+ *
+ *  The vectorized path evaluates both cases and blends on the comparison, so
+ *  eight distances resolve per iteration with no branches; the lanes keep
+ *  eight partial sums that are collapsed at the end, so the result can
+ *  differ from the sequential scalar sum in the last bit by reassociation
+ *  only.
+ */
+inline float neighborWeightSum(const float* distances, size_t count, float r_max, float diameter)
+{
+    const float threshold = r_max - diameter / float(2.0);
+    size_t bond = 0;
+    float num_neighbors = 0;
+#if defined(__AVX__)
+    if (count >= 8)
+    {
+        const __m256 r_max_v = _mm256_set1_ps(r_max);
+        const __m256 threshold_v = _mm256_set1_ps(threshold);
+        const __m256 half_diameter_v = _mm256_set1_ps(diameter / float(2.0));
+        const __m256 diameter_v = _mm256_set1_ps(diameter);
+        const __m256 one_v = _mm256_set1_ps(float(1.0));
+        __m256 acc = _mm256_setzero_ps();
+        for (; bond + 8 <= count; bond += 8)
+        {
+            const __m256 distance = _mm256_loadu_ps(distances + bond);
+            const __m256 inside = _mm256_cmp_ps(distance, threshold_v, _CMP_LT_OQ);
+            const __m256 partial = _mm256_add_ps(
+                one_v, _mm256_div_ps(_mm256_sub_ps(r_max_v, _mm256_add_ps(distance, half_diameter_v)),
+                                     diameter_v));
+            acc = _mm256_add_ps(acc, _mm256_blendv_ps(partial, one_v, inside));
+        }
+        num_neighbors = horizontalSum(acc);
+    }
+#endif
+    for (; bond < count; ++bond)
+    {
+        if (distances[bond] < threshold)
+        {
+            num_neighbors += float(1.0);
+        }
+        else
+        {
+            num_neighbors += float(1.0) + (r_max - (distances[bond] + diameter / float(2.0))) / diameter;
+        }
+    }
+    return num_neighbors;
+}
+
+}; // namespace
+
 namespace freud { namespace density {
 
 LocalDensity::LocalDensity(float r_max, float diameter)
@@ -24,51 +97,96 @@ LocalDensity::LocalDensity(float r_max, float diameter)
     }
 }
 
-void LocalDensity::compute(const freud::locality::NeighborQuery* neighbor_query,
-                           const vec3<float>* query_points, unsigned int n_query_points,
-                           const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+void LocalDensity::reset()
+{
+    m_frame_counter = 0;
+    m_reduce = true;
+}
+
+void LocalDensity::accumulate(const freud::locality::NeighborQuery* neighbor_query,
+                              const vec3<float>* query_points, unsigned int n_query_points,
+                              const freud::locality::NeighborList* nlist,
+                              freud::locality::QueryArgs qargs)
 {
     m_box = neighbor_query->getBox();
 
-    m_density_array.prepare(n_query_points);
-    m_num_neighbors_array.prepare(n_query_points);
+    if (m_frame_counter == 0)
+    {
+        m_density_sum.prepare(n_query_points);
+        m_num_neighbors_sum.prepare(n_query_points);
+    }
+    else if (m_density_sum.size() != n_query_points)
+    {
+        throw std::invalid_argument("LocalDensity requires the same number of query points in all "
+                                    "accumulated frames. Call reset to start a new average.");
+    }
 
     const float area = M_PI * m_r_max * m_r_max;
     const float volume = static_cast<float>(4.0 / 3.0 * M_PI) * m_r_max * m_r_max * m_r_max;
+    // The local density is the occupied fraction of the neighborhood: area of
+    // particles over the area of the circle in 2D, volume over the volume of
+    // the sphere in 3D.
+    const float neighborhood = m_box.is2D() ? area : volume;
     // compute the local density
-    freud::locality::loopOverNeighborsIterator(
-        neighbor_query, query_points, n_query_points, qargs, nlist,
-        [&](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
-            float num_neighbors = 0;
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
-            {
-                // count particles that are fully in the r_max sphere
-                if (nb.distance < (m_r_max - m_diameter / float(2.0)))
-                {
-                    num_neighbors += float(1.0);
-                }
-                else
-                {
-                    // partially count particles that intersect the r_max sphere
-                    // this is not particularly accurate for a single particle, but works well on average for
-                    // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
-                    // that obscure data
-                    num_neighbors
-                        += float(1.0) + (m_r_max - (nb.distance + m_diameter / float(2.0))) / m_diameter;
-                }
-                m_num_neighbors_array[i] = num_neighbors;
-                if (m_box.is2D())
+    if (nlist != nullptr && !nlist->isHalfList())
+    {
+        // The distances of each query point's bonds form one contiguous CSR
+        // slice, so the weight sum runs through the vectorized kernel.
+        nlist->updateSegmentCounts();
+        freud::locality::forBalancedChunks(
+            freud::locality::balancedQueryPointChunks(nlist, n_query_points),
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i != end; ++i)
                 {
-                    // local density is area of particles divided by the area of the circle
-                    m_density_array[i] = m_num_neighbors_array[i] / area;
+                    const auto segment = nlist->getSegment(i);
+                    const float num_neighbors
+                        = neighborWeightSum(segment.distances, segment.count, m_r_max, m_diameter);
+                    m_num_neighbors_sum[i] += num_neighbors;
+                    m_density_sum[i] += num_neighbors / neighborhood;
                 }
-                else
+            });
+    }
+    else
+    {
+        freud::locality::loopOverNeighborsIterator(
+            neighbor_query, query_points, n_query_points, qargs, nlist,
+            [&](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
+                float num_neighbors = 0;
+                for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
                 {
-                    // local density is volume of particles divided by the volume of the sphere
-                    m_density_array[i] = m_num_neighbors_array[i] / volume;
+                    // count particles that are fully in the r_max sphere and
+                    // partially count particles that intersect it.
+                    num_neighbors += neighborWeightSum(&nb.distance, 1, m_r_max, m_diameter);
                 }
-            }
-        });
+                m_num_neighbors_sum[i] += num_neighbors;
+                m_density_sum[i] += num_neighbors / neighborhood;
+            });
+    }
+    m_frame_counter++;
+    m_reduce = true;
+}
+
+void LocalDensity::compute(const freud::locality::NeighborQuery* neighbor_query,
+                           const vec3<float>* query_points, unsigned int n_query_points,
+                           const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+{
+    // A single-frame compute is an accumulation over a fresh average.
+    reset();
+    accumulate(neighbor_query, query_points, n_query_points, nlist, qargs);
+}
+
+void LocalDensity::reduce()
+{
+    const auto n_query_points = m_density_sum.size();
+    m_density_array.prepare(n_query_points);
+    m_num_neighbors_array.prepare(n_query_points);
+
+    const float prefactor = float(1.0) / static_cast<float>(m_frame_counter);
+    for (size_t i = 0; i < n_query_points; ++i)
+    {
+        m_density_array[i] = m_density_sum[i] * prefactor;
+        m_num_neighbors_array[i] = m_num_neighbors_sum[i] * prefactor;
+    }
 }
 
 }; }; // end namespace freud::density
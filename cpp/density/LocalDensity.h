@@ -17,7 +17,12 @@
 namespace freud { namespace density {
 
 //! Compute the local density at each point
-/*!
+/*! In addition to single-frame computes, the class supports accumulation
+    over trajectories: accumulate() adds each frame's per-particle density
+    and neighbor count into running sums held in C++, and the getters
+    lazily reduce those sums into time averages, so no per-frame arrays
+    need to round-trip through the bindings. reset() clears the running
+    sums to start a new average.
  */
 class LocalDensity
 {
@@ -46,28 +51,59 @@ public:
         return m_diameter;
     }
 
-    //! Compute the local density
+    //! Reset the running sums to begin accumulating a new average.
+    void reset();
+
+    //! Add a frame to the running per-particle averages.
+    /*! All accumulated frames must provide the same number of query points
+     *  so that the per-particle sums stay aligned.
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                    unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                    freud::locality::QueryArgs qargs);
+
+    //! Compute the local density for a single frame.
     void compute(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                  unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                  freud::locality::QueryArgs qargs);
 
     //! Get a reference to the last computed density
-    const util::ManagedArray<float>& getDensity() const
+    const util::ManagedArray<float>& getDensity()
     {
-        return m_density_array;
+        return reduceAndReturn(m_density_array);
     }
 
     //! Get a reference to the last computed number of neighbors
-    const util::ManagedArray<float>& getNumNeighbors() const
+    const util::ManagedArray<float>& getNumNeighbors()
     {
-        return m_num_neighbors_array;
+        return reduceAndReturn(m_num_neighbors_array);
     }
 
 private:
+    //! Reduce the running sums into per-particle time averages.
+    void reduce();
+
+    //! Return the provided quantity, reducing the sums first if required.
+    template<typename U> U& reduceAndReturn(U& thing)
+    {
+        if (m_reduce)
+        {
+            reduce();
+        }
+        m_reduce = false;
+        return thing;
+    }
+
     box::Box m_box;   //!< Simulation box where the particles belong
     float m_r_max;    //!< Maximum neighbor distance
     float m_diameter; //!< Diameter of the particles
 
+    unsigned int m_frame_counter {0}; //!< Number of frames accumulated
+    bool m_reduce {true};             //!< Whether a reduce is required
+
+    util::ManagedArray<float> m_density_sum;       //!< running sum of per-frame densities
+    util::ManagedArray<float> m_num_neighbors_sum; //!< running sum of per-frame neighbor counts
+
     util::ManagedArray<float> m_density_array;       //!< density array computed
     util::ManagedArray<float> m_num_neighbors_array; //!< number of neighbors array computed
 };
@@ -3,6 +3,10 @@
 
 #include <stdexcept>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #include "RDF.h"
 
 /*! \file RDF.cc
@@ -11,6 +15,54 @@
 
 namespace freud { namespace density {
 
+namespace {
+//! Bin a contiguous block of bond distances into a histogram.
+/*! Fuses the range check and the RegularAxis binning arithmetic over eight
+ * distances at a time; the counts are scattered serially per lane since
+ * increments to arbitrary bins cannot be vectorized without conflict
+ * detection. The arithmetic matches RegularAxis::bin() (same inverse bin
+ * width, truncation, and top-edge clamp), so the result is identical to
+ * feeding each distance through the histogram.
+ */
+void binDistanceBlock(const float* distances, size_t begin, size_t end, float r_min, float r_max,
+                      float inverse_bin_width, size_t nbins, util::Histogram<unsigned int>& hist)
+{
+    size_t i = begin;
+#if defined(__AVX__)
+    const __m256 vmin = _mm256_set1_ps(r_min);
+    const __m256 vmax = _mm256_set1_ps(r_max);
+    const __m256 vinv = _mm256_set1_ps(inverse_bin_width);
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 d = _mm256_loadu_ps(distances + i);
+        const __m256 in_range
+            = _mm256_and_ps(_mm256_cmp_ps(d, vmin, _CMP_GE_OQ), _mm256_cmp_ps(d, vmax, _CMP_LT_OQ));
+        const int mask = _mm256_movemask_ps(in_range);
+        alignas(32) int bins[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bins),
+                           _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(d, vmin), vinv)));
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            if ((mask & (1 << lane)) != 0)
+            {
+                size_t bin_i = bins[lane];
+                // Avoid rounding leading to overflow.
+                if (bin_i == nbins)
+                {
+                    --bin_i;
+                }
+                hist.increment(bin_i);
+            }
+        }
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        hist(distances[i]);
+    }
+}
+}; // namespace
+
 RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
     : BondHistogramCompute(), m_normalize(normalize)
 {
@@ -36,7 +88,35 @@ RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
     m_histogram = BondHistogram(axes);
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
 
+    computeShellVolumes();
+}
+
+RDF::RDF(const std::vector<float>& bin_edges, bool normalize)
+    : BondHistogramCompute(), m_normalize(normalize)
+{
+    if (bin_edges.size() < 2)
+    {
+        throw std::invalid_argument("RDF requires at least two bin edges.");
+    }
+    if (bin_edges.front() < 0)
+    {
+        throw std::invalid_argument("RDF requires that bin edges be non-negative.");
+    }
+
+    // The lookup table axis handles arbitrary strictly increasing spacings
+    // (validated in its constructor) at the same per-bond cost as a regular
+    // axis.
+    const auto axes = util::Axes {std::make_shared<util::LookupTableAxis>(bin_edges)};
+    m_histogram = BondHistogram(axes);
+    m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
+
+    computeShellVolumes();
+}
+
+void RDF::computeShellVolumes()
+{
     // Precompute the cell volumes to speed up later calculations.
+    const auto bins = static_cast<unsigned int>(getAxisSizes()[0]);
     m_vol_array2D.prepare(bins);
     m_vol_array3D.prepare(bins);
     float volume_prefactor = (float(4.0) / float(3.0)) * M_PI;
@@ -51,34 +131,53 @@ RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
     }
 }
 
+RDF::RDF(const std::vector<unsigned int>& bins, const std::vector<float>& r_max, float r_min,
+         bool normalize)
+    : RDF(bins.empty() ? 0 : bins[0], r_max.empty() ? 0 : r_max[0], r_min, normalize)
+{
+    if (bins.size() != r_max.size())
+    {
+        throw std::invalid_argument("RDF requires one bin count per r_max value.");
+    }
+    for (size_t i = 1; i < bins.size(); i++)
+    {
+        m_multi.push_back(std::unique_ptr<RDF>(new RDF(bins[i], r_max[i], r_min, normalize)));
+    }
+}
+
 void RDF::reduce()
 {
     m_pcf.prepare(getAxisSizes()[0]);
     m_histogram.prepare(getAxisSizes()[0]);
     m_N_r.prepare(getAxisSizes()[0]);
 
-    // Define prefactors with appropriate types to simplify and speed later code.
-    float number_density = float(m_n_query_points) / m_box.getVolume();
+    // The normalization runs in double: the bin counts are exact integers,
+    // and over long accumulations they exceed the 24-bit float mantissa, so
+    // float prefactor products and especially the sequential cumulative sum
+    // below lose low-order counts. Only the final per-bin values are stored
+    // back as float.
+    double number_density = double(m_n_query_points) / double(m_box.getVolume());
     if (m_normalize)
     {
-        number_density *= static_cast<float>(m_n_query_points - 1) / static_cast<float>(m_n_query_points);
+        number_density *= static_cast<double>(m_n_query_points - 1) / static_cast<double>(m_n_query_points);
     }
-    auto np = static_cast<float>(m_n_points);
-    auto nf = static_cast<float>(m_frame_counter);
-    float prefactor = float(1.0) / (np * number_density * nf);
+    auto np = static_cast<double>(m_n_points);
+    auto nf = static_cast<double>(m_frame_counter);
+    const double prefactor = 1.0 / (np * number_density * nf);
 
     util::ManagedArray<float> vol_array = m_box.is2D() ? m_vol_array2D : m_vol_array3D;
     m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor, &vol_array](size_t i) {
-        m_pcf[i] = m_histogram[i] * prefactor / vol_array[i];
+        m_pcf[i] = static_cast<float>(m_histogram[i] * prefactor / double(vol_array[i]));
     });
 
     // The accumulation of the cumulative density must be performed in
     // sequence, so it is done after the reduction.
-    prefactor = float(1.0) / (np * static_cast<float>(m_frame_counter));
-    m_N_r[0] = m_histogram[0] * prefactor;
-    for (unsigned int i = 1; i < getAxisSizes()[0]; i++)
+    const double count_prefactor = 1.0 / (np * nf);
+    double cumulative_count = 0.0;
+    for (unsigned int i = 0; i < getAxisSizes()[0]; i++)
     {
-        m_N_r[i] = m_N_r[i - 1] + m_histogram[i] * prefactor;
+        cumulative_count += m_histogram[i] * count_prefactor;
+        m_N_r[i] = static_cast<float>(cumulative_count);
     }
 }
 
@@ -86,10 +185,331 @@ void RDF::accumulate(const freud::locality::NeighborQuery* neighbor_query, const
                      unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                      freud::locality::QueryArgs qargs)
 {
+    if (nlist != nullptr)
+    {
+        // An explicit neighbor list stores its distances as one contiguous
+        // block, so bypass the per-bond NeighborBond plumbing and run the
+        // fused SIMD binning kernel over chunks of the block, each chunk
+        // scattering into the executing thread's local histogram. Additional
+        // cutoff specifications rebin the same chunk while it is still cache
+        // resident.
+        m_box = neighbor_query->getBox();
+        const float* distances = nlist->getDistances().get();
+        auto bin_block = [&distances](RDF& rdf, size_t begin, size_t end) {
+            const auto* axis = dynamic_cast<const util::RegularAxis*>(rdf.m_histogram.getAxes()[0].get());
+            if (axis == nullptr)
+            {
+                // Nonuniform axes bin each distance through their
+                // constant-time lookup table instead of the fused kernel.
+                auto& hist = rdf.m_local_histograms.local();
+                for (size_t i = begin; i < end; ++i)
+                {
+                    hist(distances[i]);
+                }
+                return;
+            }
+            binDistanceBlock(distances, begin, end, axis->getMin(), axis->getMax(),
+                             axis->getInverseBinWidth(), axis->size(), rdf.m_local_histograms.local());
+        };
+        util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+            bin_block(*this, begin, end);
+            for (auto& sub : m_multi)
+            {
+                bin_block(*sub, begin, end);
+            }
+        });
+        finishFrame(neighbor_query, n_query_points);
+    }
+    else
+    {
+        accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                          [&](const freud::locality::NeighborBond& neighbor_bond) {
+                              m_local_histograms(neighbor_bond.distance);
+                              for (auto& sub : m_multi)
+                              {
+                                  sub->m_local_histograms(neighbor_bond.distance);
+                              }
+                          });
+    }
+}
+
+void RDF::accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                     unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                     freud::locality::QueryArgs qargs, const unsigned int* query_point_types,
+                     const unsigned int* point_types, unsigned int n_types)
+{
+    if (n_types == 0)
+    {
+        throw std::invalid_argument("Partial RDFs require a nonzero number of types.");
+    }
+
+    if (m_partials.empty())
+    {
+        // Construct one partial per unordered type pair with this object's
+        // binning; each accumulates and reduces independently.
+        m_n_types = n_types;
+        const auto bin_edges = getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(getAxisSizes()[0]);
+        const bool regular
+            = dynamic_cast<const util::RegularAxis*>(m_histogram.getAxes()[0].get()) != nullptr;
+        const auto n_pairs = size_t(n_types) * (n_types + 1) / 2;
+        for (size_t i = 0; i < n_pairs; i++)
+        {
+            m_partials.push_back(std::unique_ptr<RDF>(
+                regular ? new RDF(bins, bin_edges.back(), bin_edges.front(), m_normalize)
+                        : new RDF(bin_edges, m_normalize)));
+        }
+    }
+    else if (m_n_types != n_types)
+    {
+        throw std::invalid_argument(
+            "The number of types passed to RDF has changed. Call reset to start a new accumulation.");
+    }
+
+    // One traversal scatters each bond into the total histogram, every extra
+    // cutoff specification, and the histogram of its unordered type pair.
+    // The per-bond path is used even with an explicit neighbor list because
+    // the pair assignment needs each bond's endpoint indices, not just its
+    // distance.
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [&](const freud::locality::NeighborBond& neighbor_bond) {
                           m_local_histograms(neighbor_bond.distance);
+                          for (auto& sub : m_multi)
+                          {
+                              sub->m_local_histograms(neighbor_bond.distance);
+                          }
+                          const size_t pair
+                              = pairIndex(query_point_types[neighbor_bond.query_point_idx],
+                                          point_types[neighbor_bond.point_idx], n_types);
+                          m_partials[pair]->m_local_histograms(neighbor_bond.distance);
                       });
 }
 
+void RDF::finishFrame(const freud::locality::NeighborQuery* neighbor_query, unsigned int n_query_points)
+{
+    locality::BondHistogramCompute::finishFrame(neighbor_query, n_query_points);
+    // Every cutoff specification and partial is normalized with the full
+    // system's bookkeeping, so that each sub-RDF reduces independently and
+    // the partials sum to the total RDF.
+    for (auto& sub : m_multi)
+    {
+        sub->m_box = m_box;
+        sub->m_frame_counter = m_frame_counter;
+        sub->m_n_points = m_n_points;
+        sub->m_n_query_points = m_n_query_points;
+        sub->m_reduce = true;
+    }
+    for (auto& partial : m_partials)
+    {
+        partial->m_box = m_box;
+        partial->m_frame_counter = m_frame_counter;
+        partial->m_n_points = m_n_points;
+        partial->m_n_query_points = m_n_query_points;
+        partial->m_reduce = true;
+    }
+}
+
+locality::BondConsumer RDF::makeBondConsumer()
+{
+    locality::BondConsumer consumer;
+    consumer.compute = this;
+    consumer.bond = [this](const freud::locality::NeighborBond& neighbor_bond) {
+        m_local_histograms(neighbor_bond.distance);
+        for (auto& sub : m_multi)
+        {
+            sub->m_local_histograms(neighbor_bond.distance);
+        }
+    };
+    return consumer;
+}
+
+void RDF::writeCheckpoint(util::ArrayFileWriter& writer)
+{
+    locality::BondHistogramCompute::writeCheckpoint(writer);
+    // Each extra cutoff specification holds its own histogram; their
+    // bookkeeping is shared with this object's, so only the counts need
+    // their own sections.
+    for (size_t i = 0; i < m_multi.size(); ++i)
+    {
+        util::ManagedArray<unsigned int> counts;
+        counts.prepare(m_multi[i]->getAxisSizes());
+        m_multi[i]->m_local_histograms.reduceInto(counts);
+        writer.write("sub" + std::to_string(i), counts);
+    }
+    // Partial RDFs share this object's binning and bookkeeping, so the type
+    // count and the per-pair counts are all that must be stored.
+    util::ManagedArray<unsigned int> n_types_array;
+    n_types_array.prepare(1);
+    n_types_array[0] = m_n_types;
+    writer.write("ptypes", n_types_array);
+    for (size_t i = 0; i < m_partials.size(); ++i)
+    {
+        util::ManagedArray<unsigned int> counts;
+        counts.prepare(m_partials[i]->getAxisSizes());
+        m_partials[i]->m_local_histograms.reduceInto(counts);
+        writer.write("p" + std::to_string(i), counts);
+    }
+}
+
+void RDF::readCheckpoint(const util::ArrayFileReader& reader)
+{
+    locality::BondHistogramCompute::readCheckpoint(reader);
+    if (reader.contains("sub" + std::to_string(m_multi.size())))
+    {
+        throw std::runtime_error("Checkpoint was written with a different set of cutoff specifications.");
+    }
+    for (size_t i = 0; i < m_multi.size(); ++i)
+    {
+        const auto counts = reader.read<unsigned int>("sub" + std::to_string(i));
+        RDF& sub = *m_multi[i];
+        if (counts.size() != sub.m_histogram.size())
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        sub.m_local_histograms.reset();
+        auto& local = sub.m_local_histograms.local();
+        for (size_t j = 0; j < counts.size(); ++j)
+        {
+            if (counts[j] != 0)
+            {
+                local.increment(j, counts[j]);
+            }
+        }
+        sub.m_box = m_box;
+        sub.m_frame_counter = m_frame_counter;
+        sub.m_n_points = m_n_points;
+        sub.m_n_query_points = m_n_query_points;
+        sub.m_reduce = true;
+    }
+    m_partials.clear();
+    m_n_types = 0;
+    if (reader.contains("ptypes"))
+    {
+        m_n_types = reader.read<unsigned int>("ptypes")[0];
+        const auto bin_edges = getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(getAxisSizes()[0]);
+        const auto n_pairs = size_t(m_n_types) * (m_n_types + 1) / 2;
+        for (size_t i = 0; i < n_pairs; ++i)
+        {
+            const auto counts = reader.read<unsigned int>("p" + std::to_string(i));
+            std::unique_ptr<RDF> partial(new RDF(bins, bin_edges.back(), bin_edges.front(), m_normalize));
+            if (counts.size() != partial->m_histogram.size())
+            {
+                throw std::runtime_error("Checkpoint does not match this compute's binning.");
+            }
+            auto& local = partial->m_local_histograms.local();
+            for (size_t j = 0; j < counts.size(); ++j)
+            {
+                if (counts[j] != 0)
+                {
+                    local.increment(j, counts[j]);
+                }
+            }
+            partial->m_box = m_box;
+            partial->m_frame_counter = m_frame_counter;
+            partial->m_n_points = m_n_points;
+            partial->m_n_query_points = m_n_query_points;
+            partial->m_reduce = true;
+            m_partials.push_back(std::move(partial));
+        }
+    }
+}
+
+void RDF::mergeCheckpoint(const util::ArrayFileReader& reader)
+{
+    locality::BondHistogramCompute::mergeCheckpoint(reader);
+    if (reader.contains("sub" + std::to_string(m_multi.size())))
+    {
+        throw std::runtime_error("Checkpoint was written with a different set of cutoff specifications.");
+    }
+    for (size_t i = 0; i < m_multi.size(); ++i)
+    {
+        const auto counts = reader.read<unsigned int>("sub" + std::to_string(i));
+        RDF& sub = *m_multi[i];
+        if (counts.size() != sub.m_histogram.size())
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        auto& local = sub.m_local_histograms.local();
+        for (size_t j = 0; j < counts.size(); ++j)
+        {
+            if (counts[j] != 0)
+            {
+                local.increment(j, counts[j]);
+            }
+        }
+        sub.m_box = m_box;
+        sub.m_frame_counter = m_frame_counter;
+        sub.m_n_points = m_n_points;
+        sub.m_n_query_points = m_n_query_points;
+        sub.m_reduce = true;
+    }
+    unsigned int n_types = 0;
+    if (reader.contains("ptypes"))
+    {
+        n_types = reader.read<unsigned int>("ptypes")[0];
+    }
+    if (m_n_types == 0 && n_types != 0)
+    {
+        // This compute has not seen typed frames yet; adopt the checkpoint's
+        // partial set (empty) and fall through to add its counts.
+        m_n_types = n_types;
+        const auto bin_edges = getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(getAxisSizes()[0]);
+        const auto n_pairs = size_t(m_n_types) * (m_n_types + 1) / 2;
+        for (size_t i = 0; i < n_pairs; ++i)
+        {
+            m_partials.emplace_back(new RDF(bins, bin_edges.back(), bin_edges.front(), m_normalize));
+        }
+    }
+    if (n_types != m_n_types)
+    {
+        throw std::runtime_error("Checkpoint was written with a different number of point types.");
+    }
+    for (size_t i = 0; i < m_partials.size(); ++i)
+    {
+        const auto counts = reader.read<unsigned int>("p" + std::to_string(i));
+        RDF& partial = *m_partials[i];
+        if (counts.size() != partial.m_histogram.size())
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        auto& local = partial.m_local_histograms.local();
+        for (size_t j = 0; j < counts.size(); ++j)
+        {
+            if (counts[j] != 0)
+            {
+                local.increment(j, counts[j]);
+            }
+        }
+        partial.m_box = m_box;
+        partial.m_frame_counter = m_frame_counter;
+        partial.m_n_points = m_n_points;
+        partial.m_n_query_points = m_n_query_points;
+        partial.m_reduce = true;
+    }
+}
+
+void RDF::accumulateAsync(const freud::locality::NeighborQuery* neighbor_query,
+                          const vec3<float>* query_points, unsigned int n_query_points,
+                          const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+{
+    m_async.launch([this, neighbor_query, query_points, n_query_points, nlist, qargs]() {
+        accumulate(neighbor_query, query_points, n_query_points, nlist, qargs);
+    });
+}
+
+void RDF::accumulateFrames(const vec3<float>* points, unsigned int n_points, unsigned int n_frames,
+                           const box::Box* boxes, freud::locality::QueryArgs qargs)
+{
+    accumulateGeneralFrames(points, n_points, n_frames, boxes, qargs,
+                            [&](const freud::locality::NeighborBond& neighbor_bond) {
+                                m_local_histograms(neighbor_bond.distance);
+                                for (auto& sub : m_multi)
+                                {
+                                    sub->m_local_histograms(neighbor_bond.distance);
+                                }
+                            });
+}
+
 }; }; // end namespace freud::density
@@ -6,7 +6,12 @@
 
 #include "BondHistogramCompute.h"
 #include "Box.h"
+#include "CompositeCompute.h"
 #include "Histogram.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 /*! \file RDF.h
     \brief Routines for computing radial density functions.
@@ -19,9 +24,61 @@ public:
     //! Constructor
     RDF(unsigned int bins, float r_max, float r_min = 0, bool normalize = false);
 
+    //! Constructor for several (bins, r_max) specifications.
+    /*! All histograms are filled during one neighbor traversal, so the same
+     * RDF can be resolved at several cutoffs (e.g. fine short-range bins and
+     * a coarse long-range tail) without regenerating neighbors per cutoff.
+     * The first specification becomes this object's own histogram; the others
+     * are accessed through getCutoff. Callers should query (or provide a
+     * neighbor list) with the largest r_max so that every histogram sees all
+     * of its bonds; bonds beyond a specification's r_max simply fall outside
+     * its axis and are dropped.
+     */
+    RDF(const std::vector<unsigned int>& bins, const std::vector<float>& r_max, float r_min = 0,
+        bool normalize = false);
+
+    //! Constructor from explicit bin edges.
+    /*! Accepts arbitrarily (e.g. logarithmically) spaced, strictly increasing
+     * edges; binning runs through the constant-time lookup table of
+     * util::LookupTableAxis, so nonuniform bins cost the same per bond as
+     * linear ones. The per-bin shell volumes used for normalization are
+     * computed from the edges, so no other part of the reduction changes.
+     */
+    explicit RDF(const std::vector<float>& bin_edges, bool normalize = false);
+
     //! Destructor
     ~RDF() override = default;
 
+    //! Get the number of (bins, r_max) specifications.
+    size_t getNumCutoffs() const
+    {
+        return 1 + m_multi.size();
+    }
+
+    //! Get the RDF for cutoff specification i (0 is this object itself).
+    RDF& getCutoff(size_t i)
+    {
+        if (i >= getNumCutoffs())
+        {
+            throw std::out_of_range("RDF cutoff specification index requested does not exist.");
+        }
+        return i == 0 ? *this : *m_multi[i - 1];
+    }
+
+    //! Reset the histograms of all cutoff specifications and partials.
+    void reset() override
+    {
+        locality::BondHistogramCompute::reset();
+        for (auto& sub : m_multi)
+        {
+            sub->reset();
+        }
+        for (auto& partial : m_partials)
+        {
+            partial->reset();
+        }
+    }
+
     //! Compute the RDF
     /*! Accumulate the given points to the histogram. Accumulation is performed
      * in parallel on thread-local copies of the data, which are reduced into
@@ -31,6 +88,73 @@ public:
                     unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                     freud::locality::QueryArgs qargs);
 
+    //! Accumulate the total RDF and all partial RDFs g_ab(r) in one pass.
+    /*! Each bond is binned into the total histogram and into the histogram of
+     * the unordered pair of its endpoints' types, so one neighbor traversal
+     * produces every species pair's g(r) instead of one traversal per pair.
+     * Cross partials count bonds in both directions, and every partial is
+     * normalized with the full system's density, so the partials sum to the
+     * total RDF. The number of types must not change between accumulated
+     * frames.
+     * \param query_point_types Per-query-point type ids in [0, n_types).
+     * \param point_types Per-point type ids in [0, n_types).
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                    unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                    freud::locality::QueryArgs qargs, const unsigned int* query_point_types,
+                    const unsigned int* point_types, unsigned int n_types);
+
+    //! Get the number of types used for partial RDFs.
+    unsigned int getNumTypes() const
+    {
+        return m_n_types;
+    }
+
+    //! Get the last computed partial RDF g_ab(r).
+    const util::ManagedArray<float>& getPartialRDF(unsigned int type_a, unsigned int type_b)
+    {
+        if (type_a >= m_n_types || type_b >= m_n_types)
+        {
+            throw std::out_of_range("Type index exceeds the number of accumulated types.");
+        }
+        return m_partials[pairIndex(type_a, type_b, m_n_types)]->getRDF();
+    }
+
+    //! Accumulate a frame asynchronously in the shared compute arena.
+    /*! Returns immediately; the accumulation runs on TBB worker threads and
+     * any accessor (or reset) blocks until it completes, so results may be
+     * requested at any time. The caller must keep neighbor_query,
+     * query_points, and nlist alive until the compute finishes — typically
+     * until the next accessor call or synchronize(). This lets a driver
+     * overlap decoding the next trajectory frame with computing the current
+     * one.
+     */
+    void accumulateAsync(const freud::locality::NeighborQuery* neighbor_query,
+                         const vec3<float>* query_points, unsigned int n_query_points,
+                         const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
+
+    //! Accumulate many frames of a trajectory in one call.
+    /*! Equivalent to calling accumulate once per frame with an AABBQuery
+     * built from that frame's positions and box, but the per-frame neighbor
+     * structure for the next frame is built concurrently with the current
+     * frame's accumulation, hiding per-call overhead on small frames.
+     * \param points Frame-major array of n_frames * n_points positions.
+     * \param n_points Number of points in each frame.
+     * \param n_frames Number of frames.
+     * \param boxes Array of n_frames simulation boxes, one per frame.
+     * \param qargs Query arguments, applied identically to every frame.
+     */
+    void accumulateFrames(const vec3<float>* points, unsigned int n_points, unsigned int n_frames,
+                          const box::Box* boxes, freud::locality::QueryArgs qargs);
+
+    //! Get this RDF's per-bond kernel for a shared traversal.
+    /*! The returned consumer bins each bond into the total histogram and
+     * every extra cutoff specification, exactly like accumulate; registering
+     * it with a CompositeCompute lets the RDF share one neighbor traversal
+     * with other computes on the same frame.
+     */
+    locality::BondConsumer makeBondConsumer();
+
     //! Reduce thread-local arrays onto the primary data arrays.
     void reduce() override;
 
@@ -50,7 +174,29 @@ public:
         return reduceAndReturn(m_N_r);
     }
 
+protected:
+    //! Share this accumulation's bookkeeping with every cutoff specification
+    //! and partial so that each can normalize its own reduction.
+    void finishFrame(const freud::locality::NeighborQuery* neighbor_query,
+                     unsigned int n_query_points) override;
+
+    //! Checkpoint the histograms of the extra cutoff specifications as well.
+    void writeCheckpoint(util::ArrayFileWriter& writer) override;
+    void readCheckpoint(const util::ArrayFileReader& reader) override;
+    void mergeCheckpoint(const util::ArrayFileReader& reader) override;
+
 private:
+    //! Precompute the per-bin shell areas and volumes from the bin edges.
+    void computeShellVolumes();
+
+    //! Linear index of the unordered type pair (a, b) among all pairs.
+    static size_t pairIndex(unsigned int type_a, unsigned int type_b, unsigned int n_types)
+    {
+        const size_t a = std::min(type_a, type_b);
+        const size_t b = std::max(type_a, type_b);
+        return a * n_types - a * (a - 1) / 2 + (b - a);
+    }
+
     bool m_normalize;                //!< Whether to enforce that the RDF should tend to 1 (instead of
                                      //!< num_query_points/num_points).
     util::ManagedArray<float> m_pcf; //!< The computed pair correlation function.
@@ -60,6 +206,9 @@ private:
         m_vol_array2D; //!< Areas of concentric rings corresponding to the histogram bins in 2D.
     util::ManagedArray<float>
         m_vol_array3D; //!< Areas of concentric spherical shells corresponding to the histogram bins in 3D.
+    std::vector<std::unique_ptr<RDF>> m_multi; //!< Additional cutoff specifications beyond the first.
+    unsigned int m_n_types {0};                //!< Number of types for partial RDFs.
+    std::vector<std::unique_ptr<RDF>> m_partials; //!< Per-type-pair partial RDFs.
 };
 
 }; }; // end namespace freud::density
@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
@@ -12,8 +13,8 @@
 
 namespace freud { namespace density {
 
-SphereVoxelization::SphereVoxelization(vec3<unsigned int> width, float r_max)
-    : m_box(), m_width(width), m_r_max(r_max), m_has_computed(false)
+SphereVoxelization::SphereVoxelization(vec3<unsigned int> width, float r_max, bool bit_packed)
+    : m_box(), m_width(width), m_r_max(r_max), m_bit_packed(bit_packed), m_has_computed(false)
 {
     if (r_max <= 0)
     {
@@ -24,6 +25,30 @@ SphereVoxelization::SphereVoxelization(vec3<unsigned int> width, float r_max)
 //! Get a reference to the last computed voxels.
 const util::ManagedArray<unsigned int>& SphereVoxelization::getVoxels() const
 {
+    if (m_bit_packed && m_voxels_stale)
+    {
+        // Expand the packed bits into the dense array on demand. Only the
+        // occupied chunks need to be visited; everything else was zeroed by
+        // the preparation.
+        m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+        const size_t n_words = m_words.size();
+        for (const unsigned int chunk : m_occupied_chunks)
+        {
+            const size_t word_end = std::min(n_words, (size_t(chunk) + 1) * CHUNK_WORDS);
+            for (size_t w = size_t(chunk) * CHUNK_WORDS; w < word_end; ++w)
+            {
+                unsigned int word = m_occupancy_bits[w];
+                for (size_t bit = 0; word != 0; ++bit, word >>= 1U)
+                {
+                    if ((word & 1U) != 0)
+                    {
+                        m_voxels_array[w * BITS_PER_WORD + bit] = 1;
+                    }
+                }
+            }
+        }
+        m_voxels_stale = false;
+    }
     return m_voxels_array;
 }
 
@@ -58,7 +83,44 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
         m_width.z = 1;
     }
 
-    m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+    const size_t n_voxels = size_t(m_width.x) * m_width.y * m_width.z;
+    const size_t n_words = (n_voxels + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    const size_t n_chunks = (n_words + CHUNK_WORDS - 1) / CHUNK_WORDS;
+    if (m_bit_packed)
+    {
+        if (m_words.size() != n_words)
+        {
+            // Atomics are neither copyable nor zero-initialized, so size the
+            // buffers by construction and zero them explicitly.
+            m_words = std::vector<std::atomic<unsigned int>>(n_words);
+            m_chunk_touched = std::vector<std::atomic<unsigned int>>(n_chunks);
+            for (auto& word : m_words)
+            {
+                word.store(0, std::memory_order_relaxed);
+            }
+            for (auto& flag : m_chunk_touched)
+            {
+                flag.store(0, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            // Frame-start reset touches only the chunks occupied last frame.
+            for (const unsigned int chunk : m_occupied_chunks)
+            {
+                const size_t word_end = std::min(n_words, (size_t(chunk) + 1) * CHUNK_WORDS);
+                for (size_t w = size_t(chunk) * CHUNK_WORDS; w < word_end; ++w)
+                {
+                    m_words[w].store(0, std::memory_order_relaxed);
+                }
+                m_chunk_touched[chunk].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    else
+    {
+        m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+    }
 
     // set up some constants first
     const float Lx = m_box.getLx();
@@ -76,69 +138,112 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
     const int bin_cut_z = m_box.is2D() ? 0 : int(m_r_max / grid_size_z);
     const float r_max_sq = m_r_max * m_r_max;
 
-    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
-        // for each reference point
-        for (size_t idx = begin; idx < end; ++idx)
-        {
-            const vec3<float> point = (*nq)[idx];
-            // Find which bin the particle is in
-            const int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
-            const int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
-            // In 2D, only loop over the z=0 plane
-            const int bin_z = m_box.is2D() ? 0 : int((point.z + Lz / float(2.0)) / grid_size_z);
-
-            // Only evaluate over bins that are within the cutoff, rejecting bins
-            // that are outside the box in aperiodic directions.
-            for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+    // The sphere stencil traversal is shared between the representations;
+    // only the innermost voxel write differs.
+    auto deposit = [&](const auto& write) {
+        util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+            // for each reference point
+            for (size_t idx = begin; idx < end; ++idx)
             {
-                if (!periodic.z && (k < 0 || k >= int(m_width.z)))
-                {
-                    continue;
-                }
-                const float dz = (grid_size_z * static_cast<float>(k)) + (grid_size_z / float(2.0)) - point.z
-                    - (Lz / float(2.0));
-
-                for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
+                const vec3<float> point = (*nq)[idx];
+                // Find which bin the particle is in
+                const int bin_x = int((point.x + Lx / float(2.0)) / grid_size_x);
+                const int bin_y = int((point.y + Ly / float(2.0)) / grid_size_y);
+                // In 2D, only loop over the z=0 plane
+                const int bin_z = m_box.is2D() ? 0 : int((point.z + Lz / float(2.0)) / grid_size_z);
+
+                // Only evaluate over bins that are within the cutoff, rejecting bins
+                // that are outside the box in aperiodic directions.
+                for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
                 {
-                    if (!periodic.y && (j < 0 || j >= int(m_width.y)))
+                    if (!periodic.z && (k < 0 || k >= int(m_width.z)))
                     {
                         continue;
                     }
-                    const float dy = (grid_size_y * static_cast<float>(j)) + (grid_size_y / float(2.0))
-                        - point.y - (Ly / float(2.0));
+                    const float dz = (grid_size_z * static_cast<float>(k)) + (grid_size_z / float(2.0))
+                        - point.z - (Lz / float(2.0));
 
-                    for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
+                    for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
                     {
-                        if (!periodic.x && (i < 0 || i >= int(m_width.x)))
+                        if (!periodic.y && (j < 0 || j >= int(m_width.y)))
                         {
                             continue;
                         }
-                        const float dx = ((grid_size_x * static_cast<float>(i)) + (grid_size_x / 2.0f)
-                                          - point.x - (Lx / float(2.0)));
-
-                        // Calculate the distance from the particle to the grid cell
-                        const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
-
-                        const float r_sq = dot(delta, delta);
+                        const float dy = (grid_size_y * static_cast<float>(j)) + (grid_size_y / float(2.0))
+                            - point.y - (Ly / float(2.0));
 
-                        // Check to see if this distance is within the specified r_max
-                        if (r_sq < r_max_sq)
+                        for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
                         {
-                            // Assure that out of range indices are corrected for storage
-                            // in the array i.e. bin -1 is actually bin 29 for nbins = 30
-                            const unsigned int ni = (i + m_width.x) % m_width.x;
-                            const unsigned int nj = (j + m_width.y) % m_width.y;
-                            const unsigned int nk = (k + m_width.z) % m_width.z;
-
-                            // This array value could be written by multiple threads in parallel.
-                            // This is only safe because all threads are writing the same value (1).
-                            m_voxels_array(ni, nj, nk) = 1;
+                            if (!periodic.x && (i < 0 || i >= int(m_width.x)))
+                            {
+                                continue;
+                            }
+                            const float dx = ((grid_size_x * static_cast<float>(i)) + (grid_size_x / 2.0f)
+                                              - point.x - (Lx / float(2.0)));
+
+                            // Calculate the distance from the particle to the grid cell
+                            const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
+
+                            const float r_sq = dot(delta, delta);
+
+                            // Check to see if this distance is within the specified r_max
+                            if (r_sq < r_max_sq)
+                            {
+                                // Assure that out of range indices are corrected for storage
+                                // in the array i.e. bin -1 is actually bin 29 for nbins = 30
+                                const unsigned int ni = (i + m_width.x) % m_width.x;
+                                const unsigned int nj = (j + m_width.y) % m_width.y;
+                                const unsigned int nk = (k + m_width.z) % m_width.z;
+
+                                write(ni, nj, nk);
+                            }
                         }
                     }
                 }
             }
+        });
+    };
+
+    if (m_bit_packed)
+    {
+        deposit([&](unsigned int ni, unsigned int nj, unsigned int nk) {
+            const size_t idx = (size_t(ni) * m_width.y + nj) * m_width.z + nk;
+            const unsigned int bit = 1U << (idx % BITS_PER_WORD);
+            std::atomic<unsigned int>& word = m_words[idx / BITS_PER_WORD];
+            // Check before the OR so that hot voxels do not contend on the
+            // read-modify-write once their bit is set.
+            if ((word.load(std::memory_order_relaxed) & bit) == 0)
+            {
+                word.fetch_or(bit, std::memory_order_relaxed);
+                m_chunk_touched[idx / BITS_PER_WORD / CHUNK_WORDS].store(1, std::memory_order_relaxed);
+            }
+        });
+
+        // Publish the packed representation and the occupied chunk list.
+        m_occupancy_bits.prepare(n_words);
+        m_occupied_chunks.clear();
+        for (size_t chunk = 0; chunk < n_chunks; ++chunk)
+        {
+            if (m_chunk_touched[chunk].load(std::memory_order_relaxed) != 0)
+            {
+                m_occupied_chunks.push_back(static_cast<unsigned int>(chunk));
+                const size_t word_end = std::min(n_words, (chunk + 1) * CHUNK_WORDS);
+                for (size_t w = chunk * CHUNK_WORDS; w < word_end; ++w)
+                {
+                    m_occupancy_bits[w] = m_words[w].load(std::memory_order_relaxed);
+                }
+            }
         }
-    });
+        m_voxels_stale = true;
+    }
+    else
+    {
+        deposit([&](unsigned int ni, unsigned int nj, unsigned int nk) {
+            // This array value could be written by multiple threads in parallel.
+            // This is only safe because all threads are writing the same value (1).
+            m_voxels_array(ni, nj, nk) = 1;
+        });
+    }
 }
 
 }; }; // end namespace freud::density
@@ -4,6 +4,9 @@
 #ifndef SPHERE_VOXELIZATION_H
 #define SPHERE_VOXELIZATION_H
 
+#include <atomic>
+#include <vector>
+
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborQuery.h"
@@ -22,12 +25,28 @@ namespace freud { namespace density {
     otherwise. The dimensions of the grid are set in the constructor, and can
     either be set equally for all dimensions or for each dimension
     independently.
+
+    Since each voxel carries a single bit of information, the occupancy can
+    optionally be stored bit-packed: 32 voxels per word, deposited with
+    word-level atomic ORs so that threads setting different bits of the same
+    word do not lose updates. The packed representation tracks which
+    fixed-size chunks of words were touched, so mostly-empty grids are
+    cleared, copied, and expanded in time proportional to the occupied region
+    rather than the full grid. The dense voxels array remains available
+    through getVoxels() and is materialized from the bits on first access.
 */
 class SphereVoxelization
 {
 public:
     //! Constructor
-    SphereVoxelization(vec3<unsigned int> width, float r_max);
+    /*! \param width Number of grid cells in each dimension.
+     *  \param r_max Sphere radius used for voxelization.
+     *  \param bit_packed If true, store the occupancy as one bit per voxel
+     *         instead of one word, reducing the memory footprint by 32x on
+     *         fine grids. getVoxels() still returns the dense array,
+     *         expanded from the bits on demand.
+     */
+    SphereVoxelization(vec3<unsigned int> width, float r_max, bool bit_packed = false);
 
     // Destructor
     ~SphereVoxelization() = default;
@@ -44,21 +63,56 @@ public:
         return m_r_max;
     }
 
+    //! Return whether the bit-packed occupancy representation is selected.
+    bool getBitPacked() const
+    {
+        return m_bit_packed;
+    }
+
     //! Compute the voxelization.
     void compute(const freud::locality::NeighborQuery* nq);
 
     //! Get a reference to the last computed voxels.
     const util::ManagedArray<unsigned int>& getVoxels() const;
 
+    //! Get a reference to the bit-packed occupancy.
+    /*! Bit (idx % 32) of word (idx / 32) holds the voxel at row-major index
+     *  idx. Only populated when bit-packed mode is enabled.
+     */
+    const util::ManagedArray<unsigned int>& getOccupancyBits() const
+    {
+        return m_occupancy_bits;
+    }
+
+    //! Get the indices of the word chunks containing at least one set bit.
+    /*! Chunks are CHUNK_WORDS consecutive words of the packed occupancy;
+     *  words in chunks not listed here are all zero, so consumers of
+     *  mostly-empty grids can skip them entirely.
+     */
+    const std::vector<unsigned int>& getOccupiedChunks() const
+    {
+        return m_occupied_chunks;
+    }
+
     vec3<unsigned int> getWidth() const;
 
+    static constexpr size_t BITS_PER_WORD = 32; //!< Voxels stored per packed word.
+    static constexpr size_t CHUNK_WORDS = 4096; //!< Words per sparsely tracked chunk (16 KB).
+
 private:
     box::Box m_box;             //!< Simulation box containing the points.
     vec3<unsigned int> m_width; //!< Number of bins in the grid in each dimension.
     float m_r_max;              //!< Sphere radius used for voxelization.
+    bool m_bit_packed;          //!< Whether to store the occupancy bit-packed.
     bool m_has_computed;        //!< Tracks whether a call to compute has been made.
 
-    util::ManagedArray<unsigned int> m_voxels_array; //! Computed voxels array.
+    std::vector<std::atomic<unsigned int>> m_words;         //!< Packed deposition buffer.
+    std::vector<std::atomic<unsigned int>> m_chunk_touched; //!< Per-chunk dirty flags.
+    std::vector<unsigned int> m_occupied_chunks;            //!< Chunks with at least one set bit.
+    util::ManagedArray<unsigned int> m_occupancy_bits;      //! Computed bit-packed occupancy.
+
+    mutable util::ManagedArray<unsigned int> m_voxels_array; //! Computed voxels array.
+    mutable bool m_voxels_stale {false}; //!< Whether the dense array lags the packed bits.
 };
 
 }; }; // end namespace freud::density
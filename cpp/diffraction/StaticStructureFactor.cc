@@ -36,4 +36,54 @@ StaticStructureFactor::StaticStructureFactor(unsigned int bins, float k_max, flo
     m_local_structure_factor = StructureFactorHistogram::ThreadLocalHistogram(m_structure_factor);
 }
 
+void StaticStructureFactor::checkpoint(const std::string& path)
+{
+    util::ArrayFileWriter writer(path);
+    writeCheckpoint(writer);
+    writer.close();
+}
+
+void StaticStructureFactor::restore(const std::string& path)
+{
+    const util::ArrayFileReader reader(path);
+    readCheckpoint(reader);
+}
+
+void StaticStructureFactor::writeCheckpoint(util::ArrayFileWriter& writer)
+{
+    util::ManagedArray<float> counts;
+    counts.prepare(m_structure_factor.getAxisSizes());
+    m_local_structure_factor.reduceInto(counts);
+    writer.write("counts", counts);
+
+    util::ManagedArray<float> kstate;
+    kstate.prepare(1);
+    kstate[0] = m_min_valid_k;
+    writer.write("kstate", kstate);
+}
+
+void StaticStructureFactor::readCheckpoint(const util::ArrayFileReader& reader)
+{
+    const auto counts = reader.read<float>("counts");
+    const auto kstate = reader.read<float>("kstate");
+    if (counts.size() != m_structure_factor.size() || kstate.size() != 1)
+    {
+        throw std::runtime_error("Checkpoint does not match this compute's binning.");
+    }
+    // The canonical accumulation state lives in the thread-local copies
+    // (reduction sums them from scratch each time), so the restored counts
+    // are injected into one local copy for future frames to build on.
+    m_local_structure_factor.reset();
+    auto& local = m_local_structure_factor.local();
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        if (counts[i] != 0.0F)
+        {
+            local.increment(i, counts[i]);
+        }
+    }
+    m_min_valid_k = kstate[0];
+    m_reduce = true;
+}
+
 }; }; // namespace freud::diffraction
@@ -5,8 +5,11 @@
 #define STATIC_STRUCTURE_FACTOR_H
 
 #include <limits>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "ArrayFile.h"
 #include "Histogram.h"
 #include "ManagedArray.h"
 #include "NeighborQuery.h"
@@ -58,9 +61,66 @@ public:
         return m_min_valid_k;
     }
 
+    //! Track per-bin moments of the per-frame contributions to S(k).
+    /*! Enables single-pass error estimation: each k bin's mean and variance
+     *  across the accumulated frames are maintained online, avoiding
+     *  reanalysis over frame subsets. Frames are gathered into blocks of
+     *  block_size whose means serve as the samples (block averaging, for
+     *  correlated trajectory frames). Call before the first frame
+     *  accumulates.
+     */
+    void trackMoments(unsigned int block_size = 1)
+    {
+        m_moments.prepare(m_structure_factor.shape(), block_size);
+    }
+
+    //! Mean per-sample (block-averaged per-frame) contribution to each k bin.
+    const util::ManagedArray<float>& getBinMean()
+    {
+        requireMoments();
+        return m_moments.getMean();
+    }
+
+    //! Sample variance of the per-sample contribution to each k bin.
+    const util::ManagedArray<float>& getBinVariance()
+    {
+        requireMoments();
+        return m_moments.getVariance();
+    }
+
+    //! Number of complete blocks folded into the moments so far.
+    unsigned int getNumMomentSamples()
+    {
+        requireMoments();
+        return m_moments.getNumSamples();
+    }
+
+    //! Write a checkpoint of the accumulation state to a file.
+    /*! Snapshots everything needed to resume accumulating exactly where this
+     *  compute left off, so long accumulations in preemptible jobs can
+     *  restart from the last snapshot instead of from frame zero.
+     */
+    void checkpoint(const std::string& path);
+
+    //! Restore the accumulation state from a checkpoint file.
+    /*! Replaces any state accumulated so far; further frames accumulate on
+     *  top of the restored state. Throws if the checkpoint's binning does
+     *  not match this compute's.
+     */
+    void restore(const std::string& path);
+
 protected:
     virtual void reduce() = 0;
 
+    //! Write this compute's accumulation state into an open checkpoint file.
+    /*! Subclasses with accumulation state beyond the primary histogram
+     *  override this (and readCheckpoint) to add their own sections.
+     */
+    virtual void writeCheckpoint(util::ArrayFileWriter& writer);
+
+    //! Read this compute's accumulation state from an open checkpoint file.
+    virtual void readCheckpoint(const util::ArrayFileReader& reader);
+
     //! Return thing_to_return after reducing if necessary.
     template<typename U> U& reduceAndReturn(U& thing_to_return)
     {
@@ -72,9 +132,29 @@ protected:
         return thing_to_return;
     }
 
+    //! Throw unless moment tracking has been enabled.
+    void requireMoments() const
+    {
+        if (!m_moments.enabled())
+        {
+            throw std::runtime_error("Moment tracking was not enabled; call trackMoments first.");
+        }
+    }
+
+    //! Record one accumulated frame into the moments, if tracking is enabled.
+    /*! Subclasses call this once per frame, after their accumulation. */
+    void recordFrameMoments()
+    {
+        if (m_moments.enabled())
+        {
+            m_moments.recordFrame(m_local_structure_factor);
+        }
+    }
+
     StructureFactorHistogram m_structure_factor; //!< Histogram to hold computed structure factor
     StructureFactorHistogram::ThreadLocalHistogram
         m_local_structure_factor; //!< Thread local histograms for TBB parallelism
+    util::HistogramMoments<float> m_moments; //!< Optional per-bin moments across frames.
 
     bool m_reduce {true};                                         //! Whether to reduce local histograms
     float m_min_valid_k {std::numeric_limits<float>::infinity()}; //! Minimum valid k-vector magnitude
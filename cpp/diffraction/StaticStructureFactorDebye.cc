@@ -1,10 +1,19 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "BatchTrig.h"
 #include "NeighborQuery.h"
 #include "StaticStructureFactorDebye.h"
 #include "utils.h"
@@ -15,8 +24,9 @@
 
 namespace freud { namespace diffraction {
 
-StaticStructureFactorDebye::StaticStructureFactorDebye(unsigned int bins, float k_max, float k_min)
-    : StaticStructureFactor(bins, k_max, k_min)
+StaticStructureFactorDebye::StaticStructureFactorDebye(unsigned int bins, float k_max, float k_min,
+                                                       unsigned int num_distance_bins)
+    : StaticStructureFactor(bins, k_max, k_min), m_num_distance_bins(num_distance_bins)
 {}
 
 void StaticStructureFactorDebye::accumulate(const freud::locality::NeighborQuery* neighbor_query,
@@ -29,35 +39,299 @@ void StaticStructureFactorDebye::accumulate(const freud::locality::NeighborQuery
         throw std::invalid_argument("2D boxes are not currently supported.");
     }
 
+    const auto* const points = neighbor_query->getPoints();
+    const auto n_points = neighbor_query->getNPoints();
+
+    std::vector<float> distances(n_points * n_query_points);
+    box.computeAllDistances(points, n_points, query_points, n_query_points, distances.data());
+    accumulateDistances(distances, box, n_total);
+}
+
+void StaticStructureFactorDebye::accumulate(const freud::locality::NeighborQuery* neighbor_query,
+                                            const unsigned int* types, unsigned int n_types,
+                                            unsigned int n_total)
+{
+    const auto& box = neighbor_query->getBox();
+    if (box.is2D())
+    {
+        throw std::invalid_argument("2D boxes are not currently supported.");
+    }
+    if (n_types == 0)
+    {
+        throw std::invalid_argument("Partial structure factors require a nonzero number of types.");
+    }
+
+    if (m_partials.empty())
+    {
+        // Construct one sub-computation per unordered type pair with this
+        // object's parameters; each accumulates and reduces independently.
+        m_n_types = n_types;
+        const auto k_bin_edges = m_structure_factor.getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(m_structure_factor.getAxisSizes()[0]);
+        const auto n_pairs = size_t(n_types) * (n_types + 1) / 2;
+        for (size_t i = 0; i < n_pairs; i++)
+        {
+            m_partials.push_back(std::unique_ptr<StaticStructureFactorDebye>(new StaticStructureFactorDebye(
+                bins, k_bin_edges.back(), k_bin_edges.front(), m_num_distance_bins)));
+        }
+    }
+    else if (m_n_types != n_types)
+    {
+        throw std::invalid_argument("The number of types passed to StaticStructureFactorDebye has "
+                                    "changed. Call reset to start a new accumulation.");
+    }
+
+    const auto* const points = neighbor_query->getPoints();
+    const auto n_points = neighbor_query->getNPoints();
+
+    std::vector<float> distances(size_t(n_points) * n_points);
+    box.computeAllDistances(points, n_points, points, n_points, distances.data());
+
+    // Assign every (ordered) pair distance to its unordered type pair, so
+    // cross partials pick up both orderings and the partials sum to the
+    // total structure factor.
+    std::vector<std::vector<float>> pair_distances(m_partials.size());
+    for (size_t i = 0; i < n_points; ++i)
+    {
+        const auto type_i = types[i];
+        for (size_t j = 0; j < n_points; ++j)
+        {
+            pair_distances[pairIndex(type_i, types[j], n_types)].push_back(distances[i * n_points + j]);
+        }
+    }
+
+    for (size_t pair = 0; pair < m_partials.size(); ++pair)
+    {
+        m_partials[pair]->accumulateDistances(pair_distances[pair], box, n_total);
+    }
+}
+
+void StaticStructureFactorDebye::accumulateDistances(const std::vector<float>& distances,
+                                                     const box::Box& box, unsigned int n_total)
+{
     // The minimum valid k value is 4 * pi / L, where L is the smallest side length.
     const auto box_L = box.getL();
     const auto min_box_length
         = box.is2D() ? std::min(box_L.x, box_L.y) : std::min(box_L.x, std::min(box_L.y, box_L.z));
     m_min_valid_k = std::min(m_min_valid_k, 2 * freud::constants::TWO_PI / min_box_length);
 
-    const auto* const points = neighbor_query->getPoints();
-    const auto n_points = neighbor_query->getNPoints();
+    const auto k_bin_centers = m_structure_factor.getBinCenters()[0];
+    const auto n_k_bins = m_structure_factor.getAxisSizes()[0];
 
-    std::vector<float> distances(n_points * n_query_points);
-    box.computeAllDistances(points, n_points, query_points, n_query_points, distances.data());
+    // Evaluate the (optionally weighted) sinc sums over a set of distances.
+    // A null weights pointer means unit weights, which reproduces the exact
+    // Debye sum over raw pair distances.
+    const auto evaluate = [&](const float* values, const float* weights, size_t count) {
+#if defined(__AVX__)
+        // Parallelize over blocks of eight k bins so that each pass over the
+        // distances loads a distance once, broadcasts it, and reuses it
+        // across the whole block while the sinc evaluations run eight wide.
+        // Each lane keeps its own double accumulator, as in the scalar path.
+        // Blocking by the vector width here (rather than inside arbitrary
+        // partitioner chunks) guarantees full lanes for every block but the
+        // last.
+        const size_t n_k_blocks = (n_k_bins + 7) / 8;
+        util::forLoopWrapper(0, n_k_blocks, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block)
+            {
+                const size_t k_index = block * 8;
+                if (k_index + 8 <= n_k_bins)
+                {
+                    const __m256 k_block = _mm256_loadu_ps(k_bin_centers.data() + k_index);
+                    __m256d sum_lo = _mm256_setzero_pd();
+                    __m256d sum_hi = _mm256_setzero_pd();
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const __m256 s
+                            = util::sincBlock(_mm256_mul_ps(k_block, _mm256_set1_ps(values[i])));
+                        __m256d s_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(s));
+                        __m256d s_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(s, 1));
+                        if (weights != nullptr)
+                        {
+                            // Bin counts can be large, so weight in double.
+                            const __m256d w = _mm256_set1_pd(weights[i]);
+                            s_lo = _mm256_mul_pd(s_lo, w);
+                            s_hi = _mm256_mul_pd(s_hi, w);
+                        }
+                        sum_lo = _mm256_add_pd(sum_lo, s_lo);
+                        sum_hi = _mm256_add_pd(sum_hi, s_hi);
+                    }
+                    alignas(32) double sums[8];
+                    _mm256_store_pd(sums, sum_lo);
+                    _mm256_store_pd(sums + 4, sum_hi);
+                    for (size_t lane = 0; lane < 8; ++lane)
+                    {
+                        m_local_structure_factor.increment(k_index + lane,
+                                                           sums[lane] / static_cast<double>(n_total));
+                    }
+                }
+                else
+                {
+                    for (size_t tail_index = k_index; tail_index < n_k_bins; ++tail_index)
+                    {
+                        const auto k = k_bin_centers[tail_index];
+                        double S_k = 0.0;
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            const double w = (weights != nullptr) ? weights[i] : 1.0;
+                            S_k += w * util::sinc(k * values[i]);
+                        }
+                        S_k /= static_cast<double>(n_total);
+                        m_local_structure_factor.increment(tail_index, S_k);
+                    }
+                }
+            }
+        });
+#else
+        util::forLoopWrapper(0, n_k_bins, [&](size_t begin, size_t end) {
+            for (size_t k_index = begin; k_index < end; ++k_index)
+            {
+                const auto k = k_bin_centers[k_index];
+                double S_k = 0.0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const double w = (weights != nullptr) ? weights[i] : 1.0;
+                    S_k += w * util::sinc(k * values[i]);
+                }
+                S_k /= static_cast<double>(n_total);
+                m_local_structure_factor.increment(k_index, S_k);
+            };
+        });
+#endif
+    };
 
-    const auto k_bin_centers = m_structure_factor.getBinCenters()[0];
+    if (distances.empty())
+    {
+        // An empty distance set (e.g. a partial for a type pair with no
+        // particles this frame) contributes nothing but still counts as an
+        // accumulated frame.
+    }
+    else if (m_num_distance_bins > 0)
+    {
+        // Binned Debye engine: accumulate the pair distances into a fine
+        // histogram, then evaluate the sinc sums once per occupied distance
+        // bin with the bin count as the weight. This replaces
+        // O(pairs x k bins) sinc evaluations with O(distance bins x k bins)
+        // at an accuracy set by the bin width.
+        const float d_max = *std::max_element(distances.begin(), distances.end());
+        const auto axes = util::Axes {std::make_shared<util::RegularAxis>(
+            m_num_distance_bins, 0, std::nextafter(d_max, std::numeric_limits<float>::max()))};
+        auto distance_histogram = util::Histogram<unsigned int>(axes);
+        auto local_distance_histograms
+            = util::Histogram<unsigned int>::ThreadLocalHistogram(distance_histogram);
+        util::forLoopWrapper(0, distances.size(), [&](size_t begin, size_t end) {
+            auto& histogram = local_distance_histograms.local();
+            for (size_t i = begin; i < end; ++i)
+            {
+                histogram(distances[i]);
+            }
+        });
+        distance_histogram.prepare(m_num_distance_bins);
+        distance_histogram.reduceOverThreads(local_distance_histograms);
 
-    util::forLoopWrapper(0, m_structure_factor.getAxisSizes()[0], [&](size_t begin, size_t end) {
-        for (size_t k_index = begin; k_index < end; ++k_index)
+        // Compact to the occupied bins; for dilute systems most fine bins
+        // are empty and contribute nothing.
+        const auto distance_bin_centers = distance_histogram.getBinCenters()[0];
+        std::vector<float> binned_distances;
+        std::vector<float> bin_weights;
+        for (size_t i = 0; i < m_num_distance_bins; ++i)
         {
-            const auto k = k_bin_centers[k_index];
-            double S_k = 0.0;
-            for (const auto& distance : distances)
+            if (distance_histogram[i] != 0)
             {
-                S_k += util::sinc(k * distance);
+                binned_distances.push_back(distance_bin_centers[i]);
+                bin_weights.push_back(static_cast<float>(distance_histogram[i]));
             }
-            S_k /= static_cast<double>(n_total);
-            m_local_structure_factor.increment(k_index, S_k);
-        };
-    });
+        }
+        evaluate(binned_distances.data(), bin_weights.data(), binned_distances.size());
+    }
+    else
+    {
+        evaluate(distances.data(), nullptr, distances.size());
+    }
     m_frame_counter++;
     m_reduce = true;
+    recordFrameMoments();
+}
+
+void StaticStructureFactorDebye::writeCheckpoint(util::ArrayFileWriter& writer)
+{
+    StaticStructureFactor::writeCheckpoint(writer);
+
+    util::ManagedArray<unsigned int> meta;
+    meta.prepare(2);
+    meta[0] = m_frame_counter;
+    meta[1] = m_n_types;
+    writer.write("meta", meta);
+
+    // The partials are full sub-computations with their own bookkeeping (in
+    // typed mode only they see frames, not this object), so each stores its
+    // counts plus its frame counter and minimum valid k.
+    if (!m_partials.empty())
+    {
+        util::ManagedArray<unsigned int> partial_frames;
+        util::ManagedArray<float> partial_min_k;
+        partial_frames.prepare(m_partials.size());
+        partial_min_k.prepare(m_partials.size());
+        for (size_t i = 0; i < m_partials.size(); ++i)
+        {
+            util::ManagedArray<float> counts;
+            counts.prepare(m_partials[i]->m_structure_factor.getAxisSizes());
+            m_partials[i]->m_local_structure_factor.reduceInto(counts);
+            writer.write("p" + std::to_string(i), counts);
+            partial_frames[i] = m_partials[i]->m_frame_counter;
+            partial_min_k[i] = m_partials[i]->m_min_valid_k;
+        }
+        writer.write("pframes", partial_frames);
+        writer.write("pminvk", partial_min_k);
+    }
+}
+
+void StaticStructureFactorDebye::readCheckpoint(const util::ArrayFileReader& reader)
+{
+    StaticStructureFactor::readCheckpoint(reader);
+    const auto meta = reader.read<unsigned int>("meta");
+    if (meta.size() != 2)
+    {
+        throw std::runtime_error("Checkpoint does not match this compute's binning.");
+    }
+    m_frame_counter = meta[0];
+
+    m_partials.clear();
+    m_n_types = meta[1];
+    if (m_n_types != 0)
+    {
+        const auto k_bin_edges = m_structure_factor.getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(m_structure_factor.getAxisSizes()[0]);
+        const auto n_pairs = size_t(m_n_types) * (m_n_types + 1) / 2;
+        const auto partial_frames = reader.read<unsigned int>("pframes");
+        const auto partial_min_k = reader.read<float>("pminvk");
+        if (partial_frames.size() != n_pairs || partial_min_k.size() != n_pairs)
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        for (size_t i = 0; i < n_pairs; i++)
+        {
+            auto partial = std::unique_ptr<StaticStructureFactorDebye>(new StaticStructureFactorDebye(
+                bins, k_bin_edges.back(), k_bin_edges.front(), m_num_distance_bins));
+            const auto counts = reader.read<float>("p" + std::to_string(i));
+            if (counts.size() != partial->m_structure_factor.size())
+            {
+                throw std::runtime_error("Checkpoint does not match this compute's binning.");
+            }
+            auto& local = partial->m_local_structure_factor.local();
+            for (size_t j = 0; j < counts.size(); ++j)
+            {
+                if (counts[j] != 0.0F)
+                {
+                    local.increment(j, counts[j]);
+                }
+            }
+            partial->m_frame_counter = partial_frames[i];
+            partial->m_min_valid_k = partial_min_k[i];
+            partial->m_reduce = true;
+            m_partials.push_back(std::move(partial));
+        }
+    }
 }
 
 void StaticStructureFactorDebye::reduce()
@@ -4,7 +4,11 @@
 #ifndef STATIC_STRUCTURE_FACTOR_DEBYE_H
 #define STATIC_STRUCTURE_FACTOR_DEBYE_H
 
+#include <algorithm>
 #include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 #include "Histogram.h"
 #include "NeighborQuery.h"
@@ -23,12 +27,57 @@ class StaticStructureFactorDebye : public StaticStructureFactor
 {
 public:
     //! Constructor
-    StaticStructureFactorDebye(unsigned int bins, float k_max, float k_min = 0);
+    /*! \param bins Number of k bins.
+     *  \param k_max Maximum k value.
+     *  \param k_min Minimum k value.
+     *  \param num_distance_bins If nonzero, use the binned Debye engine:
+     *         pair distances are first accumulated into a fine histogram of
+     *         this many bins and S(k) is evaluated from the bin counts, so
+     *         the sinc evaluations cost O(distance bins x k bins) instead of
+     *         O(pairs x k bins). The approximation error is controlled by the
+     *         bin width; a few thousand bins reproduce the exact sum to float
+     *         accuracy. Zero (the default) keeps the exact evaluation.
+     */
+    StaticStructureFactorDebye(unsigned int bins, float k_max, float k_min = 0,
+                               unsigned int num_distance_bins = 0);
+
+    //! Get the number of distance bins used by the binned engine (0 if exact).
+    unsigned int getNumDistanceBins() const
+    {
+        return m_num_distance_bins;
+    }
 
     //! Compute the structure factor S(k) using the Debye formula
     void accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                     unsigned int n_query_points, unsigned int n_total) override;
 
+    //! Accumulate all partial structure factors S_ab(k) in one pass.
+    /*! Each pair distance of the system is assigned to the unordered pair of
+     *  its particles' types and accumulated into that pair's own structure
+     *  factor, so one traversal of the positions produces every partial.
+     *  Cross partials count both (a, b) and (b, a) pairs, so the partials
+     *  sum to the total structure factor. The number of types must not
+     *  change between accumulated frames.
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const unsigned int* types,
+                    unsigned int n_types, unsigned int n_total);
+
+    //! Get the number of types used for partial structure factors.
+    unsigned int getNumTypes() const
+    {
+        return m_n_types;
+    }
+
+    //! Get a reference to the last computed partial structure factor S_ab(k).
+    const util::ManagedArray<float>& getPartialStructureFactor(unsigned int type_a, unsigned int type_b)
+    {
+        if (type_a >= m_n_types || type_b >= m_n_types)
+        {
+            throw std::out_of_range("Type index exceeds the number of accumulated types.");
+        }
+        return m_partials[pairIndex(type_a, type_b, m_n_types)]->getStructureFactor();
+    }
+
     //! Reset the histogram to all zeros
     void reset() override
     {
@@ -36,13 +85,38 @@ public:
         m_frame_counter = 0;
         m_min_valid_k = std::numeric_limits<float>::infinity();
         m_reduce = true;
+        m_moments.reset();
+        for (auto& partial : m_partials)
+        {
+            partial->reset();
+        }
     }
 
+protected:
+    //! Checkpoint the frame counter and the partial structure factors as well.
+    void writeCheckpoint(util::ArrayFileWriter& writer) override;
+    void readCheckpoint(const util::ArrayFileReader& reader) override;
+
 private:
     //! Reduce thread-local arrays onto the primary data arrays.
     void reduce() override;
 
-    unsigned int m_frame_counter {0}; //!< Number of frames calculated
+    //! Accumulate a set of pair distances into this object's histogram.
+    void accumulateDistances(const std::vector<float>& distances, const box::Box& box,
+                             unsigned int n_total);
+
+    //! Linear index of the unordered type pair (a, b) among all pairs.
+    static size_t pairIndex(unsigned int type_a, unsigned int type_b, unsigned int n_types)
+    {
+        const size_t a = std::min(type_a, type_b);
+        const size_t b = std::max(type_a, type_b);
+        return a * n_types - a * (a - 1) / 2 + (b - a);
+    }
+
+    unsigned int m_frame_counter {0};     //!< Number of frames calculated
+    unsigned int m_num_distance_bins {0}; //!< Distance bins for the binned engine (0 if exact)
+    unsigned int m_n_types {0};           //!< Number of types for partial structure factors
+    std::vector<std::unique_ptr<StaticStructureFactorDebye>> m_partials; //!< Per-type-pair partials
 };
 
 }; }; // namespace freud::diffraction
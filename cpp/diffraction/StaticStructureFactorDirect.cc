@@ -4,8 +4,10 @@
 #include <cmath>
 #include <complex>
 #include <limits>
+#include <memory>
 #include <random>
 #include <stdexcept>
+#include <string>
 #include <tbb/concurrent_vector.h>
 
 #include "Eigen/Eigen/Dense"
@@ -29,16 +31,8 @@ StaticStructureFactorDirect::StaticStructureFactorDirect(unsigned int bins, floa
       m_local_k_histograms(KBinHistogram::ThreadLocalHistogram(m_k_histogram))
 {}
 
-void StaticStructureFactorDirect::accumulate(const freud::locality::NeighborQuery* neighbor_query,
-                                             const vec3<float>* query_points, unsigned int n_query_points,
-                                             unsigned int n_total)
+void StaticStructureFactorDirect::updateKPointTable(const box::Box& box)
 {
-    // Compute k vectors by sampling reciprocal space.
-    const auto& box = neighbor_query->getBox();
-    if (box.is2D())
-    {
-        throw std::invalid_argument("2D boxes are not currently supported.");
-    }
     const auto k_bin_edges = m_structure_factor.getBinEdges()[0];
     const auto k_min = k_bin_edges.front();
     const auto k_max = k_bin_edges.back();
@@ -47,8 +41,34 @@ void StaticStructureFactorDirect::accumulate(const freud::locality::NeighborQuer
         previous_box = box;
         m_k_points
             = StaticStructureFactorDirect::reciprocal_isotropic(box, k_max, k_min, m_num_sampled_k_points);
+        // Cache each k point's bin assignment along with the table itself.
+        // The assignments depend only on the sampled k points and the fixed
+        // histogram axes, so recomputing the magnitudes and bins on every
+        // frame of an accumulation is pure overhead.
+        m_k_point_bins.resize(m_k_points.size());
+        util::forLoopWrapper(0, m_k_points.size(), [&](size_t begin, size_t end) {
+            for (size_t k_index = begin; k_index < end; ++k_index)
+            {
+                const auto& k_vec = m_k_points[k_index];
+                const auto k_magnitude = std::sqrt(dot(k_vec, k_vec));
+                m_k_point_bins[k_index] = m_structure_factor.bin({k_magnitude});
+            }
+        });
         box_assigned = true;
     }
+}
+
+void StaticStructureFactorDirect::accumulate(const freud::locality::NeighborQuery* neighbor_query,
+                                             const vec3<float>* query_points, unsigned int n_query_points,
+                                             unsigned int n_total)
+{
+    // Compute k vectors by sampling reciprocal space.
+    const auto& box = neighbor_query->getBox();
+    if (box.is2D())
+    {
+        throw std::invalid_argument("2D boxes are not currently supported.");
+    }
+    updateKPointTable(box);
 
     // The minimum valid k value is 2 * pi / L, where L is the smallest side length.
     const auto box_L = box.getL();
@@ -73,13 +93,14 @@ void StaticStructureFactorDirect::accumulate(const freud::locality::NeighborQuer
         S_k_all_points = StaticStructureFactorDirect::compute_S_k(F_k_points, F_k_points);
     }
 
-    // Bin the S_k values and track the number of k values in each bin.
+    // Bin the S_k values and track the number of k values in each bin. The
+    // k points are split over threads, each accumulating into its local
+    // partial histograms, using the bin assignments cached with the k point
+    // table.
     util::forLoopWrapper(0, m_k_points.size(), [&](size_t begin, size_t end) {
         for (size_t k_index = begin; k_index < end; ++k_index)
         {
-            const auto& k_vec = m_k_points[k_index];
-            const auto k_magnitude = std::sqrt(dot(k_vec, k_vec));
-            const auto k_bin = m_structure_factor.bin({k_magnitude});
+            const auto k_bin = m_k_point_bins[k_index];
             m_local_structure_factor.increment(k_bin, S_k_all_points[k_index]);
             m_local_k_histograms.increment(k_bin);
         };
@@ -87,6 +108,191 @@ void StaticStructureFactorDirect::accumulate(const freud::locality::NeighborQuer
     m_reduce = true;
 }
 
+void StaticStructureFactorDirect::accumulate(const freud::locality::NeighborQuery* neighbor_query,
+                                             const unsigned int* types, unsigned int n_types,
+                                             unsigned int n_total)
+{
+    const auto& box = neighbor_query->getBox();
+    if (box.is2D())
+    {
+        throw std::invalid_argument("2D boxes are not currently supported.");
+    }
+    if (n_types == 0)
+    {
+        throw std::invalid_argument("Partial structure factors require a nonzero number of types.");
+    }
+
+    if (m_partials.empty())
+    {
+        // Construct one sub-computation per unordered type pair with this
+        // object's parameters; each accumulates and reduces independently.
+        m_n_types = n_types;
+        const auto k_bin_edges = m_structure_factor.getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(m_structure_factor.getAxisSizes()[0]);
+        const auto n_pairs = size_t(n_types) * (n_types + 1) / 2;
+        for (size_t i = 0; i < n_pairs; i++)
+        {
+            m_partials.push_back(std::unique_ptr<StaticStructureFactorDirect>(new StaticStructureFactorDirect(
+                bins, k_bin_edges.back(), k_bin_edges.front(), m_num_sampled_k_points)));
+        }
+    }
+    else if (m_n_types != n_types)
+    {
+        throw std::invalid_argument("The number of types passed to StaticStructureFactorDirect has "
+                                    "changed. Call reset to start a new accumulation.");
+    }
+
+    updateKPointTable(box);
+
+    // The minimum valid k value is 2 * pi / L, where L is the smallest side length.
+    const auto box_L = box.getL();
+    const auto min_box_length = std::min(box_L.x, std::min(box_L.y, box_L.z));
+    m_min_valid_k = std::min(m_min_valid_k, freud::constants::TWO_PI / min_box_length);
+
+    // Partition the points by type; one traversal of the positions serves
+    // every per-type amplitude computation.
+    const auto* const points = neighbor_query->getPoints();
+    const auto n_points = neighbor_query->getNPoints();
+    std::vector<std::vector<vec3<float>>> typed_points(n_types);
+    for (unsigned int i = 0; i < n_points; ++i)
+    {
+        typed_points[types[i]].push_back(points[i]);
+    }
+
+    // Compute the per-type scattering amplitudes over the shared k point table.
+    std::vector<std::vector<std::complex<float>>> F_k_types(n_types);
+    for (unsigned int t = 0; t < n_types; ++t)
+    {
+        F_k_types[t] = StaticStructureFactorDirect::compute_F_k(
+            typed_points[t].data(), static_cast<unsigned int>(typed_points[t].size()), n_total, m_k_points);
+    }
+
+    for (unsigned int type_a = 0; type_a < n_types; ++type_a)
+    {
+        for (unsigned int type_b = type_a; type_b < n_types; ++type_b)
+        {
+            auto& partial = *m_partials[pairIndex(type_a, type_b, n_types)];
+            const auto S_k_pair = compute_S_k(F_k_types[type_a], F_k_types[type_b]);
+            // Cross partials count both (a, b) and (b, a) orderings so that
+            // the partials sum to the total structure factor.
+            const float pair_weight = (type_a == type_b) ? float(1.0) : float(2.0);
+            util::forLoopWrapper(0, m_k_points.size(), [&](size_t begin, size_t end) {
+                for (size_t k_index = begin; k_index < end; ++k_index)
+                {
+                    const auto k_bin = m_k_point_bins[k_index];
+                    partial.m_local_structure_factor.increment(k_bin, pair_weight * S_k_pair[k_index]);
+                    partial.m_local_k_histograms.increment(k_bin);
+                }
+            });
+            partial.m_min_valid_k = m_min_valid_k;
+            partial.m_reduce = true;
+        }
+    }
+}
+
+void StaticStructureFactorDirect::writeCheckpoint(util::ArrayFileWriter& writer)
+{
+    StaticStructureFactor::writeCheckpoint(writer);
+
+    // The binned mean over sampled k points normalizes the structure factor
+    // in reduce, so the sampled-k counts are part of the accumulation state.
+    // The k point table itself is regenerated on the next box assignment.
+    util::ManagedArray<unsigned int> k_counts;
+    k_counts.prepare(m_structure_factor.getAxisSizes());
+    m_local_k_histograms.reduceInto(k_counts);
+    writer.write("kcounts", k_counts);
+
+    util::ManagedArray<unsigned int> meta;
+    meta.prepare(1);
+    meta[0] = m_n_types;
+    writer.write("meta", meta);
+
+    // In typed mode only the partials see frames, so each stores its own
+    // minimum valid k alongside its counts.
+    if (!m_partials.empty())
+    {
+        util::ManagedArray<float> partial_min_k;
+        partial_min_k.prepare(m_partials.size());
+        for (size_t i = 0; i < m_partials.size(); ++i)
+        {
+            util::ManagedArray<float> counts;
+            counts.prepare(m_partials[i]->m_structure_factor.getAxisSizes());
+            m_partials[i]->m_local_structure_factor.reduceInto(counts);
+            writer.write("p" + std::to_string(i), counts);
+
+            util::ManagedArray<unsigned int> partial_k_counts;
+            partial_k_counts.prepare(m_partials[i]->m_structure_factor.getAxisSizes());
+            m_partials[i]->m_local_k_histograms.reduceInto(partial_k_counts);
+            writer.write("pk" + std::to_string(i), partial_k_counts);
+            partial_min_k[i] = m_partials[i]->m_min_valid_k;
+        }
+        writer.write("pminvk", partial_min_k);
+    }
+}
+
+void StaticStructureFactorDirect::readCheckpoint(const util::ArrayFileReader& reader)
+{
+    StaticStructureFactor::readCheckpoint(reader);
+    const auto k_counts = reader.read<unsigned int>("kcounts");
+    const auto meta = reader.read<unsigned int>("meta");
+    if (k_counts.size() != m_structure_factor.size() || meta.size() != 1)
+    {
+        throw std::runtime_error("Checkpoint does not match this compute's binning.");
+    }
+    m_local_k_histograms.reset();
+    auto& local_k = m_local_k_histograms.local();
+    for (size_t i = 0; i < k_counts.size(); ++i)
+    {
+        if (k_counts[i] != 0)
+        {
+            local_k.increment(i, k_counts[i]);
+        }
+    }
+    box_assigned = false;
+
+    m_partials.clear();
+    m_n_types = meta[0];
+    if (m_n_types != 0)
+    {
+        const auto k_bin_edges = m_structure_factor.getBinEdges()[0];
+        const auto bins = static_cast<unsigned int>(m_structure_factor.getAxisSizes()[0]);
+        const auto n_pairs = size_t(m_n_types) * (m_n_types + 1) / 2;
+        const auto partial_min_k = reader.read<float>("pminvk");
+        if (partial_min_k.size() != n_pairs)
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        for (size_t i = 0; i < n_pairs; i++)
+        {
+            auto partial = std::unique_ptr<StaticStructureFactorDirect>(new StaticStructureFactorDirect(
+                bins, k_bin_edges.back(), k_bin_edges.front(), m_num_sampled_k_points));
+            const auto counts = reader.read<float>("p" + std::to_string(i));
+            const auto partial_k_counts = reader.read<unsigned int>("pk" + std::to_string(i));
+            if (counts.size() != partial->m_structure_factor.size()
+                || partial_k_counts.size() != partial->m_structure_factor.size())
+            {
+                throw std::runtime_error("Checkpoint does not match this compute's binning.");
+            }
+            auto& partial_local = partial->m_local_structure_factor.local();
+            auto& partial_local_k = partial->m_local_k_histograms.local();
+            for (size_t j = 0; j < counts.size(); ++j)
+            {
+                if (counts[j] != 0.0F)
+                {
+                    partial_local.increment(j, counts[j]);
+                }
+                if (partial_k_counts[j] != 0)
+                {
+                    partial_local_k.increment(j, partial_k_counts[j]);
+                }
+            }
+            partial->m_min_valid_k = partial_min_k[i];
+            partial->m_reduce = true;
+            m_partials.push_back(std::move(partial));
+        }
+    }
+}
+
 void StaticStructureFactorDirect::reduce()
 {
     const auto axis_size = m_structure_factor.getAxisSizes()[0];
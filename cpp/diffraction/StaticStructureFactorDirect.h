@@ -4,8 +4,11 @@
 #ifndef STATIC_STRUCTURE_FACTOR_DIRECT_H
 #define STATIC_STRUCTURE_FACTOR_DIRECT_H
 
+#include <algorithm>
 #include <complex>
 #include <limits>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include "Box.h"
@@ -54,6 +57,33 @@ public:
     void accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                     unsigned int n_query_points, unsigned int n_total) override;
 
+    //! Accumulate all partial structure factors S_ab(k) in one pass.
+    /*! The points are partitioned by type, one scattering amplitude is
+     *  computed per type over the shared k point table, and each unordered
+     *  type pair's amplitude product is binned into that pair's own
+     *  structure factor. Cross partials count both (a, b) and (b, a)
+     *  orderings, so the partials sum to the total structure factor. The
+     *  number of types must not change between accumulated frames.
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const unsigned int* types,
+                    unsigned int n_types, unsigned int n_total);
+
+    //! Get the number of types used for partial structure factors.
+    unsigned int getNumTypes() const
+    {
+        return m_n_types;
+    }
+
+    //! Get a reference to the last computed partial structure factor S_ab(k).
+    const util::ManagedArray<float>& getPartialStructureFactor(unsigned int type_a, unsigned int type_b)
+    {
+        if (type_a >= m_n_types || type_b >= m_n_types)
+        {
+            throw std::out_of_range("Type index exceeds the number of accumulated types.");
+        }
+        return m_partials[pairIndex(type_a, type_b, m_n_types)]->getStructureFactor();
+    }
+
     //! Reset the histogram to all zeros
     void reset() override
     {
@@ -62,6 +92,10 @@ public:
         m_min_valid_k = std::numeric_limits<float>::infinity();
         m_reduce = true;
         box_assigned = false;
+        for (auto& partial : m_partials)
+        {
+            partial->reset();
+        }
     }
 
     //! Get the number of sampled k points
@@ -76,10 +110,26 @@ public:
         return m_k_points;
     }
 
+protected:
+    //! Checkpoint the sampled-k histogram and the partial structure factors as well.
+    void writeCheckpoint(util::ArrayFileWriter& writer) override;
+    void readCheckpoint(const util::ArrayFileReader& reader) override;
+
 private:
     //! Reduce thread-local arrays onto the primary data arrays.
     void reduce() override;
 
+    //! Regenerate the k point table and its bin assignments on box change.
+    void updateKPointTable(const box::Box& box);
+
+    //! Linear index of the unordered type pair (a, b) among all pairs.
+    static size_t pairIndex(unsigned int type_a, unsigned int type_b, unsigned int n_types)
+    {
+        const size_t a = std::min(type_a, type_b);
+        const size_t b = std::max(type_a, type_b);
+        return a * n_types - a * (a - 1) / 2 + (b - a);
+    }
+
     //! Compute the complex amplitude F(k) for a set of points and k points
     static std::vector<std::complex<float>> compute_F_k(const vec3<float>* points, unsigned int n_points,
                                                         unsigned int n_total,
@@ -95,11 +145,14 @@ private:
 
     unsigned int m_num_sampled_k_points; //!< Target number of k-vectors to sample
     std::vector<vec3<float>> m_k_points; //!< k-vectors used for sampling
+    std::vector<size_t> m_k_point_bins;  //!< Cached histogram bin of each sampled k-vector
     KBinHistogram m_k_histogram;         //!< Histogram of sampled k bins, used to normalize S(q)
     KBinHistogram::ThreadLocalHistogram
         m_local_k_histograms;  //!< Thread local histograms of sampled k bins for TBB parallelism
     box::Box previous_box;     //!< box assigned to the system
     bool box_assigned {false}; //!< Whether to reuse the box
+    unsigned int m_n_types {0}; //!< Number of types for partial structure factors
+    std::vector<std::unique_ptr<StaticStructureFactorDirect>> m_partials; //!< Per-type-pair partials
 };
 
 }; }; // namespace freud::diffraction
@@ -1,6 +1,12 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #include "AngularSeparation.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
@@ -9,6 +15,54 @@
     \brief Compute the angular separation for each particle.
 */
 
+namespace {
+
+//! Maximum scalar part of a * b over a block of quaternion products b.
+/*! Evaluates s(a * b_k) = a.s * b_k.s - dot(a.v, b_k.v) for each product in
+ * the structure-of-arrays block, eight at a time, and returns the largest
+ * value found starting from init. The separation angle is monotone
+ * decreasing in this scalar part, so the minimum angle over a set of
+ * equivalent orientations follows from the maximum scalar part.
+ */
+inline float maxProductScalarPart(const quat<float>& a, const float* bs, const float* bx, const float* by,
+                                  const float* bz, unsigned int n, float init)
+{
+    float max_s = init;
+    unsigned int k = 0;
+#if defined(__AVX__)
+    if (n >= 8)
+    {
+        const __m256 as = _mm256_set1_ps(a.s);
+        const __m256 ax = _mm256_set1_ps(a.v.x);
+        const __m256 ay = _mm256_set1_ps(a.v.y);
+        const __m256 az = _mm256_set1_ps(a.v.z);
+        __m256 vmax = _mm256_set1_ps(init);
+        for (; k + 8 <= n; k += 8)
+        {
+            const __m256 s = _mm256_sub_ps(
+                _mm256_mul_ps(as, _mm256_loadu_ps(bs + k)),
+                _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, _mm256_loadu_ps(bx + k)),
+                                            _mm256_mul_ps(ay, _mm256_loadu_ps(by + k))),
+                              _mm256_mul_ps(az, _mm256_loadu_ps(bz + k))));
+            vmax = _mm256_max_ps(vmax, s);
+        }
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, vmax);
+        for (float lane : lanes)
+        {
+            max_s = std::max(max_s, lane);
+        }
+    }
+#endif
+    for (; k < n; ++k)
+    {
+        max_s = std::max(max_s, a.s * bs[k] - (a.v.x * bx[k] + a.v.y * by[k] + a.v.z * bz[k]));
+    }
+    return max_s;
+}
+
+}; // namespace
+
 namespace freud { namespace environment {
 
 float computeSeparationAngle(const quat<float>& ref_q, const quat<float>& q)
@@ -62,22 +116,44 @@ void AngularSeparationNeighbor::compute(const locality::NeighborQuery* nq, const
     const size_t tot_num_neigh = m_nlist.getNumBonds();
     m_angles.prepare(tot_num_neigh);
 
+    const quat<float> qconst = equiv_orientations[0];
     util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
+        // Products of each equivalent orientation with the conjugate of the
+        // current center orientation, staged in structure-of-arrays form;
+        // they are shared by every bond of the center.
+        std::vector<float> es(n_equiv_orientations);
+        std::vector<float> ex(n_equiv_orientations);
+        std::vector<float> ey(n_equiv_orientations);
+        std::vector<float> ez(n_equiv_orientations);
+
         size_t bond(m_nlist.find_first_index(begin));
         for (size_t i = begin; i < end; ++i)
         {
             quat<float> q = orientations[i];
+            const quat<float> ref_conj = conj(q);
+            for (unsigned int k = 0; k < n_equiv_orientations; ++k)
+            {
+                const quat<float> product = equiv_orientations[k] * ref_conj;
+                es[k] = product.s;
+                ex[k] = product.v.x;
+                ey[k] = product.v.y;
+                ez[k] = product.v.z;
+            }
 
             for (; bond < tot_num_neigh && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
             {
                 const size_t j(m_nlist.getNeighbors()(bond, 1));
                 quat<float> query_q = query_orientations[j];
 
-                float theta = computeMinSeparationAngle(q, query_q, equiv_orientations, n_equiv_orientations);
-                m_angles[bond] = theta;
+                // The candidate before any equivalent rotation is applied.
+                const float init = (query_q * ref_conj).s;
+                const quat<float> qtemp = query_q * conj(qconst);
+                const float max_s = maxProductScalarPart(qtemp, es.data(), ex.data(), ey.data(),
+                                                         ez.data(), n_equiv_orientations, init);
+                m_angles[bond] = float(2.0 * std::acos(util::clamp(max_s, -1, 1)));
             }
         }
-    });
+    }, m_loop_policy);
 }
 
 void AngularSeparationGlobal::compute(const quat<float>* global_orientations, unsigned int n_global,
@@ -87,19 +163,40 @@ void AngularSeparationGlobal::compute(const quat<float>* global_orientations, un
 {
     m_angles.prepare({n_points, n_global});
 
+    const quat<float> qconst = equiv_orientations[0];
     util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        // See AngularSeparationNeighbor::compute above: the
+        // equivalent-orientation products only depend on the current point's
+        // orientation.
+        std::vector<float> es(n_equiv_orientations);
+        std::vector<float> ex(n_equiv_orientations);
+        std::vector<float> ey(n_equiv_orientations);
+        std::vector<float> ez(n_equiv_orientations);
+
         for (size_t i = begin; i < end; ++i)
         {
             quat<float> q = orientations[i];
+            const quat<float> ref_conj = conj(q);
+            for (unsigned int k = 0; k < n_equiv_orientations; ++k)
+            {
+                const quat<float> product = equiv_orientations[k] * ref_conj;
+                es[k] = product.s;
+                ex[k] = product.v.x;
+                ey[k] = product.v.y;
+                ez[k] = product.v.z;
+            }
+
             for (unsigned int j = 0; j < n_global; j++)
             {
                 quat<float> global_q = global_orientations[j];
-                float theta
-                    = computeMinSeparationAngle(q, global_q, equiv_orientations, n_equiv_orientations);
-                m_angles(i, j) = theta;
+                const float init = (global_q * ref_conj).s;
+                const quat<float> qtemp = global_q * conj(qconst);
+                const float max_s = maxProductScalarPart(qtemp, es.data(), ex.data(), ey.data(),
+                                                         ez.data(), n_equiv_orientations, init);
+                m_angles(i, j) = float(2.0 * std::acos(util::clamp(max_s, -1, 1)));
             }
         }
-    });
+    }, m_loop_policy);
 }
 
 }; }; // end namespace freud::environment
@@ -7,6 +7,7 @@
 #include "NeighborList.h"
 #include "NeighborQuery.h"
 #include "VectorMath.h"
+#include "utils.h"
 
 /*! \file AngularSeparation.h
     \brief Compute the angular separations.
@@ -43,6 +44,10 @@ public:
 
 private:
     util::ManagedArray<float> m_angles; //!< Global angle array computed
+    //! Measured-grain, cache-affine scheduling: the per-point work is tiny,
+    //! so default partitioning undersplits, and repeated calls iterate the
+    //! same range.
+    util::LoopPolicy m_loop_policy {util::LoopPolicy::AUTO_GRAIN, true};
 };
 
 //! Compute the difference in orientation between pairs of points.
@@ -81,6 +86,8 @@ public:
 private:
     util::ManagedArray<float> m_angles; //!< neighbor angle array computed
     locality::NeighborList m_nlist;     //!< The NeighborList used in the last call to compute.
+    //! See AngularSeparationGlobal: light per-point work iterated every frame.
+    util::LoopPolicy m_loop_policy {util::LoopPolicy::AUTO_GRAIN, true};
 };
 
 }; }; // end namespace freud::environment
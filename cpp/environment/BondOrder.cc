@@ -2,11 +2,17 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <cmath>
+#include <memory>
 #include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
+#include "BatchTrig.h"
 #include "BondOrder.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
@@ -15,6 +21,96 @@
     \brief Compute the bond order diagram for the system of particles.
 */
 
+namespace {
+
+//! Number of bonds staged per thread before the fused binning kernel runs.
+constexpr size_t BOND_BLOCK_SIZE = 8;
+
+//! Per-thread staging buffer of mode-rotated bond vectors.
+struct BondBlock
+{
+    float x[BOND_BLOCK_SIZE];
+    float y[BOND_BLOCK_SIZE];
+    float z[BOND_BLOCK_SIZE];
+    size_t count = 0;
+};
+
+//! Bin a staged block of mode-rotated bond vectors into the histogram.
+/*! Fuses both inverse trigonometric evaluations and the two RegularAxis
+ * binning steps over eight bonds at a time; the counts are scattered
+ * serially per lane since increments to arbitrary bins cannot be vectorized
+ * without conflict detection. Out-of-range angles are dropped and the top
+ * bin edge is clamped exactly like RegularAxis::bin(), so only the float
+ * accuracy of the polynomial atan2/acos distinguishes the result from
+ * feeding each bond through the histogram.
+ */
+void binBondBlock(const float* vx, const float* vy, const float* vz, size_t count, size_t n_bins_theta,
+                  size_t n_bins_phi, float inverse_dt, float inverse_dp,
+                  freud::util::Histogram<unsigned int>& hist)
+{
+    size_t b = 0;
+#if defined(__AVX__)
+    if (count == BOND_BLOCK_SIZE)
+    {
+        const __m256 x = _mm256_loadu_ps(vx);
+        const __m256 y = _mm256_loadu_ps(vy);
+        const __m256 z = _mm256_loadu_ps(vz);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 two_pi = _mm256_set1_ps(freud::constants::TWO_PI);
+        const __m256 pi = _mm256_set1_ps(M_PI);
+        __m256 theta = freud::util::atan2Block(y, x);
+        // Wrap -Pi..Pi into 0..2*Pi like util::modulusPositive.
+        theta = _mm256_add_ps(theta, _mm256_and_ps(_mm256_cmp_ps(theta, zero, _CMP_LT_OQ), two_pi));
+        const __m256 r2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+                                        _mm256_mul_ps(z, z));
+        const __m256 one = _mm256_set1_ps(1.0F);
+        // Clamp against roundoff pushing z/r outside the domain of acos.
+        const __m256 cos_phi = _mm256_max_ps(
+            _mm256_min_ps(_mm256_div_ps(z, _mm256_sqrt_ps(r2)), one), _mm256_sub_ps(zero, one));
+        const __m256 phi = freud::util::acosBlock(cos_phi);
+        const __m256 in_range = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(theta, zero, _CMP_GE_OQ), _mm256_cmp_ps(theta, two_pi, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(phi, zero, _CMP_GE_OQ), _mm256_cmp_ps(phi, pi, _CMP_LT_OQ)));
+        const int mask = _mm256_movemask_ps(in_range);
+        alignas(32) int theta_bins[BOND_BLOCK_SIZE];
+        alignas(32) int phi_bins[BOND_BLOCK_SIZE];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(theta_bins),
+                           _mm256_cvttps_epi32(_mm256_mul_ps(theta, _mm256_set1_ps(inverse_dt))));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(phi_bins),
+                           _mm256_cvttps_epi32(_mm256_mul_ps(phi, _mm256_set1_ps(inverse_dp))));
+        for (int lane = 0; lane < int(BOND_BLOCK_SIZE); ++lane)
+        {
+            if ((mask & (1 << lane)) != 0)
+            {
+                size_t theta_bin = theta_bins[lane];
+                size_t phi_bin = phi_bins[lane];
+                // Avoid rounding leading to overflow.
+                if (theta_bin == n_bins_theta)
+                {
+                    --theta_bin;
+                }
+                if (phi_bin == n_bins_phi)
+                {
+                    --phi_bin;
+                }
+                hist.increment(theta_bin * n_bins_phi + phi_bin);
+            }
+        }
+        b = count;
+    }
+#endif
+    for (; b < count; ++b)
+    {
+        const vec3<float> v(vx[b], vy[b], vz[b]);
+        float theta = std::atan2(v.y, v.x); //-Pi..Pi
+        theta = freud::util::modulusPositive(theta, freud::constants::TWO_PI);
+        const float phi = std::acos(v.z / std::sqrt(dot(v, v))); // 0..Pi
+        hist(theta, phi);
+    }
+}
+
+}; // namespace
+
 namespace freud { namespace environment {
 
 BondOrder::BondOrder(unsigned int n_bins_theta, unsigned int n_bins_phi, BondOrderMode mode)
@@ -78,31 +174,26 @@ const util::ManagedArray<float>& BondOrder::getBondOrder()
     return reduceAndReturn(m_bo_array);
 }
 
-void BondOrder::accumulate(const locality::NeighborQuery* neighbor_query, quat<float>* orientations,
-                           vec3<float>* query_points, quat<float>* query_orientations,
-                           unsigned int n_query_points, const freud::locality::NeighborList* nlist,
-                           freud::locality::QueryArgs qargs)
+template<BondOrderMode Mode>
+void BondOrder::accumulateMode(const locality::NeighborQuery* neighbor_query, quat<float>* orientations,
+                               vec3<float>* query_points, quat<float>* query_orientations,
+                               unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                               freud::locality::QueryArgs qargs)
 {
+    const auto& theta_axis = dynamic_cast<const util::RegularAxis&>(*m_histogram.getAxes()[0]);
+    const auto& phi_axis = dynamic_cast<const util::RegularAxis&>(*m_histogram.getAxes()[1]);
+    const size_t n_bins_theta = theta_axis.size();
+    const size_t n_bins_phi = phi_axis.size();
+    const float inverse_dt = theta_axis.getInverseBinWidth();
+    const float inverse_dp = phi_axis.getInverseBinWidth();
+
+    tbb::enumerable_thread_specific<BondBlock> blocks;
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [&](const freud::locality::NeighborBond& neighbor_bond) {
                           const quat<float>& ref_q(orientations[neighbor_bond.point_idx]);
-                          vec3<float> v(bondVector(neighbor_bond, neighbor_query, query_points));
                           const quat<float>& q = query_orientations[neighbor_bond.query_point_idx];
-                          if (m_mode == obcd)
-                          {
-                              // give bond directions of neighboring particles rotated by the matrix
-                              // that takes the orientation of particle neighbor_bond.id to the orientation of
-                              // particle neighbor_bond.ref_id.
-                              v = rotate(conj(ref_q), v);
-                              v = rotate(q, v);
-                          }
-                          else if (m_mode == lbod)
-                          {
-                              // give bond directions of neighboring particles rotated into the
-                              // local orientation of the central particle.
-                              v = rotate(conj(ref_q), v);
-                          }
-                          else if (m_mode == oocd)
+                          vec3<float> v;
+                          if (Mode == oocd)
                           {
                               // give the directors of neighboring particles rotated into the local
                               // orientation of the central particle. pick a (random vector)
@@ -113,18 +204,140 @@ void BondOrder::accumulate(const locality::NeighborQuery* neighbor_query, quat<f
                               // the central particle
                               v = rotate(conj(ref_q), z);
                           }
+                          else
+                          {
+                              v = bondVector(neighbor_bond, neighbor_query, query_points);
+                              if (Mode == obcd)
+                              {
+                                  // give bond directions of neighboring particles rotated by the matrix
+                                  // that takes the orientation of particle neighbor_bond.id to the
+                                  // orientation of particle neighbor_bond.ref_id.
+                                  v = rotate(conj(ref_q), v);
+                                  v = rotate(q, v);
+                              }
+                              else if (Mode == lbod)
+                              {
+                                  // give bond directions of neighboring particles rotated into the
+                                  // local orientation of the central particle.
+                                  v = rotate(conj(ref_q), v);
+                              }
+                          }
 
                           // NOTE that angles are defined in the "mathematical" way, rather than how
-                          // most physics textbooks do it. get theta (azimuthal angle), phi (polar
-                          // angle)
-                          float theta = std::atan2(v.y, v.x); //-Pi..Pi
-                          theta = util::modulusPositive(theta, constants::TWO_PI);
+                          // most physics textbooks do it. theta (azimuthal angle) and phi (polar
+                          // angle) are found by the binning kernel once a full block is staged.
+                          BondBlock& block = blocks.local();
+                          block.x[block.count] = v.x;
+                          block.y[block.count] = v.y;
+                          block.z[block.count] = v.z;
+                          if (++block.count == BOND_BLOCK_SIZE)
+                          {
+                              binBondBlock(block.x, block.y, block.z, block.count, n_bins_theta,
+                                           n_bins_phi, inverse_dt, inverse_dp, m_local_histograms.local());
+                              block.count = 0;
+                          }
+                      });
+    // Drain the partially filled per-thread blocks. This runs serially after
+    // the parallel loop, and the reduction sums over every thread's local
+    // histogram, so the calling thread's copy is a valid target for all of
+    // the leftovers.
+    for (auto& block : blocks)
+    {
+        binBondBlock(block.x, block.y, block.z, block.count, n_bins_theta, n_bins_phi, inverse_dt,
+                     inverse_dp, m_local_histograms.local());
+        block.count = 0;
+    }
+}
 
-                          // NOTE that the below has replaced the commented out expression for phi.
-                          float phi = std::acos(v.z / std::sqrt(dot(v, v))); // 0..Pi
+locality::BondConsumer BondOrder::makeBondConsumer(const locality::NeighborQuery* neighbor_query,
+                                                   quat<float>* orientations, vec3<float>* query_points,
+                                                   quat<float>* query_orientations)
+{
+    const auto& theta_axis = dynamic_cast<const util::RegularAxis&>(*m_histogram.getAxes()[0]);
+    const auto& phi_axis = dynamic_cast<const util::RegularAxis&>(*m_histogram.getAxes()[1]);
+    const size_t n_bins_theta = theta_axis.size();
+    const size_t n_bins_phi = phi_axis.size();
+    const float inverse_dt = theta_axis.getInverseBinWidth();
+    const float inverse_dp = phi_axis.getInverseBinWidth();
+    // The staging blocks are shared between the per-bond kernel and the
+    // drain, and must outlive this call; the consumer's lambdas keep them
+    // alive for the duration of the composite's traversal.
+    auto blocks = std::make_shared<tbb::enumerable_thread_specific<BondBlock>>();
 
-                          m_local_histograms(theta, phi);
-                      });
+    locality::BondConsumer consumer;
+    consumer.compute = this;
+    consumer.bond = [this, blocks, neighbor_query, orientations, query_points, query_orientations,
+                     n_bins_theta, n_bins_phi, inverse_dt,
+                     inverse_dp](const freud::locality::NeighborBond& neighbor_bond) {
+        const quat<float>& ref_q(orientations[neighbor_bond.point_idx]);
+        const quat<float>& q = query_orientations[neighbor_bond.query_point_idx];
+        vec3<float> v;
+        if (m_mode == oocd)
+        {
+            vec3<float> z(0, 0, 1);
+            z = rotate(q, z);
+            v = rotate(conj(ref_q), z);
+        }
+        else
+        {
+            v = bondVector(neighbor_bond, neighbor_query, query_points);
+            if (m_mode == obcd)
+            {
+                v = rotate(conj(ref_q), v);
+                v = rotate(q, v);
+            }
+            else if (m_mode == lbod)
+            {
+                v = rotate(conj(ref_q), v);
+            }
+        }
+        BondBlock& block = blocks->local();
+        block.x[block.count] = v.x;
+        block.y[block.count] = v.y;
+        block.z[block.count] = v.z;
+        if (++block.count == BOND_BLOCK_SIZE)
+        {
+            binBondBlock(block.x, block.y, block.z, block.count, n_bins_theta, n_bins_phi, inverse_dt,
+                         inverse_dp, m_local_histograms.local());
+            block.count = 0;
+        }
+    };
+    consumer.drain = [this, blocks, n_bins_theta, n_bins_phi, inverse_dt, inverse_dp]() {
+        for (auto& block : *blocks)
+        {
+            binBondBlock(block.x, block.y, block.z, block.count, n_bins_theta, n_bins_phi, inverse_dt,
+                         inverse_dp, m_local_histograms.local());
+            block.count = 0;
+        }
+    };
+    return consumer;
+}
+
+void BondOrder::accumulate(const locality::NeighborQuery* neighbor_query, quat<float>* orientations,
+                           vec3<float>* query_points, quat<float>* query_orientations,
+                           unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                           freud::locality::QueryArgs qargs)
+{
+    // Resolve the mode once so the per-bond path is branch-free.
+    switch (m_mode)
+    {
+    case bod:
+        accumulateMode<bod>(neighbor_query, orientations, query_points, query_orientations, n_query_points,
+                            nlist, qargs);
+        break;
+    case lbod:
+        accumulateMode<lbod>(neighbor_query, orientations, query_points, query_orientations,
+                             n_query_points, nlist, qargs);
+        break;
+    case obcd:
+        accumulateMode<obcd>(neighbor_query, orientations, query_points, query_orientations,
+                             n_query_points, nlist, qargs);
+        break;
+    case oocd:
+        accumulateMode<oocd>(neighbor_query, orientations, query_points, query_orientations,
+                             n_query_points, nlist, qargs);
+        break;
+    }
 }
 
 }; }; // end namespace freud::environment
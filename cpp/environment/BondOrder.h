@@ -6,6 +6,7 @@
 
 #include "BondHistogramCompute.h"
 #include "Box.h"
+#include "CompositeCompute.h"
 #include "Histogram.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
@@ -44,6 +45,17 @@ public:
                     vec3<float>* query_points, quat<float>* query_orientations, unsigned int n_query_points,
                     const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
 
+    //! Get this compute's per-bond kernel for a shared traversal.
+    /*! The returned consumer performs the same staged accumulation as
+     *  accumulate (with the mode resolved per bond rather than hoisted);
+     *  registering it with a CompositeCompute lets the bond order share one
+     *  neighbor traversal with other computes on the same frame. The input
+     *  arrays must stay alive until the composite's accumulate call returns.
+     */
+    locality::BondConsumer makeBondConsumer(const locality::NeighborQuery* neighbor_query,
+                                            quat<float>* orientations, vec3<float>* query_points,
+                                            quat<float>* query_orientations);
+
     void reduce() override;
 
     //! Get a reference to the last computed bond order
@@ -55,6 +67,17 @@ public:
     }
 
 private:
+    //! Implementation of accumulate with the mode fixed at compile time.
+    /*! Templating on the mode hoists the per-bond quaternion-rotation
+     *  dispatch out of the inner loop; accumulate() selects the
+     *  instantiation once per call.
+     */
+    template<BondOrderMode Mode>
+    void accumulateMode(const locality::NeighborQuery* neighbor_query, quat<float>* orientations,
+                        vec3<float>* query_points, quat<float>* query_orientations,
+                        unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                        freud::locality::QueryArgs qargs);
+
     util::ManagedArray<float> m_bo_array; //!< bond order array computed
     util::ManagedArray<float> m_sa_array; //!< surface area array computed
     BondOrderMode m_mode;                 //!< The mode to calculate with.
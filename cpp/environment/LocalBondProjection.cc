@@ -1,6 +1,13 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is part of the freud project, released under the BSD 3-Clause License.
 
+#include <limits>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #include "LocalBondProjection.h"
 #include "NeighborComputeFunctional.h"
 
@@ -9,6 +16,50 @@
     set of reference vectors, defined in the particles' local reference frame.
 */
 
+namespace {
+
+//! Maximum dot product of a vector against a structure-of-arrays block.
+/*! Evaluates dot((x_k, y_k, z_k), b) eight vectors at a time and returns the
+ * largest value. The blocks hold the symmetry-rotated copies of a projection
+ * vector, which only depend on the frame's equivalent orientations and are
+ * precomputed once rather than rotated per bond.
+ */
+inline float maxDotBlock(const vec3<float>& b, const float* x, const float* y, const float* z,
+                         unsigned int n)
+{
+    float max_dot = -std::numeric_limits<float>::infinity();
+    unsigned int k = 0;
+#if defined(__AVX__)
+    if (n >= 8)
+    {
+        const __m256 bx = _mm256_set1_ps(b.x);
+        const __m256 by = _mm256_set1_ps(b.y);
+        const __m256 bz = _mm256_set1_ps(b.z);
+        __m256 vmax = _mm256_set1_ps(max_dot);
+        for (; k + 8 <= n; k += 8)
+        {
+            const __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(x + k), bx),
+                                                         _mm256_mul_ps(_mm256_loadu_ps(y + k), by)),
+                                           _mm256_mul_ps(_mm256_loadu_ps(z + k), bz));
+            vmax = _mm256_max_ps(vmax, d);
+        }
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, vmax);
+        for (float lane : lanes)
+        {
+            max_dot = std::max(max_dot, lane);
+        }
+    }
+#endif
+    for (; k < n; ++k)
+    {
+        max_dot = std::max(max_dot, x[k] * b.x + y[k] * b.y + z[k] * b.z);
+    }
+    return max_dot;
+}
+
+}; // namespace
+
 namespace freud { namespace environment {
 
 // The set of all equivalent quaternions equiv_qs is the set that takes the particle as it
@@ -61,6 +112,34 @@ void LocalBondProjection::compute(const locality::NeighborQuery* nq, const quat<
     m_local_bond_proj.prepare({tot_num_neigh, n_proj});
     m_local_bond_proj_norm.prepare({tot_num_neigh, n_proj});
 
+    // The symmetry-rotated copies of the projection vectors do not depend on
+    // the bond, so compute them once per frame instead of rotating inside
+    // computeMaxProjection per bond. Each projection vector's row starts with
+    // the unrotated vector, matching the starting candidate of
+    // computeMaxProjection, followed by its image under each equivalent
+    // orientation.
+    const quat<float> qconst = equiv_orientations[0];
+    const unsigned int n_rotated = n_equiv_orientations + 1;
+    std::vector<float> px(size_t(n_proj) * n_rotated);
+    std::vector<float> py(size_t(n_proj) * n_rotated);
+    std::vector<float> pz(size_t(n_proj) * n_rotated);
+    for (unsigned int k = 0; k < n_proj; k++)
+    {
+        const size_t row = size_t(k) * n_rotated;
+        px[row] = proj_vecs[k].x;
+        py[row] = proj_vecs[k].y;
+        pz[row] = proj_vecs[k].z;
+        for (unsigned int e = 0; e < n_equiv_orientations; e++)
+        {
+            // here we undo a rotation represented by one of the equivalent orientations
+            const quat<float> qtest = conj(qconst) * equiv_orientations[e];
+            const vec3<float> equiv_proj_vec = rotate(qtest, proj_vecs[k]);
+            px[row + 1 + e] = equiv_proj_vec.x;
+            py[row + 1 + e] = equiv_proj_vec.y;
+            pz[row + 1 + e] = equiv_proj_vec.z;
+        }
+    }
+
     // compute the order parameter
     util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
         size_t bond(m_nlist.find_first_index(begin));
@@ -79,9 +158,10 @@ void LocalBondProjection::compute(const locality::NeighborQuery* nq, const quat<
 
                 for (unsigned int k = 0; k < n_proj; k++)
                 {
-                    vec3<float> proj_vec = proj_vecs[k];
-                    float max_proj = computeMaxProjection(proj_vec, local_bond, equiv_orientations,
-                                                          n_equiv_orientations);
+                    const size_t row = size_t(k) * n_rotated;
+                    const float max_proj
+                        = maxDotBlock(local_bond, px.data() + row, py.data() + row, pz.data() + row,
+                                      n_rotated);
                     m_local_bond_proj(bond, k) = max_proj;
                     m_local_bond_proj_norm(bond, k) = max_proj / local_bond_len;
                 }
@@ -1,16 +1,93 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <cmath>
 #include <vector>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "BatchedYlmEvaluator.h"
 #include "LocalDescriptors.h"
 #include "NeighborComputeFunctional.h"
 #include "diagonalize.h"
+#include "utils.h"
 
 /*! \file LocalDescriptors.cc
   \brief Computes local descriptors.
 */
 
+namespace {
+
+//! Rotate a block of bond vectors into the local frame and find their angles.
+/*! Applies the rotation whose rows are given to the count staged bond
+ *  vectors and writes the polar and azimuthal angles of the rotated bonds.
+ *  The rotation and radii run across SIMD lanes; the inverse trigonometry is
+ *  evaluated per bond from the stored lanes.
+ */
+inline void rotateBlockToAngles(const vec3<float>& rotation_0, const vec3<float>& rotation_1,
+                                const vec3<float>& rotation_2, const float* rx, const float* ry,
+                                const float* rz, size_t count, float* polars, float* azimuths)
+{
+    alignas(32) float bx[freud::order::YLM_BATCH_SIZE];
+    alignas(32) float by[freud::order::YLM_BATCH_SIZE];
+    alignas(32) float bz[freud::order::YLM_BATCH_SIZE];
+    alignas(32) float r2[freud::order::YLM_BATCH_SIZE];
+    size_t b = 0;
+#if defined(__AVX__)
+    if (count == freud::order::YLM_BATCH_SIZE)
+    {
+        const __m256 vx = _mm256_loadu_ps(rx);
+        const __m256 vy = _mm256_loadu_ps(ry);
+        const __m256 vz = _mm256_loadu_ps(rz);
+        const __m256 vbx = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(rotation_0.x), vx),
+                          _mm256_mul_ps(_mm256_set1_ps(rotation_0.y), vy)),
+            _mm256_mul_ps(_mm256_set1_ps(rotation_0.z), vz));
+        const __m256 vby = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(rotation_1.x), vx),
+                          _mm256_mul_ps(_mm256_set1_ps(rotation_1.y), vy)),
+            _mm256_mul_ps(_mm256_set1_ps(rotation_1.z), vz));
+        const __m256 vbz = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(rotation_2.x), vx),
+                          _mm256_mul_ps(_mm256_set1_ps(rotation_2.y), vy)),
+            _mm256_mul_ps(_mm256_set1_ps(rotation_2.z), vz));
+        _mm256_store_ps(bx, vbx);
+        _mm256_store_ps(by, vby);
+        _mm256_store_ps(bz, vbz);
+        _mm256_store_ps(r2,
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vbx, vbx), _mm256_mul_ps(vby, vby)),
+                                      _mm256_mul_ps(vbz, vbz)));
+        b = count;
+    }
+#endif
+    for (; b < count; ++b)
+    {
+        const vec3<float> r_ij(rx[b], ry[b], rz[b]);
+        bx[b] = dot(rotation_0, r_ij);
+        by[b] = dot(rotation_1, r_ij);
+        bz[b] = dot(rotation_2, r_ij);
+        r2[b] = bx[b] * bx[b] + by[b] * by[b] + bz[b] * bz[b];
+    }
+    for (b = 0; b < count; ++b)
+    {
+        const float magR = std::sqrt(r2[b]);
+        // The azimuth only enters Ylm as exp(i * m * azimuth), so the
+        // -Pi..Pi range of atan2 gives the same results as 0..2*Pi.
+        azimuths[b] = std::atan2(by[b], bx[b]);
+        // Clamp against roundoff pushing bz/magR outside the domain of acos
+        // for bonds aligned with z; a zero-length bond gets a zero angle.
+        polars[b] = std::acos(freud::util::clamp(bz[b] / magR, -1, 1));
+        if (magR == float(0))
+        {
+            polars[b] = 0;
+        }
+    }
+}
+
+} // namespace
+
 namespace freud { namespace environment {
 
 LocalDescriptors::LocalDescriptors(unsigned int l_max, bool negative_m,
@@ -30,10 +107,51 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
     {
         max_num_neighbors = std::numeric_limits<unsigned int>::max();
     }
-    m_sphArray.prepare({m_nlist.getNumBonds(), getSphWidth()});
+    const unsigned int sph_width = getSphWidth();
+    m_sphArray.prepare({m_nlist.getNumBonds(), sph_width});
+
+    // One batched evaluator over every l up to m_l_max, shared by all threads.
+    std::vector<unsigned int> ls(m_l_max + 1);
+    for (unsigned int l = 0; l <= m_l_max; ++l)
+    {
+        ls[l] = l;
+    }
+    const order::BatchedYlmEvaluator ylm_evaluator(ls);
+
+    // Map the evaluator's per-l output index k to the column of m_sphArray
+    // and the sign matching the stored convention: for each l the values for
+    // m = 0, ..., l come first, followed by m = -1, ..., -l when negative m
+    // is requested, and positive m is stored without the Condon-Shortley
+    // phase the evaluator includes.
+    std::vector<std::vector<int>> columns(m_l_max + 1);
+    std::vector<std::vector<float>> column_signs(m_l_max + 1);
+    unsigned int column = 0;
+    for (unsigned int l = 0; l <= m_l_max; ++l)
+    {
+        columns[l].assign(2 * size_t(l) + 1, -1);
+        column_signs[l].assign(2 * size_t(l) + 1, 1.0F);
+        for (unsigned int m = 0; m <= l; ++m)
+        {
+            columns[l][m] = int(column++);
+            column_signs[l][m] = (m % 2 == 1) ? -1.0F : 1.0F;
+        }
+        if (m_negative_m)
+        {
+            for (unsigned int m = 1; m <= l; ++m)
+            {
+                columns[l][l + m] = int(column++);
+            }
+        }
+    }
 
     util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
-        fsph::PointSPHEvaluator<float> sph_eval(m_l_max);
+        // Staged bond vectors and angles of the current block.
+        float rxs[order::YLM_BATCH_SIZE];
+        float rys[order::YLM_BATCH_SIZE];
+        float rzs[order::YLM_BATCH_SIZE];
+        float polars[order::YLM_BATCH_SIZE];
+        float azimuths[order::YLM_BATCH_SIZE];
+        size_t bond_rows[order::YLM_BATCH_SIZE];
 
         for (size_t i = begin; i < end; ++i)
         {
@@ -99,38 +217,44 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
                 throw std::runtime_error("Uncaught orientation mode in LocalDescriptors::compute");
             }
 
+            // Rotate the staged bonds into the local frame and write their
+            // spherical harmonics directly into the rows of m_sphArray.
+            size_t staged = 0;
+            const auto flush = [&]() {
+                rotateBlockToAngles(rotation_0, rotation_1, rotation_2, rxs, rys, rzs, staged, polars,
+                                    azimuths);
+                ylm_evaluator.evaluateEach(
+                    polars, azimuths, staged,
+                    [&](size_t b, int /*l_index*/, unsigned int l, unsigned int k, float re, float im) {
+                        const int col = columns[l][k];
+                        if (col < 0)
+                        {
+                            return;
+                        }
+                        const float sign = column_signs[l][k];
+                        m_sphArray[bond_rows[b] * sph_width + col]
+                            = std::complex<float>(sign * re, sign * im);
+                    });
+                staged = 0;
+            };
+
             neighbor_count = 0;
             for (; bond < m_nlist.getNumBonds() && m_nlist.getNeighbors()(bond, 0) == i
                  && neighbor_count < max_num_neighbors;
                  ++bond, ++neighbor_count)
             {
-                const unsigned int sphCount(bond * getSphWidth());
                 const size_t j(m_nlist.getNeighbors()(bond, 1));
                 const vec3<float> r_ij(bondVector(locality::NeighborBond(i, j), nq, query_points));
-                const float r_sq(dot(r_ij, r_ij));
-                const vec3<float> bond_ij(dot(rotation_0, r_ij), dot(rotation_1, r_ij),
-                                          dot(rotation_2, r_ij));
-
-                const float magR(std::sqrt(r_sq));
-
-                // Wrap theta into [0, 2*pi]
-                float theta(std::atan2(bond_ij.y, bond_ij.x));
-                theta = util::modulusPositive(theta, constants::TWO_PI);
-
-                // Phi in [0, pi]
-                float phi(std::acos(bond_ij.z / magR));
-
-                // catch cases where bond_ij.z/magR falls outside [-1, 1]
-                // due to numerical issues
-                if (std::isnan(phi))
+                rxs[staged] = r_ij.x;
+                rys[staged] = r_ij.y;
+                rzs[staged] = r_ij.z;
+                bond_rows[staged] = bond;
+                if (++staged == order::YLM_BATCH_SIZE)
                 {
-                    phi = bond_ij.z > 0 ? 0 : M_PI;
+                    flush();
                 }
-
-                sph_eval.compute(phi, theta);
-
-                std::copy(sph_eval.begin(m_negative_m), sph_eval.end(), &m_sphArray[sphCount]);
             }
+            flush();
         }
     });
 
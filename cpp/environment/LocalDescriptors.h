@@ -11,7 +11,6 @@
 #include "NeighborList.h"
 #include "NeighborQuery.h"
 #include "VectorMath.h"
-#include "fsph/src/spherical_harmonics.hpp"
 
 /*! \file LocalDescriptors.h
   \brief Computes local descriptors.
@@ -64,9 +63,14 @@ public:
     }
 
     //! Return the number of spherical harmonics that will be computed for each bond.
+    /*! There are (l_max + 1) * (l_max + 2) / 2 harmonics with m >= 0 for l up
+     *  to l_max, plus the l_max * (l_max + 1) / 2 negative-m harmonics when
+     *  those are requested.
+     */
     unsigned int getSphWidth() const
     {
-        return fsph::sphCount(m_l_max) + (m_l_max > 0 && m_negative_m ? fsph::sphCount(m_l_max - 1) : 0);
+        return (m_l_max + 1) * (m_l_max + 2) / 2
+            + (m_l_max > 0 && m_negative_m ? m_l_max * (m_l_max + 1) / 2 : 0);
     }
 
     //! Return a pointer to the NeighborList used in the last call to compute.
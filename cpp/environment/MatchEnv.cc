@@ -1,6 +1,9 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -8,6 +11,53 @@
 
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
+#include "utils.h"
+
+namespace {
+
+//! Sorted spectrum of bond lengths of an environment's vectors.
+/*! The spectrum is invariant under rotations and under the permutations and
+ *  proper rotations applied to an environment by merges, so it can be
+ *  computed once per environment and reused for every comparison.
+ */
+std::vector<float> bondLengthSpectrum(const freud::environment::Environment& e)
+{
+    std::vector<float> spectrum;
+    spectrum.reserve(e.vecs.size());
+    for (const auto& v : e.vecs)
+    {
+        spectrum.push_back(std::sqrt(dot(v, v)));
+    }
+    std::sort(spectrum.begin(), spectrum.end());
+    return spectrum;
+}
+
+//! Whether two bond-length spectra could belong to matching environments.
+/*! A complete matching requires every paired |v1 - v2| to be below the
+ *  threshold, which bounds the difference of the two lengths; a matching
+ *  below the threshold therefore exists only if the sorted spectra agree
+ *  elementwise within the threshold (the sorted pairing minimizes the
+ *  largest difference). Rejecting on this criterion is thus exactly
+ *  conservative: every rejected pair would have produced an empty map from
+ *  isSimilar, with or without registration.
+ */
+bool spectraCompatible(const std::vector<float>& s1, const std::vector<float>& s2, float threshold)
+{
+    if (s1.size() != s2.size())
+    {
+        return false;
+    }
+    for (size_t k = 0; k < s1.size(); k++)
+    {
+        if (std::abs(s1[k] - s2[k]) >= threshold)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
 
 namespace freud { namespace environment {
 
@@ -17,15 +67,32 @@ namespace freud { namespace environment {
 EnvDisjointSet::EnvDisjointSet(unsigned int Np) : rank(std::vector<unsigned int>(Np, 0)), m_max_num_neigh(0)
 {}
 
+void EnvDisjointSet::syncMembers()
+{
+    const size_t old_size = members.size();
+    if (old_size == s.size())
+    {
+        return;
+    }
+    members.resize(s.size());
+    // Environments are appended with env_ind equal to their position, so
+    // every newly covered index starts as a singleton set.
+    for (size_t i = old_size; i < s.size(); ++i)
+    {
+        members[i].push_back(static_cast<unsigned int>(i));
+    }
+}
+
 void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
-                           BiMap<unsigned int, unsigned int> vec_map, rotmat3<float>& rotation)
+                           FlatBiMap<unsigned int, unsigned int> vec_map, rotmat3<float>& rotation)
 {
+    syncMembers();
     // if tree heights are equal, merge b to a
     if (rank[s[a].env_ind] == rank[s[b].env_ind])
     {
         // Get the ENTIRE set that corresponds to head_b.
         unsigned int head_b = find(b);
-        std::vector<unsigned int> m_set = findSet(head_b);
+        std::vector<unsigned int>& m_set = members[head_b];
         for (unsigned int node : m_set)
         {
             // Go through the entire tree/set.
@@ -56,6 +123,10 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
             // we've added another leaf to the tree or whatever the lingo is.
             rank[s[a].env_ind]++;
         }
+        // hand b's members over to a's set
+        std::vector<unsigned int>& target = members[s[a].env_ind];
+        target.insert(target.end(), m_set.begin(), m_set.end());
+        m_set.clear();
     }
     else
     {
@@ -64,7 +135,7 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
         {
             // Get the ENTIRE set that corresponds to head_b.
             unsigned int head_b = find(b);
-            std::vector<unsigned int> m_set = findSet(head_b);
+            std::vector<unsigned int>& m_set = members[head_b];
             for (unsigned int node : m_set)
             {
                 // Go through the entire tree/set.
@@ -94,13 +165,17 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
                 // we've added another leaf to the tree or whatever the lingo is.
                 rank[s[a].env_ind]++;
             }
+            // hand b's members over to a's set
+            std::vector<unsigned int>& target = members[s[a].env_ind];
+            target.insert(target.end(), m_set.begin(), m_set.end());
+            m_set.clear();
         }
         else
         {
             rotmat3<float> rotationT = transpose(rotation);
             // Get the ENTIRE set that corresponds to head_a.
             unsigned int head_a = find(a);
-            std::vector<unsigned int> m_set = findSet(head_a);
+            std::vector<unsigned int>& m_set = members[head_a];
             for (unsigned int node : m_set)
             {
                 // Go through the entire tree/set.
@@ -134,6 +209,10 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
                 // we've added another leaf to the tree or whatever the lingo is.
                 rank[s[b].env_ind]++;
             }
+            // hand a's members over to b's set
+            std::vector<unsigned int>& target = members[s[b].env_ind];
+            target.insert(target.end(), m_set.begin(), m_set.end());
+            m_set.clear();
         }
     }
 }
@@ -159,6 +238,19 @@ unsigned int EnvDisjointSet::find(const unsigned int c)
     return r;
 }
 
+unsigned int EnvDisjointSet::find(const unsigned int c) const
+{
+    unsigned int r = c;
+
+    // follow up to the head of the tree; merge leaves every node pointing
+    // directly at its head, so this loop rarely iterates more than once
+    while (s[r].env_ind != r)
+    {
+        r = s[r].env_ind;
+    }
+    return r;
+}
+
 std::vector<unsigned int> EnvDisjointSet::findSet(const unsigned int m)
 {
     bool invalid_ind = true;
@@ -265,17 +357,17 @@ std::vector<vec3<float>> EnvDisjointSet::getIndividualEnv(const unsigned int m)
 /*************************
  * Convenience functions *
  *************************/
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
+std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
                                                                        float threshold_sq, bool registration)
 {
-    BiMap<unsigned int, unsigned int> vec_map;
+    FlatBiMap<unsigned int, unsigned int> vec_map;
     rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
 
     // If the vector sets do not have equal numbers of vectors, just return
     // an empty map since the 1-1 bimapping will be too weird in this case.
     if (e1.vecs.size() != e2.vecs.size())
     {
-        return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, vec_map);
+        return std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>>(rotation, vec_map);
     }
 
     std::vector<vec3<float>> v1(e1.vecs.size());
@@ -299,19 +391,19 @@ std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environme
         std::vector<vec3<float>> rot = r.getRotation();
         // rot must be a 3x3 matrix. if it isn't, something has gone wrong.
         rotation = rotmat3<float>(rot[0], rot[1], rot[2]);
-        BiMap<unsigned int, unsigned int> tmp_vec_map = r.getVecMap();
+        FlatBiMap<unsigned int, unsigned int> tmp_vec_map = r.getVecMap();
 
-        for (const auto* registered_pair : tmp_vec_map)
+        for (const auto& registered_pair : tmp_vec_map)
         {
             // RegisterBruteForce has found the vector mapping that results in
             // minimal RMSD, as best as it can figure out.
             // Does this vector mapping pass the more stringent criterion
             // imposed by the threshold?
-            vec3<float> delta = v1[registered_pair->first] - v2[registered_pair->second];
+            vec3<float> delta = v1[registered_pair.first] - v2[registered_pair.second];
             float r_sq = dot(delta, delta);
             if (r_sq < threshold_sq)
             {
-                vec_map.emplace(registered_pair->first, registered_pair->second);
+                vec_map.emplace(registered_pair.first, registered_pair.second);
             }
         }
     }
@@ -340,11 +432,11 @@ std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environme
     // if every vector has been paired with every other vector, return this bimap
     if (vec_map.size() == e1.vecs.size())
     {
-        return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, vec_map);
+        return std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>>(rotation, vec_map);
     }
     // otherwise, return an empty bimap
-    BiMap<unsigned int, unsigned int> empty_map;
-    return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, empty_map);
+    FlatBiMap<unsigned int, unsigned int> empty_map;
+    return std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>>(rotation, empty_map);
 }
 
 std::map<unsigned int, unsigned int> isSimilar(const box::Box& box, const vec3<float>* refPoints1,
@@ -356,10 +448,10 @@ std::map<unsigned int, unsigned int> isSimilar(const box::Box& box, const vec3<f
     std::tie(e0, e1) = makeEnvironments(box, refPoints1, refPoints2, numRef);
 
     // call isSimilar for e0 and e1
-    std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+    std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> mapping
         = isSimilar(e0, e1, threshold_sq, registration);
     rotmat3<float> rotation = mapping.first;
-    BiMap<unsigned int, unsigned int> vec_map = mapping.second;
+    FlatBiMap<unsigned int, unsigned int> vec_map = mapping.second;
 
     // update refPoints2 in case registration has taken place
     for (unsigned int i = 0; i < numRef; i++)
@@ -367,7 +459,7 @@ std::map<unsigned int, unsigned int> isSimilar(const box::Box& box, const vec3<f
         refPoints2[i] = rotation * e1.vecs[i];
     }
 
-    // Convert BiMap to a std::map and return
+    // Convert FlatBiMap to a std::map and return
     return vec_map.asMap();
 }
 
@@ -399,10 +491,10 @@ std::pair<Environment, Environment> makeEnvironments(const box::Box& box, const
     return std::pair<Environment, Environment>(e0, e1);
 }
 
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
+std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
                                                                           float& min_rmsd, bool registration)
 {
-    BiMap<unsigned int, unsigned int> vec_map;
+    FlatBiMap<unsigned int, unsigned int> vec_map;
     rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
 
     // If the vector sets do not have equal numbers of vectors, force the map
@@ -411,7 +503,7 @@ std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Enviro
     if (e1.vecs.size() != e2.vecs.size())
     {
         min_rmsd = -1.0;
-        return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, vec_map);
+        return std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>>(rotation, vec_map);
     }
 
     std::vector<vec3<float>> v1(e1.vecs.size());
@@ -446,7 +538,7 @@ std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Enviro
     }
 
     // return the rotation matrix and bimap
-    return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, vec_map);
+    return std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>>(rotation, vec_map);
 }
 
 std::map<unsigned int, unsigned int> minimizeRMSD(const box::Box& box, const vec3<float>* refPoints1,
@@ -458,10 +550,10 @@ std::map<unsigned int, unsigned int> minimizeRMSD(const box::Box& box, const vec
     std::tie(e0, e1) = makeEnvironments(box, refPoints1, refPoints2, numRef);
 
     float tmp_min_rmsd = -1.0;
-    std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+    std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> mapping
         = minimizeRMSD(e0, e1, tmp_min_rmsd, registration);
     rotmat3<float> rotation = mapping.first;
-    BiMap<unsigned int, unsigned int> vec_map = mapping.second;
+    FlatBiMap<unsigned int, unsigned int> vec_map = mapping.second;
     min_rmsd = tmp_min_rmsd;
 
     // update refPoints2 in case registration has taken place
@@ -470,7 +562,7 @@ std::map<unsigned int, unsigned int> minimizeRMSD(const box::Box& box, const vec
         refPoints2[i] = rotation * e1.vecs[i];
     }
 
-    // Convert BiMap to a std::map and return
+    // Convert FlatBiMap to a std::map and return
     return vec_map.asMap();
 }
 
@@ -548,6 +640,19 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
     // reallocate the m_point_environments array
     m_point_environments.prepare({Np, dj.m_max_num_neigh});
 
+    // Precompute the bond-length spectrum of every environment in parallel.
+    // The spectra cheaply reject the vast majority of non-matching pairs
+    // below, before the combinatorial registration in isSimilar. The vecs of
+    // an environment are not touched by merges, so the spectra stay valid
+    // throughout the matching loop.
+    std::vector<std::vector<float>> spectra(Np);
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            spectra[i] = bondLengthSpectrum(dj.s[i]);
+        }
+    });
+
     size_t bond(0);
     // loop through points
     for (unsigned int i = 0; i < Np; i++)
@@ -558,10 +663,14 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
             for (; bond < nlist.getNumBonds() && nlist.getNeighbors()(bond, 0) == i; ++bond)
             {
                 const size_t j(nlist.getNeighbors()(bond, 1));
-                std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+                if (!spectraCompatible(spectra[i], spectra[j], threshold))
+                {
+                    continue;
+                }
+                std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> mapping
                     = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
                 rotmat3<float> rotation = mapping.first;
-                BiMap<unsigned int, unsigned int> vec_map = mapping.second;
+                FlatBiMap<unsigned int, unsigned int> vec_map = mapping.second;
                 // if the mapping between the vectors of the environments
                 // is NOT empty, then the environments are similar, so
                 // merge them.
@@ -582,10 +691,14 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
             // loop over all other particles
             for (unsigned int j = i + 1; j < Np; j++)
             {
-                std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+                if (!spectraCompatible(spectra[i], spectra[j], threshold))
+                {
+                    continue;
+                }
+                std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> mapping
                     = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
                 rotmat3<float> rotation = mapping.first;
-                BiMap<unsigned int, unsigned int> vec_map = mapping.second;
+                FlatBiMap<unsigned int, unsigned int> vec_map = mapping.second;
                 // if the mapping between the vectors of the environments
                 // is NOT empty, then the environments are similar, so
                 // merge them.
@@ -608,54 +721,93 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
     m_num_clusters = populateEnv(dj);
 }
 
-unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet dj)
+unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet& dj)
 {
-    std::map<unsigned int, unsigned int> label_map;
-    std::map<unsigned int, std::vector<vec3<float>>> cluster_env;
-
-    // loop over all environments
-    unsigned int label_ind;
+    const auto n_envs = static_cast<unsigned int>(dj.s.size());
+
+    // Resolve every environment's head in parallel. The merges are done, so
+    // the compression-free find is safe from concurrent workers.
+    std::vector<unsigned int> heads(n_envs);
+    const EnvDisjointSet& const_dj = dj;
+    util::forLoopWrapper(0, n_envs, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            heads[i] = const_dj.find(static_cast<unsigned int>(i));
+        }
+    });
+
+    // Counting relabel: walk the heads once, assigning cluster labels in
+    // order of first appearance over the physical environments and recording
+    // each one's position among them. This reproduces the labels the
+    // map-based scan assigned, without the per-particle map lookups.
+    constexpr auto unlabeled = std::numeric_limits<unsigned int>::max();
+    std::vector<unsigned int> labels(n_envs, unlabeled);
+    std::vector<unsigned int> particle_inds(n_envs);
     unsigned int cur_set = 0;
     unsigned int particle_ind = 0;
-    for (unsigned int i = 0; i < dj.s.size(); i++)
+    for (unsigned int i = 0; i < n_envs; i++)
     {
         // only count this if the environment is physical
         if (!dj.s[i].ghost)
         {
-            // grab the set of vectors that define this individual environment
-            std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(i);
-
-            unsigned int c = dj.find(i);
-            // insert the set into the mapping if we haven't seen it before.
-            // also grab the vectors that define the set and insert them into cluster_env
-            if (label_map.count(c) == 0)
+            if (labels[heads[i]] == unlabeled)
             {
-                label_map[c] = cur_set;
-                std::vector<vec3<float>> vecs = dj.getAvgEnv(c);
-                label_ind = label_map[c];
-                cluster_env[label_ind] = vecs;
+                labels[heads[i]] = cur_set;
                 cur_set++;
             }
-            else
+            particle_inds[i] = particle_ind;
+            particle_ind++;
+        }
+    }
+
+    // Fill the per-particle outputs in parallel; each physical environment
+    // writes its own rows.
+    util::forLoopWrapper(0, n_envs, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (dj.s[i].ghost)
             {
-                label_ind = label_map[c];
+                continue;
             }
-
-            // label this particle in m_env_index
-            m_env_index[particle_ind] = label_ind;
+            const std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(static_cast<unsigned int>(i));
+            const unsigned int p = particle_inds[i];
+            m_env_index[p] = labels[heads[i]];
             for (unsigned int m = 0; m < part_vecs.size(); m++)
             {
-                m_point_environments(particle_ind, m) = part_vecs[m];
+                m_point_environments(p, m) = part_vecs[m];
             }
-            particle_ind++;
         }
+    });
+
+    // Average each cluster's environment in one pass over the environments
+    // instead of one getAvgEnv scan per cluster. Iteration stays in index
+    // order, so each cluster's vectors accumulate in the same order (and to
+    // the same values) as getAvgEnv produced.
+    m_cluster_environments.assign(cur_set,
+                                  std::vector<vec3<float>>(dj.m_max_num_neigh, vec3<float>(0.0, 0.0, 0.0)));
+    std::vector<unsigned int> cluster_sizes(cur_set, 0);
+    for (unsigned int i = 0; i < n_envs; i++)
+    {
+        const Environment& env = dj.s[i];
+        if (env.ghost)
+        {
+            continue;
+        }
+        const unsigned int label_ind = labels[heads[i]];
+        std::vector<vec3<float>>& avg = m_cluster_environments[label_ind];
+        for (unsigned int proper_ind = 0; proper_ind < env.vecs.size(); proper_ind++)
+        {
+            unsigned int relative_ind = env.vec_ind[proper_ind];
+            avg[proper_ind] += env.proper_rot * env.vecs[relative_ind];
+        }
+        cluster_sizes[label_ind]++;
     }
-
-    // Now update the vector of environments from the map.
-    m_cluster_environments.resize(cluster_env.size());
-    for (const auto& it : cluster_env)
+    for (unsigned int label_ind = 0; label_ind < cur_set; label_ind++)
     {
-        m_cluster_environments[it.first] = it.second;
+        for (auto& vec : m_cluster_environments[label_ind])
+        {
+            vec = vec / static_cast<float>(cluster_sizes[label_ind]);
+        }
     }
 
     // specify the number of cluster environments
@@ -705,6 +857,10 @@ void EnvironmentMotifMatch::compute(const freud::locality::NeighborQuery* nq,
     // add this environment to the set
     dj.s.push_back(e0);
 
+    // The motif's bond-length spectrum cheaply rejects particles whose
+    // environments cannot possibly match, before the expensive registration.
+    const std::vector<float> motif_spectrum = bondLengthSpectrum(e0);
+
     size_t bond(0);
     const size_t num_bonds(nlist.getNumBonds());
 
@@ -721,16 +877,19 @@ void EnvironmentMotifMatch::compute(const freud::locality::NeighborQuery* nq,
         dj.s.push_back(ei);
 
         // if the environment matches e0, merge it into the e0 environment set
-        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-            = isSimilar(dj.s[0], dj.s[dummy], m_threshold_sq, registration);
-        rotmat3<float> rotation = mapping.first;
-        BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-        // if the mapping between the vectors of the environments is NOT empty,
-        // then the environments are similar.
-        if (!vec_map.empty())
+        if (spectraCompatible(motif_spectrum, bondLengthSpectrum(ei), threshold))
         {
-            dj.merge(0, dummy, vec_map, rotation);
-            m_matches[i] = true;
+            std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> mapping
+                = isSimilar(dj.s[0], dj.s[dummy], m_threshold_sq, registration);
+            rotmat3<float> rotation = mapping.first;
+            FlatBiMap<unsigned int, unsigned int> vec_map = mapping.second;
+            // if the mapping between the vectors of the environments is NOT empty,
+            // then the environments are similar.
+            if (!vec_map.empty())
+            {
+                dj.merge(0, dummy, vec_map, rotation);
+                m_matches[i] = true;
+            }
         }
         // grab the set of vectors that define this individual environment
         std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(dummy);
@@ -799,10 +958,10 @@ void EnvironmentRMSDMinimizer::compute(const freud::locality::NeighborQuery* nq,
 
         // if the environment matches e0, merge it into the e0 environment set
         float min_rmsd = -1.0;
-        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+        std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> mapping
             = minimizeRMSD(dj.s[0], dj.s[dummy], min_rmsd, registration);
         rotmat3<float> rotation = mapping.first;
-        BiMap<unsigned int, unsigned int> vec_map = mapping.second;
+        FlatBiMap<unsigned int, unsigned int> vec_map = mapping.second;
         // populate the min_rmsd vector
         m_rmsds[i] = min_rmsd;
 
@@ -7,7 +7,7 @@
 #include <map>
 #include <vector>
 
-#include "BiMap.h"
+#include "FlatBiMap.h"
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
@@ -61,12 +61,27 @@ struct EnvDisjointSet
      * the right. The rotation must take the set of PROPERLY ROTATED vectors b
      * and rotate them to match the set of PROPERLY ROTATED vectors a
      */
-    void merge(const unsigned int a, const unsigned int b, BiMap<unsigned int, unsigned int> vec_map,
+    void merge(const unsigned int a, const unsigned int b, FlatBiMap<unsigned int, unsigned int> vec_map,
                rotmat3<float>& rotation);
 
     //! Find the set with a given element (taken mostly from Cluster.cc).
     unsigned int find(const unsigned int c);
 
+    //! Find without path compression, safe to call concurrently.
+    /*! merge() leaves every node of the combined set pointing directly at
+     *  its head, so this read-only walk terminates immediately in practice;
+     *  it exists so relabeling passes can resolve heads from parallel
+     *  workers without mutating the set.
+     */
+    unsigned int find(const unsigned int c) const;
+
+    //! Bring the per-set member lists in step with the environments in s.
+    /*! Environments are appended to s directly by client code, so the
+     *  member lists are grown lazily: every index not yet covered starts as
+     *  its own singleton set, matching how environments are added.
+     */
+    void syncMembers();
+
     //! Return ALL nodes in the tree that correspond to the head index m
     /*! Return ALL nodes in the tree that correspond to the head index m.
      * Values returned: the actual locations of the nodes in s. (i.e. if i is
@@ -88,6 +103,11 @@ struct EnvDisjointSet
 
     std::vector<Environment> s;     //!< The disjoint set data
     std::vector<unsigned int> rank; //!< The rank of each tree in the set
+    //! The members of each set, indexed by head (kept by merge/syncMembers).
+    /*! Walking a set through this list is O(set size); the findSet scan over
+     *  every environment made each merge O(total environments) instead.
+     */
+    std::vector<std::vector<unsigned int>> members;
     unsigned int m_max_num_neigh;   //!< The maximum number of neighbors in any environment in the set
 };
 
@@ -121,7 +141,7 @@ std::pair<Environment, Environment> makeEnvironments(const box::Box& box, const
  *                     orient the second set of vectors such that it
  *                     minimizes the RMSD between the two sets
  */
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
+std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
                                                                           float& min_rmsd, bool registration);
 
 //! Overload of the above minimizeRMSD function that provides an easier interface to Python.
@@ -163,7 +183,7 @@ std::map<unsigned int, unsigned int> minimizeRMSD(const box::Box& box, const vec
  *                     orient the second set of vectors such that it
  *                     minimizes the RMSD between the two sets
  */
-std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
+std::pair<rotmat3<float>, FlatBiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
                                                                        float threshold_sq, bool registration);
 
 //! Overload of the above isSimilar function that provides an easier interface to Python.
@@ -307,7 +327,7 @@ private:
      *                with that environment (which defines the cluster).
      * \return The number of clusters found.
      */
-    unsigned int populateEnv(EnvDisjointSet dj);
+    unsigned int populateEnv(EnvDisjointSet& dj);
 
     unsigned int m_num_clusters {0};              //!< Last number of local environments computed
     util::ManagedArray<unsigned int> m_env_index; //!< Cluster index determined for each particle
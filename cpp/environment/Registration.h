@@ -5,7 +5,9 @@
 #define REGISTRATION_H
 
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <sstream>
 #include <vector>
@@ -21,7 +23,11 @@
 #include "Eigen/Eigen/Dense"
 #include "Eigen/Eigen/Sparse"
 
-#include "BiMap.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "FlatBiMap.h"
 #include "VectorMath.h"
 
 namespace freud { namespace environment {
@@ -130,6 +136,100 @@ inline void KabschAlgorithm(const matrix& P, const matrix& Q, matrix& Rotation)
     Rotation = V * U.transpose();
 }
 
+//! Kabsch rotation from a precomputed 3x3 cross-covariance matrix.
+/*! Fixed-size counterpart of KabschAlgorithm for the candidate-evaluation
+ *  loop in RegisterBruteForce::Fit. The caller accumulates the covariance
+ *  A = Q^T P over the sampled points; the SVD then runs entirely on
+ *  stack-allocated 3x3 matrices, so evaluating a candidate ordering performs
+ *  no heap allocation.
+ */
+inline void KabschAlgorithm3(const Eigen::Matrix3d& A, Eigen::Matrix3d& Rotation)
+{
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::Matrix3d U = svd.matrixU();
+    Eigen::Matrix3d V = svd.matrixV();
+
+    // if the rotation as we've found it, rot=VU^T, is IMPROPER, find the next best
+    // (proper) rotation by reflecting the smallest principal axis in rot:
+    if ((V * U.transpose()).determinant() < 0)
+    {
+        V.col(2) *= -1.0;
+    }
+    Rotation = V * U.transpose();
+}
+
+//! Apply a row-major 3x3 rotation to coordinates stored in SoA arrays.
+inline void rotatePointsSoA(const float* rot, const float* x, const float* y, const float* z,
+                            unsigned int n, float* out_x, float* out_y, float* out_z)
+{
+    unsigned int i = 0;
+#if defined(__AVX__)
+    const __m256 r00 = _mm256_set1_ps(rot[0]);
+    const __m256 r01 = _mm256_set1_ps(rot[1]);
+    const __m256 r02 = _mm256_set1_ps(rot[2]);
+    const __m256 r10 = _mm256_set1_ps(rot[3]);
+    const __m256 r11 = _mm256_set1_ps(rot[4]);
+    const __m256 r12 = _mm256_set1_ps(rot[5]);
+    const __m256 r20 = _mm256_set1_ps(rot[6]);
+    const __m256 r21 = _mm256_set1_ps(rot[7]);
+    const __m256 r22 = _mm256_set1_ps(rot[8]);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 vx = _mm256_loadu_ps(x + i);
+        const __m256 vy = _mm256_loadu_ps(y + i);
+        const __m256 vz = _mm256_loadu_ps(z + i);
+        _mm256_storeu_ps(out_x + i,
+                         _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r00, vx), _mm256_mul_ps(r01, vy)),
+                                       _mm256_mul_ps(r02, vz)));
+        _mm256_storeu_ps(out_y + i,
+                         _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r10, vx), _mm256_mul_ps(r11, vy)),
+                                       _mm256_mul_ps(r12, vz)));
+        _mm256_storeu_ps(out_z + i,
+                         _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r20, vx), _mm256_mul_ps(r21, vy)),
+                                       _mm256_mul_ps(r22, vz)));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out_x[i] = rot[0] * x[i] + rot[1] * y[i] + rot[2] * z[i];
+        out_y[i] = rot[3] * x[i] + rot[4] * y[i] + rot[5] * z[i];
+        out_z[i] = rot[6] * x[i] + rot[7] * y[i] + rot[8] * z[i];
+    }
+}
+
+//! Squared distances from one point to coordinates stored in SoA arrays.
+/*! Writes |(x[i], y[i], z[i]) - point|^2 + penalty[i] to out[i]. The penalty
+ *  array lets callers exclude entries (by storing infinity) without branching
+ *  inside the loop.
+ */
+inline void squaredDistancesSoA(float point_x, float point_y, float point_z, const float* x,
+                                const float* y, const float* z, const float* penalty, unsigned int n,
+                                float* out)
+{
+    unsigned int i = 0;
+#if defined(__AVX__)
+    const __m256 ppx = _mm256_set1_ps(point_x);
+    const __m256 ppy = _mm256_set1_ps(point_y);
+    const __m256 ppz = _mm256_set1_ps(point_z);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), ppx);
+        const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), ppy);
+        const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), ppz);
+        const __m256 d2 = _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(d2, _mm256_loadu_ps(penalty + i)));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        const float dx = x[i] - point_x;
+        const float dy = y[i] - point_y;
+        const float dz = z[i] - point_z;
+        out[i] = dx * dx + dy * dy + dz * dz + penalty[i];
+    }
+}
+
 inline void AlignVectorSets(matrix& P, matrix& Q, matrix* pRotation = nullptr)
 {
     // Aligns p with q.
@@ -155,16 +255,26 @@ inline void AlignVectorSets(matrix& P, matrix& Q, matrix* pRotation = nullptr)
 class RegisterBruteForce
 {
 public:
-    explicit RegisterBruteForce(std::vector<vec3<float>>& vecs) : m_ref_points(makeEigenMatrix(vecs)) {};
+    explicit RegisterBruteForce(std::vector<vec3<float>>& vecs) : m_ref_points(makeEigenMatrix(vecs))
+    {
+        // SoA copies of the reference coordinates; all candidate evaluations
+        // run on these flat arrays.
+        m_ref_x.reserve(vecs.size());
+        m_ref_y.reserve(vecs.size());
+        m_ref_z.reserve(vecs.size());
+        for (const auto& v : vecs)
+        {
+            m_ref_x.push_back(v.x);
+            m_ref_y.push_back(v.y);
+            m_ref_z.push_back(v.z);
+        }
+    };
 
     ~RegisterBruteForce() = default;
 
     void Fit(std::vector<vec3<float>>& pts)
     {
         matrix points;
-        matrix p;
-        matrix q;
-        matrix r;
         // make the Eigen matrix from pts
         points = makeEigenMatrix(pts);
         int num_pts;
@@ -179,6 +289,22 @@ public:
             throw std::invalid_argument(msg.str());
         }
 
+        // SoA copies of the candidate coordinates, and scratch for the
+        // rotated candidates, shared by every candidate evaluation below.
+        const auto n = static_cast<unsigned int>(N);
+        std::vector<float> point_x(n);
+        std::vector<float> point_y(n);
+        std::vector<float> point_z(n);
+        for (unsigned int i = 0; i < n; i++)
+        {
+            point_x[i] = pts[i].x;
+            point_y[i] = pts[i].y;
+            point_z[i] = pts[i].z;
+        }
+        std::vector<float> rot_x(n);
+        std::vector<float> rot_y(n);
+        std::vector<float> rot_z(n);
+
         RandomNumber<std::mt19937_64> rng;
         double rmsd_min = -1.0;
         for (size_t shuffles = 0; shuffles < m_shuffles; shuffles++)
@@ -211,64 +337,58 @@ public:
             // We should switch this to using something other than C-style
             // arrays, but we need to be careful to preserve the right behavior
             // (particularly wrt NextCombination).
-            size_t comb[3] = {0, 1, 2}; // NOLINT(modernize-avoid-c-arrays)
-            if (N == 2)
+            size_t comb[3] = {0, 1, 2};  // NOLINT(modernize-avoid-c-arrays)
+            const int sel[3] = {p0, p1, p2}; // NOLINT(modernize-avoid-c-arrays)
+            if (N >= 3)
             {
-                num_pts = 2;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                p.row(1) = m_ref_points.row(p1);
-                q.resize(num_pts, m_ref_points.cols());
-            }
-            else if (N == int(1))
-            {
-                num_pts = 1;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                q.resize(num_pts, m_ref_points.cols());
+                num_pts = 3;
             }
             else
             {
-                num_pts = 3;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                p.row(1) = m_ref_points.row(p1);
-                p.row(2) = m_ref_points.row(p2);
-                q.resize(num_pts, m_ref_points.cols());
+                num_pts = N;
             }
             do
             {
                 do
                 {
-                    if (N == int(2))
-                    {
-                        q.row(0) = points.row(comb[0]);
-                        q.row(1) = points.row(comb[1]);
-                    }
-                    else if (N == int(1))
+                    // Cross-covariance between the sampled candidate points
+                    // and the sampled reference points. This is the Q^T P of
+                    // KabschAlgorithm, accumulated directly from the SoA
+                    // coordinates; with at most three sampled points the sum
+                    // is tiny, so the SIMD effort goes into the rotation and
+                    // matching of the full point set below instead.
+                    Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+                    for (int k = 0; k < num_pts; k++)
                     {
-                        q.row(0) = points.row(comb[0]);
-                    }
-                    else
-                    {
-                        q.row(0) = points.row(comb[0]);
-                        q.row(1) = points.row(comb[1]);
-                        q.row(2) = points.row(comb[2]);
+                        const auto qi = static_cast<unsigned int>(comb[k]);
+                        const int pi = sel[k];
+                        const double qv[3] = {point_x[qi], point_y[qi], point_z[qi]}; // NOLINT
+                        const double pv[3] = {m_ref_x[pi], m_ref_y[pi], m_ref_z[pi]}; // NOLINT
+                        for (int a = 0; a < 3; a++)
+                        {
+                            for (int b = 0; b < 3; b++)
+                            {
+                                cov(a, b) += qv[a] * pv[b];
+                            }
+                        }
                     }
 
                     // finds the optimal rotation of the FIRST input set
                     // of points such that they match the SECOND input
                     // set of points
-                    KabschAlgorithm(q, p, r);
-
-                    // The rotation that we've found from the
-                    // KabschAlgorithm actually acts on P^T.
-                    matrix rot_points = Rotate(r, points.transpose());
-
-                    // feed back in the TRANSPOSE of rot_points such that
-                    // the input matrix is (Nx3).
-                    BiMap<unsigned int, unsigned int> vec_map;
-                    float rmsd = AlignedRMSDTree(rot_points.transpose(), vec_map);
+                    Eigen::Matrix3d r;
+                    KabschAlgorithm3(cov, r);
+
+                    // Rotate the full candidate set and match it greedily
+                    // against the references.
+                    const float rot[9] // NOLINT(modernize-avoid-c-arrays)
+                        = {float(r(0, 0)), float(r(0, 1)), float(r(0, 2)),
+                           float(r(1, 0)), float(r(1, 1)), float(r(1, 2)),
+                           float(r(2, 0)), float(r(2, 1)), float(r(2, 2))};
+                    rotatePointsSoA(rot, point_x.data(), point_y.data(), point_z.data(), n, rot_x.data(),
+                                    rot_y.data(), rot_z.data());
+                    FlatBiMap<unsigned int, unsigned int> vec_map;
+                    float rmsd = AlignedRMSDFlat(rot_x.data(), rot_y.data(), rot_z.data(), n, vec_map);
                     if (rmsd < rmsd_min || rmsd_min < 0.0)
                     {
                         m_rmsd = rmsd;
@@ -314,7 +434,7 @@ public:
         return m_rmsd;
     }
 
-    BiMap<unsigned int, unsigned int> getVecMap()
+    FlatBiMap<unsigned int, unsigned int> getVecMap()
     {
         return m_vec_map;
     }
@@ -329,76 +449,78 @@ public:
         m_tol = tol;
     }
 
-    // This uses an R-tree to efficiently determine pairs of points that
-    // are closest, next closest, etc to each other. NOTE that this does
-    // not guarantee an absolutely minimal RMSD. It doesn't figure out the
-    // optimal permutation of BOTH sets of vectors to minimize the RMSD.
-    // Rather, it just figures out the optimal permutation of the second
-    // set, the vector set used in the argument below.
-    // To fully solve this, we need to use the Hungarian algorithm or some
-    // other way of solving the so-called assignment problem.
-    float AlignedRMSDTree(const matrix& points, BiMap<unsigned int, unsigned int>& m)
+    // Greedily pairs each point with its nearest still-unmatched reference
+    // point. NOTE that this does not guarantee an absolutely minimal RMSD.
+    // It doesn't figure out the optimal permutation of BOTH sets of vectors
+    // to minimize the RMSD. Rather, it just figures out the optimal
+    // permutation of the second set, the vector set used in the argument
+    // below. To fully solve this, we need to use the Hungarian algorithm or
+    // some other way of solving the so-called assignment problem.
+    float AlignedRMSDTree(const matrix& points, FlatBiMap<unsigned int, unsigned int>& m)
+    {
+        if (points.cols() != 2 && points.cols() != 3)
+        {
+            throw(std::runtime_error("points must 2 or 3 dimensions"));
+        }
+        // Convert the points to SoA coordinates and run the flat kernel.
+        const auto n = static_cast<unsigned int>(points.rows());
+        const bool planar = (points.cols() == 2);
+        std::vector<float> x(n);
+        std::vector<float> y(n);
+        std::vector<float> z(n);
+        for (unsigned int i = 0; i < n; i++)
+        {
+            x[i] = float(points(i, 0));
+            y[i] = float(points(i, 1));
+            z[i] = planar ? 0.0F : float(points(i, 2));
+        }
+        return AlignedRMSDFlat(x.data(), y.data(), z.data(), n, m);
+    }
+
+private:
+    //! Greedy nearest-reference matching on SoA coordinates.
+    /*! The kernel behind AlignedRMSDTree and the Fit loop. Already matched
+     *  references are excluded by an infinite additive penalty rather than by
+     *  erasing them from a set, so one vectorized distance sweep plus a
+     *  linear min-scan replaces the per-point sort of the scalar version.
+     *  The scratch arrays are members so repeated candidate evaluations do
+     *  not reallocate them.
+     */
+    float AlignedRMSDFlat(const float* x, const float* y, const float* z, unsigned int n,
+                          FlatBiMap<unsigned int, unsigned int>& m)
     {
-        // Also brute force.
         float rmsd = 0.0;
 
         // a mapping between the vectors of m_ref_points and the vectors of points
-        BiMap<unsigned int, unsigned int> vec_map;
+        FlatBiMap<unsigned int, unsigned int> vec_map;
 
-        // keeps track of whether m_ref_points have been matched to any point in points
-        // guarantees 1-1 mapping
-        std::set<unsigned int> unused_indices;
-        for (int i = 0; i < m_ref_points.rows(); i++)
-        {
-            unused_indices.insert(i);
-        }
+        m_match_penalty.assign(n, 0.0F);
+        m_match_dist_sq.resize(n);
 
         // loop through all the points
-        for (int r = 0; r < points.rows(); r++)
+        for (unsigned int r = 0; r < n; r++)
         {
-            // get the rotated point
-            vec3<float> pfit = make_point(points.row(r));
-            // compute squared distances to all unused reference points
-            std::vector<std::pair<unsigned int, float>> ref_distances;
-            for (auto ref_index : unused_indices)
+            squaredDistancesSoA(x[r], y[r], z[r], m_ref_x.data(), m_ref_y.data(), m_ref_z.data(),
+                                m_match_penalty.data(), n, m_match_dist_sq.data());
+            // take the nearest reference point that has not been used yet
+            unsigned int best = 0;
+            for (unsigned int i = 1; i < n; i++)
             {
-                vec3<float> ref_point = make_point(m_ref_points.row(ref_index));
-                vec3<float> delta = ref_point - pfit;
-                float r_sq = dot(delta, delta);
-                ref_distances.emplace_back(ref_index, r_sq);
+                if (m_match_dist_sq[i] < m_match_dist_sq[best])
+                {
+                    best = i;
+                }
             }
-            // sort the ref_distances from nearest to farthest
-            sort(ref_distances.begin(), ref_distances.end(), compare_ref_distances);
-            // take the first (nearest) ref_point found and mark it as used
-            unused_indices.erase(ref_distances[0].first);
+            // mark it as used; this guarantees a 1-1 mapping
+            m_match_penalty[best] = std::numeric_limits<float>::infinity();
             // add this pairing to the mapping between vectors
-            vec_map.emplace(ref_distances[0].first, r);
+            vec_map.emplace(best, r);
             // add this squared distance to the rmsd
-            rmsd += ref_distances[0].second;
+            rmsd += m_match_dist_sq[best];
         }
 
         m = vec_map;
-        return std::sqrt(rmsd / static_cast<float>(points.rows()));
-    }
-
-private:
-    static vec3<float> make_point(const Eigen::VectorXd& row)
-    {
-        if (row.rows() == 2)
-        {
-            return vec3<float>(row[0], row[1], 0.0);
-        }
-        if (row.rows() == 3)
-        {
-            return vec3<float>(row[0], row[1], row[2]);
-        }
-        throw(std::runtime_error("points must 2 or 3 dimensions"));
-    }
-
-    static bool compare_ref_distances(const std::pair<unsigned int, float>& a,
-                                      const std::pair<unsigned int, float>& b)
-    {
-        return (a.second < b.second);
+        return std::sqrt(rmsd / static_cast<float>(n));
     }
 
     static inline bool NextCombination(size_t* comb, int N, int k)
@@ -466,12 +588,17 @@ private:
     };
 
     matrix m_ref_points;
+    std::vector<float> m_ref_x; //!< SoA copies of the reference coordinates
+    std::vector<float> m_ref_y;
+    std::vector<float> m_ref_z;
+    std::vector<float> m_match_penalty; //!< Scratch for AlignedRMSDFlat
+    std::vector<float> m_match_dist_sq; //!< Scratch for AlignedRMSDFlat
     matrix m_rotation;
     matrix m_translation;
     float m_rmsd {0.0};
     double m_tol {1e-6};
     size_t m_shuffles {1};
-    BiMap<unsigned int, unsigned int>
+    FlatBiMap<unsigned int, unsigned int>
         m_vec_map; //! The mapping between indices of the two sets of points ref_points->points (where
                    //! "ref_points" are those that RegisterBruteForce was constructed with and "points" are
                    //! those passed to Fit).
@@ -5,9 +5,32 @@
 #include <stdexcept>
 
 #include "AABBQuery.h"
+#include "utils.h"
 
 namespace freud { namespace locality {
 
+namespace {
+//! Spread the low 10 bits of x so that there are two zero bits between each.
+inline unsigned int expandBits(unsigned int x)
+{
+    x = (x * 0x00010001U) & 0xFF0000FFU;
+    x = (x * 0x00000101U) & 0x0F00F00FU;
+    x = (x * 0x00000011U) & 0xC30C30C3U;
+    x = (x * 0x00000005U) & 0x49249249U;
+    return x;
+}
+
+//! Compute a 30-bit Morton code from fractional coordinates in [0, 1).
+inline unsigned int mortonCode(const vec3<float>& fraction)
+{
+    const auto quantize = [](float f) {
+        return static_cast<unsigned int>(util::clamp(f, 0.0f, 1.0f) * 1023.0f);
+    };
+    return (expandBits(quantize(fraction.x)) << 2) | (expandBits(quantize(fraction.y)) << 1)
+        | expandBits(quantize(fraction.z));
+}
+} // namespace
+
 AABBQuery::AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points)
     : NeighborQuery(box, points, n_points)
 {
@@ -18,6 +41,23 @@ AABBQuery::AABBQuery(const box::Box& box, const vec3<float>* points, unsigned in
     buildTree(m_points, m_n_points);
 }
 
+AABBQuery::AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                     bool spatial_reorder)
+    : NeighborQuery(box, points, n_points)
+{
+    setupTree(m_n_points);
+
+    if (spatial_reorder)
+    {
+        reorderPoints(m_points, m_n_points);
+        buildTree(m_sorted_points.data(), m_n_points);
+    }
+    else
+    {
+        buildTree(m_points, m_n_points);
+    }
+}
+
 AABBQuery::~AABBQuery() = default;
 
 std::shared_ptr<NeighborQueryPerPointIterator>
@@ -26,8 +66,11 @@ AABBQuery::querySingle(const vec3<float> query_point, unsigned int query_point_i
     this->validateQueryArgs(args);
     if (args.mode == QueryType::ball)
     {
-        return std::make_shared<AABBQueryBallIterator>(this, query_point, query_point_idx, args.r_max,
-                                                       args.r_min, args.exclude_ii);
+        const float r_max = args.r_maxes != nullptr ? args.r_maxes[query_point_idx] : args.r_max;
+        auto iterator = std::make_shared<AABBQueryBallIterator>(this, query_point, query_point_idx, r_max,
+                                                                args.r_min, args.exclude_ii);
+        iterator->setTypeFilter(args);
+        return iterator;
     }
     if (args.mode == QueryType::nearest)
     {
@@ -45,22 +88,54 @@ void AABBQuery::setupTree(unsigned int Np)
 
 void AABBQuery::buildTree(const vec3<float>* points, unsigned int Np)
 {
-    // Construct a point AABB for each point
-    for (unsigned int i = 0; i < Np; ++i)
-    {
-        // Make a point AABB
-        vec3<float> my_pos(points[i]);
-        if (m_box.is2D())
+    // Construct a point AABB for each point. Tags always hold the original
+    // point index so that query output is unaffected by spatial reordering.
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i != end; ++i)
         {
-            my_pos.z = 0;
+            // Make a point AABB
+            vec3<float> my_pos(points[i]);
+            if (m_box.is2D())
+            {
+                my_pos.z = 0;
+            }
+            const unsigned int tag
+                = m_sorted_order.empty() ? static_cast<unsigned int>(i) : m_sorted_order[i];
+            m_aabbs[i] = AABB(my_pos, tag);
         }
-        m_aabbs[i] = AABB(my_pos, i);
-    }
+    });
 
     // Call the tree build routine, one tree per type
     m_aabb_tree.buildTree(m_aabbs.data(), Np);
 }
 
+void AABBQuery::reorderPoints(const vec3<float>* points, unsigned int Np)
+{
+    // Quantize each point's fractional coordinate onto a Morton curve and
+    // argsort, so that points close in space end up close in memory.
+    std::vector<unsigned int> codes(Np);
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i != end; ++i)
+        {
+            codes[i] = mortonCode(m_box.makeFractional(points[i]));
+        }
+    });
+
+    m_sorted_order.resize(Np);
+    for (unsigned int i = 0; i < Np; ++i)
+    {
+        m_sorted_order[i] = i;
+    }
+    std::sort(m_sorted_order.begin(), m_sorted_order.end(),
+              [&codes](unsigned int a, unsigned int b) { return codes[a] < codes[b]; });
+
+    m_sorted_points.resize(Np);
+    for (unsigned int i = 0; i < Np; ++i)
+    {
+        m_sorted_points[i] = points[m_sorted_order[i]];
+    }
+}
+
 void AABBIterator::updateImageVectors(float r_max, bool _check_r_max)
 {
     box::Box box = m_neighbor_query->getBox();
@@ -146,20 +221,22 @@ NeighborBond AABBQueryBallIterator::next()
     {
         // Make an AABB for the image of this point
         vec3<float> pos_i_image = pos_i + m_image_list[cur_image];
-        AABBSphere asphere = AABBSphere(pos_i_image, m_r_max);
 
         // Stackless traversal of the tree
         while (cur_node_idx < m_aabb_query->m_aabb_tree.getNumNodes())
         {
-            if (overlap(m_aabb_query->m_aabb_tree.getNodeAABB(cur_node_idx), asphere))
+            if (nodeOverlaps(cur_node_idx, pos_i_image, r_max_sq))
             {
                 if (m_aabb_query->m_aabb_tree.isNodeLeaf(cur_node_idx))
                 {
                     while (cur_ref_p < m_aabb_query->m_aabb_tree.getNodeNumParticles(cur_node_idx))
                     {
-                        // Neighbor j
+                        // Neighbor j, reported by its original index
                         const unsigned int j
                             = m_aabb_query->m_aabb_tree.getNodeParticleTag(cur_node_idx, cur_ref_p);
+                        // Internal index into the (possibly reordered) points
+                        const unsigned int p
+                            = m_aabb_query->m_aabb_tree.getNodeParticle(cur_node_idx, cur_ref_p);
                         // Increment before possible return.
                         cur_ref_p++;
 
@@ -169,8 +246,14 @@ NeighborBond AABBQueryBallIterator::next()
                             continue;
                         }
 
+                        // Skip type pairs excluded by the mask, if one is set.
+                        if (!allowsTypePair(j))
+                        {
+                            continue;
+                        }
+
                         // Read in the position of j
-                        vec3<float> pos_j((*m_neighbor_query)[j]);
+                        vec3<float> pos_j(m_aabb_query->getInternalPoint(p));
                         if (m_neighbor_query->getBox().is2D())
                         {
                             pos_j.z = 0;
@@ -183,7 +266,9 @@ NeighborBond AABBQueryBallIterator::next()
                         // Check ii exclusion before including the pair.
                         if (r_sq < r_max_sq && r_sq >= r_min_sq)
                         {
-                            return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq));
+                            // The delta for this image is already in hand, so
+                            // record it for computes to reuse.
+                            return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq), r_ij);
                         }
                     }
                 }
@@ -198,6 +283,9 @@ NeighborBond AABBQueryBallIterator::next()
         } // end stackless search
         cur_image++;
         cur_node_idx = 0;
+        // The cached packet was computed for the previous image's sphere.
+        m_packet_start = INVALID_NODE;
+        m_packet_mask = 0;
     } // end loop over images
 
     m_finished = true;
@@ -232,6 +320,46 @@ NeighborBond AABBQueryIterator::next()
             m_current_neighbors.clear();
             m_all_distances.clear();
             m_query_points_below_r_min.clear();
+
+            // Small-k fast path: keep candidates in a fixed-capacity,
+            // register-resident buffer instead of appending to a vector and
+            // sorting. Only valid while the search stays within the safe
+            // duplicate-free distance, where every candidate is unique. The
+            // capacity bucket is selected at compile time so the insertion
+            // network fully unrolls.
+            if (!m_search_extended && m_num_neighbors <= MAX_SMALL_K)
+            {
+                const float r_ball = std::min(m_r_cur, m_r_max);
+                if (m_num_neighbors <= 4)
+                {
+                    ballPassSmallK<4>(r_ball);
+                }
+                else if (m_num_neighbors <= 8)
+                {
+                    ballPassSmallK<8>(r_ball);
+                }
+                else
+                {
+                    ballPassSmallK<MAX_SMALL_K>(r_ball);
+                }
+
+                m_r_cur *= m_scale;
+
+                if (m_current_neighbors.size() >= m_num_neighbors)
+                {
+                    break;
+                }
+                if ((m_r_cur >= m_r_max) || (m_r_cur >= max_plane_distance))
+                {
+                    break;
+                }
+                if (m_r_cur > min_plane_distance / 2)
+                {
+                    m_search_extended = true;
+                }
+                continue;
+            }
+
             std::shared_ptr<NeighborQueryPerPointIterator> ball_it = std::make_shared<AABBQueryBallIterator>(
                 static_cast<const AABBQuery*>(m_neighbor_query), m_query_point, m_query_point_idx,
                 std::min(m_r_cur, m_r_max), 0, m_exclude_ii, false);
@@ -38,9 +38,33 @@ public:
     //! New-style constructor.
     AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points);
 
+    //! Constructor with optional spatial reordering.
+    /*! When spatial_reorder is true, the points are sorted along a Morton
+     *  (Z-order) curve into an internal buffer before the tree is built, so
+     *  that points that are close in space are also close in memory during
+     *  traversal. Bond output is unaffected: leaf nodes tag particles with
+     *  their original indices, so all reported point indices refer to the
+     *  caller's ordering.
+     */
+    AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points, bool spatial_reorder);
+
     //! Destructor
     ~AABBQuery() override;
 
+    //! Get the position of a point by its internal (possibly reordered) index.
+    /*! Leaf nodes store both the internal index and the original tag of each
+     *  particle; iterators should read positions through this method so that
+     *  reordered queries benefit from the cache-friendly layout.
+     */
+    inline vec3<float> getInternalPoint(unsigned int internal_idx) const
+    {
+        if (!m_sorted_points.empty())
+        {
+            return m_sorted_points[internal_idx];
+        }
+        return m_points[internal_idx];
+    }
+
     //! Implementation of per-particle query for AABBQuery (see NeighborQuery.h for documentation).
     /*! \param query_point The point to find neighbors for.
      *  \param n_query_points The number of query points.
@@ -110,7 +134,12 @@ private:
     //! Driver to build AABB trees
     void buildTree(const vec3<float>* points, unsigned int N);
 
-    std::vector<AABB> m_aabbs; //!< Flat array of AABBs of all types
+    //! Sort the points along a Morton curve into m_sorted_points.
+    void reorderPoints(const vec3<float>* points, unsigned int N);
+
+    std::vector<AABB> m_aabbs;                //!< Flat array of AABBs of all types
+    std::vector<vec3<float>> m_sorted_points; //!< Morton-ordered copy of the points (when reordering)
+    std::vector<unsigned int> m_sorted_order; //!< Original index of each entry in m_sorted_points
 };
 
 //! Parent class of AABB iterators that knows how to traverse general AABB tree structures.
@@ -137,6 +166,61 @@ protected:
     unsigned int m_n_images {0};           //!< The number of image vectors to check
 };
 
+//! Largest neighbor count served by the fixed-capacity candidate buffer.
+/*! Nearest-neighbor queries with num_neighbors at or below this value keep
+ *  their candidates in a BestKBuffer instead of an unbounded vector.
+ */
+constexpr unsigned int MAX_SMALL_K = 12;
+
+//! Fixed-capacity sorted buffer of the k best (smallest-distance) bonds.
+/*! The buffer is a small array that the compiler can keep in registers, with
+ *  candidates merged in by an insertion network: once the buffer is full, a
+ *  candidate no better than the current worst entry is rejected with a single
+ *  comparison, and accepted candidates shift at most Capacity entries. This
+ *  replaces the vector-append-then-sort bookkeeping for the small-k queries
+ *  that dominate k-NN profiles.
+ */
+template<unsigned int Capacity> class BestKBuffer
+{
+public:
+    //! Get the number of stored bonds.
+    unsigned int size() const
+    {
+        return m_size;
+    }
+
+    //! Offer a candidate bond, keeping only the best Capacity seen so far.
+    void insert(const NeighborBond& nb)
+    {
+        if (m_size == Capacity)
+        {
+            if (!(nb < m_bonds[Capacity - 1]))
+            {
+                return;
+            }
+            --m_size;
+        }
+        unsigned int i = m_size;
+        while (i > 0 && nb < m_bonds[i - 1])
+        {
+            m_bonds[i] = m_bonds[i - 1];
+            --i;
+        }
+        m_bonds[i] = nb;
+        ++m_size;
+    }
+
+    //! Copy the stored bonds, already sorted by distance, into a vector.
+    void copyTo(std::vector<NeighborBond>& out) const
+    {
+        out.assign(m_bonds, m_bonds + m_size);
+    }
+
+private:
+    NeighborBond m_bonds[Capacity]; //!< The best bonds seen so far, sorted ascending.
+    unsigned int m_size {0};        //!< The number of valid entries in m_bonds.
+};
+
 //! Iterator that gets a specified number of nearest neighbors from AABB tree structures.
 class AABBQueryIterator : public AABBIterator
 {
@@ -159,6 +243,14 @@ public:
     NeighborBond next() override;
 
 protected:
+    //! Run one ball pass keeping the best candidates in a fixed-size buffer.
+    /*! Fills m_current_neighbors, sorted by distance, with up to Capacity of
+     *  the closest points within r_ball. Used instead of the generic
+     *  collect-and-sort pass when num_neighbors <= MAX_SMALL_K and the search
+     *  has not been extended beyond the safe duplicate-free distance.
+     */
+    template<unsigned int Capacity> void ballPassSmallK(float r_ball);
+
     unsigned int m_count;                          //!< Number of neighbors returned for the current point.
     unsigned int m_num_neighbors;                  //!< Number of nearest neighbors to find
     std::vector<NeighborBond> m_current_neighbors; //!< The current set of found neighbors.
@@ -198,7 +290,43 @@ private:
     unsigned int cur_node_idx; //!< The current node in the tree.
     unsigned int
         cur_ref_p; //!< The current index into the reference particles in the current node of the tree.
+    unsigned int m_packet_start {INVALID_NODE}; //!< First node covered by the cached overlap packet.
+    unsigned int m_packet_mask {0};             //!< Cached overlap bitmask for the current packet.
+
+    //! Test whether a node overlaps the query sphere using the cached packet.
+    /*! Consecutive nodes in the preorder traversal share one SIMD overlap
+     *  test; a new packet is only computed when the traversal leaves the
+     *  cached window (e.g. after a skip or an image change).
+     */
+    inline bool nodeOverlaps(unsigned int node_idx, const vec3<float>& position, float r_sq)
+    {
+        if (node_idx < m_packet_start || node_idx >= m_packet_start + OVERLAP_PACKET_WIDTH)
+        {
+            m_packet_start = node_idx;
+            m_packet_mask = m_aabb_query->m_aabb_tree.overlapPacket(node_idx, position, r_sq);
+        }
+        return ((m_packet_mask >> (node_idx - m_packet_start)) & 1U) != 0;
+    }
 };
+
+template<unsigned int Capacity> void AABBQueryIterator::ballPassSmallK(float r_ball)
+{
+    BestKBuffer<Capacity> buffer;
+    AABBQueryBallIterator ball_it(m_aabb_query, m_query_point, m_query_point_idx, r_ball, 0, m_exclude_ii,
+                                  false);
+    for (NeighborBond nb = ball_it.next(); !ball_it.end(); nb = ball_it.next())
+    {
+        // The ball pass may exceed the normally safe bounds, so r_min
+        // filtering happens here rather than in the ball query.
+        if (nb.distance < m_r_min)
+        {
+            continue;
+        }
+        nb.query_point_idx = m_query_point_idx;
+        buffer.insert(nb);
+    }
+    buffer.copyTo(m_current_neighbors);
+}
 }; }; // end namespace freud::locality
 
 #endif // AABBQUERY_H
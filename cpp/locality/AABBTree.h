@@ -5,9 +5,12 @@
 #define AABB_TREE_H
 
 #include <array>
+#include <cfloat>
 #include <cstring>
+#include <memory>
 #include <stack>
 #include <stdexcept>
+#include <tbb/task_group.h>
 #include <vector>
 
 #include "AABB.h"
@@ -30,6 +33,19 @@ namespace freud { namespace locality {
 
 constexpr unsigned int NODE_CAPACITY = 16;        //!< Maximum number of particles in a node
 constexpr unsigned int INVALID_NODE = 0xffffffff; //!< Invalid node index sentinel
+//! Minimum number of particles for which buildTree spawns parallel tasks
+constexpr unsigned int PARALLEL_BUILD_MIN_PARTICLES = 16384;
+//! Subranges smaller than this are built serially within their task
+constexpr unsigned int PARALLEL_BUILD_GRAIN = 4096;
+//! Number of consecutive node AABBs tested against a query sphere per packet
+/*! Matches the widest SIMD instruction set enabled at compile time, following
+ *  the same compile-time selection already used for AABB overlap tests.
+ */
+#if defined(__AVX__)
+constexpr unsigned int OVERLAP_PACKET_WIDTH = 8;
+#else
+constexpr unsigned int OVERLAP_PACKET_WIDTH = 4;
+#endif
 
 //! Node in an AABBTree
 /*! Stores data for a node in the AABB tree
@@ -238,6 +254,18 @@ public:
         return (m_nodes[node].particle_tags[j]);
     }
 
+    //! Test a query sphere against a packet of consecutive node AABBs.
+    /*! \param start Index of the first node to test
+     *  \param position Center of the query sphere
+     *  \param r_sq Squared radius of the query sphere
+     *  \returns A bitmask whose bit i is set when node (start + i) overlaps
+     *
+     *  Tests up to OVERLAP_PACKET_WIDTH nodes at once against the sphere
+     *  using the SoA bounds mirror, one SIMD lane per node. Bits past the end
+     *  of the tree are computed from padding nodes that can never overlap.
+     */
+    inline unsigned int overlapPacket(unsigned int start, const vec3<float>& position, float r_sq) const;
+
 private:
     AABBNode* m_nodes {nullptr};         //!< The nodes of the tree
     unsigned int m_num_nodes {0};        //!< Number of nodes
@@ -245,6 +273,32 @@ private:
     unsigned int m_root {0};             //!< Index to the root node of the tree
     std::vector<unsigned int> m_mapping; //!< Reverse mapping to find node given a particle index
 
+    //! SoA mirror of node bounds for packetized overlap tests, padded to a
+    //! multiple of OVERLAP_PACKET_WIDTH with never-overlapping sentinels
+    std::vector<float> m_soa_lower_x; //!< Lower x bound per node
+    std::vector<float> m_soa_lower_y; //!< Lower y bound per node
+    std::vector<float> m_soa_lower_z; //!< Lower z bound per node
+    std::vector<float> m_soa_upper_x; //!< Upper x bound per node
+    std::vector<float> m_soa_upper_y; //!< Upper y bound per node
+    std::vector<float> m_soa_upper_z; //!< Upper z bound per node
+
+    //! Record of one node produced by the parallel partition phase
+    /*! The parallel build first partitions the particle ranges recursively
+     *  without touching m_nodes, recording the subtree structure here. Once
+     *  subtree node counts are known, every node's index in the preorder
+     *  m_nodes layout can be computed independently, so the emission phase can
+     *  also run as parallel tasks.
+     */
+    struct BuildRecord
+    {
+        AABB aabb;                   //!< Merged AABB of this subrange
+        unsigned int start {0};      //!< Start of this node's subrange in aabbs and idx
+        unsigned int len {0};        //!< Length of this node's subrange
+        unsigned int num_nodes {1};  //!< Number of nodes in this subtree (including this node)
+        std::unique_ptr<BuildRecord> left;  //!< Left child record (null for leaves)
+        std::unique_ptr<BuildRecord> right; //!< Right child record (null for leaves)
+    };
+
     //! Initialize the tree to hold N particles
     inline void init(unsigned int N);
 
@@ -252,9 +306,29 @@ private:
     inline unsigned int buildNode(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
                                   unsigned int len, unsigned int parent);
 
+    //! Partition a subrange of aabbs and idx about the center of their merged AABB
+    inline unsigned int partitionRange(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
+                                       unsigned int len, const AABB& my_aabb) const;
+
+    //! Recursively partition a subrange, spawning parallel tasks for large subranges
+    inline void partitionTask(AABB* aabbs, std::vector<unsigned int>& idx, BuildRecord& record);
+
+    //! Write the nodes described by a BuildRecord subtree into the preorder m_nodes layout
+    inline void emitNodes(const AABB* aabbs, const std::vector<unsigned int>& idx, const BuildRecord& record,
+                          unsigned int my_idx, unsigned int parent);
+
     //! Allocate a new node
     inline unsigned int allocateNode();
 
+    //! Grow the node storage to hold at least the requested number of nodes
+    inline void ensureNodeCapacity(unsigned int capacity);
+
+    //! Rebuild the SoA mirror of node bounds from m_nodes
+    inline void buildSoABounds();
+
+    //! Refresh the SoA bounds of a single node from m_nodes
+    inline void updateSoABounds(unsigned int idx);
+
     //! Update the skip value for a node
     inline unsigned int updateSkip(unsigned int idx);
 };
@@ -335,6 +409,7 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
     if (!contains(m_nodes[node_idx].aabb, aabb))
     {
         m_nodes[node_idx].aabb = merge(m_nodes[node_idx].aabb, aabb);
+        updateSoABounds(node_idx);
 
         // update all parent node AABBs
         unsigned int current_node = m_nodes[node_idx].parent;
@@ -344,6 +419,7 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
             unsigned int right_idx = m_nodes[current_node].right;
 
             m_nodes[current_node].aabb = merge(m_nodes[left_idx].aabb, m_nodes[right_idx].aabb);
+            updateSoABounds(current_node);
             current_node = m_nodes[current_node].parent;
         }
     }
@@ -381,6 +457,14 @@ inline unsigned int AABBTree::height(unsigned int idx)
 
     Builds a balanced tree from a given list of AABBs for each particle. Data in \a aabbs will be modified
    during the construction process.
+
+    For large inputs the build runs as a two-phase parallel algorithm. The
+   first phase recursively partitions the particle ranges as TBB tasks,
+   recording the subtree structure and node counts without allocating tree
+   nodes. Because the preorder index of every node follows directly from the
+   subtree counts, the second phase can write all nodes (including their skip
+   values) into the flat array in parallel as well. Small inputs use the
+   original serial recursion, and both paths produce an identical node layout.
 */
 inline void AABBTree::buildTree(AABB* aabbs, unsigned int N)
 {
@@ -392,8 +476,25 @@ inline void AABBTree::buildTree(AABB* aabbs, unsigned int N)
         idx.push_back(i);
     }
 
-    m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
-    updateSkip(m_root);
+    if (N >= PARALLEL_BUILD_MIN_PARTICLES)
+    {
+        BuildRecord root;
+        root.start = 0;
+        root.len = N;
+        partitionTask(aabbs, idx, root);
+
+        ensureNodeCapacity(root.num_nodes);
+        m_num_nodes = root.num_nodes;
+        m_root = 0;
+        emitNodes(aabbs, idx, root, 0, INVALID_NODE);
+    }
+    else
+    {
+        m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
+        updateSkip(m_root);
+    }
+
+    buildSoABounds();
 }
 
 /*! \param aabbs List of AABBs
@@ -420,7 +521,6 @@ inline unsigned int AABBTree::buildNode(AABB* aabbs, std::vector<unsigned int>&
     {
         my_aabb = merge(my_aabb, aabbs[start + i]);
     }
-    vec3<float> my_radius = my_aabb.getUpper() - my_aabb.getLower();
 
     // handle the case of a leaf node creation
     if (len <= NODE_CAPACITY)
@@ -447,7 +547,36 @@ inline unsigned int AABBTree::buildNode(AABB* aabbs, std::vector<unsigned int>&
     unsigned int my_idx = allocateNode();
 
     // need to split the list of aabbs into two sets for left and right
-    unsigned int start_left = 0;
+    unsigned int start_right = partitionRange(aabbs, idx, start, len, my_aabb);
+
+    // note: calling buildNode has side effects, the m_nodes array may be reallocated. So we need to determine
+    // the left and right children, then build our node (can't say m_nodes[my_idx].left = buildNode(...))
+    unsigned int new_left = buildNode(aabbs, idx, start, start_right, my_idx);
+    unsigned int new_right = buildNode(aabbs, idx, start + start_right, len - start_right, my_idx);
+
+    // now, create the children and connect them up
+    m_nodes[my_idx].aabb = my_aabb;
+    m_nodes[my_idx].parent = parent;
+    m_nodes[my_idx].left = new_left;
+    m_nodes[my_idx].right = new_right;
+
+    return my_idx;
+}
+
+/*! \param aabbs List of AABBs
+    \param idx List of indices
+    \param start Start point in aabbs and idx to examine
+    \param len Number of aabbs to examine (must be greater than NODE_CAPACITY or equal to 2)
+    \param my_aabb Merged AABB of the subrange
+    \returns The number of elements partitioned onto the left side
+
+    Partitions the subrange in place about the center of \a my_aabb along its
+   longest axis, exactly as the serial build heuristic does. The returned split
+   is clamped so that neither side is empty.
+*/
+inline unsigned int AABBTree::partitionRange(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
+                                             unsigned int len, const AABB& my_aabb) const
+{
     unsigned int start_right = len;
 
     // if there are only 2 aabbs, put one on each side
@@ -457,74 +586,41 @@ inline unsigned int AABBTree::buildNode(AABB* aabbs, std::vector<unsigned int>&
     // cppcheck-suppress knownConditionTrueFalse
     if (len != 2)
     {
-        // otherwise, we need to split them based on a heuristic. split the longest dimension in half
+        // we need to split based on a heuristic. split the longest dimension in half
+        const vec3<float> my_radius = my_aabb.getUpper() - my_aabb.getLower();
+        const vec3<float> center = my_aabb.getPosition();
+        float split_plane(center.z);
+        int axis(2);
         if (my_radius.x > my_radius.y && my_radius.x > my_radius.z)
         {
-            // split on x direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().x < my_aabb.getPosition().x)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
+            split_plane = center.x;
+            axis = 0;
         }
         else if (my_radius.y > my_radius.z)
         {
-            // split on y direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().y < my_aabb.getPosition().y)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
+            split_plane = center.y;
+            axis = 1;
         }
-        else
+
+        for (unsigned int i = 0; i < start_right; i++)
         {
-            // split on z direction
-            for (unsigned int i = 0; i < start_right; i++)
+            const vec3<float> pos = aabbs[start + i].getPosition();
+            const float value = (axis == 0 ? pos.x : (axis == 1 ? pos.y : pos.z));
+            if (value < split_plane)
             {
-                if (aabbs[start + i].getPosition().z < my_aabb.getPosition().z)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
+                // if on the left side, everything is happy, just continue on
+            }
+            else
+            {
+                // if on the right side, need to swap the current aabb with the one at
+                // start_right-1, subtract one off of start_right to indicate the addition
+                // of one to the right side and subtract 1 from i to look at the current
+                // index (new aabb). This is quick and easy to write, but will randomize
+                // indices - might need to look into a stable partitioning algorithm!
+                std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
+                std::swap(idx[start + i], idx[start + start_right - 1]);
+                start_right--;
+                i--;
             }
         }
     }
@@ -539,18 +635,115 @@ inline unsigned int AABBTree::buildNode(AABB* aabbs, std::vector<unsigned int>&
         start_right = 1;
     }
 
-    // note: calling buildNode has side effects, the m_nodes array may be reallocated. So we need to determine
-    // the left and right children, then build our node (can't say m_nodes[my_idx].left = buildNode(...))
-    unsigned int new_left = buildNode(aabbs, idx, start + start_left, start_right - start_left, my_idx);
-    unsigned int new_right = buildNode(aabbs, idx, start + start_right, len - start_right, my_idx);
+    return start_right;
+}
 
-    // now, create the children and connect them up
-    m_nodes[my_idx].aabb = my_aabb;
-    m_nodes[my_idx].parent = parent;
-    m_nodes[my_idx].left = new_left;
-    m_nodes[my_idx].right = new_right;
+/*! \param aabbs List of AABBs
+    \param idx List of indices
+    \param record Build record whose subrange should be partitioned
+
+    First phase of the parallel build. Recursively partitions the subrange
+   owned by \a record using the same heuristic as the serial build, filling in
+   the merged AABB, the child records, and the subtree node count. Sibling
+   subranges are disjoint, so the two children can be partitioned as
+   independent TBB tasks; small subranges recurse serially to limit task
+   overhead.
+*/
+inline void AABBTree::partitionTask(AABB* aabbs, std::vector<unsigned int>& idx, BuildRecord& record)
+{
+    // merge all the AABBs into one
+    AABB my_aabb = aabbs[record.start];
+    for (unsigned int i = 1; i < record.len; i++)
+    {
+        my_aabb = merge(my_aabb, aabbs[record.start + i]);
+    }
+    record.aabb = my_aabb;
 
-    return my_idx;
+    // leaves terminate the recursion
+    if (record.len <= NODE_CAPACITY)
+    {
+        record.num_nodes = 1;
+        return;
+    }
+
+    const unsigned int start_right = partitionRange(aabbs, idx, record.start, record.len, my_aabb);
+
+    record.left = std::make_unique<BuildRecord>();
+    record.left->start = record.start;
+    record.left->len = start_right;
+    record.right = std::make_unique<BuildRecord>();
+    record.right->start = record.start + start_right;
+    record.right->len = record.len - start_right;
+
+    if (record.len >= PARALLEL_BUILD_GRAIN)
+    {
+        tbb::task_group tasks;
+        tasks.run([&] { partitionTask(aabbs, idx, *record.left); });
+        tasks.run([&] { partitionTask(aabbs, idx, *record.right); });
+        tasks.wait();
+    }
+    else
+    {
+        partitionTask(aabbs, idx, *record.left);
+        partitionTask(aabbs, idx, *record.right);
+    }
+
+    record.num_nodes = 1 + record.left->num_nodes + record.right->num_nodes;
+}
+
+/*! \param aabbs List of AABBs (already partitioned by partitionTask)
+    \param idx List of indices (already partitioned by partitionTask)
+    \param record Build record describing the subtree to emit
+    \param my_idx Preorder index at which to write this node
+    \param parent Index of the parent node
+
+    Second phase of the parallel build. Writes the subtree described by
+   \a record into m_nodes using the preorder layout of the serial build: a
+   node at index i is followed by its left subtree and then its right subtree,
+   so left = i + 1 and right = i + 1 + num_nodes(left). Since the subtree node
+   counts are known, skip values are filled in directly and sibling subtrees
+   write to disjoint slices of m_nodes, making the emission safe to run as
+   parallel tasks.
+*/
+inline void AABBTree::emitNodes(const AABB* aabbs, const std::vector<unsigned int>& idx,
+                                const BuildRecord& record, unsigned int my_idx, unsigned int parent)
+{
+    AABBNode& node = m_nodes[my_idx];
+    node = AABBNode();
+    node.aabb = record.aabb;
+    node.parent = parent;
+
+    if (!record.left)
+    {
+        // leaf node
+        node.num_particles = record.len;
+        for (unsigned int i = 0; i < record.len; i++)
+        {
+            node.particles[i] = idx[record.start + i];
+            node.particle_tags[i] = aabbs[record.start + i].tag;
+            m_mapping[idx[record.start + i]] = my_idx;
+        }
+        return;
+    }
+
+    const unsigned int left_idx = my_idx + 1;
+    const unsigned int right_idx = my_idx + 1 + record.left->num_nodes;
+    node.left = left_idx;
+    node.right = right_idx;
+    node.skip = record.num_nodes - 1;
+
+    if (record.len >= PARALLEL_BUILD_GRAIN)
+    {
+        tbb::task_group tasks;
+        tasks.run([&] { emitNodes(aabbs, idx, *record.left, left_idx, my_idx); });
+        tasks.run([&] { emitNodes(aabbs, idx, *record.right, right_idx, my_idx); });
+        tasks.wait();
+    }
+    else
+    {
+        emitNodes(aabbs, idx, *record.left, left_idx, my_idx);
+        emitNodes(aabbs, idx, *record.right, right_idx, my_idx);
+    }
 }
 
 /*! \param idx Index of the node to update
@@ -581,39 +774,159 @@ inline unsigned int AABBTree::updateSkip(unsigned int idx)
 inline unsigned int AABBTree::allocateNode()
 {
     // grow the memory if needed
-    if (m_num_nodes >= m_node_capacity)
+    ensureNodeCapacity(m_num_nodes + 1);
+
+    m_nodes[m_num_nodes] = AABBNode();
+    m_num_nodes++;
+    return m_num_nodes - 1;
+}
+
+/*! Rebuilds the SoA mirror of the node bounds used by overlapPacket. The
+   arrays are padded to a full packet with sentinel bounds whose clamped
+   distance is always far outside any query sphere, so full-width SIMD loads
+   starting at any valid node index are safe.
+*/
+inline void AABBTree::buildSoABounds()
+{
+    const unsigned int padded_size = m_num_nodes + OVERLAP_PACKET_WIDTH;
+    m_soa_lower_x.assign(padded_size, FLT_MAX);
+    m_soa_lower_y.assign(padded_size, FLT_MAX);
+    m_soa_lower_z.assign(padded_size, FLT_MAX);
+    m_soa_upper_x.assign(padded_size, -FLT_MAX);
+    m_soa_upper_y.assign(padded_size, -FLT_MAX);
+    m_soa_upper_z.assign(padded_size, -FLT_MAX);
+    for (unsigned int i = 0; i < m_num_nodes; i++)
     {
-        // determine new capacity
-        AABBNode* m_new_nodes = nullptr;
-        unsigned int m_new_node_capacity = m_node_capacity * 2;
-        if (m_new_node_capacity == 0)
-        {
-            m_new_node_capacity = 16;
-        }
+        updateSoABounds(i);
+    }
+}
 
-        // allocate new memory
-        // cppcheck-suppress AssignmentAddressToInteger
-        int retval = posix_memalign((void**) &m_new_nodes, 32, m_new_node_capacity * sizeof(AABBNode));
-        if (retval != 0)
-        {
-            throw std::runtime_error("Error allocating AABBTree memory");
-        }
+/*! \param idx Index of the node whose SoA bounds should be refreshed
+ */
+inline void AABBTree::updateSoABounds(unsigned int idx)
+{
+    const vec3<float> lower = m_nodes[idx].aabb.getLower();
+    const vec3<float> upper = m_nodes[idx].aabb.getUpper();
+    m_soa_lower_x[idx] = lower.x;
+    m_soa_lower_y[idx] = lower.y;
+    m_soa_lower_z[idx] = lower.z;
+    m_soa_upper_x[idx] = upper.x;
+    m_soa_upper_y[idx] = upper.y;
+    m_soa_upper_z[idx] = upper.z;
+}
 
-        // if we have old memory, copy it over
-        if (m_nodes != nullptr)
+/*! \param start Index of the first node to test
+    \param position Center of the query sphere
+    \param r_sq Squared radius of the query sphere
+    \returns A bitmask whose bit i is set when node (start + i) overlaps
+
+    Computes the clamped point-to-box distance for OVERLAP_PACKET_WIDTH
+   consecutive nodes at once, one SIMD lane per node, replicating the scalar
+   sphere-AABB test in AABB.h. The traversal consumes the mask bit by bit as
+   it walks the preorder layout, so most overlap tests are amortized over a
+   whole packet.
+*/
+inline unsigned int AABBTree::overlapPacket(unsigned int start, const vec3<float>& position,
+                                            float r_sq) const
+{
+#if defined(__AVX__)
+    const __m256 px = _mm256_set1_ps(position.x);
+    const __m256 py = _mm256_set1_ps(position.y);
+    const __m256 pz = _mm256_set1_ps(position.z);
+    const __m256 dx
+        = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(px, _mm256_loadu_ps(&m_soa_lower_x[start])),
+                                      _mm256_loadu_ps(&m_soa_upper_x[start])),
+                        px);
+    const __m256 dy
+        = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(py, _mm256_loadu_ps(&m_soa_lower_y[start])),
+                                      _mm256_loadu_ps(&m_soa_upper_y[start])),
+                        py);
+    const __m256 dz
+        = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(pz, _mm256_loadu_ps(&m_soa_lower_z[start])),
+                                      _mm256_loadu_ps(&m_soa_upper_z[start])),
+                        pz);
+    const __m256 dr_sq = _mm256_add_ps(_mm256_mul_ps(dx, dx),
+                                       _mm256_add_ps(_mm256_mul_ps(dy, dy), _mm256_mul_ps(dz, dz)));
+    return static_cast<unsigned int>(
+        _mm256_movemask_ps(_mm256_cmp_ps(dr_sq, _mm256_set1_ps(r_sq), _CMP_LT_OQ)));
+#elif defined(__SSE__)
+    const __m128 px = _mm_set1_ps(position.x);
+    const __m128 py = _mm_set1_ps(position.y);
+    const __m128 pz = _mm_set1_ps(position.z);
+    const __m128 dx = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(px, _mm_loadu_ps(&m_soa_lower_x[start])), _mm_loadu_ps(&m_soa_upper_x[start])),
+        px);
+    const __m128 dy = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(py, _mm_loadu_ps(&m_soa_lower_y[start])), _mm_loadu_ps(&m_soa_upper_y[start])),
+        py);
+    const __m128 dz = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(pz, _mm_loadu_ps(&m_soa_lower_z[start])), _mm_loadu_ps(&m_soa_upper_z[start])),
+        pz);
+    const __m128 dr_sq
+        = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_add_ps(_mm_mul_ps(dy, dy), _mm_mul_ps(dz, dz)));
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmplt_ps(dr_sq, _mm_set1_ps(r_sq))));
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < OVERLAP_PACKET_WIDTH; i++)
+    {
+        const float dx
+            = std::min(std::max(position.x, m_soa_lower_x[start + i]), m_soa_upper_x[start + i]) - position.x;
+        const float dy
+            = std::min(std::max(position.y, m_soa_lower_y[start + i]), m_soa_upper_y[start + i]) - position.y;
+        const float dz
+            = std::min(std::max(position.z, m_soa_lower_z[start + i]), m_soa_upper_z[start + i]) - position.z;
+        if (dx * dx + dy * dy + dz * dz < r_sq)
         {
-            // cppcheck doesn't recognize that posix_memalign allocates memory for m_new_nodes above.
-            // cppcheck-suppress nullPointer
-            std::memcpy((void*) m_new_nodes, (void*) m_nodes, sizeof(AABBNode) * m_num_nodes);
-            posix_memalign_free(m_nodes);
+            mask |= (1U << i);
         }
-        m_nodes = m_new_nodes;
-        m_node_capacity = m_new_node_capacity;
     }
+    return mask;
+#endif
+}
 
-    m_nodes[m_num_nodes] = AABBNode();
-    m_num_nodes++;
-    return m_num_nodes - 1;
+/*! \param capacity Minimum number of nodes the storage must hold
+
+    Grows the node array geometrically until it can hold at least \a capacity
+   nodes, copying over any existing nodes. Does nothing if the current storage
+   is already large enough.
+*/
+inline void AABBTree::ensureNodeCapacity(unsigned int capacity)
+{
+    if (capacity <= m_node_capacity)
+    {
+        return;
+    }
+
+    // determine new capacity
+    AABBNode* m_new_nodes = nullptr;
+    unsigned int m_new_node_capacity = m_node_capacity * 2;
+    if (m_new_node_capacity == 0)
+    {
+        m_new_node_capacity = 16;
+    }
+    while (m_new_node_capacity < capacity)
+    {
+        m_new_node_capacity *= 2;
+    }
+
+    // allocate new memory
+    // cppcheck-suppress AssignmentAddressToInteger
+    int retval = posix_memalign((void**) &m_new_nodes, 32, m_new_node_capacity * sizeof(AABBNode));
+    if (retval != 0)
+    {
+        throw std::runtime_error("Error allocating AABBTree memory");
+    }
+
+    // if we have old memory, copy it over
+    if (m_nodes != nullptr)
+    {
+        // cppcheck doesn't recognize that posix_memalign allocates memory for m_new_nodes above.
+        // cppcheck-suppress nullPointer
+        std::memcpy((void*) m_new_nodes, (void*) m_nodes, sizeof(AABBNode) * m_num_nodes);
+        posix_memalign_free(m_nodes);
+    }
+    m_nodes = m_new_nodes;
+    m_node_capacity = m_new_node_capacity;
 }
 
 }; }; // end namespace freud::locality
@@ -1,10 +1,19 @@
 #ifndef BOND_HISTOGRAM_COMPUTE_H
 #define BOND_HISTOGRAM_COMPUTE_H
 
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tbb/task_group.h>
+
+#include "AABBQuery.h"
+#include "ArrayFile.h"
 #include "Box.h"
+#include "ComputeProfile.h"
 #include "Histogram.h"
 #include "NeighborComputeFunctional.h"
 #include "NeighborQuery.h"
+#include "async_dispatch.h"
 
 namespace freud { namespace locality {
 
@@ -28,9 +37,12 @@ public:
     //! Reset the histogram to all zeros
     virtual void reset()
     {
+        m_async.wait();
         m_local_histograms.reset();
         m_frame_counter = 0;
         m_reduce = true;
+        m_profile.reset();
+        m_moments.reset();
     }
 
     //! Reduce thread-local arrays onto the primary data arrays.
@@ -42,23 +54,127 @@ public:
         return m_box;
     }
 
+    //! Block until any asynchronously enqueued accumulation has finished.
+    /*! Synchronous paths need not call this; reduceAndReturn and reset do so
+     *  on behalf of every accessor.
+     */
+    void synchronize()
+    {
+        m_async.wait();
+    }
+
+    //! Write a checkpoint of the accumulation state to a file.
+    /*! Snapshots everything needed to resume accumulating exactly where this
+     *  compute left off: the reduced bin counts, the frame counter and point
+     *  counts, and the box. Long accumulations in preemptible jobs can
+     *  checkpoint periodically and restart from the last snapshot instead of
+     *  from frame zero.
+     */
+    void checkpoint(const std::string& path)
+    {
+        m_async.wait();
+        util::ArrayFileWriter writer(path);
+        writeCheckpoint(writer);
+        writer.close();
+    }
+
+    //! Restore the accumulation state from a checkpoint file.
+    /*! Replaces any state accumulated so far; further frames accumulate on
+     *  top of the restored counts as if the run had never been interrupted.
+     *  Throws if the checkpoint's binning does not match this compute's.
+     */
+    void restore(const std::string& path)
+    {
+        m_async.wait();
+        const util::ArrayFileReader reader(path);
+        readCheckpoint(reader);
+    }
+
+    //! Merge a checkpoint file's accumulation state into this compute.
+    /*! The reduction endpoint for distributed accumulation: workers that
+     *  split a trajectory into frame ranges accumulate independently,
+     *  checkpoint their partial state, and one process merges the files
+     *  (the file is the transport, so any launcher that can move files
+     *  works). Bin counts and frame counters add on top of whatever this
+     *  compute has accumulated so far. Throws if the checkpoint's binning
+     *  does not match this compute's.
+     */
+    void merge(const std::string& path)
+    {
+        m_async.wait();
+        const util::ArrayFileReader reader(path);
+        mergeCheckpoint(reader);
+    }
+
     //! Return thing_to_return after reducing if necessary.
     template<typename U> U& reduceAndReturn(U& thing_to_return)
     {
+        m_async.wait();
         if (m_reduce)
         {
+            util::ComputeProfile::ScopedTimer timer(m_profile, util::ComputeProfile::reduce_phase);
             reduce();
         }
         m_reduce = false;
         return thing_to_return;
     }
 
+    //! Get the accumulated timing and counter instrumentation.
+    /*! The profile splits wall time between the accumulation and reduction
+     *  phases and counts processed bonds across all frames since the last
+     *  reset; see util::ComputeProfile for the details.
+     */
+    const util::ComputeProfile& getProfile() const
+    {
+        return m_profile;
+    }
+
     //! Get a reference to the bin counts array
     const util::ManagedArray<unsigned int>& getBinCounts()
     {
         return reduceAndReturn(m_histogram.getBinCounts());
     }
 
+    //! Track per-bin moments of the per-frame counts.
+    /*! Enables single-pass error estimation: each bin's mean and variance
+     *  across the frames of the accumulation are maintained online, so error
+     *  bars no longer require reanalyzing the trajectory over frame subsets.
+     *  Frames are gathered into blocks of block_size whose means serve as
+     *  the samples (block averaging, for correlated trajectory frames); a
+     *  block size of one treats every frame as its own sample. Call before
+     *  the first frame accumulates. Tracking adds one reduction of the
+     *  thread-local histograms per frame.
+     */
+    void trackMoments(unsigned int block_size = 1)
+    {
+        m_async.wait();
+        m_moments.prepare(getAxisSizes(), block_size);
+    }
+
+    //! Mean per-sample (block-averaged per-frame) contribution to each bin.
+    const util::ManagedArray<float>& getBinCountMean()
+    {
+        m_async.wait();
+        requireMoments();
+        return m_moments.getMean();
+    }
+
+    //! Sample variance of the per-sample contribution to each bin.
+    const util::ManagedArray<float>& getBinCountVariance()
+    {
+        m_async.wait();
+        requireMoments();
+        return m_moments.getVariance();
+    }
+
+    //! Number of complete blocks folded into the moments so far.
+    unsigned int getNumMomentSamples()
+    {
+        m_async.wait();
+        requireMoments();
+        return m_moments.getNumSamples();
+    }
+
     //! Return the bin centers.
     /*! This vector will be of size axis.size() for each axis.
      */
@@ -103,23 +219,201 @@ public:
                            locality::QueryArgs qargs, Func cf)
     {
         m_box = neighbor_query->getBox();
-        locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf);
+        util::ComputeProfile::ScopedTimer timer(m_profile, util::ComputeProfile::accumulate_phase);
+        locality::loopOverNeighborsStatic(neighbor_query, query_points, n_query_points, qargs, nlist,
+                                          [this, &cf](const NeighborBond& neighbor_bond) {
+                                              m_profile.countBond();
+                                              cf(neighbor_bond);
+                                          });
+        finishFrame(neighbor_query, n_query_points);
+    }
+
+    //! \internal
+    // Record the per-frame bookkeeping that accumulateGeneral performs.
+    /*! CompositeCompute drives registered computes' per-bond kernels from one
+        shared traversal and then calls this on each compute in place of
+        accumulateGeneral. Subclasses that mirror the bookkeeping into
+        secondary accumulations override it.
+    */
+    virtual void finishFrame(const locality::NeighborQuery* neighbor_query, unsigned int n_query_points)
+    {
+        m_box = neighbor_query->getBox();
         m_frame_counter++;
         m_n_points = neighbor_query->getNPoints();
         m_n_query_points = n_query_points;
         m_reduce = true;
+        if (m_moments.enabled())
+        {
+            m_moments.recordFrame(m_local_histograms);
+        }
+    }
+
+    //! \internal
+    // Batched accumulation over many frames of a trajectory.
+    /*! Accumulates n_frames frames in one call, each frame holding n_points
+        positions laid out frame-major in points with its own box. The points
+        of each frame serve as both the neighbor source and the query points,
+        which is how every per-frame accumulation loop in freud uses this
+        class. Per-frame overhead is hidden by software pipelining: the AABB
+        tree for frame i+1 is built on a separate task while the bonds of
+        frame i are being histogrammed, so on small frames the tree
+        construction cost largely disappears behind the accumulation.
+        \param points Frame-major array of n_frames * n_points positions.
+        \param n_points Number of points in each frame.
+        \param n_frames Number of frames.
+        \param boxes Array of n_frames simulation boxes, one per frame.
+        \param qargs Query arguments, applied identically to every frame.
+        \param cf An object with operator(NeighborBond) as input.
+    */
+    template<typename Func>
+    void accumulateGeneralFrames(const vec3<float>* points, unsigned int n_points, unsigned int n_frames,
+                                 const box::Box* boxes, locality::QueryArgs qargs, Func cf)
+    {
+        if (n_frames == 0)
+        {
+            return;
+        }
+        std::unique_ptr<locality::AABBQuery> frame_query(new locality::AABBQuery(boxes[0], points, n_points));
+        std::unique_ptr<locality::AABBQuery> next_query;
+        tbb::task_group builder;
+        for (unsigned int frame = 0; frame < n_frames; ++frame)
+        {
+            const vec3<float>* frame_points = points + size_t(frame) * n_points;
+            if (frame + 1 < n_frames)
+            {
+                builder.run([&, frame] {
+                    next_query.reset(new locality::AABBQuery(
+                        boxes[frame + 1], points + size_t(frame + 1) * n_points, n_points));
+                });
+            }
+            accumulateGeneral(frame_query.get(), frame_points, n_points, nullptr, qargs, cf);
+            // The builder task writes next_query, so it must finish before the
+            // handoff (and before the loop may touch the shared captures again).
+            builder.wait();
+            frame_query = std::move(next_query);
+        }
     }
 
 protected:
+    //! Write this compute's accumulation state into an open checkpoint file.
+    /*! Subclasses with accumulation state beyond the primary histogram
+     *  override this (and readCheckpoint) to add their own sections.
+     */
+    virtual void writeCheckpoint(util::ArrayFileWriter& writer)
+    {
+        util::ManagedArray<unsigned int> counts;
+        counts.prepare(getAxisSizes());
+        m_local_histograms.reduceInto(counts);
+        writer.write("counts", counts);
+
+        util::ManagedArray<unsigned int> meta;
+        meta.prepare(3);
+        meta[0] = m_frame_counter;
+        meta[1] = m_n_points;
+        meta[2] = m_n_query_points;
+        writer.write("meta", meta);
+
+        util::ManagedArray<float> box_state;
+        box_state.prepare(10);
+        box_state[0] = m_box.getLx();
+        box_state[1] = m_box.getLy();
+        box_state[2] = m_box.getLz();
+        box_state[3] = m_box.getTiltFactorXY();
+        box_state[4] = m_box.getTiltFactorXZ();
+        box_state[5] = m_box.getTiltFactorYZ();
+        box_state[6] = m_box.is2D() ? 1.0F : 0.0F;
+        box_state[7] = m_box.getPeriodicX() ? 1.0F : 0.0F;
+        box_state[8] = m_box.getPeriodicY() ? 1.0F : 0.0F;
+        box_state[9] = m_box.getPeriodicZ() ? 1.0F : 0.0F;
+        writer.write("box", box_state);
+    }
+
+    //! Read this compute's accumulation state from an open checkpoint file.
+    virtual void readCheckpoint(const util::ArrayFileReader& reader)
+    {
+        const auto counts = reader.read<unsigned int>("counts");
+        const auto meta = reader.read<unsigned int>("meta");
+        const auto box_state = reader.read<float>("box");
+        if (counts.size() != m_histogram.size() || meta.size() != 3 || box_state.size() != 10)
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        // The canonical accumulation state lives in the thread-local copies
+        // (reduction sums them from scratch each time), so the restored
+        // counts are injected into one local copy for future frames to build
+        // on.
+        m_local_histograms.reset();
+        auto& local = m_local_histograms.local();
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] != 0)
+            {
+                local.increment(i, counts[i]);
+            }
+        }
+        m_frame_counter = meta[0];
+        m_n_points = meta[1];
+        m_n_query_points = meta[2];
+        m_box = box::Box(box_state[0], box_state[1], box_state[2], box_state[3], box_state[4], box_state[5],
+                         box_state[6] != 0.0F);
+        m_box.setPeriodic(box_state[7] != 0.0F, box_state[8] != 0.0F, box_state[9] != 0.0F);
+        m_reduce = true;
+    }
+
+    //! Add a checkpoint file's accumulation state onto this compute's.
+    /*! Unlike readCheckpoint this does not replace existing state: counts
+     *  and frame counters add, and the point counts are taken from the
+     *  checkpoint (merged workers analyze the same system, so they agree).
+     *  Subclasses with accumulation state beyond the primary histogram
+     *  override this to merge their own sections.
+     */
+    virtual void mergeCheckpoint(const util::ArrayFileReader& reader)
+    {
+        const auto counts = reader.read<unsigned int>("counts");
+        const auto meta = reader.read<unsigned int>("meta");
+        const auto box_state = reader.read<float>("box");
+        if (counts.size() != m_histogram.size() || meta.size() != 3 || box_state.size() != 10)
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's binning.");
+        }
+        auto& local = m_local_histograms.local();
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] != 0)
+            {
+                local.increment(i, counts[i]);
+            }
+        }
+        m_frame_counter += meta[0];
+        m_n_points = meta[1];
+        m_n_query_points = meta[2];
+        m_box = box::Box(box_state[0], box_state[1], box_state[2], box_state[3], box_state[4], box_state[5],
+                         box_state[6] != 0.0F);
+        m_box.setPeriodic(box_state[7] != 0.0F, box_state[8] != 0.0F, box_state[9] != 0.0F);
+        m_reduce = true;
+    }
+
     box::Box m_box;
     unsigned int m_frame_counter {0};  //!< Number of frames calculated.
     unsigned int m_n_points {0};       //!< The number of points.
     unsigned int m_n_query_points {0}; //!< The number of query points.
     bool m_reduce {true};              //!< Whether or not the histogram needs to be reduced.
+    util::ComputeProfile m_profile;    //!< Phase timers and bond counters for this compute.
+    parallel::AsyncHandle m_async;     //!< Completion of an asynchronously enqueued accumulation.
+
+    //! Throw unless moment tracking has been enabled.
+    void requireMoments() const
+    {
+        if (!m_moments.enabled())
+        {
+            throw std::runtime_error("Moment tracking was not enabled; call trackMoments first.");
+        }
+    }
 
     util::Histogram<unsigned int> m_histogram; //!< Histogram of interparticle distances (bond lengths).
     util::Histogram<unsigned int>::ThreadLocalHistogram
         m_local_histograms; //!< Thread local bin counts for TBB parallelism
+    util::HistogramMoments<unsigned int> m_moments; //!< Optional per-bin moments across frames.
 
     using BondHistogram = util::Histogram<unsigned int>;
 };
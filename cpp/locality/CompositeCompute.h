@@ -0,0 +1,187 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef COMPOSITE_COMPUTE_H
+#define COMPOSITE_COMPUTE_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "BondHistogramCompute.h"
+#include "DomainDecomposition.h"
+#include "NeighborBond.h"
+#include "NeighborComputeFunctional.h"
+#include "NeighborQuery.h"
+#include "RawPoints.h"
+#include "VectorMath.h"
+
+/*! \file CompositeCompute.h
+    \brief Drive several bond histogram computes from one neighbor traversal.
+*/
+
+namespace freud { namespace locality {
+
+//! One compute's participation in a shared neighbor traversal.
+/*! bond is invoked once per neighbor bond, concurrently from the traversal's
+ *  worker threads, exactly like the kernels accumulateGeneral drives. drain,
+ *  when set, runs serially after the traversal; computes that stage bonds in
+ *  per-thread blocks use it to flush their partially filled blocks. The
+ *  compute receives the frame bookkeeping through finishFrame once the
+ *  traversal completes.
+ */
+struct BondConsumer
+{
+    BondHistogramCompute* compute {nullptr};       //!< Bookkeeping target.
+    std::function<void(const NeighborBond&)> bond; //!< Per-bond accumulation kernel.
+    std::function<void()> drain;                   //!< Optional post-traversal flush.
+};
+
+//! Accumulate multiple bond histogram computes over one neighbor pass.
+/*! Running several computes on the same frame regenerates the same bonds
+ *  once per compute, and bond generation (query iteration plus the periodic
+ *  wrap) dominates each compute's runtime. A CompositeCompute instead
+ *  traverses the neighbors once and fans every bond out to each registered
+ *  consumer's kernel, so the traversal cost is paid once regardless of how
+ *  many analyses consume the frame.
+ *
+ *  Consumers bind the current frame's input arrays, so the intended pattern
+ *  is to register fresh consumers for each frame (registration is cheap)
+ *  and accumulate once per frame:
+ *
+ *      CompositeCompute composite;
+ *      composite.addConsumer(rdf.makeBondConsumer());
+ *      composite.addConsumer(pmft.makeBondConsumer(nq, orientations, points));
+ *      composite.accumulate(nq, points, n_points, nullptr, qargs);
+ *      composite.clearConsumers();
+ *
+ *  The per-compute profile bond counters are not advanced by a shared
+ *  traversal, since its bonds belong to no single compute.
+ */
+class CompositeCompute
+{
+public:
+    //! Register a consumer for subsequent accumulate calls.
+    void addConsumer(BondConsumer consumer)
+    {
+        m_consumers.push_back(std::move(consumer));
+    }
+
+    //! Remove all registered consumers.
+    void clearConsumers()
+    {
+        m_consumers.clear();
+    }
+
+    //! Accumulate one frame into every registered consumer.
+    /*! The arguments mirror BondHistogramCompute::accumulateGeneral.
+     */
+    void accumulate(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                    unsigned int n_query_points, const NeighborList* nlist, QueryArgs qargs)
+    {
+        loopOverNeighborsStatic(neighbor_query, query_points, n_query_points, qargs, nlist,
+                                [this](const NeighborBond& neighbor_bond) {
+                                    for (const auto& consumer : m_consumers)
+                                    {
+                                        consumer.bond(neighbor_bond);
+                                    }
+                                });
+        for (const auto& consumer : m_consumers)
+        {
+            if (consumer.drain)
+            {
+                consumer.drain();
+            }
+            consumer.compute->finishFrame(neighbor_query, n_query_points);
+        }
+    }
+
+    //! Accumulate one frame subdomain by subdomain.
+    /*! Frames too large to neighbor-search in one piece are processed through
+     *  a DomainDecomposition: each subdomain's owned points are queried
+     *  against its owned-plus-ghost set, so only one subdomain's acceleration
+     *  structure is ever resident, and every bond of the full frame (including
+     *  bonds crossing subdomain and periodic boundaries) is accumulated
+     *  exactly once. The results match a single full-frame accumulation.
+     *
+     *  Bond indices refer to the subdomain's local point buffer, so consumers
+     *  must bind subdomain-local input arrays; bind is invoked once per
+     *  subdomain, after any previously registered consumers are cleared, and
+     *  registers that subdomain's consumers (gathering per-point inputs such
+     *  as orientations through Subdomain::point_ids). Each registered
+     *  compute's frame bookkeeping is recorded once for the whole frame, not
+     *  once per subdomain, so frame counters and point counts match the
+     *  single-shot path.
+     *
+     *  Only ball queries are supported: a nearest-neighbor query could need
+     *  neighbors beyond the ghost distance, and qargs.r_max must not exceed
+     *  the decomposition's for the same reason.
+     */
+    void accumulateDecomposed(DomainDecomposition& decomposition, const vec3<float>* points,
+                              unsigned int n_points, QueryArgs qargs,
+                              const std::function<void(const Subdomain&, const NeighborQuery*)>& bind)
+    {
+        if (qargs.mode != QueryType::ball)
+        {
+            throw std::invalid_argument("Decomposed accumulation only supports ball queries.");
+        }
+        if (qargs.r_max > decomposition.getRMax())
+        {
+            throw std::invalid_argument(
+                "Query r_max exceeds the decomposition's ghost distance.");
+        }
+        decomposition.assign(points, n_points);
+
+        std::vector<BondHistogramCompute*> computes;
+        for (unsigned int s = 0; s < decomposition.getNumSubdomains(); ++s)
+        {
+            const Subdomain sub = decomposition.buildSubdomain(s, points);
+            if (sub.points.empty())
+            {
+                continue;
+            }
+            const AABBQuery subdomain_query(decomposition.getBox(), sub.points.data(),
+                                            sub.points.size());
+            clearConsumers();
+            bind(sub, &subdomain_query);
+            loopOverNeighborsStatic(&subdomain_query, sub.points.data(), sub.n_owned, qargs, nullptr,
+                                    [this](const NeighborBond& neighbor_bond) {
+                                        for (const auto& consumer : m_consumers)
+                                        {
+                                            consumer.bond(neighbor_bond);
+                                        }
+                                    });
+            for (const auto& consumer : m_consumers)
+            {
+                if (consumer.drain)
+                {
+                    consumer.drain();
+                }
+                if (std::find(computes.begin(), computes.end(), consumer.compute) == computes.end())
+                {
+                    computes.push_back(consumer.compute);
+                }
+            }
+        }
+        clearConsumers();
+
+        // One bookkeeping pass for the whole frame; the RawPoints query
+        // carries the frame's box and point count without building any
+        // acceleration structure.
+        const RawPoints full_frame(decomposition.getBox(), points, n_points);
+        for (BondHistogramCompute* compute : computes)
+        {
+            compute->finishFrame(&full_frame, n_points);
+        }
+    }
+
+private:
+    std::vector<BondConsumer> m_consumers; //!< Consumers sharing the traversal.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // COMPOSITE_COMPUTE_H
@@ -0,0 +1,197 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <stdexcept>
+
+#include "DomainDecomposition.h"
+#include "utils.h"
+
+/*! \file DomainDecomposition.cc
+    \brief Splits a frame into spatial subdomains with ghost layers.
+*/
+
+namespace freud { namespace locality {
+
+DomainDecomposition::DomainDecomposition(const box::Box& box, vec3<unsigned int> grid, float r_max)
+    : m_box(box), m_grid(grid), m_r_max(r_max)
+{
+    if (r_max <= 0)
+    {
+        throw std::invalid_argument("DomainDecomposition requires r_max to be positive.");
+    }
+    if (grid.x < 1 || grid.y < 1 || grid.z < 1)
+    {
+        throw std::invalid_argument(
+            "DomainDecomposition requires at least one subdomain along each axis.");
+    }
+    if (box.is2D() && grid.z != 1)
+    {
+        throw std::invalid_argument("2D boxes cannot be decomposed along z.");
+    }
+
+    // The ghost test works in subdomain widths: a point within m_ghost_width
+    // of a subdomain face (measured toward that face) is a ghost of the
+    // adjacent subdomain. Adjacent is the operative word; like LinkCell's
+    // cell width, each subdomain must be at least r_max wide along every
+    // decomposed axis so that ghosts never originate further than one
+    // subdomain away.
+    const vec3<float> plane_distance = box.getNearestPlaneDistance();
+    m_ghost_width = vec3<float>(r_max * float(grid.x) / plane_distance.x,
+                                r_max * float(grid.y) / plane_distance.y,
+                                box.is2D() ? float(0.0) : r_max * float(grid.z) / plane_distance.z);
+    if ((grid.x > 1 && m_ghost_width.x > 1) || (grid.y > 1 && m_ghost_width.y > 1)
+        || (grid.z > 1 && m_ghost_width.z > 1))
+    {
+        throw std::invalid_argument(
+            "Subdomain width required to be at least r_max along every decomposed axis.");
+    }
+
+    m_owned.resize(getNumSubdomains());
+    m_ghosts.resize(getNumSubdomains());
+}
+
+void DomainDecomposition::assign(const vec3<float>* points, unsigned int n_points)
+{
+    m_n_points = n_points;
+    for (auto& ids : m_owned)
+    {
+        ids.clear();
+    }
+    for (auto& ids : m_ghosts)
+    {
+        ids.clear();
+    }
+
+    const vec3<bool> periodic = m_box.getPeriodic();
+    const vec3<int> grid(int(m_grid.x), int(m_grid.y), int(m_grid.z));
+    for (unsigned int i = 0; i < n_points; ++i)
+    {
+        // Work in fractional coordinates scaled by the grid, wrapped into the
+        // box along periodic axes so out-of-box points land in their image's
+        // subdomain, exactly as a neighbor query would treat them.
+        vec3<float> alpha = m_box.makeFractional(points[i]);
+        if (periodic.x)
+        {
+            alpha.x = util::modulusPositive(alpha.x, float(1.0));
+        }
+        if (periodic.y)
+        {
+            alpha.y = util::modulusPositive(alpha.y, float(1.0));
+        }
+        if (periodic.z)
+        {
+            alpha.z = util::modulusPositive(alpha.z, float(1.0));
+        }
+        const vec3<float> scaled(alpha.x * float(grid.x), alpha.y * float(grid.y),
+                                 alpha.z * float(grid.z));
+        vec3<int> home(int(std::floor(scaled.x)), int(std::floor(scaled.y)), int(std::floor(scaled.z)));
+        // Aperiodic axes can place points outside the grid; they belong to
+        // the nearest edge subdomain.
+        home.x = std::min(std::max(home.x, 0), grid.x - 1);
+        home.y = std::min(std::max(home.y, 0), grid.y - 1);
+        home.z = std::min(std::max(home.z, 0), grid.z - 1);
+        const unsigned int home_index = subdomainIndex(home.x, home.y, home.z);
+        m_owned[home_index].push_back(i);
+
+        // Flag per axis whether the point sits within the ghost distance of
+        // its subdomain's lower (-1) or upper (+1) face.
+        int lo[3] = {0, 0, 0};
+        int hi[3] = {0, 0, 0};
+        lo[0] = (scaled.x - float(home.x) < m_ghost_width.x) ? -1 : 0;
+        hi[0] = (float(home.x + 1) - scaled.x < m_ghost_width.x) ? 1 : 0;
+        lo[1] = (scaled.y - float(home.y) < m_ghost_width.y) ? -1 : 0;
+        hi[1] = (float(home.y + 1) - scaled.y < m_ghost_width.y) ? 1 : 0;
+        lo[2] = (scaled.z - float(home.z) < m_ghost_width.z) ? -1 : 0;
+        hi[2] = (float(home.z + 1) - scaled.z < m_ghost_width.z) ? 1 : 0;
+
+        // Enumerate the flagged neighbor subdomains, wrapping along periodic
+        // axes and dropping out-of-range neighbors along aperiodic ones. With
+        // fewer than three subdomains on an axis the two wrapped neighbors
+        // can coincide (or be the home subdomain itself), so ghost targets
+        // are deduplicated before insertion.
+        unsigned int targets[26];
+        unsigned int n_targets = 0;
+        for (int ox = lo[0]; ox <= hi[0]; ++ox)
+        {
+            for (int oy = lo[1]; oy <= hi[1]; ++oy)
+            {
+                for (int oz = lo[2]; oz <= hi[2]; ++oz)
+                {
+                    if (ox == 0 && oy == 0 && oz == 0)
+                    {
+                        continue;
+                    }
+                    vec3<int> cell(home.x + ox, home.y + oy, home.z + oz);
+                    if (periodic.x)
+                    {
+                        cell.x = (cell.x + grid.x) % grid.x;
+                    }
+                    if (periodic.y)
+                    {
+                        cell.y = (cell.y + grid.y) % grid.y;
+                    }
+                    if (periodic.z)
+                    {
+                        cell.z = (cell.z + grid.z) % grid.z;
+                    }
+                    if (cell.x < 0 || cell.x >= grid.x || cell.y < 0 || cell.y >= grid.y || cell.z < 0
+                        || cell.z >= grid.z)
+                    {
+                        continue;
+                    }
+                    const unsigned int target = subdomainIndex(cell.x, cell.y, cell.z);
+                    if (target == home_index)
+                    {
+                        continue;
+                    }
+                    bool seen = false;
+                    for (unsigned int t = 0; t < n_targets; ++t)
+                    {
+                        if (targets[t] == target)
+                        {
+                            seen = true;
+                            break;
+                        }
+                    }
+                    if (!seen)
+                    {
+                        targets[n_targets++] = target;
+                    }
+                }
+            }
+        }
+        for (unsigned int t = 0; t < n_targets; ++t)
+        {
+            m_ghosts[targets[t]].push_back(i);
+        }
+    }
+}
+
+Subdomain DomainDecomposition::buildSubdomain(unsigned int subdomain, const vec3<float>* points) const
+{
+    if (subdomain >= getNumSubdomains())
+    {
+        throw std::out_of_range("Subdomain index requested does not exist.");
+    }
+    const auto& owned = m_owned[subdomain];
+    const auto& ghosts = m_ghosts[subdomain];
+
+    Subdomain sub;
+    sub.n_owned = owned.size();
+    sub.points.reserve(owned.size() + ghosts.size());
+    sub.point_ids.reserve(owned.size() + ghosts.size());
+    for (const unsigned int id : owned)
+    {
+        sub.points.push_back(points[id]);
+        sub.point_ids.push_back(id);
+    }
+    for (const unsigned int id : ghosts)
+    {
+        sub.points.push_back(points[id]);
+        sub.point_ids.push_back(id);
+    }
+    return sub;
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,117 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef DOMAIN_DECOMPOSITION_H
+#define DOMAIN_DECOMPOSITION_H
+
+#include <vector>
+
+#include "Box.h"
+#include "VectorMath.h"
+
+/*! \file DomainDecomposition.h
+    \brief Splits a frame into spatial subdomains with ghost layers.
+*/
+
+namespace freud { namespace locality {
+
+//! One materialized subdomain of a decomposed frame.
+/*! The points a subdomain owns occupy indices [0, n_owned); the remaining
+ *  entries are ghosts, points owned by neighboring subdomains that lie within
+ *  the ghost distance of this one (under the minimum image convention).
+ *  Because the owned points lead the array, a query that uses the subdomain's
+ *  points as both neighbor source and query points keeps matching indices for
+ *  the owned points, so self-exclusion behaves exactly as in the full frame.
+ *  point_ids maps every entry (owned and ghost) back to its index in the
+ *  original frame, for gathering per-point inputs such as orientations.
+ */
+struct Subdomain
+{
+    std::vector<vec3<float>> points;     //!< Owned points first, then ghosts.
+    std::vector<unsigned int> point_ids; //!< Original frame index of each entry.
+    unsigned int n_owned {0};            //!< Number of owned points.
+};
+
+//! Assign points to a grid of spatial subdomains with ghost layers.
+/*! Frames too large to neighbor-search in one piece can be processed one
+ *  subdomain at a time: each point is owned by exactly one subdomain, and
+ *  every point within the ghost distance of a subdomain (under the minimum
+ *  image convention) is replicated into it as a ghost. Querying each
+ *  subdomain's owned points against its owned-plus-ghost set then finds
+ *  every bond of the full frame exactly once, including bonds that cross
+ *  subdomain and periodic boundaries, while only one subdomain's
+ *  acceleration structure is ever resident.
+ *
+ *  Assignment stores only per-subdomain index lists; the point buffers are
+ *  materialized one subdomain at a time through buildSubdomain, which is
+ *  what bounds the peak memory footprint.
+ */
+class DomainDecomposition
+{
+public:
+    //! Constructor
+    /*! \param box The simulation box being decomposed.
+     *  \param grid Number of subdomains along each box vector. Each
+     *         subdomain must be at least r_max wide along every decomposed
+     *         axis so that ghosts come only from adjacent subdomains.
+     *  \param r_max The ghost distance; queries against the decomposition
+     *         must not exceed it.
+     */
+    DomainDecomposition(const box::Box& box, vec3<unsigned int> grid, float r_max);
+
+    //! Get the simulation box.
+    const box::Box& getBox() const
+    {
+        return m_box;
+    }
+
+    //! Get the ghost distance.
+    float getRMax() const
+    {
+        return m_r_max;
+    }
+
+    //! Get the total number of subdomains.
+    unsigned int getNumSubdomains() const
+    {
+        return m_grid.x * m_grid.y * m_grid.z;
+    }
+
+    //! Get the number of points in the most recent assignment.
+    unsigned int getNumPoints() const
+    {
+        return m_n_points;
+    }
+
+    //! Assign a frame's points to subdomains.
+    /*! Builds the owned and ghost index lists for every subdomain. Only
+     *  indices are stored; call buildSubdomain to materialize one
+     *  subdomain's point buffer.
+     */
+    void assign(const vec3<float>* points, unsigned int n_points);
+
+    //! Materialize one subdomain of the most recently assigned frame.
+    /*! \param subdomain The subdomain index, 0 <= subdomain < getNumSubdomains().
+     *  \param points The same frame passed to assign.
+     */
+    Subdomain buildSubdomain(unsigned int subdomain, const vec3<float>* points) const;
+
+private:
+    //! Flatten grid cell coordinates to a subdomain index.
+    unsigned int subdomainIndex(unsigned int cx, unsigned int cy, unsigned int cz) const
+    {
+        return cx + m_grid.x * (cy + m_grid.y * cz);
+    }
+
+    box::Box m_box;             //!< The simulation box being decomposed.
+    vec3<unsigned int> m_grid;  //!< Number of subdomains along each box vector.
+    float m_r_max;              //!< The ghost distance.
+    vec3<float> m_ghost_width;  //!< Ghost distance per axis, in subdomain widths.
+    unsigned int m_n_points {0}; //!< Number of points in the last assignment.
+    std::vector<std::vector<unsigned int>> m_owned;  //!< Owned point ids per subdomain.
+    std::vector<std::vector<unsigned int>> m_ghosts; //!< Ghost point ids per subdomain.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // DOMAIN_DECOMPOSITION_H
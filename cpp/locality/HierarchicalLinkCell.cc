@@ -0,0 +1,218 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "HierarchicalLinkCell.h"
+
+/*! \file HierarchicalLinkCell.cc
+    \brief Build a multi-resolution cell list from a set of points.
+*/
+
+namespace freud { namespace locality {
+
+// Default constructor
+HierarchicalLinkCell::HierarchicalLinkCell() : NeighborQuery() {}
+
+HierarchicalLinkCell::HierarchicalLinkCell(const box::Box& box, const vec3<float>* points,
+                                           unsigned int n_points, const float* point_scales,
+                                           unsigned int num_levels)
+    : NeighborQuery(box, points, n_points)
+{
+    // Width ceiling imposed by the box: cells may not exceed half the
+    // nearest plane distance (see LinkCell::isValidCellWidth).
+    const vec3<float> plane_distance = box.getNearestPlaneDistance();
+    float max_width = std::min(plane_distance.x, plane_distance.y);
+    if (!box.is2D())
+    {
+        max_width = std::min(max_width, plane_distance.z);
+    }
+    max_width *= 0.499f;
+
+    float min_scale(0);
+    float max_scale(0);
+    if (point_scales != nullptr)
+    {
+        min_scale = max_scale = point_scales[0];
+        for (unsigned int i = 0; i < n_points; ++i)
+        {
+            if (point_scales[i] <= 0)
+            {
+                throw std::invalid_argument("HierarchicalLinkCell requires positive point scales.");
+            }
+            min_scale = std::min(min_scale, point_scales[i]);
+            max_scale = std::max(max_scale, point_scales[i]);
+        }
+    }
+
+    // Pick the number of levels: one per factor-of-eight span of scales
+    // unless the caller fixed it, and always one for uniform scales.
+    unsigned int levels = 1;
+    if (point_scales != nullptr && max_scale > min_scale)
+    {
+        if (num_levels != 0)
+        {
+            levels = std::min(num_levels, MAX_LEVELS);
+        }
+        else
+        {
+            const float spread = max_scale / min_scale;
+            levels = 1 + static_cast<unsigned int>(std::log(spread) / std::log(8.0F));
+            levels = std::min(levels, MAX_LEVELS);
+        }
+    }
+
+    // Assign each point to the level whose geometric scale band contains it.
+    const float log_band
+        = levels > 1 ? std::log(max_scale / min_scale) / static_cast<float>(levels) : float(1.0);
+    std::vector<std::vector<vec3<float>>> level_points(levels);
+    std::vector<std::vector<unsigned int>> level_indices(levels);
+    for (unsigned int i = 0; i < n_points; ++i)
+    {
+        unsigned int l = 0;
+        if (levels > 1)
+        {
+            l = static_cast<unsigned int>(std::log(point_scales[i] / min_scale) / log_band);
+            l = std::min(l, levels - 1);
+        }
+        level_points[l].push_back(points[i]);
+        level_indices[l].push_back(i);
+    }
+
+    // Build a grid per nonempty level, with cells sized to the upper edge of
+    // the level's scale band (clamped to what the box allows). With no scale
+    // information the single grid falls back to LinkCell's density heuristic.
+    for (unsigned int l = 0; l < levels; ++l)
+    {
+        if (level_points[l].empty())
+        {
+            continue;
+        }
+        Level level;
+        level.points = std::move(level_points[l]);
+        level.original_indices = std::move(level_indices[l]);
+        float width = 0;
+        if (point_scales != nullptr)
+        {
+            width = levels > 1 ? min_scale * std::exp(log_band * static_cast<float>(l + 1)) : max_scale;
+            width = std::min(width, max_width);
+        }
+        level.cells.reset(new LinkCell(box, level.points.data(),
+                                       static_cast<unsigned int>(level.points.size()), width));
+        m_levels.push_back(std::move(level));
+    }
+}
+
+std::shared_ptr<NeighborQueryPerPointIterator>
+HierarchicalLinkCell::querySingle(const vec3<float> query_point, unsigned int query_point_idx,
+                                  QueryArgs args) const
+{
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::ball)
+    {
+        const float r_max = args.r_maxes != nullptr ? args.r_maxes[query_point_idx] : args.r_max;
+        return std::make_shared<HierarchicalBallIterator>(this, query_point, query_point_idx, r_max,
+                                                          args.r_min, args.exclude_ii);
+    }
+    if (args.mode == QueryType::nearest)
+    {
+        return std::make_shared<HierarchicalNearestIterator>(this, query_point, query_point_idx,
+                                                             args.num_neighbors, args.r_max, args.r_min,
+                                                             args.exclude_ii);
+    }
+    throw std::runtime_error("Invalid query mode provided to generic query function.");
+}
+
+NeighborBond HierarchicalBallIterator::next()
+{
+    const auto& levels = m_hierarchy->m_levels;
+    while (m_level < levels.size())
+    {
+        const auto& level = levels[m_level];
+        if (!m_level_iter)
+        {
+            // The inner iterator sees level-local indices, so self-exclusion
+            // must wait until after remapping below.
+            QueryArgs args;
+            args.mode = QueryType::ball;
+            args.r_max = m_r_max;
+            args.r_min = m_r_min;
+            args.exclude_ii = false;
+            m_level_iter = level.cells->querySingle(m_query_point, m_query_point_idx, args);
+        }
+        while (!m_level_iter->end())
+        {
+            NeighborBond nb = m_level_iter->next();
+            if (nb == ITERATOR_TERMINATOR)
+            {
+                continue;
+            }
+            nb.point_idx = level.original_indices[nb.point_idx];
+            if (m_exclude_ii && nb.point_idx == m_query_point_idx)
+            {
+                continue;
+            }
+            return nb;
+        }
+        m_level_iter.reset();
+        ++m_level;
+    }
+    m_finished = true;
+    return ITERATOR_TERMINATOR;
+}
+
+HierarchicalNearestIterator::HierarchicalNearestIterator(const HierarchicalLinkCell* neighbor_query,
+                                                         const vec3<float>& query_point,
+                                                         unsigned int query_point_idx,
+                                                         unsigned int num_neighbors, float r_max,
+                                                         float r_min, bool exclude_ii)
+    : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii)
+{
+    // The k nearest overall are each among the k nearest within their own
+    // level. When excluding self bonds the self point may consume one slot
+    // in its level, so one extra candidate is requested per level.
+    const unsigned int per_level = exclude_ii ? num_neighbors + 1 : num_neighbors;
+    for (const auto& level : neighbor_query->m_levels)
+    {
+        QueryArgs args;
+        args.mode = QueryType::nearest;
+        args.num_neighbors = per_level;
+        args.r_max = r_max;
+        args.r_min = r_min;
+        args.exclude_ii = false;
+        auto it = level.cells->querySingle(query_point, query_point_idx, args);
+        while (!it->end())
+        {
+            NeighborBond nb = it->next();
+            if (nb == ITERATOR_TERMINATOR)
+            {
+                continue;
+            }
+            nb.point_idx = level.original_indices[nb.point_idx];
+            if (exclude_ii && nb.point_idx == query_point_idx)
+            {
+                continue;
+            }
+            m_neighbors.push_back(nb);
+        }
+    }
+    std::sort(m_neighbors.begin(), m_neighbors.end(), compareNeighborDistance);
+    if (m_neighbors.size() > num_neighbors)
+    {
+        m_neighbors.resize(num_neighbors);
+    }
+}
+
+NeighborBond HierarchicalNearestIterator::next()
+{
+    if (m_current < m_neighbors.size())
+    {
+        return m_neighbors[m_current++];
+    }
+    m_finished = true;
+    return ITERATOR_TERMINATOR;
+}
+
+}; }; // end namespace freud::locality
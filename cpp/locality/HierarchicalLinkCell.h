@@ -0,0 +1,150 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef HIERARCHICAL_LINK_CELL_H
+#define HIERARCHICAL_LINK_CELL_H
+
+#include <memory>
+#include <vector>
+
+#include "Box.h"
+#include "LinkCell.h"
+#include "NeighborQuery.h"
+
+/*! \file HierarchicalLinkCell.h
+    \brief Build a multi-resolution cell list from a set of points.
+*/
+
+namespace freud { namespace locality {
+
+//! A nested multi-resolution cell list for multi-scale systems.
+/*! A single uniform grid collapses for polydisperse systems where
+ *  interaction scales span a wide range: a grid coarse enough for the large
+ *  particles produces huge candidate sets for the small ones, while a grid
+ *  fine enough for the small particles makes queries for the large ones walk
+ *  enormous numbers of cells. This class maintains two or three nested
+ *  LinkCell grids at geometrically spaced resolutions and bins each particle
+ *  at the level matching its own interaction scale, so sparse large-scale
+ *  particles live in coarse cells and dense small-scale particles in fine
+ *  ones.
+ *
+ *  Queries search every level with that level's grid and merge the results,
+ *  which makes the structure a drop-in NeighborQuery: all points within the
+ *  cutoff are found regardless of which level holds them, and the class is
+ *  usable everywhere a NeighborQuery pointer is accepted. With a null scale
+ *  array (or uniform scales) a single level is built and behavior matches a
+ *  plain LinkCell.
+ */
+class HierarchicalLinkCell : public NeighborQuery
+{
+public:
+    //! Largest number of levels ever built; beyond three the per-level query
+    //! overhead outweighs any binning gain.
+    static constexpr unsigned int MAX_LEVELS = 3;
+
+    //! Null Constructor
+    HierarchicalLinkCell();
+
+    //! Constructor
+    /*! \param box The simulation box.
+     *  \param points The points to bin.
+     *  \param n_points Number of points.
+     *  \param point_scales Per-point interaction scales (e.g. particle
+     *         diameters or cutoffs), of length n_points; may be null, in
+     *         which case a single level is built.
+     *  \param num_levels Number of resolution levels, 0 to choose
+     *         automatically from the scale spread (at most MAX_LEVELS).
+     */
+    HierarchicalLinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                         const float* point_scales = nullptr, unsigned int num_levels = 0);
+
+    //! Get the number of levels actually built.
+    unsigned int getNumLevels() const
+    {
+        return static_cast<unsigned int>(m_levels.size());
+    }
+
+    //! Get the cell width of one level's grid.
+    float getCellWidth(unsigned int level) const
+    {
+        return m_levels.at(level).cells->getCellWidth();
+    }
+
+    //! Get the number of points binned at one level.
+    unsigned int getLevelSize(unsigned int level) const
+    {
+        return static_cast<unsigned int>(m_levels.at(level).original_indices.size());
+    }
+
+    //! Implementation of per-particle query (see NeighborQuery.h for documentation).
+    std::shared_ptr<NeighborQueryPerPointIterator>
+    querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const override;
+
+private:
+    //! One resolution level: a LinkCell over a subset of the points.
+    struct Level
+    {
+        std::vector<vec3<float>> points;            //!< The points binned at this level.
+        std::vector<unsigned int> original_indices; //!< Level-local index to original index.
+        std::unique_ptr<LinkCell> cells;            //!< The grid over this level's points.
+    };
+
+    friend class HierarchicalBallIterator;
+    friend class HierarchicalNearestIterator;
+
+    std::vector<Level> m_levels; //!< The nested grids, finest first.
+};
+
+//! Ball iterator over a HierarchicalLinkCell.
+/*! Streams through the levels in order, draining each level's own ball
+ *  iterator and remapping level-local point indices back to the original
+ *  index space. Self-exclusion is applied here after remapping, since the
+ *  inner iterators only see level-local indices.
+ */
+class HierarchicalBallIterator : public NeighborQueryPerPointIterator
+{
+public:
+    HierarchicalBallIterator(const HierarchicalLinkCell* neighbor_query, const vec3<float>& query_point,
+                             unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii)
+        : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min,
+                                        exclude_ii),
+          m_hierarchy(neighbor_query)
+    {}
+
+    ~HierarchicalBallIterator() override = default;
+
+    //! Get the next element.
+    NeighborBond next() override;
+
+protected:
+    const HierarchicalLinkCell* m_hierarchy; //!< Link to the HierarchicalLinkCell object.
+    size_t m_level {0};                      //!< The level currently being searched.
+    std::shared_ptr<NeighborQueryPerPointIterator>
+        m_level_iter; //!< The current level's own ball iterator.
+};
+
+//! Nearest-neighbor iterator over a HierarchicalLinkCell.
+/*! The k nearest neighbors overall are each among the k nearest within their
+ *  own level, so construction drains a k-nearest query per level, remaps the
+ *  candidates to original indices, and keeps the k best of the merged set.
+ */
+class HierarchicalNearestIterator : public NeighborQueryPerPointIterator
+{
+public:
+    HierarchicalNearestIterator(const HierarchicalLinkCell* neighbor_query, const vec3<float>& query_point,
+                                unsigned int query_point_idx, unsigned int num_neighbors, float r_max,
+                                float r_min, bool exclude_ii);
+
+    ~HierarchicalNearestIterator() override = default;
+
+    //! Get the next element.
+    NeighborBond next() override;
+
+protected:
+    std::vector<NeighborBond> m_neighbors; //!< The merged k nearest neighbors, sorted by distance.
+    size_t m_current {0};                  //!< Position within m_neighbors.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // HIERARCHICAL_LINK_CELL_H
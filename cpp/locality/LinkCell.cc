@@ -2,8 +2,15 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
 #include "LinkCell.h"
 
@@ -211,8 +218,10 @@ void IteratorCellShell::reset(unsigned int range)
 // Default constructor
 LinkCell::LinkCell() : NeighborQuery() {}
 
-LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width)
-    : NeighborQuery(box, points, n_points), m_cell_width(cell_width)
+LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width,
+                   bool autotune)
+    : NeighborQuery(box, points, n_points), m_cell_width(cell_width), m_autotune(autotune),
+      m_autotune_pending(autotune)
 {
     // If no cell width is provided, we calculate the system density and
     // estimate the number of cells that would lead to 10 particles per cell.
@@ -227,17 +236,32 @@ LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int
         m_cell_width = std::cbrtf(box.getVolume() / static_cast<float>(desired_num_cells));
     }
 
-    m_celldim = computeDimensions(box, m_cell_width);
+    setCellWidth(m_cell_width);
+}
+
+bool LinkCell::isValidCellWidth(float cell_width) const
+{
+    if (cell_width <= 0)
+    {
+        return false;
+    }
+    const vec3<float> nearest_plane_distance = m_box.getNearestPlaneDistance();
+    return !((cell_width * 2.0 > nearest_plane_distance.x) || (cell_width * 2.0 > nearest_plane_distance.y)
+             || (!m_box.is2D() && cell_width * 2.0 > nearest_plane_distance.z));
+}
+
+void LinkCell::setCellWidth(float cell_width)
+{
+    m_cell_width = cell_width;
+    m_celldim = computeDimensions(m_box, m_cell_width);
 
     // Check if box is too small!
-    vec3<float> nearest_plane_distance = box.getNearestPlaneDistance();
-    if ((m_cell_width * 2.0 > nearest_plane_distance.x) || (m_cell_width * 2.0 > nearest_plane_distance.y)
-        || (!box.is2D() && m_cell_width * 2.0 > nearest_plane_distance.z))
+    if (!isValidCellWidth(m_cell_width))
     {
         throw std::runtime_error("Cannot generate a cell list where cell_width is larger than half the box.");
     }
     // Only 1 cell deep in 2D
-    if (box.is2D())
+    if (m_box.is2D())
     {
         m_celldim.z = 1;
     }
@@ -248,7 +272,60 @@ LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int
         throw std::runtime_error("At least one cell must be present.");
     }
 
-    computeCellList(points, n_points);
+    m_cell_neighbors.clear();
+    computeCellList(m_points, m_n_points);
+}
+
+void LinkCell::autotuneWidth(float r_max, const vec3<float>* query_points, unsigned int n_query_points)
+{
+    // Lock in a width on the first suitable query even if every candidate is
+    // rejected below, so tuning never runs more than once.
+    m_autotune_pending = false;
+    if (m_n_points == 0 || n_query_points == 0)
+    {
+        return;
+    }
+
+    // The classic choice is one cell per cutoff; half-width cells reduce the
+    // search volume overshoot on dense systems and double-width cells reduce
+    // the shell bookkeeping on dilute ones. The current heuristic width
+    // competes on equal footing.
+    const std::vector<float> candidates {r_max / 2.0f, r_max, 2.0f * r_max, m_cell_width};
+
+    const unsigned int sample_size = std::min(n_query_points, 64U);
+    const unsigned int stride = n_query_points / sample_size;
+
+    float best_width(m_cell_width);
+    double best_time(std::numeric_limits<double>::max());
+    for (size_t c = 0; c < candidates.size(); ++c)
+    {
+        const float width = candidates[c];
+        if (!isValidCellWidth(width)
+            || std::find(candidates.begin(), candidates.begin() + c, width) != candidates.begin() + c)
+        {
+            continue;
+        }
+
+        const LinkCell trial(m_box, m_points, m_n_points, width);
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned int s = 0; s < sample_size; ++s)
+        {
+            const unsigned int idx = s * stride;
+            LinkCellQueryBallIterator it(&trial, query_points[idx], idx, r_max, float(0), false);
+            for (NeighborBond nb = it.next(); !it.end(); nb = it.next()) {}
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best_time)
+        {
+            best_time = elapsed.count();
+            best_width = width;
+        }
+    }
+
+    if (best_width != m_cell_width)
+    {
+        setCellWidth(best_width);
+    }
 }
 
 unsigned int LinkCell::getCellIndex(const vec3<int> cellCoord) const
@@ -318,6 +395,97 @@ void LinkCell::computeCellList(const vec3<float>* points, unsigned int n_points)
         m_cell_list[n_points + cell] = LINK_CELL_TERMINATOR;
     }
 
+    // The linked-list insertion is inherently serial (and runs backwards so
+    // each per-cell chain ends up in ascending order), but the cell
+    // coordinate arithmetic is not. When binning this object's own points,
+    // the SoA mirror provides contiguous coordinate streams, so blocks of
+    // fractional coordinates are evaluated with SIMD and only the insertion
+    // is done per lane. Lanes that fall outside the box (which the scalar
+    // path wraps through the modulo) fall back to getCell.
+#if defined(__AVX__)
+    if (points == m_points && n_points >= 8)
+    {
+        const vec3<float> box_L = m_box.getL();
+        const float tilt_xy = m_box.getTiltFactorXY();
+        const float tilt_xz = m_box.getTiltFactorXZ();
+        const float tilt_yz = m_box.getTiltFactorYZ();
+        const __m256 vlo_x = _mm256_set1_ps(-box_L.x / 2.0f);
+        const __m256 vlo_y = _mm256_set1_ps(-box_L.y / 2.0f);
+        const __m256 vlo_z = _mm256_set1_ps(-box_L.z / 2.0f);
+        const __m256 vl_x = _mm256_set1_ps(box_L.x);
+        const __m256 vl_y = _mm256_set1_ps(box_L.y);
+        const __m256 vl_z = _mm256_set1_ps(box_L.z);
+        const __m256 vxz_term = _mm256_set1_ps(tilt_xz - tilt_yz * tilt_xy);
+        const __m256 vxy = _mm256_set1_ps(tilt_xy);
+        const __m256 vyz = _mm256_set1_ps(tilt_yz);
+        const __m256 vdim_x = _mm256_set1_ps(float(m_celldim.x));
+        const __m256 vdim_y = _mm256_set1_ps(float(m_celldim.y));
+        const __m256 vdim_z = _mm256_set1_ps(float(m_celldim.z));
+        const bool is2D = m_box.is2D();
+
+        const float* xs = m_points_x.get();
+        const float* ys = m_points_y.get();
+        const float* zs = m_points_z.get();
+
+        alignas(32) int cx[8];
+        alignas(32) int cy[8];
+        alignas(32) int cz[8];
+        // Process blocks from the back so insertion order matches the scalar
+        // loop exactly.
+        unsigned int i = n_points;
+        while (i >= 8)
+        {
+            const unsigned int start = i - 8;
+            const __m256 x = _mm256_loadu_ps(xs + start);
+            const __m256 y = _mm256_loadu_ps(ys + start);
+            const __m256 z = _mm256_loadu_ps(zs + start);
+            // Mirror Box::makeFractional lane-wise, using the same division
+            // so in-range lanes bin identically to the scalar path.
+            __m256 ax = _mm256_sub_ps(x, vlo_x);
+            ax = _mm256_sub_ps(ax, _mm256_add_ps(_mm256_mul_ps(vxz_term, z), _mm256_mul_ps(vxy, y)));
+            ax = _mm256_div_ps(ax, vl_x);
+            __m256 ay = _mm256_sub_ps(y, vlo_y);
+            ay = _mm256_sub_ps(ay, _mm256_mul_ps(vyz, z));
+            ay = _mm256_div_ps(ay, vl_y);
+            // In 2D the fractional z is defined as zero.
+            const __m256 az
+                = is2D ? _mm256_setzero_ps() : _mm256_div_ps(_mm256_sub_ps(z, vlo_z), vl_z);
+
+            _mm256_store_si256(reinterpret_cast<__m256i*>(cx),
+                               _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_mul_ps(ax, vdim_x))));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(cy),
+                               _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_mul_ps(ay, vdim_y))));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(cz),
+                               _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_mul_ps(az, vdim_z))));
+
+            for (int lane = 7; lane >= 0; --lane)
+            {
+                const unsigned int p = start + static_cast<unsigned int>(lane);
+                unsigned int cell;
+                if (cx[lane] >= 0 && cx[lane] < int(m_celldim.x) && cy[lane] >= 0
+                    && cy[lane] < int(m_celldim.y) && cz[lane] >= 0 && cz[lane] < int(m_celldim.z))
+                {
+                    cell = coordToIndex(cx[lane], cy[lane], cz[lane]);
+                }
+                else
+                {
+                    cell = getCell(points[p]);
+                }
+                m_cell_list[p] = m_cell_list[n_points + cell];
+                m_cell_list[n_points + cell] = p;
+            }
+            i = start;
+        }
+        for (unsigned int p = i - 1; p != static_cast<unsigned int>(-1); --p)
+        {
+            const unsigned int cell = getCell(points[p]);
+            m_cell_list[p] = m_cell_list[n_points + cell];
+            m_cell_list[n_points + cell] = p;
+        }
+        return;
+    }
+#endif
+
     // Generate the cell list.
     for (unsigned int i = n_points - 1; i != static_cast<unsigned int>(-1); --i)
     {
@@ -470,14 +638,35 @@ const std::vector<unsigned int>& LinkCell::computeCellNeighbors(unsigned int cur
     return a->second;
 }
 
+std::shared_ptr<NeighborQueryIterator>
+LinkCell::query(const vec3<float>* query_points, unsigned int n_query_points, QueryArgs query_args) const
+{
+    if (m_autotune_pending)
+    {
+        QueryArgs args(query_args);
+        validateQueryArgs(args);
+        if (args.mode == QueryType::ball)
+        {
+            // Tuning rebuilds the cell structure, so it must finish before
+            // the base class hands out per-point iterators; query() is the
+            // serial entry point of every compute, making this safe.
+            const_cast<LinkCell*>(this)->autotuneWidth(args.r_max, query_points, n_query_points);
+        }
+    }
+    return NeighborQuery::query(query_points, n_query_points, query_args);
+}
+
 std::shared_ptr<NeighborQueryPerPointIterator>
 LinkCell::querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const
 {
     this->validateQueryArgs(args);
     if (args.mode == QueryType::ball)
     {
-        return std::make_shared<LinkCellQueryBallIterator>(this, query_point, query_point_idx, args.r_max,
-                                                           args.r_min, args.exclude_ii);
+        const float r_max = args.r_maxes != nullptr ? args.r_maxes[query_point_idx] : args.r_max;
+        auto iterator = std::make_shared<LinkCellQueryBallIterator>(this, query_point, query_point_idx,
+                                                                    r_max, args.r_min, args.exclude_ii);
+        iterator->setTypeFilter(args);
+        return iterator;
     }
     if (args.mode == QueryType::nearest)
     {
@@ -511,12 +700,20 @@ NeighborBond LinkCellQueryBallIterator::next()
                 continue;
             }
 
+            // Skip type pairs excluded by the mask, if one is set.
+            if (!allowsTypePair(j))
+            {
+                continue;
+            }
+
             const vec3<float> r_ij(m_neighbor_query->getBox().wrap((*m_linkcell)[j] - m_query_point));
             const float r_sq(dot(r_ij, r_ij));
 
             if (r_sq < r_max_sq && r_sq >= r_min_sq)
             {
-                return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq));
+                // The wrapped delta is already in hand, so record it for
+                // computes to reuse.
+                return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq), r_ij);
             }
         }
 
@@ -604,7 +801,7 @@ NeighborBond LinkCellQueryIterator::next()
                     const float r_sq(dot(r_ij, r_ij));
                     if (r_sq < r_max_sq && r_sq >= r_min_sq)
                     {
-                        m_current_neighbors.emplace_back(m_query_point_idx, j, std::sqrt(r_sq));
+                        m_current_neighbors.emplace_back(m_query_point_idx, j, std::sqrt(r_sq), r_ij);
                     }
                 }
             }
@@ -182,7 +182,15 @@ public:
     LinkCell();
 
     //! Constructor
-    LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width = 0);
+    /*! If \a cell_width is 0, a density-based heuristic width is used. If
+     *  \a autotune is true, the heuristic width is only provisional: the
+     *  first call to query() samples a small subset of query points at a few
+     *  candidate widths, locks in the fastest, and rebuilds the cell list at
+     *  that width. The chosen width can be read back through getCellWidth()
+     *  for logging.
+     */
+    LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width = 0,
+             bool autotune = false);
 
     //! Compute LinkCell dimensions
     static vec3<unsigned int> computeDimensions(const box::Box& box, float cell_width);
@@ -197,11 +205,20 @@ public:
     }
 
     //! Get the cell width
+    /*! For autotuned instances this is the provisional heuristic width until
+     *  the first query and the tuned width afterwards.
+     */
     float getCellWidth() const
     {
         return m_cell_width;
     }
 
+    //! Whether the cell width has been locked in by autotuning.
+    bool isAutotuned() const
+    {
+        return m_autotune && !m_autotune_pending;
+    }
+
     //! Compute the cell id for a given position
     unsigned int getCell(const vec3<float>& p) const
     {
@@ -230,6 +247,16 @@ public:
     //! Compute the cell list
     void computeCellList(const vec3<float>* points, unsigned int n_points);
 
+    //! Implementation of the generic query for LinkCell (see NeighborQuery.h for documentation).
+    /*! This override runs any pending width autotune before delegating to the
+     *  base class. query() is the serial entry point of every compute, so
+     *  tuning here guarantees the cell list is not rebuilt underneath the
+     *  per-point iterators created during parallel iteration.
+     */
+    std::shared_ptr<NeighborQueryIterator> query(const vec3<float>* query_points,
+                                                 unsigned int n_query_points,
+                                                 QueryArgs query_args) const override;
+
     //! Implementation of per-particle query for LinkCell (see NeighborQuery.h for documentation).
     /*! \param query_point The point to find neighbors for.
      *  \param n_query_points The number of query points.
@@ -242,7 +269,23 @@ private:
     //! Helper function to compute cell neighbors
     const std::vector<unsigned int>& computeCellNeighbors(unsigned int cell) const;
 
+    //! Whether the given width satisfies the box size constraints.
+    bool isValidCellWidth(float cell_width) const;
+
+    //! Rebuild the cell structure at a new width.
+    void setCellWidth(float cell_width);
+
+    //! Sample a few query points at candidate widths and lock in the fastest.
+    /*! Candidates are r_max / 2, r_max, 2 * r_max, and the current heuristic
+     *  width, filtered to those the box can support. Each candidate is timed
+     *  by exhausting ball queries over an evenly strided sample of the query
+     *  points against a throwaway LinkCell built at that width.
+     */
+    void autotuneWidth(float r_max, const vec3<float>* query_points, unsigned int n_query_points);
+
     float m_cell_width {0};                 //!< Minimum necessary cell width cutoff
+    bool m_autotune {false};                //!< Whether width autotuning was requested
+    bool m_autotune_pending {false};        //!< Whether autotuning still has to run
     vec3<unsigned int> m_celldim {0, 0, 0}; //!< Cell dimensions
     unsigned int m_size {0};                //!< The size of cell list.
 
@@ -1,6 +1,8 @@
 #ifndef NEIGHBOR_BOND_H
 #define NEIGHBOR_BOND_H
 
+#include "VectorMath.h"
+
 namespace freud { namespace locality {
 
 //! Simple data structure encoding neighboring points.
@@ -18,6 +20,16 @@ struct NeighborBond
         : query_point_idx(query_point_idx), point_idx(point_idx), distance(d), weight(w)
     {}
 
+    //! Constructor recording the already-resolved bond vector.
+    /*! Query iterators that compute the periodic delta vector during
+     *  traversal store it here so computes can use it directly instead of
+     *  re-wrapping the point difference (see bondVector).
+     */
+    NeighborBond(unsigned int query_point_idx, unsigned int point_idx, float d, const vec3<float>& v)
+        : query_point_idx(query_point_idx), point_idx(point_idx), distance(d), weight(1), vector(v),
+          has_vector(true)
+    {}
+
     //! Equality checks both query_point_idx and distance.
     bool operator==(const NeighborBond& other) const
     {
@@ -91,6 +103,8 @@ struct NeighborBond
     unsigned int point_idx {0};       //! The reference point index.
     float distance {0};               //! The distance between the points.
     float weight {0};                 //! The weight of this bond.
+    vec3<float> vector {};            //! The vector from the query point to the point, if resolved.
+    bool has_vector {false};          //! Whether the bond vector was resolved during traversal.
 };
 
 }; }; // end namespace freud::locality
@@ -8,9 +8,33 @@ namespace freud { namespace locality {
 
 NeighborList makeDefaultNlist(const NeighborQuery* nq, const NeighborList* nlist,
                               const vec3<float>* query_points, unsigned int num_query_points,
-                              locality::QueryArgs qargs)
+                              locality::QueryArgs qargs, bool half_list)
 {
     bool requires_delete(false);
+    if (nlist == nullptr && nq->getNlistCacheEnabled())
+    {
+        // Memoized path: computes run one at a time per frame, so identical
+        // requests (same query points, parameters, and data generation) can
+        // reuse the bonds generated by the first compute instead of
+        // re-querying.
+        const size_t key = nq->hashNlistRequest(query_points, num_query_points, qargs, half_list);
+        const NeighborList* cached = nq->findCachedNlist(key);
+        if (cached == nullptr)
+        {
+            auto nqiter(nq->query(query_points, num_query_points, qargs));
+            const NeighborList* generated = nqiter->toNeighborList();
+            NeighborList new_nlist(*generated);
+            delete generated;
+            if (half_list && num_query_points == nq->getNPoints())
+            {
+                new_nlist.compressToHalfList();
+            }
+            cached = &nq->storeCachedNlist(key, std::move(new_nlist));
+        }
+        NeighborList result(*cached);
+        result.validate(num_query_points, nq->getNPoints());
+        return result;
+    }
     if (nlist == nullptr)
     {
         auto nqiter(nq->query(query_points, num_query_points, qargs));
@@ -34,6 +58,12 @@ NeighborList makeDefaultNlist(const NeighborQuery* nq, const NeighborList* nlist
     if (requires_delete)
     {
         delete nlist;
+        // Only internally generated lists are compressed; a user-provided
+        // list's storage mode is the caller's choice.
+        if (half_list && num_query_points == nq->getNPoints())
+        {
+            new_nlist.compressToHalfList();
+        }
     }
     return new_nlist;
 }
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "AABBQuery.h"
+#include "LinkCell.h"
 #include "NeighborList.h"
 #include "NeighborPerPointIterator.h"
 #include "NeighborQuery.h"
@@ -19,76 +20,197 @@ namespace freud { namespace locality {
 /*! This function makes a NeighborList from the provided NeighborQuery object
  * if the provided NeighborList is NULL. Otherwise, it simply returns a copy of
  * the provided NeighborList.
+ *
+ * If half_list is true and the list is generated internally, the generated
+ * list is compressed to half-list (i < j) storage, halving its memory
+ * footprint for symmetric pair computes. A user-provided NeighborList is
+ * never compressed since its storage mode is the caller's choice.
  */
 NeighborList makeDefaultNlist(const NeighborQuery* nq, const NeighborList* nlist,
                               const vec3<float>* query_points, unsigned int num_query_points,
-                              locality::QueryArgs qargs);
+                              locality::QueryArgs qargs, bool half_list = false);
 
 //! Compute the vector corresponding to a NeighborBond.
 /*! The primary purpose of this function is to standardize the directionality
  * of the delta vector, which is defined as pointing from the query_point to
- * the point (point - query_point), wrapped into the box.
+ * the point (point - query_point), wrapped into the box. Bonds whose vector
+ * was already resolved during query traversal (ball query iterators know the
+ * periodic image they are visiting) return it directly, skipping the
+ * fractional-coordinate round trip of Box::wrap entirely.
  */
 inline vec3<float> bondVector(const NeighborBond& nb, const NeighborQuery* nq,
                               const vec3<float>* query_points)
 {
+    if (nb.has_vector)
+    {
+        return nb.vector;
+    }
     return nq->getBox().wrap((*nq)[nb.point_idx] - query_points[nb.query_point_idx]);
 }
 
 //! Implementation of per-point finding logic for NeighborList objects.
 /*! This class provides a concrete implementation of the per-point neighbor
- *  finding interface specified by the NeighborPerPointIterator. In particular,
- *  it includes the logic for finding neighbors within a NeighborList by using
- *  the find_first_index method to initialize a start index and looping over all
- *  neighbors in the NeighborList.
+ *  finding interface specified by the NeighborPerPointIterator. It grabs a
+ *  zero-copy CSR slice of the NeighborList for its query point on
+ *  construction, so each call to next() is a pointer bump through contiguous
+ *  per-bond data rather than a binary search plus bounds check per bond.
+ *
+ *  Note that construction triggers a (lazy) build of the NeighborList's CSR
+ *  arrays, which is not thread-safe. Callers constructing these iterators in
+ *  parallel must ensure the CSR arrays are current first, e.g. by calling
+ *  NeighborList::updateSegmentCounts (loopOverNeighborsIterator does this).
  */
 class NeighborListPerPointIterator : public NeighborPerPointIterator
 {
 public:
     NeighborListPerPointIterator(const NeighborList* nlist, size_t point_index)
-        : NeighborPerPointIterator(point_index), m_nlist(nlist)
-    {
-        m_current_index = m_nlist->find_first_index(point_index);
-        m_finished = m_current_index == m_nlist->getNumBonds();
-        if (!m_finished)
-        {
-            m_returned_point_index = m_nlist->getNeighbors()(m_current_index, 0);
-        }
-    }
+        : NeighborPerPointIterator(point_index), m_segment(nlist->getSegment(point_index)),
+          m_finished(m_segment.count == 0)
+    {}
 
     ~NeighborListPerPointIterator() override = default;
 
     NeighborBond next() override
     {
-        if (m_current_index == m_nlist->getNumBonds())
+        if (m_current_index == m_segment.count)
         {
             m_finished = true;
             return ITERATOR_TERMINATOR;
         }
 
-        NeighborBond nb = NeighborBond(
-            m_nlist->getNeighbors()(m_current_index, 0), m_nlist->getNeighbors()(m_current_index, 1),
-            m_nlist->getDistances()[m_current_index], m_nlist->getWeights()[m_current_index]);
+        NeighborBond nb = NeighborBond(m_query_point_idx, m_segment.point_indices[m_current_index],
+                                       m_segment.distances[m_current_index],
+                                       m_segment.weights[m_current_index]);
         ++m_current_index;
-        m_returned_point_index = nb.query_point_idx;
         return nb;
     }
 
     bool end() const override
     {
-        return (m_returned_point_index != m_query_point_idx) || m_finished;
+        return m_finished;
     }
 
 private:
-    const NeighborList* m_nlist; //! The NeighborList being iterated over.
-    size_t m_current_index;      //! The row of m_nlist where the iterator is currently located.
-    size_t m_returned_point_index {
-        0xffffffff}; //! The index of the last returned point (i.e. the value of
-                     //! m_nlist.getNeighbors()(m_current_index, 0)). Initialized to an arbitrary sentinel in
-                     //! case the user ever tries to access this for an iterator built from an empty nlist.
-    bool m_finished; //! Flag to indicate that the iterator has been exhausted.
+    NeighborList::BondSegment m_segment; //! The CSR slice for this query point.
+    size_t m_current_index {0};          //! The position within the slice.
+    bool m_finished;                     //! Flag to indicate that the iterator has been exhausted.
 };
 
+//! Per-point iterator over a filtered view of a NeighborList.
+/*! Behaves like NeighborListPerPointIterator but skips the bonds rejected by
+ *  the view's filters, so computes consume the filtered list without it ever
+ *  being materialized. The same CSR caveats apply: callers constructing
+ *  these in parallel must bring the CSR arrays up to date first.
+ */
+class FilteredNeighborListPerPointIterator : public NeighborPerPointIterator
+{
+public:
+    FilteredNeighborListPerPointIterator(const NeighborListView* view, size_t point_index)
+        : NeighborPerPointIterator(point_index), m_view(view),
+          m_segment(view->list()->getSegment(point_index))
+    {}
+
+    ~FilteredNeighborListPerPointIterator() override = default;
+
+    NeighborBond next() override
+    {
+        while (m_current_index != m_segment.count)
+        {
+            const NeighborBond nb(m_query_point_idx, m_segment.point_indices[m_current_index],
+                                  m_segment.distances[m_current_index],
+                                  m_segment.weights[m_current_index]);
+            ++m_current_index;
+            if (m_view->accepts(nb))
+            {
+                return nb;
+            }
+        }
+        m_finished = true;
+        return ITERATOR_TERMINATOR;
+    }
+
+    bool end() const override
+    {
+        return m_finished;
+    }
+
+private:
+    const NeighborListView* m_view;      //! The view supplying the filters.
+    NeighborList::BondSegment m_segment; //! The CSR slice for this query point.
+    size_t m_current_index {0};          //! The position within the slice.
+    bool m_finished {false};             //! Flag to indicate that the iterator has been exhausted.
+};
+
+//! Per-query-point fixed cost, expressed in bonds, used by the cost model.
+/*! Accounts for iterator construction and loop overhead so that chunks of
+ *  sparsely bonded points do not degenerate into one point per chunk.
+ */
+constexpr size_t QUERY_POINT_COST_IN_BONDS = 4;
+
+//! Split query points into chunks of approximately equal bond count.
+/*! Uniformly splitting query points across threads load-imbalances systems
+ *  with heterogeneous density, where per-point neighbor counts can vary by
+ *  orders of magnitude: a few workers draw the dense regions and finish
+ *  last. This helper walks the CSR offsets (the exclusive prefix sum of the
+ *  per-point neighbor counts, already maintained by the NeighborList) and
+ *  closes a chunk whenever its accumulated cost -- bonds plus a small fixed
+ *  cost per point -- reaches an even share. Several chunks per thread are
+ *  produced so TBB's work stealing can still correct any residual skew.
+ *
+ *  The caller must have brought the CSR arrays up to date (via
+ *  updateSegmentCounts) before calling. Returns chunk boundaries: chunk c
+ *  spans query points [boundaries[c], boundaries[c + 1]).
+ */
+inline std::vector<size_t> balancedQueryPointChunks(const NeighborList* nlist, size_t n_query_points)
+{
+    std::vector<size_t> boundaries {0};
+    const auto& offsets = nlist->getOffsets();
+    const size_t n_counted = std::min(n_query_points, size_t(nlist->getNumQueryPoints()));
+    const size_t total_bonds = n_counted > 0 ? offsets[n_counted] : 0;
+    const size_t total_cost = total_bonds + QUERY_POINT_COST_IN_BONDS * n_query_points;
+    const auto threads = static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+    const size_t chunk_cost = std::max(total_cost / (8 * threads), size_t(1));
+
+    size_t cost = 0;
+    for (size_t i = 0; i < n_query_points; ++i)
+    {
+        cost += QUERY_POINT_COST_IN_BONDS + (i < n_counted ? offsets[i + 1] - offsets[i] : 0);
+        if (cost >= chunk_cost && i + 1 < n_query_points)
+        {
+            boundaries.push_back(i + 1);
+            cost = 0;
+        }
+    }
+    boundaries.push_back(n_query_points);
+    return boundaries;
+}
+
+//! Run a range body over precomputed chunks with work stealing.
+/*! Each chunk becomes one stealable task (grain 1, simple partitioner), so
+ *  idle threads pick up whole chunks from busy ones; combined with
+ *  cost-balanced boundaries this keeps all workers busy until the end of
+ *  the loop.
+ */
+template<typename Body>
+inline void forBalancedChunks(const std::vector<size_t>& boundaries, const Body& body, bool parallel = true)
+{
+    const size_t num_chunks = boundaries.size() - 1;
+    if (!parallel || num_chunks <= 1)
+    {
+        body(boundaries.front(), boundaries.back());
+        return;
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_chunks, 1),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t c = r.begin(); c != r.end(); ++c)
+            {
+                body(boundaries[c], boundaries[c + 1]);
+            }
+        },
+        tbb::simple_partitioner());
+}
+
 //! Wrapper iterating looping over NeighborQuery or NeighborList.
 /*! This function dynamically determines whether or not the provided
  *  NeighborList is valid. If it is, it applies the provide compute function to
@@ -121,8 +243,20 @@ void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<f
     // check if nlist exists
     if (nlist != nullptr)
     {
-        util::forLoopWrapper(
-            0, n_query_points,
+        if (nlist->isHalfList())
+        {
+            // Per-point slices cannot present the reversed direction of bonds
+            // stored on the partner point, so per-point iteration requires a
+            // full list.
+            throw std::runtime_error(
+                "Per-point neighbor iteration requires a full NeighborList, not a half list.");
+        }
+        // Ensure the CSR arrays are built before iterators are constructed in
+        // parallel; the lazy rebuild itself is not thread-safe. The same
+        // arrays feed the cost model that balances chunks by bond count.
+        nlist->updateSegmentCounts();
+        forBalancedChunks(
+            balancedQueryPointChunks(nlist, n_query_points),
             [&](size_t begin, size_t end) {
                 for (size_t i = begin; i != end; ++i)
                 {
@@ -181,6 +315,7 @@ void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* q
     // check if nlist exists
     if (nlist != nullptr)
     {
+        const bool half_list(nlist->isHalfList());
         util::forLoopWrapper(
             0, nlist->getNumBonds(),
             [&](size_t begin, size_t end) {
@@ -189,6 +324,12 @@ void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* q
                     const NeighborBond nb(nlist->getNeighbors()(bond, 0), nlist->getNeighbors()(bond, 1),
                                           nlist->getDistances()[bond], nlist->getWeights()[bond]);
                     cf(nb);
+                    if (half_list)
+                    {
+                        // Each stored (i, j) pair also represents the
+                        // reversed bond, which is presented virtually.
+                        cf(NeighborBond(nb.point_idx, nb.query_point_idx, nb.distance, nb.weight));
+                    }
                 }
             },
             parallel);
@@ -218,6 +359,250 @@ void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* q
     }
 }
 
+//! Loop over the bonds of a filtered NeighborList view.
+/*! Each bond of the underlying list is tested against the view's filters as
+ *  it streams by, so no filtered copy of the bond arrays is ever built. Half
+ *  lists present both directions virtually, each tested independently (an
+ *  index mask may accept one direction of a pair and not the other).
+ */
+template<typename ComputePairType>
+void loopOverNeighbors(const NeighborListView& view, const ComputePairType& cf, bool parallel = true)
+{
+    const NeighborList* nlist = view.list();
+    const bool half_list(nlist->isHalfList());
+    util::forLoopWrapper(
+        0, nlist->getNumBonds(),
+        [&](size_t begin, size_t end) {
+            for (size_t bond = begin; bond != end; ++bond)
+            {
+                const NeighborBond nb(nlist->getNeighbors()(bond, 0), nlist->getNeighbors()(bond, 1),
+                                      nlist->getDistances()[bond], nlist->getWeights()[bond]);
+                if (view.accepts(nb))
+                {
+                    cf(nb);
+                }
+                if (half_list)
+                {
+                    const NeighborBond reversed(nb.point_idx, nb.query_point_idx, nb.distance, nb.weight);
+                    if (view.accepts(reversed))
+                    {
+                        cf(reversed);
+                    }
+                }
+            }
+        },
+        parallel);
+}
+
+//! Loop over the query points of a filtered NeighborList view.
+/*! The view's counterpart of the NeighborList form of
+ *  loopOverNeighborsIterator: cf is called once per query point of the
+ *  underlying list with a FilteredNeighborListPerPointIterator, so computes
+ *  consume the filtered bonds without materializing them. Chunks are
+ *  balanced by the unfiltered bond counts, which bounds the work per chunk
+ *  whatever the filters reject.
+ */
+template<typename ComputePairType>
+void loopOverNeighborsIterator(const NeighborListView& view, const ComputePairType& cf,
+                               bool parallel = true)
+{
+    const NeighborList* nlist = view.list();
+    if (nlist->isHalfList())
+    {
+        throw std::runtime_error(
+            "Per-point neighbor iteration requires a full NeighborList, not a half list.");
+    }
+    nlist->updateSegmentCounts();
+    forBalancedChunks(
+        balancedQueryPointChunks(nlist, nlist->getNumQueryPoints()),
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i != end; ++i)
+            {
+                std::shared_ptr<FilteredNeighborListPerPointIterator> niter
+                    = std::make_shared<FilteredNeighborListPerPointIterator>(&view, i);
+                cf(i, niter);
+            }
+        },
+        parallel);
+}
+
+//! Invoke a per-point function with concrete, non-virtual iterator types.
+/*! The runtime-polymorphic loops above pay a virtual next() call per bond. For
+ *  the known (NeighborQuery subclass, query mode) combinations this helper
+ *  resolves the dynamic type once per compute and then constructs the concrete
+ *  per-point iterator on the stack inside the loop, so next() inlines into the
+ *  caller's compute function. The per-point function is invoked as
+ *  f(query_point_idx, iterator&) with a different iterator type per branch and
+ *  therefore must be generic (e.g. a lambda taking auto&).
+ *
+ *  Returns false when no static specialization exists for the given query
+ *  object, in which case the caller should fall back to the
+ *  runtime-polymorphic path.
+ */
+template<typename PerPointFunc>
+bool loopOverConcreteIterators(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                               unsigned int n_query_points, QueryArgs qargs, const PerPointFunc& f,
+                               bool parallel = true)
+{
+    // Resolve the query mode up front, and run the virtual query entry point
+    // once so any one-time work it performs (validation, LinkCell width
+    // autotuning) happens before concrete iterators are constructed.
+    neighbor_query->validateQueryArgs(qargs);
+    neighbor_query->query(query_points, n_query_points, qargs);
+
+    if (const auto* aabb_query = dynamic_cast<const AABBQuery*>(neighbor_query))
+    {
+        if (qargs.mode == QueryType::ball)
+        {
+            util::forLoopWrapper(
+                0, n_query_points,
+                [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i != end; ++i)
+                    {
+                        AABBQueryBallIterator it(
+                            aabb_query, query_points[i], i,
+                            qargs.r_maxes != nullptr ? qargs.r_maxes[i] : qargs.r_max, qargs.r_min,
+                            qargs.exclude_ii);
+                        it.setTypeFilter(qargs);
+                        f(i, it);
+                    }
+                },
+                parallel);
+            return true;
+        }
+        if (qargs.mode == QueryType::nearest)
+        {
+            util::forLoopWrapper(
+                0, n_query_points,
+                [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i != end; ++i)
+                    {
+                        AABBQueryIterator it(aabb_query, query_points[i], i, qargs.num_neighbors,
+                                             qargs.r_guess, qargs.r_max, qargs.r_min, qargs.scale,
+                                             qargs.exclude_ii);
+                        f(i, it);
+                    }
+                },
+                parallel);
+            return true;
+        }
+    }
+    else if (const auto* link_cell = dynamic_cast<const LinkCell*>(neighbor_query))
+    {
+        if (qargs.mode == QueryType::ball)
+        {
+            util::forLoopWrapper(
+                0, n_query_points,
+                [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i != end; ++i)
+                    {
+                        LinkCellQueryBallIterator it(
+                            link_cell, query_points[i], i,
+                            qargs.r_maxes != nullptr ? qargs.r_maxes[i] : qargs.r_max, qargs.r_min,
+                            qargs.exclude_ii);
+                        it.setTypeFilter(qargs);
+                        f(i, it);
+                    }
+                },
+                parallel);
+            return true;
+        }
+        if (qargs.mode == QueryType::nearest)
+        {
+            util::forLoopWrapper(
+                0, n_query_points,
+                [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i != end; ++i)
+                    {
+                        LinkCellQueryIterator it(link_cell, query_points[i], i, qargs.num_neighbors,
+                                                 qargs.r_max, qargs.r_min, qargs.exclude_ii);
+                        f(i, it);
+                    }
+                },
+                parallel);
+            return true;
+        }
+    }
+    return false;
+}
+
+//! Statically dispatched counterpart of loopOverNeighborsIterator.
+/*! Behaves like loopOverNeighborsIterator but provides the compute function
+ *  with concrete iterator types (NeighborList CSR slice, AABB or LinkCell
+ *  query iterators) so that per-bond next() calls inline instead of going
+ *  through the NeighborPerPointIterator vtable. The compute function is
+ *  invoked as cf(query_point_idx, iterator&) and must be generic over the
+ *  iterator type. Unrecognized query objects fall back to the
+ *  runtime-polymorphic loop, where cf receives the shared_ptr it already
+ *  accepts when written generically.
+ */
+template<typename ComputePairType>
+void loopOverNeighborsIteratorStatic(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                                     unsigned int n_query_points, QueryArgs qargs,
+                                     const NeighborList* nlist, const ComputePairType& cf,
+                                     bool parallel = true)
+{
+    if (nlist != nullptr)
+    {
+        if (nlist->isHalfList())
+        {
+            throw std::runtime_error(
+                "Per-point neighbor iteration requires a full NeighborList, not a half list.");
+        }
+        nlist->updateSegmentCounts();
+        forBalancedChunks(
+            balancedQueryPointChunks(nlist, n_query_points),
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i != end; ++i)
+                {
+                    NeighborListPerPointIterator niter(nlist, i);
+                    cf(i, niter);
+                }
+            },
+            parallel);
+        return;
+    }
+
+    if (!loopOverConcreteIterators(
+            neighbor_query, query_points, n_query_points, qargs,
+            [&cf](size_t i, auto& it) { cf(i, it); }, parallel))
+    {
+        loopOverNeighborsIterator(neighbor_query, query_points, n_query_points, qargs, nlist,
+                                  [&cf](size_t i, const auto& it) { cf(i, *it); }, parallel);
+    }
+}
+
+//! Statically dispatched counterpart of loopOverNeighbors.
+/*! Behaves like loopOverNeighbors — cf is applied to every NeighborBond — but
+ *  drains concrete iterator types on the query path so that per-bond next()
+ *  calls inline. The NeighborList path already touches the bond arrays
+ *  directly and is shared with loopOverNeighbors.
+ */
+template<typename ComputePairType>
+void loopOverNeighborsStatic(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                             unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist,
+                             const ComputePairType& cf, bool parallel = true)
+{
+    if (nlist != nullptr)
+    {
+        loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf, parallel);
+        return;
+    }
+
+    if (!loopOverConcreteIterators(
+            neighbor_query, query_points, n_query_points, qargs,
+            [&cf](size_t, auto& it) {
+                for (NeighborBond nb = it.next(); !it.end(); nb = it.next())
+                {
+                    cf(nb);
+                }
+            },
+            parallel))
+    {
+        loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf, parallel);
+    }
+}
+
 }; }; // end namespace freud::locality
 
 #endif // NEIGHBOR_COMPUTE_FUNCTIONAL_H
@@ -2,9 +2,14 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <tbb/parallel_sort.h>
 
+#include "ArrayFile.h"
 #include "NeighborList.h"
+#include "utils.h"
 
 namespace freud { namespace locality {
 
@@ -110,10 +115,39 @@ void NeighborList::updateSegmentCounts() const
         {
             m_counts[last_index] = counter;
         }
+
+        // Build the CSR representation: offsets are the exclusive prefix sum
+        // of the counts (with a one-past-the-end sentinel), and the point
+        // index column is packed contiguously so that per-point iteration can
+        // proceed by pointer bump.
+        m_offsets.prepare(m_num_query_points + 1);
+        unsigned int offset(0);
+        for (unsigned int i = 0; i < m_num_query_points; i++)
+        {
+            m_offsets[i] = offset;
+            offset += m_counts[i];
+        }
+        m_offsets[m_num_query_points] = offset;
+
+        m_csr_point_indices.prepare(getNumBonds());
+        for (unsigned int i = 0; i < getNumBonds(); i++)
+        {
+            m_csr_point_indices[i] = m_neighbors(i, 1);
+        }
+
         m_segments_counts_updated = true;
     }
 }
 
+NeighborList::BondSegment NeighborList::getSegment(unsigned int query_point) const
+{
+    updateSegmentCounts();
+    const unsigned int first(m_offsets[query_point]);
+    const unsigned int count(m_offsets[query_point + 1] - first);
+    return {m_csr_point_indices.get() + first, m_distances.get() + first, m_weights.get() + first, first,
+            count};
+}
+
 // We are currently assuming that the input iterator has the correct length;
 // however, this is compatible with the original assumptions of this function
 // (pre-iterator syntax), so we'll accept that level of type-safety for now. In
@@ -162,6 +196,28 @@ template unsigned int NeighborList::filter(std::vector<bool>::iterator);
 template unsigned int NeighborList::filter(const bool*);
 template unsigned int NeighborList::filter(bool*);
 
+unsigned int NeighborList::compressToHalfList()
+{
+    if (m_num_query_points != m_num_points)
+    {
+        throw std::runtime_error(
+            "NeighborList.compressToHalfList requires num_query_points to equal num_points.");
+    }
+    if (m_half_list)
+    {
+        return 0;
+    }
+
+    std::vector<bool> pair_filter(getNumBonds());
+    for (unsigned int i(0); i < getNumBonds(); ++i)
+    {
+        pair_filter[i] = m_neighbors(i, 0) < m_neighbors(i, 1);
+    }
+    const unsigned int num_removed(filter(pair_filter.cbegin()));
+    m_half_list = true;
+    return num_removed;
+}
+
 unsigned int NeighborList::filter_r(float r_max, float r_min)
 {
     if (r_max <= 0)
@@ -187,6 +243,13 @@ unsigned int NeighborList::filter_r(float r_max, float r_min)
 
 unsigned int NeighborList::find_first_index(unsigned int i) const
 {
+    // When the CSR arrays are current this is a single lookup. We do not
+    // trigger a rebuild here because this method is called concurrently from
+    // per-point iterators; the bisection fallback is safe on stale arrays.
+    if (m_segments_counts_updated && i <= m_num_query_points)
+    {
+        return m_offsets[i];
+    }
     if (getNumBonds() != 0)
     {
         return bisection_search(i, 0, getNumBonds()) + (i > m_neighbors(0, 0) ? 1 : 0);
@@ -224,6 +287,46 @@ void NeighborList::copy(const NeighborList& other)
     m_neighbors = other.m_neighbors.copy();
     m_weights = other.m_weights.copy();
     m_distances = other.m_distances.copy();
+    m_half_list = other.m_half_list;
+    m_segments_counts_updated = false;
+}
+
+void NeighborList::save(const std::string& path) const
+{
+    // The scalar bookkeeping travels as a small metadata section alongside
+    // the per-bond arrays.
+    util::ManagedArray<unsigned int> meta(size_t(3));
+    meta[0] = m_num_query_points;
+    meta[1] = m_num_points;
+    meta[2] = m_half_list ? 1 : 0;
+
+    util::ArrayFileWriter writer(path);
+    writer.write("meta", meta);
+    writer.write("neighbors", m_neighbors);
+    writer.write("distances", m_distances);
+    writer.write("weights", m_weights);
+    writer.close();
+}
+
+void NeighborList::load(const std::string& path)
+{
+    util::ArrayFileReader reader(path);
+    const auto meta = reader.read<unsigned int>("meta");
+    auto neighbors = reader.read<unsigned int>("neighbors");
+    auto distances = reader.read<float>("distances");
+    auto weights = reader.read<float>("weights");
+    if (meta.size() != 3 || neighbors.shape().size() != 2 || neighbors.shape()[1] != 2
+        || distances.size() != neighbors.shape()[0] || weights.size() != neighbors.shape()[0])
+    {
+        throw std::runtime_error(path + " does not hold a saved NeighborList.");
+    }
+
+    m_num_query_points = meta[0];
+    m_num_points = meta[1];
+    m_half_list = meta[2] != 0;
+    m_neighbors = neighbors;
+    m_distances = distances;
+    m_weights = weights;
     m_segments_counts_updated = false;
 }
 
@@ -265,6 +368,191 @@ bool compareNeighborDistance(const NeighborBond& left, const NeighborBond& right
     return left.less_as_distance(right);
 }
 
+namespace {
+
+//! Pack the radix sort key for a bond.
+/*! The primary NeighborList ordering is (query_point_idx, point_idx); the
+ *  distance ordering is (query_point_idx, distance). Distances are
+ *  non-negative, so their IEEE bit patterns sort in numeric order when
+ *  treated as unsigned integers.
+ */
+inline std::uint64_t bondSortKey(const NeighborBond& bond, bool sort_by_distance)
+{
+    std::uint32_t low(bond.point_idx);
+    if (sort_by_distance)
+    {
+        std::memcpy(&low, &bond.distance, sizeof(low));
+    }
+    return (std::uint64_t(bond.query_point_idx) << 32) | low;
+}
+
+} // namespace
+
+void sortNeighborBonds(std::vector<NeighborBond>& bonds, bool sort_by_distance)
+{
+    const auto comparator = sort_by_distance ? compareNeighborDistance : compareNeighborBond;
+    const size_t num_bonds = bonds.size();
+
+    // For small lists the comparison sort wins; the radix machinery only pays
+    // off once the list no longer fits in cache.
+    constexpr size_t MIN_RADIX_SIZE = 1U << 16U;
+    if (num_bonds < MIN_RADIX_SIZE)
+    {
+        tbb::parallel_sort(bonds.begin(), bonds.end(), comparator);
+        return;
+    }
+
+    // Parallel LSD radix sort over the packed 64-bit key: each pass
+    // histograms one digit per chunk, takes an exclusive scan over (digit,
+    // chunk) to assign disjoint output slices, and scatters. Six 11-bit
+    // passes cover the key, and the even pass count lands the result back in
+    // the input vector.
+    constexpr unsigned int RADIX_BITS = 11;
+    constexpr size_t NUM_BUCKETS = size_t(1) << RADIX_BITS;
+    constexpr unsigned int NUM_PASSES = 6;
+
+    const size_t num_chunks = std::min<size_t>(256, (num_bonds + MIN_RADIX_SIZE - 1) / MIN_RADIX_SIZE * 4);
+    const size_t chunk_size = (num_bonds + num_chunks - 1) / num_chunks;
+
+    std::vector<NeighborBond> buffer(num_bonds);
+    NeighborBond* src = bonds.data();
+    NeighborBond* dst = buffer.data();
+
+    std::vector<size_t> counts(num_chunks * NUM_BUCKETS);
+
+    for (unsigned int pass = 0; pass < NUM_PASSES; ++pass)
+    {
+        const unsigned int shift = pass * RADIX_BITS;
+        std::fill(counts.begin(), counts.end(), 0);
+
+        util::forLoopWrapper(0, num_chunks, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk != end; ++chunk)
+            {
+                size_t* chunk_counts = &counts[chunk * NUM_BUCKETS];
+                const size_t lo = chunk * chunk_size;
+                const size_t hi = std::min(lo + chunk_size, num_bonds);
+                for (size_t i = lo; i < hi; ++i)
+                {
+                    ++chunk_counts[(bondSortKey(src[i], sort_by_distance) >> shift) & (NUM_BUCKETS - 1)];
+                }
+            }
+        });
+
+        // Exclusive scan in (digit, chunk) order so every (chunk, digit)
+        // pair owns a disjoint slice of the output.
+        size_t running(0);
+        for (size_t digit = 0; digit < NUM_BUCKETS; ++digit)
+        {
+            for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+            {
+                const size_t count = counts[chunk * NUM_BUCKETS + digit];
+                counts[chunk * NUM_BUCKETS + digit] = running;
+                running += count;
+            }
+        }
+
+        util::forLoopWrapper(0, num_chunks, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk != end; ++chunk)
+            {
+                size_t* chunk_offsets = &counts[chunk * NUM_BUCKETS];
+                const size_t lo = chunk * chunk_size;
+                const size_t hi = std::min(lo + chunk_size, num_bonds);
+                for (size_t i = lo; i < hi; ++i)
+                {
+                    const size_t digit
+                        = (bondSortKey(src[i], sort_by_distance) >> shift) & (NUM_BUCKETS - 1);
+                    dst[chunk_offsets[digit]++] = src[i];
+                }
+            }
+        });
+
+        std::swap(src, dst);
+    }
+
+    // The radix passes are stable but only order the packed key; runs of
+    // bonds with identical keys still need the full comparator applied for
+    // the secondary fields (weight and the remaining index or distance).
+    // Such runs are almost always of length one.
+    size_t run_start(0);
+    for (size_t i = 1; i <= num_bonds; ++i)
+    {
+        if (i == num_bonds
+            || bondSortKey(bonds[i], sort_by_distance) != bondSortKey(bonds[run_start], sort_by_distance))
+        {
+            if (i - run_start > 1)
+            {
+                std::sort(bonds.begin() + run_start, bonds.begin() + i, comparator);
+            }
+            run_start = i;
+        }
+    }
+}
+
+NeighborList NeighborListView::materialize(bool parallel) const
+{
+    const unsigned int num_bonds = m_nlist->getNumBonds();
+    const auto& neighbors = m_nlist->getNeighbors();
+    const auto& distances = m_nlist->getDistances();
+    const auto& weights = m_nlist->getWeights();
+
+    // Pass one: count the accepted bonds in fixed blocks so pass two can
+    // scatter each block independently at a precomputed offset.
+    constexpr size_t BLOCK_SIZE = 1 << 15;
+    const size_t num_blocks = (size_t(num_bonds) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<unsigned int> block_offsets(num_blocks + 1, 0);
+    util::forLoopWrapper(
+        0, num_blocks,
+        [&](size_t begin, size_t end) {
+            for (size_t block = begin; block != end; ++block)
+            {
+                const size_t stop = std::min(size_t(num_bonds), (block + 1) * BLOCK_SIZE);
+                unsigned int kept = 0;
+                for (size_t bond = block * BLOCK_SIZE; bond != stop; ++bond)
+                {
+                    kept += accepts(NeighborBond(neighbors(bond, 0), neighbors(bond, 1), distances[bond],
+                                                 weights[bond]))
+                        ? 1
+                        : 0;
+                }
+                block_offsets[block + 1] = kept;
+            }
+        },
+        parallel);
+    for (size_t block = 0; block < num_blocks; ++block)
+    {
+        block_offsets[block + 1] += block_offsets[block];
+    }
+
+    NeighborList result;
+    result.setNumBonds(block_offsets[num_blocks], m_nlist->getNumQueryPoints(), m_nlist->getNumPoints());
+    result.m_half_list = m_nlist->m_half_list;
+
+    // Pass two: copy each block's accepted bonds to its slice of the result.
+    util::forLoopWrapper(
+        0, num_blocks,
+        [&](size_t begin, size_t end) {
+            for (size_t block = begin; block != end; ++block)
+            {
+                const size_t stop = std::min(size_t(num_bonds), (block + 1) * BLOCK_SIZE);
+                unsigned int out = block_offsets[block];
+                for (size_t bond = block * BLOCK_SIZE; bond != stop; ++bond)
+                {
+                    if (accepts(NeighborBond(neighbors(bond, 0), neighbors(bond, 1), distances[bond],
+                                             weights[bond])))
+                    {
+                        result.m_neighbors(out, 0) = neighbors(bond, 0);
+                        result.m_neighbors(out, 1) = neighbors(bond, 1);
+                        result.m_distances[out] = distances[bond];
+                        result.m_weights[out] = weights[bond];
+                        ++out;
+                    }
+                }
+            }
+        },
+        parallel);
+    return result;
+}
+
 bool compareFirstNeighborPairs(const std::vector<NeighborBond>& left, const std::vector<NeighborBond>& right)
 {
     if (right.empty())
@@ -4,6 +4,8 @@
 #ifndef NEIGHBOR_LIST_H
 #define NEIGHBOR_LIST_H
 
+#include <limits>
+#include <string>
 #include <vector>
 
 #include "Box.h"
@@ -23,10 +25,33 @@ namespace freud { namespace locality {
 
     Query point and point indices are stored in a 2D array m_neighbors of shape
     (n_bonds, 2). The distances and weights arrays are flat per-bond arrays.
+
+    In addition to the per-bond arrays, a CSR (compressed sparse row)
+    representation is maintained lazily alongside them: an offsets array of
+    length (n_query_points + 1) holding the exclusive prefix sum of the
+    per-point neighbor counts, and a packed copy of the point index column so
+    that the neighbors of a single query point form one contiguous slice. The
+    CSR arrays are rebuilt on demand behind the same m_segments_counts_updated
+    flag as the counts and segments arrays, and per-point iteration through
+    getSegment is a pointer bump rather than a binary search per bond.
  */
 class NeighborList
 {
 public:
+    //! Zero-copy view of all bonds belonging to a single query point.
+    /*! The pointers index into the CSR arrays of the owning NeighborList and
+     *  remain valid until the list is next modified. The point_indices slice
+     *  is contiguous, so consumers can iterate with a simple pointer bump.
+     */
+    struct BondSegment
+    {
+        const unsigned int* point_indices; //!< Packed point indices for this query point.
+        const float* distances;            //!< Distances for this query point's bonds.
+        const float* weights;              //!< Weights for this query point's bonds.
+        unsigned int first_bond;           //!< Global index of this query point's first bond.
+        unsigned int count;                //!< Number of bonds for this query point.
+    };
+
     //! Default constructor
     NeighborList();
     //! Create a NeighborList that can hold up to the given number of bonds
@@ -105,6 +130,39 @@ public:
         updateSegmentCounts();
         return m_segments;
     }
+    //! Access the CSR offsets array (length num_query_points + 1) for reading
+    const util::ManagedArray<unsigned int>& getOffsets() const
+    {
+        updateSegmentCounts();
+        return m_offsets;
+    }
+
+    //! Get a zero-copy view of the bonds of the given query point.
+    /*! Triggers a rebuild of the CSR arrays if they are stale. Like
+     *  updateSegmentCounts, the rebuild is not thread-safe, so callers
+     *  iterating in parallel should touch the CSR arrays once beforehand.
+     */
+    BondSegment getSegment(unsigned int query_point) const;
+
+    //! Whether this list stores each symmetric pair once with i < j.
+    /*! In half-list mode every stored bond (i, j) with i < j implicitly
+     *  represents the reversed bond (j, i) as well. Consumers iterating over
+     *  all bonds (e.g. loopOverNeighbors) present both directions virtually;
+     *  the counts, segments, and CSR arrays describe only the stored bonds.
+     */
+    bool isHalfList() const
+    {
+        return m_half_list;
+    }
+
+    //! Compress a full symmetric list to half-list (i < j) storage.
+    /*! Drops all bonds with query_point_idx >= point_idx, which removes both
+     *  the reversed duplicates and any self bonds, and marks the list as a
+     *  half list. Requires num_query_points == num_points since the stored
+     *  pairs are only meaningful for symmetric lists. Returns the number of
+     *  bonds removed.
+     */
+    unsigned int compressToHalfList();
 
     //! Remove bonds in this object based on an array of boolean values. The
     //  array must be at least as long as the number of neighbor bonds.
@@ -120,6 +178,22 @@ public:
     //! Resize member arrays to a different size
     void resize(unsigned int num_bonds);
 
+    //! Save this NeighborList to a binary array file.
+    /*! The per-bond arrays are written as aligned sections of the format
+     *  described in ArrayFile.h, so saved lists can be reloaded with load()
+     *  by pointing directly into a memory mapping of the file.
+     */
+    void save(const std::string& path) const;
+
+    //! Replace this NeighborList with one loaded from a saved array file.
+    /*! The loaded per-bond arrays are zero-copy views into a private mapping
+     *  of the file: nothing is read at load time beyond the headers, pages
+     *  fault in lazily as bonds are accessed, and modification (e.g. filter)
+     *  dirties only in-memory pages, never the file. The derived CSR arrays
+     *  are not stored; they are rebuilt lazily on first use as usual.
+     */
+    void load(const std::string& path);
+
     //! Copy the bonds from another NeighborList object
     void copy(const NeighborList& other);
     //! Throw a runtime_error if num_points and num_query_points do not match
@@ -127,6 +201,8 @@ public:
     void validate(unsigned int num_query_points, unsigned int num_points) const;
 
 private:
+    friend class NeighborListView;
+
     //! Helper method for bisection search of the neighbor list, used in find_first_index
     unsigned int bisection_search(unsigned int val, unsigned int left, unsigned int right) const;
 
@@ -141,18 +217,116 @@ private:
     //! Neighbor list per-bond weight array
     util::ManagedArray<float> m_weights;
 
+    //! Whether each symmetric pair is stored once with i < j
+    bool m_half_list {false};
     //! Track whether segments and counts are up to date
     mutable bool m_segments_counts_updated;
     //! Neighbor counts for each query point
     mutable util::ManagedArray<unsigned int> m_counts;
     //! Neighbor segments for each query point
     mutable util::ManagedArray<unsigned int> m_segments;
+    //! CSR offsets, the exclusive prefix sum of m_counts with a final sentinel
+    mutable util::ManagedArray<unsigned int> m_offsets;
+    //! Packed copy of the point index column, contiguous per query point
+    mutable util::ManagedArray<unsigned int> m_csr_point_indices;
+};
+
+//! A lazily filtered view of a NeighborList.
+/*! Post-processing a list before feeding it to a compute -- masking bonds by
+ *  a distance window, by membership of their endpoints in index sets, or by
+ *  a weight threshold -- normally copies the full bond arrays per filter. A
+ *  view instead holds the unmodified list plus the filter parameters, and
+ *  consumers test each bond with accepts() as they iterate, so no bond data
+ *  is copied. The loopOverNeighbors and loopOverNeighborsIterator overloads
+ *  in NeighborComputeFunctional.h consume views directly; materialize()
+ *  produces a concrete filtered NeighborList in parallel when one is
+ *  required.
+ *
+ *  Filters compose: a bond passes the view if it passes every filter set on
+ *  it. The view borrows the list and any masks; the caller must keep them
+ *  alive for the lifetime of the view (and of anything iterating it), as
+ *  with the point arrays held by neighbor query objects.
+ */
+class NeighborListView
+{
+public:
+    explicit NeighborListView(const NeighborList* nlist) : m_nlist(nlist) {}
+
+    //! Keep only bonds with r_min <= distance < r_max (filter_r's convention).
+    NeighborListView& distanceWindow(float r_min, float r_max)
+    {
+        m_r_min = r_min;
+        m_r_max = r_max;
+        return *this;
+    }
+
+    //! Keep only bonds with weight >= min_weight.
+    NeighborListView& minWeight(float min_weight)
+    {
+        m_min_weight = min_weight;
+        return *this;
+    }
+
+    //! Keep only bonds whose query point is flagged in the mask.
+    /*! The mask must be at least num_query_points long. */
+    NeighborListView& queryPointMask(const bool* mask)
+    {
+        m_query_point_mask = mask;
+        return *this;
+    }
+
+    //! Keep only bonds whose point is flagged in the mask.
+    /*! The mask must be at least num_points long. */
+    NeighborListView& pointMask(const bool* mask)
+    {
+        m_point_mask = mask;
+        return *this;
+    }
+
+    //! Get the underlying list.
+    const NeighborList* list() const
+    {
+        return m_nlist;
+    }
+
+    //! Whether a bond (as presented to a consumer) passes every filter.
+    bool accepts(const NeighborBond& nb) const
+    {
+        return nb.distance >= m_r_min && nb.distance < m_r_max && nb.weight >= m_min_weight
+            && (m_query_point_mask == nullptr || m_query_point_mask[nb.query_point_idx])
+            && (m_point_mask == nullptr || m_point_mask[nb.point_idx]);
+    }
+
+    //! Build a concrete NeighborList holding only the accepted bonds.
+    /*! Runs a parallel two-pass copy (count per block, prefix sum, scatter),
+     *  so materializing a large view scales with cores. Half lists stay half
+     *  lists; the filters are applied to the stored direction of each bond.
+     */
+    NeighborList materialize(bool parallel = true) const;
+
+private:
+    const NeighborList* m_nlist; //!< The unmodified list this view filters.
+    float m_r_min {0};           //!< Minimum accepted distance (inclusive).
+    float m_r_max {std::numeric_limits<float>::infinity()}; //!< Maximum accepted distance (exclusive).
+    float m_min_weight {-std::numeric_limits<float>::infinity()}; //!< Minimum accepted weight.
+    const bool* m_query_point_mask {nullptr}; //!< Accepted query points (null accepts all).
+    const bool* m_point_mask {nullptr};       //!< Accepted points (null accepts all).
 };
 
 bool compareNeighborBond(const NeighborBond& left, const NeighborBond& right);
 bool compareNeighborDistance(const NeighborBond& left, const NeighborBond& right);
 bool compareFirstNeighborPairs(const std::vector<NeighborBond>& left, const std::vector<NeighborBond>& right);
 
+//! Sort bonds into NeighborList order using a parallel LSD radix sort.
+/*! Orders bonds identically to compareNeighborBond (or, when
+ *  sort_by_distance is set, compareNeighborDistance) but runs as a parallel
+ *  least-significant-digit radix sort on the packed 64-bit
+ *  (query_point_idx, point_idx) or (query_point_idx, distance) key, so large
+ *  lists sort at memory bandwidth and scale with cores. Small inputs fall
+ *  back to comparison sorting.
+ */
+void sortNeighborBonds(std::vector<NeighborBond>& bonds, bool sort_by_distance = false);
+
 }; }; // end namespace freud::locality
 
 #endif // NEIGHBOR_LIST_H
@@ -4,16 +4,19 @@
 #ifndef NEIGHBOR_QUERY_H
 #define NEIGHBOR_QUERY_H
 
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <tbb/enumerable_thread_specific.h>
-#include <tbb/parallel_sort.h>
+#include <unordered_map>
 #include <utility>
 
 #include "Box.h"
+#include "ManagedArray.h"
 #include "NeighborBond.h"
 #include "NeighborList.h"
 #include "NeighborPerPointIterator.h"
+#include "ThreadStorage.h"
 #include "utils.h"
 
 /*! \file NeighborQuery.h
@@ -60,6 +63,30 @@ struct QueryArgs
     float scale {DEFAULT_SCALE};          //! The scale factor to use when performing repeated ball queries
                                           //! to find a specified number of nearest neighbors.
     bool exclude_ii {DEFAULT_EXCLUDE_II}; //! If true, exclude self-neighbors.
+
+    //! Per-query-point cutoff distances, indexed by query point index (may be
+    //! null). When set, each query point's ball query prunes the tree or cell
+    //! traversal with its own cutoff instead of one global one, so
+    //! polydisperse systems avoid querying everything at the largest radius
+    //! and discarding most candidates afterwards. r_max must still be set (to
+    //! the largest per-point cutoff); it sizes acceleration structures such
+    //! as the LinkCell cell width. Only supported for ball queries. The array
+    //! is borrowed; the caller keeps it alive for the duration of the query.
+    const float* r_maxes {nullptr};
+
+    //! Per-query-point type ids, indexed by query point index (may be null).
+    const unsigned int* query_point_types {nullptr};
+    //! Per-point type ids, indexed by point index (may be null).
+    const unsigned int* point_types {nullptr};
+    //! Row-major num_types x num_types inclusion mask over (query point type,
+    //! point type) pairs. When set, ball queries only report bonds whose type
+    //! pair is flagged, so one traversal serves any subset of species pairs.
+    //! Requires both type arrays and num_types; only supported for ball
+    //! queries (pair filtering would change the semantics of k-nearest
+    //! queries). May be null to report all bonds. The arrays are borrowed;
+    //! the caller keeps them alive for the duration of the query.
+    const bool* type_pair_mask {nullptr};
+    unsigned int num_types {0}; //! Number of types indexing type_pair_mask.
 };
 
 // Forward declare the iterators
@@ -100,6 +127,19 @@ public:
                 }
             }
         }
+
+        // Build the structure-of-arrays mirror of the points once, so SIMD
+        // kernels can load each coordinate contiguously instead of gathering
+        // from the interleaved layout.
+        m_points_x.prepare(m_n_points);
+        m_points_y.prepare(m_n_points);
+        m_points_z.prepare(m_n_points);
+        for (unsigned int i(0); i < m_n_points; i++)
+        {
+            m_points_x[i] = m_points[i].x;
+            m_points_y[i] = m_points[i].y;
+            m_points_z[i] = m_points[i].z;
+        }
     }
 
     //! Empty Destructor
@@ -156,6 +196,30 @@ public:
         return m_points;
     }
 
+    //! Get the contiguous x components of the points.
+    /*! The x/y/z accessors expose a structure-of-arrays mirror of the points
+     *  built once at construction. Vectorized kernels should read coordinates
+     *  through these so that a block of points loads as three contiguous
+     *  streams; the interleaved getPoints/operator[] view remains the
+     *  canonical per-point access.
+     */
+    const float* getPointsX() const
+    {
+        return m_points_x.get();
+    }
+
+    //! Get the contiguous y components of the points.
+    const float* getPointsY() const
+    {
+        return m_points_y.get();
+    }
+
+    //! Get the contiguous z components of the points.
+    const float* getPointsZ() const
+    {
+        return m_points_z.get();
+    }
+
     //! Get the number of reference points
     unsigned int getNPoints() const
     {
@@ -174,13 +238,95 @@ public:
         return m_points[index];
     }
 
-protected:
+    //! Enable or disable memoization of internally generated NeighborLists.
+    /*! When enabled, makeDefaultNlist stores each list it generates from this
+     *  object in a small registry keyed by the query parameters, so later
+     *  computes in the same frame that use identical parameters reuse the
+     *  stored bonds instead of regenerating them. The cache is opt-in because
+     *  it pins the generated lists in memory for the lifetime of this object
+     *  (or until invalidateNlistCache is called). Like the computes that
+     *  populate it, the cache is not thread-safe across concurrent computes
+     *  on the same object.
+     */
+    void setNlistCacheEnabled(bool enabled)
+    {
+        m_nlist_cache_enabled = enabled;
+        if (!enabled)
+        {
+            m_nlist_cache.clear();
+        }
+    }
+
+    //! Whether NeighborList memoization is enabled on this object.
+    bool getNlistCacheEnabled() const
+    {
+        return m_nlist_cache_enabled;
+    }
+
+    //! Drop all cached NeighborLists and bump the data generation counter.
+    /*! Must be called if the underlying point data is mutated in place;
+     *  freud's own bindings construct a fresh NeighborQuery per frame, but
+     *  long-lived C++ consumers may update points behind the same pointer.
+     */
+    void invalidateNlistCache()
+    {
+        ++m_nlist_generation;
+        m_nlist_cache.clear();
+    }
+
+    //! Compute the cache key for a set of query parameters.
+    size_t hashNlistRequest(const vec3<float>* query_points, unsigned int n_query_points,
+                            const QueryArgs& args, bool half_list) const
+    {
+        size_t seed(m_nlist_generation);
+        const auto combine = [&seed](size_t value) {
+            // Standard hash-combine mixing constant (golden ratio).
+            seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6U) + (seed >> 2U);
+        };
+        combine(std::hash<const void*>()(query_points));
+        combine(n_query_points);
+        combine(static_cast<size_t>(args.mode));
+        combine(args.num_neighbors);
+        combine(std::hash<float>()(args.r_max));
+        // Per-query-point cutoffs change the bonds produced, so they must
+        // participate in the key; like query_points, the pointer stands in
+        // for the array contents.
+        combine(std::hash<const void*>()(args.r_maxes));
+        combine(std::hash<float>()(args.r_min));
+        combine(std::hash<float>()(args.r_guess));
+        combine(std::hash<float>()(args.scale));
+        combine(static_cast<size_t>(args.exclude_ii));
+        // The type filter also changes the bonds produced; as with r_maxes,
+        // the array pointers stand in for their contents.
+        combine(std::hash<const void*>()(args.query_point_types));
+        combine(std::hash<const void*>()(args.point_types));
+        combine(std::hash<const void*>()(args.type_pair_mask));
+        combine(args.num_types);
+        combine(static_cast<size_t>(half_list));
+        return seed;
+    }
+
+    //! Look up a cached NeighborList, returning nullptr on a miss.
+    const NeighborList* findCachedNlist(size_t key) const
+    {
+        const auto it = m_nlist_cache.find(key);
+        return it == m_nlist_cache.end() ? nullptr : &it->second;
+    }
+
+    //! Store a generated NeighborList in the cache and return the stored copy.
+    const NeighborList& storeCachedNlist(size_t key, NeighborList nlist) const
+    {
+        return m_nlist_cache.emplace(key, std::move(nlist)).first->second;
+    }
+
     //! Validate the combination of specified arguments.
     /*! Before checking if the combination of parameters currently set is
      *  valid, this function first attempts to infer a mode if one is not set in
      *  order to allow the user to specify certain simple minimal argument
      *  combinations (e.g. just an r_max) without having to specify the mode
-     *  explicitly.
+     *  explicitly. This is public so that code dispatching on the resolved
+     *  query mode (e.g. loopOverConcreteIterators) can resolve the arguments
+     *  the same way the query entry points do.
      */
     virtual void validateQueryArgs(QueryArgs& args) const
     {
@@ -215,8 +361,25 @@ protected:
         {
             throw std::runtime_error("Unknown mode");
         }
+        if (args.r_maxes != nullptr && args.mode != QueryType::ball)
+        {
+            throw std::runtime_error("Per-query-point cutoffs are only supported for ball queries.");
+        }
+        if (args.type_pair_mask != nullptr)
+        {
+            if (args.mode != QueryType::ball)
+            {
+                throw std::runtime_error("Type pair masks are only supported for ball queries.");
+            }
+            if (args.query_point_types == nullptr || args.point_types == nullptr || args.num_types == 0)
+            {
+                throw std::runtime_error(
+                    "Type pair masks require both type arrays and a nonzero num_types.");
+            }
+        }
     }
 
+protected:
     //! Try to determine the query mode if one is not specified.
     /*! If no mode is specified and a number of neighbors is specified, the
      *  query mode must be a nearest neighbors query (all other arguments can
@@ -242,6 +405,15 @@ protected:
     const box::Box m_box;        //!< Simulation box where the particles belong.
     const vec3<float>* m_points; //!< Point coordinates.
     unsigned int m_n_points;     //!< Number of points.
+
+    util::ManagedArray<float> m_points_x; //!< Contiguous x components of the points (SoA mirror).
+    util::ManagedArray<float> m_points_y; //!< Contiguous y components of the points (SoA mirror).
+    util::ManagedArray<float> m_points_z; //!< Contiguous z components of the points (SoA mirror).
+
+    bool m_nlist_cache_enabled {false};  //!< Whether generated NeighborLists are memoized.
+    unsigned int m_nlist_generation {0}; //!< Data generation counter mixed into cache keys.
+    mutable std::unordered_map<size_t, NeighborList>
+        m_nlist_cache; //!< Memoized NeighborLists keyed by query parameters.
 };
 
 //! Implementation of per-point finding logic for NeighborQuery objects.
@@ -288,13 +460,37 @@ public:
     //! Get the next element.
     NeighborBond next() override = 0;
 
+    //! Install the type arrays and pair inclusion mask from query arguments.
+    /*! Concrete iterators that support type filtering consult
+     *  allowsTypePair while traversing; without a mask every pair passes.
+     */
+    void setTypeFilter(const QueryArgs& args)
+    {
+        m_query_point_types = args.query_point_types;
+        m_point_types = args.point_types;
+        m_type_pair_mask = args.type_pair_mask;
+        m_num_types = args.num_types;
+    }
+
 protected:
+    //! Whether the bond from this query point to point j passes the mask.
+    bool allowsTypePair(unsigned int j) const
+    {
+        return m_type_pair_mask == nullptr
+            || m_type_pair_mask[size_t(m_query_point_types[m_query_point_idx]) * m_num_types
+                                + m_point_types[j]];
+    }
+
     const NeighborQuery* m_neighbor_query;       //!< Link to the NeighborQuery object.
     const vec3<float> m_query_point = {0, 0, 0}; //!< Coordinates of the query point.
     bool m_finished; //!< Flag to indicate that iteration is complete (must be set by next() on termination).
     float m_r_max;   //!< Cutoff distance for neighbors.
     float m_r_min;   //!< Minimum distance for neighbors.
     bool m_exclude_ii; //!< Flag to indicate whether or not to include self bonds.
+    const unsigned int* m_query_point_types {nullptr}; //!< Per-query-point type ids (may be null).
+    const unsigned int* m_point_types {nullptr};       //!< Per-point type ids (may be null).
+    const bool* m_type_pair_mask {nullptr}; //!< Row-major type pair inclusion mask (may be null).
+    unsigned int m_num_types {0};           //!< Number of types indexing the mask.
 };
 
 //! The iterator class for neighbor queries on NeighborQuery objects.
@@ -381,10 +577,17 @@ public:
      */
     NeighborList* toNeighborList(bool sort_by_distance = false)
     {
-        using BondVector = tbb::enumerable_thread_specific<std::vector<NeighborBond>>;
-        BondVector bonds;
+        // Per-thread bond buffers are drawn from a process-wide pool so that
+        // their capacity is reused from frame to frame; in steady-state
+        // trajectory analysis the bond accumulation below performs no heap
+        // allocations. freud computes are driven one at a time per process
+        // from Python, so a single pool (and gather buffer) suffices.
+        static util::ThreadBufferPool<NeighborBond> bond_pool;
+        static std::vector<NeighborBond> linear_bonds;
+        bond_pool.clear();
+
         util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
-            BondVector::reference local_bonds(bonds.local());
+            util::ThreadBufferPool<NeighborBond>::reference local_bonds(bond_pool.local());
             NeighborBond nb;
             for (size_t i = begin; i < end; ++i)
             {
@@ -401,16 +604,8 @@ public:
             }
         });
 
-        tbb::flattened2d<BondVector> flat_bonds = tbb::flatten2d(bonds);
-        std::vector<NeighborBond> linear_bonds(flat_bonds.begin(), flat_bonds.end());
-        if (sort_by_distance)
-        {
-            tbb::parallel_sort(linear_bonds.begin(), linear_bonds.end(), compareNeighborDistance);
-        }
-        else
-        {
-            tbb::parallel_sort(linear_bonds.begin(), linear_bonds.end(), compareNeighborBond);
-        }
+        bond_pool.gatherInto(linear_bonds);
+        sortNeighborBonds(linear_bonds, sort_by_distance);
 
         unsigned int num_bonds = linear_bonds.size();
 
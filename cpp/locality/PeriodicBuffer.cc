@@ -11,10 +11,10 @@
 
 namespace freud { namespace locality {
 
-void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>& buff,
-                             const bool use_images)
+PeriodicBufferIterator::PeriodicBufferIterator(const NeighborQuery* neighbor_query,
+                                               const vec3<float>& buff, bool use_images)
+    : m_neighbor_query(neighbor_query), m_box(neighbor_query->getBox()), m_use_images(use_images)
 {
-    m_box = neighbor_query->getBox();
     if (buff.x < 0)
     {
         throw std::invalid_argument("Buffer x distance must be non-negative.");
@@ -29,89 +29,138 @@ void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_quer
     }
 
     // Get the box dimensions
-    vec3<float> L(m_box.getL());
-    float xy = m_box.getTiltFactorXY();
-    float xz = m_box.getTiltFactorXZ();
-    float yz = m_box.getTiltFactorYZ();
-    bool is2D = m_box.is2D();
-    vec3<int> images;
+    const vec3<float> L(m_box.getL());
+    const float xy = m_box.getTiltFactorXY();
+    const float xz = m_box.getTiltFactorXZ();
+    const float yz = m_box.getTiltFactorYZ();
+    const bool is2D = m_box.is2D();
 
     if (use_images)
     {
-        images = vec3<int>(std::ceil(buff.x), std::ceil(buff.y), std::ceil(buff.z));
-        m_buffer_box
-            = freud::box::Box(static_cast<float>(1 + images.x) * L.x, static_cast<float>(1 + images.y) * L.y,
-                              static_cast<float>(1 + images.z) * L.z, xy, xz, yz, is2D);
+        m_images = vec3<int>(std::ceil(buff.x), std::ceil(buff.y), std::ceil(buff.z));
+        m_buffer_box = freud::box::Box(static_cast<float>(1 + m_images.x) * L.x,
+                                       static_cast<float>(1 + m_images.y) * L.y,
+                                       static_cast<float>(1 + m_images.z) * L.z, xy, xz, yz, is2D);
     }
     else
     {
-        images = vec3<int>(std::ceil(buff.x / L.x), std::ceil(buff.y / L.y), std::ceil(buff.z / L.z));
+        m_images = vec3<int>(std::ceil(buff.x / L.x), std::ceil(buff.y / L.y), std::ceil(buff.z / L.z));
         m_buffer_box
             = freud::box::Box(L.x + 2 * buff.x, L.y + 2 * buff.y, L.z + 2 * buff.z, xy, xz, yz, is2D);
     }
 
     if (is2D)
     {
-        images.z = 0;
+        m_images.z = 0;
     }
 
-    m_buffer_points.clear();
-    m_buffer_ids.clear();
+    // Position on the first valid ghost.
+    m_i = use_images ? 0 : -m_images.x;
+    m_j = use_images ? 0 : -m_images.y;
+    m_k = use_images ? 0 : -m_images.z;
+    while (!m_finished && !currentValid())
+    {
+        step();
+    }
+}
+
+PeriodicBufferIterator::BufferPoint PeriodicBufferIterator::makeGhost() const
+{
+    // Compute the new position for the buffer point, shifted by images.
+    vec3<float> point_image = (*m_neighbor_query)[m_point_id];
+    point_image += float(m_i) * m_box.getLatticeVector(0);
+    point_image += float(m_j) * m_box.getLatticeVector(1);
+    if (!m_box.is2D())
+    {
+        point_image += float(m_k) * m_box.getLatticeVector(2);
+    }
+
+    if (m_use_images)
+    {
+        // Wrap the positions back into the buffer box. Wrapping here ensures
+        // we yield the correct number of points instead of relying on the
+        // floating point precision of the fractional check below.
+        point_image = m_buffer_box.wrap(point_image);
+    }
+    return BufferPoint {point_image, m_point_id};
+}
+
+bool PeriodicBufferIterator::currentValid() const
+{
+    // Skip the origin image
+    if (m_i == 0 && m_j == 0 && m_k == 0)
+    {
+        return false;
+    }
+    if (m_use_images)
+    {
+        // Every image combination is yielded when a number of images was
+        // specified.
+        return true;
+    }
+    // When using a buffer "skin distance," we check the fractional
+    // coordinates to see if the points are inside the buffer box. Unexpected
+    // results may occur due to numerical imprecision in this check!
+    vec3<float> point_image = (*m_neighbor_query)[m_point_id];
+    point_image += float(m_i) * m_box.getLatticeVector(0);
+    point_image += float(m_j) * m_box.getLatticeVector(1);
+    if (!m_box.is2D())
+    {
+        point_image += float(m_k) * m_box.getLatticeVector(2);
+    }
+    const vec3<float> buff_frac = m_buffer_box.makeFractional(point_image);
+    return 0 <= buff_frac.x && buff_frac.x < 1 && 0 <= buff_frac.y && buff_frac.y < 1
+        && (m_box.is2D() || (0 <= buff_frac.z && buff_frac.z < 1));
+}
 
-    // for each point
-    for (unsigned int point_id = 0; point_id < neighbor_query->getNPoints(); point_id++)
+void PeriodicBufferIterator::step()
+{
+    if (++m_k > m_images.z)
     {
-        for (int i = use_images ? 0 : -images.x; i <= images.x; i++)
+        m_k = m_use_images ? 0 : -m_images.z;
+        if (++m_j > m_images.y)
         {
-            for (int j = use_images ? 0 : -images.y; j <= images.y; j++)
+            m_j = m_use_images ? 0 : -m_images.y;
+            if (++m_i > m_images.x)
             {
-                for (int k = use_images ? 0 : -images.z; k <= images.z; k++)
+                m_i = m_use_images ? 0 : -m_images.x;
+                if (++m_point_id >= m_neighbor_query->getNPoints())
                 {
-                    // Skip the origin image
-                    if (i == 0 && j == 0 && k == 0)
-                    {
-                        continue;
-                    }
-
-                    // Compute the new position for the buffer point,
-                    // shifted by images.
-                    vec3<float> point_image = (*neighbor_query)[point_id];
-                    point_image += float(i) * m_box.getLatticeVector(0);
-                    point_image += float(j) * m_box.getLatticeVector(1);
-                    if (!is2D)
-                    {
-                        point_image += float(k) * m_box.getLatticeVector(2);
-                    }
-
-                    if (use_images)
-                    {
-                        // Wrap the positions back into the buffer box and
-                        // always append them if a number of images was
-                        // specified. Performing the check this way ensures we
-                        // have the correct number of points instead of
-                        // relying on the floating point precision of the
-                        // fractional check below.
-                        m_buffer_points.push_back(m_buffer_box.wrap(point_image));
-                        m_buffer_ids.push_back(point_id);
-                    }
-                    else
-                    {
-                        // When using a buffer "skin distance," we check the
-                        // fractional coordinates to see if the points are
-                        // inside the buffer box. Unexpected results may occur
-                        // due to numerical imprecision in this check!
-                        vec3<float> buff_frac = m_buffer_box.makeFractional(point_image);
-                        if (0 <= buff_frac.x && buff_frac.x < 1 && 0 <= buff_frac.y && buff_frac.y < 1
-                            && (is2D || (0 <= buff_frac.z && buff_frac.z < 1)))
-                        {
-                            m_buffer_points.push_back(point_image);
-                            m_buffer_ids.push_back(point_id);
-                        }
-                    }
+                    m_finished = true;
                 }
             }
         }
     }
 }
 
+PeriodicBufferIterator::BufferPoint PeriodicBufferIterator::next()
+{
+    const BufferPoint result = makeGhost();
+    // Advance to the next valid ghost so end() is accurate.
+    do
+    {
+        step();
+    } while (!m_finished && !currentValid());
+    return result;
+}
+
+void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>& buff,
+                             const bool use_images)
+{
+    m_box = neighbor_query->getBox();
+
+    PeriodicBufferIterator iter(neighbor_query, buff, use_images);
+    m_buffer_box = iter.getBufferBox();
+
+    m_buffer_points.clear();
+    m_buffer_ids.clear();
+
+    while (!iter.end())
+    {
+        const PeriodicBufferIterator::BufferPoint ghost = iter.next();
+        m_buffer_points.push_back(ghost.position);
+        m_buffer_ids.push_back(ghost.point_id);
+    }
+}
+
 }; }; // end namespace freud::locality
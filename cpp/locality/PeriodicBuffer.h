@@ -16,6 +16,70 @@
 
 namespace freud { namespace locality {
 
+//! Streams replicated ghost points one at a time without materializing them.
+/*! The eager PeriodicBuffer::compute holds every ghost in memory at once,
+ *  which for thin slabs with large buffer distances can multiply the memory
+ *  footprint several times over before any query runs. This iterator walks
+ *  the same (point, image) space lazily: each call to next() yields one ghost
+ *  point together with its original point id, so consumers can feed ghosts
+ *  directly into binning or query structures and never hold the full set.
+ *
+ *  The iteration order and the set of yielded ghosts match compute() exactly;
+ *  compute() is itself implemented by draining one of these iterators.
+ */
+class PeriodicBufferIterator
+{
+public:
+    //! One replicated point together with the id of the point it images.
+    struct BufferPoint
+    {
+        vec3<float> position;  //!< The ghost point position.
+        unsigned int point_id; //!< The original point's index.
+    };
+
+    //! Constructor
+    /*! \param neighbor_query The points to replicate.
+     *  \param buff The buffer distance (or image count if use_images) per dimension.
+     *  \param use_images Whether buff counts whole box images instead of a skin distance.
+     */
+    PeriodicBufferIterator(const NeighborQuery* neighbor_query, const vec3<float>& buff, bool use_images);
+
+    //! Get the buffer box enclosing all ghosts this iterator yields.
+    const freud::box::Box& getBufferBox() const
+    {
+        return m_buffer_box;
+    }
+
+    //! Test if the iteration is complete.
+    bool end() const
+    {
+        return m_finished;
+    }
+
+    //! Get the next ghost point.
+    /*! Must not be called once end() returns true. */
+    BufferPoint next();
+
+private:
+    //! Build the ghost for the current (point, image) indices.
+    BufferPoint makeGhost() const;
+
+    //! Whether the current indices denote a ghost that should be yielded.
+    bool currentValid() const;
+
+    //! Advance the (point, image) indices by one step.
+    void step();
+
+    const NeighborQuery* m_neighbor_query; //!< The points being replicated
+    freud::box::Box m_box;                 //!< Simulation box of the original points
+    freud::box::Box m_buffer_box;          //!< Simulation box of the replicated points
+    bool m_use_images;                     //!< Whether buff counts whole images
+    bool m_finished {false};               //!< Whether all ghosts have been yielded
+    vec3<int> m_images;                    //!< Image shell extent per dimension
+    unsigned int m_point_id {0};           //!< Current original point index
+    int m_i, m_j, m_k;                     //!< Current image indices
+};
+
 class PeriodicBuffer
 {
 public:
@@ -0,0 +1,142 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+#include <tbb/parallel_reduce.h>
+
+#include "PersistentNeighborEngine.h"
+
+namespace freud { namespace locality {
+
+PersistentNeighborEngine::PersistentNeighborEngine(float skin) : m_skin(skin)
+{
+    if (skin <= 0)
+    {
+        throw std::invalid_argument("PersistentNeighborEngine requires skin to be positive.");
+    }
+}
+
+const NeighborList& PersistentNeighborEngine::compute(const box::Box& box, const vec3<float>* points,
+                                                      unsigned int n_points, QueryArgs qargs)
+{
+    if (qargs.mode != QueryType::ball)
+    {
+        throw std::invalid_argument("PersistentNeighborEngine only supports ball queries.");
+    }
+
+    if (needsRebuild(box, points, n_points, qargs))
+    {
+        rebuild(box, points, n_points, qargs);
+        m_last_frame_rebuilt = true;
+        ++m_num_rebuilds;
+    }
+    else
+    {
+        refreshFromSkinList(box, points, qargs);
+        m_last_frame_rebuilt = false;
+    }
+    return m_nlist;
+}
+
+void PersistentNeighborEngine::reset()
+{
+    m_has_state = false;
+    m_reference_points.clear();
+}
+
+bool PersistentNeighborEngine::needsRebuild(const box::Box& box, const vec3<float>* points,
+                                            unsigned int n_points, const QueryArgs& qargs) const
+{
+    if (!m_has_state || n_points != m_reference_points.size() || box != m_reference_box)
+    {
+        return true;
+    }
+    if (qargs.r_max != m_reference_qargs.r_max || qargs.r_min != m_reference_qargs.r_min
+        || qargs.exclude_ii != m_reference_qargs.exclude_ii)
+    {
+        return true;
+    }
+
+    // The skin list contains every pair within (r_max + skin) of the
+    // reference positions. It remains a superset of all pairs within r_max as
+    // long as no two particles have together closed more than skin, which is
+    // guaranteed while the maximum single-particle displacement is below
+    // skin / 2.
+    const float max_displacement_sq = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(0, n_points), 0.0f,
+        [&](const tbb::blocked_range<size_t>& r, float local_max) {
+            for (size_t i = r.begin(); i != r.end(); ++i)
+            {
+                const vec3<float> dr = box.wrap(points[i] - m_reference_points[i]);
+                local_max = std::max(local_max, dot(dr, dr));
+            }
+            return local_max;
+        },
+        [](float a, float b) { return std::max(a, b); });
+
+    const float half_skin = m_skin / 2.0f;
+    return max_displacement_sq > half_skin * half_skin;
+}
+
+void PersistentNeighborEngine::rebuild(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                       const QueryArgs& qargs)
+{
+    m_reference_box = box;
+    m_reference_qargs = qargs;
+    m_reference_points.assign(points, points + n_points);
+
+    // Generate the skin list with an enlarged cutoff so it can be filtered
+    // down to r_max on subsequent frames without a new query.
+    AABBQuery aabb_query(box, m_reference_points.data(), n_points);
+    QueryArgs skin_qargs(qargs);
+    skin_qargs.r_max = qargs.r_max + m_skin;
+    auto iterator = aabb_query.query(m_reference_points.data(), n_points, skin_qargs);
+    NeighborList* skin_nlist = iterator->toNeighborList();
+    m_skin_nlist.copy(*skin_nlist);
+    delete skin_nlist;
+    m_has_state = true;
+
+    refreshFromSkinList(box, points, qargs);
+}
+
+void PersistentNeighborEngine::refreshFromSkinList(const box::Box& box, const vec3<float>* points,
+                                                   const QueryArgs& qargs)
+{
+    const unsigned int num_skin_bonds = m_skin_nlist.getNumBonds();
+    const auto& neighbors = m_skin_nlist.getNeighbors();
+    const auto& weights = m_skin_nlist.getWeights();
+
+    // Recompute distances from the current positions and keep only bonds
+    // within the true cutoff. The skin list is sorted by query point index
+    // and filtering preserves that order.
+    std::vector<unsigned int> query_point_indices;
+    std::vector<unsigned int> point_indices;
+    std::vector<float> distances;
+    std::vector<float> bond_weights;
+    query_point_indices.reserve(num_skin_bonds);
+    point_indices.reserve(num_skin_bonds);
+    distances.reserve(num_skin_bonds);
+    bond_weights.reserve(num_skin_bonds);
+
+    for (unsigned int bond = 0; bond < num_skin_bonds; ++bond)
+    {
+        const unsigned int i(neighbors(bond, 0));
+        const unsigned int j(neighbors(bond, 1));
+        const vec3<float> dr = box.wrap(points[j] - points[i]);
+        const float distance = std::sqrt(dot(dr, dr));
+        if (distance < qargs.r_max && distance >= qargs.r_min)
+        {
+            query_point_indices.push_back(i);
+            point_indices.push_back(j);
+            distances.push_back(distance);
+            bond_weights.push_back(weights[bond]);
+        }
+    }
+
+    const auto num_points = static_cast<unsigned int>(m_reference_points.size());
+    m_nlist = NeighborList(static_cast<unsigned int>(query_point_indices.size()),
+                           query_point_indices.data(), num_points, point_indices.data(), num_points,
+                           distances.data(), bond_weights.data());
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,100 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef PERSISTENT_NEIGHBOR_ENGINE_H
+#define PERSISTENT_NEIGHBOR_ENGINE_H
+
+#include <memory>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "Box.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file PersistentNeighborEngine.h
+    \brief Stateful neighbor engine that reuses neighbor data across frames.
+*/
+
+namespace freud { namespace locality {
+
+//! Stateful neighbor engine with a Verlet skin for trajectory analysis.
+/*! Building an acceleration structure and generating a NeighborList from
+ *  scratch for every frame is redundant when particles move only a small
+ *  fraction of the cutoff between frames. This engine keeps the previous
+ *  build's bond list, generated with an enlarged cutoff of (r_max + skin),
+ *  along with the positions at build time. On subsequent frames it tracks the
+ *  maximum displacement of any particle since the last build; while no
+ *  particle has moved more than skin / 2, the enlarged list is guaranteed to
+ *  contain every pair within r_max, so the engine only recomputes bond
+ *  distances from the current positions and filters to the true cutoff. The
+ *  tree build and full query are repeated only once the skin is exhausted or
+ *  the system (box, point count, query arguments) changes.
+ *
+ *  Only ball queries are supported, since the skin guarantee is a statement
+ *  about distances rather than neighbor ranks.
+ */
+class PersistentNeighborEngine
+{
+public:
+    //! Construct an engine with the given skin distance.
+    explicit PersistentNeighborEngine(float skin);
+
+    //! Get a NeighborList for the given frame, rebuilding only when required.
+    /*! The returned reference remains valid until the next call to compute.
+     *  \param box Simulation box for this frame.
+     *  \param points Points for this frame.
+     *  \param n_points Number of points.
+     *  \param qargs Query arguments; mode must be QueryType::ball.
+     */
+    const NeighborList& compute(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                QueryArgs qargs);
+
+    //! Get the skin distance.
+    float getSkin() const
+    {
+        return m_skin;
+    }
+
+    //! Whether the last call to compute performed a full rebuild.
+    bool lastFrameRebuilt() const
+    {
+        return m_last_frame_rebuilt;
+    }
+
+    //! Get the number of full rebuilds performed so far.
+    unsigned int getNumRebuilds() const
+    {
+        return m_num_rebuilds;
+    }
+
+    //! Drop all cached state, forcing a rebuild on the next call to compute.
+    void reset();
+
+private:
+    //! Determine whether the cached bond list can be reused for this frame.
+    bool needsRebuild(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                      const QueryArgs& qargs) const;
+
+    //! Rebuild the acceleration structure and skin bond list from scratch.
+    void rebuild(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                 const QueryArgs& qargs);
+
+    //! Filter the cached skin list to the true cutoff with fresh distances.
+    void refreshFromSkinList(const box::Box& box, const vec3<float>* points, const QueryArgs& qargs);
+
+    float m_skin;                         //!< Verlet skin distance added to r_max at build time.
+    bool m_last_frame_rebuilt {false};    //!< Whether the last compute call rebuilt.
+    unsigned int m_num_rebuilds {0};      //!< Total number of full rebuilds.
+    bool m_has_state {false};             //!< Whether any cached state exists.
+    box::Box m_reference_box;             //!< Box at build time.
+    QueryArgs m_reference_qargs;          //!< Query arguments at build time.
+    std::vector<vec3<float>> m_reference_points; //!< Positions at build time.
+    NeighborList m_skin_nlist;            //!< Bond list generated with cutoff (r_max + skin).
+    NeighborList m_nlist;                 //!< Filtered bond list returned to the caller.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // PERSISTENT_NEIGHBOR_ENGINE_H
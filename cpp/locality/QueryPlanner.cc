@@ -0,0 +1,301 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "AABBQuery.h"
+#include "LinkCell.h"
+#include "QueryPlanner.h"
+
+/*! \file QueryPlanner.cc
+    \brief Cost-model based selection of the neighbor finding strategy.
+*/
+
+namespace freud { namespace locality {
+
+namespace {
+
+//! Calibrated seconds per candidate distance check, per strategy.
+/*! Measured on the freud_benchmarks locality suite; the absolute values only
+ *  matter relative to each other. Brute force pays one wrap and one dot per
+ *  check; the cell list adds the linked-list hop; the tree adds its node
+ *  descent amortized over the points per leaf. recordTiming overwrites these
+ *  with measured values as they arrive.
+ */
+double cost_per_check[3] = {3e-9, 5e-9, 7e-9};
+
+//! Calibrated seconds per point of building each acceleration structure.
+constexpr double CELL_BUILD_PER_POINT = 1.5e-8;
+constexpr double TREE_BUILD_PER_POINT = 6e-8;
+
+//! Weight of a new measurement in the moving average kept by recordTiming.
+constexpr double MEASUREMENT_WEIGHT = 0.3;
+
+//! Whether any measurement has replaced the calibrated default yet.
+bool has_measurement[3] = {false, false, false};
+
+//! The radius whose ball is expected to hold the requested neighbors.
+/*! Mirrors the r_guess estimate in AABBQuery::validateQueryArgs: assumes a
+ *  homogeneous density of n_points / volume and inverts the ball volume.
+ */
+float effectiveRadius(const box::Box& box, unsigned int n_points, const QueryArgs& args)
+{
+    if (args.mode == QueryType::ball)
+    {
+        return args.r_max;
+    }
+    const float k = static_cast<float>(args.num_neighbors);
+    const float volume_per_point = box.getVolume() / static_cast<float>(n_points);
+    if (box.is2D())
+    {
+        return std::sqrt(k * volume_per_point / static_cast<float>(M_PI));
+    }
+    return std::cbrt(float(3.0) * k * volume_per_point / (float(4.0) * static_cast<float>(M_PI)));
+}
+
+//! Expected candidate checks per query point for a region of linear size w.
+/*! The mean density times the region volume, clamped to the total number of
+ *  points: no strategy checks a point twice.
+ */
+double candidatesInRegion(const box::Box& box, unsigned int n_points, float w)
+{
+    const double density = double(n_points) / double(box.getVolume());
+    const double region = box.is2D() ? double(w) * double(w) : double(w) * double(w) * double(w);
+    return std::min(density * region, double(n_points));
+}
+
+//! Whether the box can hold a cell list of width r (LinkCell's constraint).
+bool cellListFits(const box::Box& box, float r)
+{
+    if (r <= 0 || !std::isfinite(r))
+    {
+        return false;
+    }
+    const vec3<float> nearest_plane_distance = box.getNearestPlaneDistance();
+    return !((r * 2.0 > nearest_plane_distance.x) || (r * 2.0 > nearest_plane_distance.y)
+             || (!box.is2D() && r * 2.0 > nearest_plane_distance.z));
+}
+
+}; // namespace
+
+/**************
+ * Brute force *
+ **************/
+
+BruteForceIterator::BruteForceIterator(const BruteForceQuery* neighbor_query, const vec3<float>& query_point,
+                                       unsigned int query_point_idx, float r_max, float r_min,
+                                       bool exclude_ii, unsigned int num_neighbors)
+    : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii)
+{
+    const box::Box& box = neighbor_query->getBox();
+    const vec3<float>* points = neighbor_query->getPoints();
+    const unsigned int n_points = neighbor_query->getNPoints();
+    const float r_max_sq = r_max * r_max;
+    const float r_min_sq = r_min * r_min;
+
+    for (unsigned int j = 0; j < n_points; ++j)
+    {
+        if (exclude_ii && j == query_point_idx)
+        {
+            continue;
+        }
+        const vec3<float> r_ij(box.wrap(points[j] - query_point));
+        const float r_sq(dot(r_ij, r_ij));
+        if (r_sq < r_max_sq && r_sq >= r_min_sq)
+        {
+            // The wrapped delta is already in hand, so record it for computes
+            // to reuse.
+            m_bonds.emplace_back(query_point_idx, j, std::sqrt(r_sq), r_ij);
+        }
+    }
+
+    if (num_neighbors != DEFAULT_NUM_NEIGHBORS)
+    {
+        // Nearest query: keep the best k, reported in distance order like the
+        // tree and cell list iterators.
+        if (m_bonds.size() > num_neighbors)
+        {
+            std::partial_sort(m_bonds.begin(), m_bonds.begin() + num_neighbors, m_bonds.end());
+            m_bonds.resize(num_neighbors);
+        }
+        else
+        {
+            std::sort(m_bonds.begin(), m_bonds.end());
+        }
+    }
+}
+
+NeighborBond BruteForceIterator::next()
+{
+    while (m_cur_bond < m_bonds.size())
+    {
+        const NeighborBond& nb = m_bonds[m_cur_bond];
+        ++m_cur_bond;
+        if (allowsTypePair(nb.point_idx))
+        {
+            return nb;
+        }
+    }
+    m_finished = true;
+    return ITERATOR_TERMINATOR;
+}
+
+std::shared_ptr<NeighborQueryPerPointIterator>
+BruteForceQuery::querySingle(const vec3<float> query_point, unsigned int query_point_idx,
+                             QueryArgs args) const
+{
+    this->validateQueryArgs(args);
+    if (args.mode == QueryType::ball)
+    {
+        const float r_max = args.r_maxes != nullptr ? args.r_maxes[query_point_idx] : args.r_max;
+        auto iterator = std::make_shared<BruteForceIterator>(this, query_point, query_point_idx, r_max,
+                                                             args.r_min, args.exclude_ii,
+                                                             DEFAULT_NUM_NEIGHBORS);
+        iterator->setTypeFilter(args);
+        return iterator;
+    }
+    if (args.mode == QueryType::nearest)
+    {
+        return std::make_shared<BruteForceIterator>(this, query_point, query_point_idx, args.r_max,
+                                                    args.r_min, args.exclude_ii, args.num_neighbors);
+    }
+    throw std::runtime_error("Invalid query mode provided to query function in BruteForceQuery.");
+}
+
+/**************
+ * The planner *
+ **************/
+
+double QueryPlanner::estimateCost(QueryStrategy strategy, const box::Box& box, unsigned int n_points,
+                                  unsigned int n_query_points, const QueryArgs& args)
+{
+    const float r = effectiveRadius(box, n_points, args);
+    const double n_queries = std::max(n_query_points, 1U);
+
+    switch (strategy)
+    {
+    case QueryStrategy::brute_force:
+        // Every query point checks every point; nothing is built.
+        return cost_per_check[0] * double(n_points) * n_queries;
+    case QueryStrategy::cell_list:
+    {
+        // A ball query visits the 3^d cells of width r around the query
+        // point; nearest queries expand outward from the same footprint.
+        if (!cellListFits(box, r))
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        const double checks = candidatesInRegion(box, n_points, float(3.0) * r);
+        return CELL_BUILD_PER_POINT * double(n_points) + cost_per_check[1] * checks * n_queries;
+    }
+    case QueryStrategy::aabb_tree:
+    {
+        // The tree visits little more than the ball's bounding box; the
+        // descent to the overlapping leaves costs about one node per level.
+        const double checks = candidatesInRegion(box, n_points, float(2.0) * r)
+            + std::log2(double(std::max(n_points, 2U)));
+        return TREE_BUILD_PER_POINT * double(n_points) + cost_per_check[2] * checks * n_queries;
+    }
+    }
+    throw std::runtime_error("Invalid strategy provided to QueryPlanner.");
+}
+
+QueryStrategy QueryPlanner::chooseStrategy(const box::Box& box, unsigned int n_points,
+                                           unsigned int n_query_points, const QueryArgs& args)
+{
+    QueryStrategy best = QueryStrategy::brute_force;
+    double best_cost = estimateCost(best, box, n_points, n_query_points, args);
+    for (const auto candidate : {QueryStrategy::cell_list, QueryStrategy::aabb_tree})
+    {
+        const double cost = estimateCost(candidate, box, n_points, n_query_points, args);
+        if (cost < best_cost)
+        {
+            best = candidate;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+std::shared_ptr<NeighborQuery> QueryPlanner::plan(const box::Box& box, const vec3<float>* points,
+                                                  unsigned int n_points, unsigned int n_query_points,
+                                                  const QueryArgs& args)
+{
+    switch (chooseStrategy(box, n_points, n_query_points, args))
+    {
+    case QueryStrategy::brute_force:
+        return std::make_shared<BruteForceQuery>(box, points, n_points);
+    case QueryStrategy::cell_list:
+        // Ball queries bind the cell width to the cutoff; nearest queries
+        // leave it to LinkCell's density heuristic.
+        return std::make_shared<LinkCell>(box, points, n_points,
+                                          args.mode == QueryType::ball ? args.r_max : float(0.0));
+    case QueryStrategy::aabb_tree:
+        return std::make_shared<AABBQuery>(box, points, n_points);
+    }
+    throw std::runtime_error("Invalid strategy provided to QueryPlanner.");
+}
+
+void QueryPlanner::recordTiming(QueryStrategy strategy, double seconds, uint64_t candidates)
+{
+    if (candidates == 0 || seconds <= 0)
+    {
+        return;
+    }
+    const auto index = static_cast<size_t>(strategy);
+    const double measured = seconds / double(candidates);
+    if (has_measurement[index])
+    {
+        cost_per_check[index]
+            = (1.0 - MEASUREMENT_WEIGHT) * cost_per_check[index] + MEASUREMENT_WEIGHT * measured;
+    }
+    else
+    {
+        cost_per_check[index] = measured;
+        has_measurement[index] = true;
+    }
+}
+
+/*****************
+ * PlannedQuery *
+ *****************/
+
+std::shared_ptr<NeighborQueryIterator> PlannedQuery::query(const vec3<float>* query_points,
+                                                           unsigned int n_query_points,
+                                                           QueryArgs query_args) const
+{
+    this->validateQueryArgs(query_args);
+    const QueryStrategy strategy = QueryPlanner::chooseStrategy(m_box, m_n_points, n_query_points,
+                                                                query_args);
+    if (!m_impl || strategy != m_strategy)
+    {
+        m_impl = QueryPlanner::plan(m_box, m_points, m_n_points, n_query_points, query_args);
+        m_strategy = strategy;
+    }
+    return m_impl->query(query_points, n_query_points, query_args);
+}
+
+std::shared_ptr<NeighborQueryPerPointIterator>
+PlannedQuery::querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const
+{
+    if (!m_impl)
+    {
+        throw std::runtime_error("The underlying NeighborQuery object has not yet been planned. Please "
+                                 "report this error.");
+    }
+    return m_impl->querySingle(query_point, query_point_idx, args);
+}
+
+QueryStrategy PlannedQuery::getLastStrategy() const
+{
+    if (!m_impl)
+    {
+        throw std::runtime_error("No query has been planned yet.");
+    }
+    return m_strategy;
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,178 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef QUERY_PLANNER_H
+#define QUERY_PLANNER_H
+
+#include <memory>
+#include <vector>
+
+#include "Box.h"
+#include "NeighborQuery.h"
+
+/*! \file QueryPlanner.h
+    \brief Cost-model based selection of the neighbor finding strategy.
+
+    freud ships three ways to answer the same neighbor query -- an all-pairs
+    scan, a cell list, and an AABB tree -- and which one wins depends on the
+    number of points, the box volume, and the cutoff: brute force beats any
+    acceleration structure for small systems, the cell list degenerates when
+    the cutoff approaches the box size, and the tree tolerates density
+    heterogeneity the uniform grid does not. Leaving the choice to the caller
+    costs an order of magnitude when it is made badly, so the planner here
+    estimates the candidate work of each strategy from the system parameters
+    and constructs the cheapest one behind the ordinary NeighborQuery
+    interface.
+*/
+
+namespace freud { namespace locality {
+
+//! The neighbor finding strategies the planner chooses between.
+enum class QueryStrategy
+{
+    brute_force, //!< All-pairs scan with no acceleration structure.
+    cell_list,   //!< LinkCell uniform grid.
+    aabb_tree    //!< AABBQuery bounding volume hierarchy.
+};
+
+//! NeighborQuery implementation that scans every point for every query point.
+/*! No acceleration structure is built, so construction is free and each query
+ *  point costs one pass over all points. For small systems, or cutoffs so
+ *  large that most points are neighbors anyway, this beats building and
+ *  traversing a cell list or tree. Supports ball and nearest queries.
+ */
+class BruteForceQuery : public NeighborQuery
+{
+public:
+    BruteForceQuery() = default;
+
+    BruteForceQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points)
+        : NeighborQuery(box, points, n_points)
+    {}
+
+    ~BruteForceQuery() override = default;
+
+    //! Implementation of per-particle query (see NeighborQuery.h for documentation).
+    std::shared_ptr<NeighborQueryPerPointIterator>
+    querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const override;
+};
+
+//! Iterator scanning all points of a BruteForceQuery for one query point.
+/*! The scan runs eagerly in the constructor: every point is wrapped against
+ *  the query point and filtered by the cutoffs, and nearest queries keep the
+ *  best k by a partial sort. next() then drains the collected bonds.
+ */
+class BruteForceIterator : public NeighborQueryPerPointIterator
+{
+public:
+    //! Constructor; num_neighbors of DEFAULT_NUM_NEIGHBORS means a ball query.
+    BruteForceIterator(const BruteForceQuery* neighbor_query, const vec3<float>& query_point,
+                       unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                       unsigned int num_neighbors);
+
+    ~BruteForceIterator() override = default;
+
+    //! Get the next element.
+    NeighborBond next() override;
+
+private:
+    std::vector<NeighborBond> m_bonds; //!< All matching bonds, found at construction.
+    size_t m_cur_bond {0};             //!< The next bond to return.
+};
+
+//! Chooses the cheapest neighbor finding strategy for a query.
+/*! The model prices each strategy in candidate distance checks per query
+ *  point -- the quantity that dominates every strategy's runtime -- plus the
+ *  build cost of its acceleration structure amortized over the query points.
+ *  Candidate counts follow from the mean density: a ball query checks all N
+ *  points under brute force, the contents of the 3^d cells of width r_max
+ *  under the cell list, and little more than the ball itself under the tree.
+ *  The per-check cost of each strategy is a calibrated constant that
+ *  recordTiming can replace with measured values, so a caller that times its
+ *  queries (e.g. from the ComputeProfile counters) sharpens later plans.
+ */
+class QueryPlanner
+{
+public:
+    //! Choose the cheapest strategy for the given system and query.
+    /*! \param box Simulation box holding the points.
+     *  \param n_points Number of points to query against.
+     *  \param n_query_points Number of query points the build cost is
+     *         amortized over.
+     *  \param args Query arguments; the mode must already be resolved (pass
+     *         the arguments through validateQueryArgs first).
+     */
+    static QueryStrategy chooseStrategy(const box::Box& box, unsigned int n_points,
+                                        unsigned int n_query_points, const QueryArgs& args);
+
+    //! Construct the chosen strategy's NeighborQuery for the given system.
+    static std::shared_ptr<NeighborQuery> plan(const box::Box& box, const vec3<float>* points,
+                                               unsigned int n_points, unsigned int n_query_points,
+                                               const QueryArgs& args);
+
+    //! Refine the cost model with a measured timing.
+    /*! \param strategy The strategy that ran.
+     *  \param seconds Wall time of the query, excluding the structure build.
+     *  \param candidates Number of candidate checks (bonds examined) the
+     *         query performed, e.g. a ComputeProfile bond count.
+     *
+     *  The measurement replaces the calibrated per-check cost of the strategy
+     *  with an exponential moving average of the observed values. Like the
+     *  computes feeding it, the table is not thread-safe across concurrent
+     *  callers; freud computes run one at a time per process.
+     */
+    static void recordTiming(QueryStrategy strategy, double seconds, uint64_t candidates);
+
+    //! Estimated cost in seconds of running the query with one strategy.
+    /*! Exposed so callers can log or compare the model's predictions; the
+     *  returned values are only meaningful relative to each other.
+     */
+    static double estimateCost(QueryStrategy strategy, const box::Box& box, unsigned int n_points,
+                               unsigned int n_query_points, const QueryArgs& args);
+};
+
+//! NeighborQuery that plans its strategy on first query.
+/*! Stands in for a concrete NeighborQuery the same way RawPoints does, but
+ *  instead of always building an AABB tree it defers to the QueryPlanner once
+ *  the query arguments are known. The constructed structure is kept and
+ *  reused as long as subsequent queries plan to the same strategy; a query
+ *  planning differently rebuilds. The strategy chosen last can be read back
+ *  through getLastStrategy() for logging.
+ */
+class PlannedQuery : public NeighborQuery
+{
+public:
+    PlannedQuery() = default;
+
+    PlannedQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points)
+        : NeighborQuery(box, points, n_points)
+    {}
+
+    ~PlannedQuery() override = default;
+
+    //! Perform a query based on a set of query parameters.
+    /*! Shadows the parent function to plan and construct the underlying
+     *  strategy before iteration begins; like RawPoints::query it is the
+     *  serial entry point, so the structure is never rebuilt underneath the
+     *  per-point iterators created during parallel iteration.
+     */
+    std::shared_ptr<NeighborQueryIterator> query(const vec3<float>* query_points, unsigned int n_query_points,
+                                                 QueryArgs query_args) const override;
+
+    //! Implementation of per-particle query (see NeighborQuery.h for documentation).
+    std::shared_ptr<NeighborQueryPerPointIterator>
+    querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const override;
+
+    //! Get the strategy chosen by the most recent query.
+    /*! Throws if no query has been planned yet.
+     */
+    QueryStrategy getLastStrategy() const;
+
+private:
+    mutable std::shared_ptr<NeighborQuery> m_impl; //!< The strategy built by the last plan.
+    mutable QueryStrategy m_strategy {QueryStrategy::brute_force}; //!< Strategy of m_impl.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // QUERY_PLANNER_H
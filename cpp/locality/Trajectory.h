@@ -0,0 +1,278 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "AABBQuery.h"
+#include "ArrayFile.h"
+#include "Box.h"
+#include "ManagedArray.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+#include "async_dispatch.h"
+
+/*! \file Trajectory.h
+    \brief Native trajectory input: a memory-mapped binary frame container
+           and a prefetcher that overlaps frame ingest with computation.
+*/
+
+namespace freud { namespace locality {
+
+//! One fully ingested trajectory frame.
+/*! The position and type arrays are zero-copy views into the source's
+ *  backing storage (for file sources, the memory-mapped file), kept alive by
+ *  the arrays themselves; a frame remains valid after the source or
+ *  prefetcher that produced it is destroyed. The query member, when present,
+ *  is a NeighborQuery built over the frame's positions, ready to be handed
+ *  to any compute.
+ */
+struct TrajectoryFrame
+{
+    box::Box box;                            //!< The frame's simulation box.
+    util::ManagedArray<float> positions;     //!< Positions with shape {N, 3}.
+    util::ManagedArray<unsigned int> types;  //!< Per-point type ids; empty if the frame has none.
+    std::shared_ptr<NeighborQuery> query;    //!< Query over the positions, if one has been built.
+
+    //! The positions viewed as points.
+    const vec3<float>* points() const
+    {
+        return reinterpret_cast<const vec3<float>*>(positions.get());
+    }
+
+    //! Number of points in the frame.
+    unsigned int numPoints() const
+    {
+        return static_cast<unsigned int>(positions.shape()[0]);
+    }
+
+    //! Whether the frame carries per-point type ids.
+    bool hasTypes() const
+    {
+        return types.size() != 0;
+    }
+};
+
+//! Interface for anything that can produce trajectory frames by index.
+/*! Sources only decode; they do not build neighbor structures. That is left
+ *  to the caller or to FramePrefetcher, which overlaps the build with the
+ *  previous frame's computation. loadFrame must be safe to call from a
+ *  thread other than the one that constructed the source, one call at a
+ *  time.
+ */
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+
+    //! Number of frames this source can produce.
+    virtual unsigned int getNumFrames() const = 0;
+
+    //! Decode the given frame.
+    virtual TrajectoryFrame loadFrame(unsigned int frame) const = 0;
+};
+
+//! Write a trajectory as an array file with one block of sections per frame.
+/*! Frame i is stored as sections "pos<i>" (float, {N, 3}), "box<i>" (the
+ *  same 10-float box encoding the compute checkpoints use) and optionally
+ *  "type<i>" (uint32, {N}); a "nframes" section records the frame count.
+ *  Because section data is 64-byte aligned in the file, readers can map the
+ *  whole trajectory and ingest each frame without copying it.
+ */
+class TrajectoryWriter
+{
+public:
+    explicit TrajectoryWriter(const std::string& path) : m_writer(path) {}
+
+    //! Append one frame.
+    /*! The positions (and types, if given) are written directly from the
+     *  caller's buffers.
+     */
+    void appendFrame(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                     const unsigned int* types = nullptr)
+    {
+        const std::string index = std::to_string(m_n_frames);
+        m_writer.write("pos" + index,
+                       util::ManagedArray<float>::wrap(
+                           const_cast<float*>(reinterpret_cast<const float*>(points)),
+                           {n_points, 3}, std::shared_ptr<const void>()));
+
+        util::ManagedArray<float> box_state;
+        box_state.prepare(10);
+        box_state[0] = box.getLx();
+        box_state[1] = box.getLy();
+        box_state[2] = box.getLz();
+        box_state[3] = box.getTiltFactorXY();
+        box_state[4] = box.getTiltFactorXZ();
+        box_state[5] = box.getTiltFactorYZ();
+        box_state[6] = box.is2D() ? 1.0F : 0.0F;
+        box_state[7] = box.getPeriodicX() ? 1.0F : 0.0F;
+        box_state[8] = box.getPeriodicY() ? 1.0F : 0.0F;
+        box_state[9] = box.getPeriodicZ() ? 1.0F : 0.0F;
+        m_writer.write("box" + index, box_state);
+
+        if (types != nullptr)
+        {
+            m_writer.write("type" + index,
+                           util::ManagedArray<unsigned int>::wrap(const_cast<unsigned int*>(types),
+                                                                  {n_points},
+                                                                  std::shared_ptr<const void>()));
+        }
+        m_n_frames++;
+    }
+
+    //! Write the frame count and close the file.
+    void close()
+    {
+        util::ManagedArray<unsigned int> n_frames;
+        n_frames.prepare(1);
+        n_frames[0] = m_n_frames;
+        m_writer.write("nframes", n_frames);
+        m_writer.close();
+    }
+
+private:
+    util::ArrayFileWriter m_writer; //!< The underlying array file.
+    unsigned int m_n_frames {0};    //!< Number of frames appended so far.
+};
+
+//! Frame source backed by a memory-mapped trajectory file.
+/*! The file is mapped once on construction; loadFrame returns views into
+ *  the mapping, so ingest cost is independent of frame size and pages fault
+ *  in only as positions are actually read.
+ */
+class ArrayFileFrameSource : public FrameSource
+{
+public:
+    explicit ArrayFileFrameSource(const std::string& path) : m_reader(path)
+    {
+        if (!m_reader.contains("nframes"))
+        {
+            throw std::runtime_error(path + " is not a trajectory file.");
+        }
+        m_n_frames = m_reader.read<unsigned int>("nframes")[0];
+    }
+
+    unsigned int getNumFrames() const override
+    {
+        return m_n_frames;
+    }
+
+    TrajectoryFrame loadFrame(unsigned int frame) const override
+    {
+        if (frame >= m_n_frames)
+        {
+            throw std::out_of_range("Trajectory frame index is out of range.");
+        }
+        const std::string index = std::to_string(frame);
+
+        TrajectoryFrame result;
+        result.positions = m_reader.read<float>("pos" + index);
+        if (result.positions.shape().size() != 2 || result.positions.shape()[1] != 3)
+        {
+            throw std::runtime_error("Trajectory frame positions do not have shape {N, 3}.");
+        }
+
+        const auto box_state = m_reader.read<float>("box" + index);
+        if (box_state.size() != 10)
+        {
+            throw std::runtime_error("Trajectory frame has a corrupt box section.");
+        }
+        result.box = box::Box(box_state[0], box_state[1], box_state[2], box_state[3], box_state[4],
+                              box_state[5], box_state[6] != 0.0F);
+        result.box.setPeriodic(box_state[7] != 0.0F, box_state[8] != 0.0F, box_state[9] != 0.0F);
+
+        if (m_reader.contains("type" + index))
+        {
+            result.types = m_reader.read<unsigned int>("type" + index);
+            if (result.types.size() != result.numPoints())
+            {
+                throw std::runtime_error("Trajectory frame has one type id per point or none.");
+            }
+        }
+        return result;
+    }
+
+private:
+    util::ArrayFileReader m_reader; //!< The mapped trajectory file.
+    unsigned int m_n_frames {0};    //!< Number of frames in the file.
+};
+
+//! Double-buffered frame ingestion over any FrameSource.
+/*! While the caller computes on the frame returned by the last next() call,
+ *  the prefetcher decodes the following frame and builds its AABBQuery on
+ *  the compute arena. next() then only blocks on whatever ingest work has
+ *  not already been hidden behind the computation, the same pipelining that
+ *  accumulateGeneralFrames applies to in-memory frame batches. Exactly one
+ *  frame is staged ahead, so memory overhead is a single frame regardless of
+ *  trajectory length.
+ *
+ *  Like AsyncHandle, the prefetcher expects a single driving thread calling
+ *  next().
+ */
+class FramePrefetcher
+{
+public:
+    //! Start prefetching the source's first frame.
+    /*! The source must outlive the prefetcher.
+     */
+    explicit FramePrefetcher(const FrameSource& source) : m_source(source)
+    {
+        if (m_source.getNumFrames() > 0)
+        {
+            scheduleLoad(0);
+        }
+    }
+
+    //! Whether every frame has been consumed.
+    bool end() const
+    {
+        return m_consumed == m_source.getNumFrames();
+    }
+
+    //! Hand over the next frame, with its NeighborQuery built.
+    /*! Blocks until the staged frame's ingest finishes, then starts
+     *  prefetching the frame after it before returning.
+     */
+    TrajectoryFrame next()
+    {
+        if (end())
+        {
+            throw std::out_of_range("All trajectory frames have been consumed.");
+        }
+        m_async.wait();
+        TrajectoryFrame frame = std::move(m_staged);
+        m_consumed++;
+        if (!end())
+        {
+            scheduleLoad(m_consumed);
+        }
+        return frame;
+    }
+
+private:
+    //! Enqueue the decode and query build of one frame.
+    void scheduleLoad(unsigned int frame)
+    {
+        m_async.launch([this, frame]() {
+            TrajectoryFrame staged = m_source.loadFrame(frame);
+            // The query borrows the frame's position buffer, which the
+            // frame's own positions view keeps alive.
+            staged.query = std::make_shared<AABBQuery>(staged.box, staged.points(), staged.numPoints());
+            m_staged = std::move(staged);
+        });
+    }
+
+    const FrameSource& m_source;     //!< The source being iterated.
+    unsigned int m_consumed {0};     //!< Number of frames handed out so far.
+    TrajectoryFrame m_staged;        //!< The frame currently being ingested.
+    parallel::AsyncHandle m_async;   //!< Completion of the staged frame's ingest.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // TRAJECTORY_H
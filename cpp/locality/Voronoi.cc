@@ -3,7 +3,7 @@
 
 #include <cmath>
 #include <iterator>
-#include <tbb/parallel_sort.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <vector>
 
 #include "NeighborBond.h"
@@ -16,12 +16,22 @@
 namespace freud { namespace locality {
 
 // Voronoi calculations should be kept in double precision.
-void Voronoi::compute(const freud::locality::NeighborQuery* nq)
+void Voronoi::compute(const freud::locality::NeighborQuery* nq, bool compute_polytopes)
 {
     const auto box = nq->getBox();
     const auto n_points = nq->getNPoints();
 
-    m_polytopes.resize(n_points);
+    if (compute_polytopes)
+    {
+        m_polytopes.resize(n_points);
+    }
+    else
+    {
+        // Release any polytopes from a previous compute so stale vertices are
+        // never served alongside this compute's NeighborList.
+        m_polytopes.clear();
+        m_polytopes.shrink_to_fit();
+    }
     m_volumes.prepare(n_points);
 
     const vec3<float> v1 = box.getLatticeVector(0);
@@ -48,76 +58,122 @@ void Voronoi::compute(const freud::locality::NeighborQuery* nq)
         container.put(query_point_id, query_point.x, query_point.y, query_point.z);
     }
 
-    voro::voronoicell_neighbor cell;
-    voro::c_loop_all_periodic voronoi_loop(container);
-    std::vector<double> face_areas;
-    std::vector<int> face_vertices;
-    std::vector<int> neighbors;
-    std::vector<double> normals;
-    std::vector<double> vertices;
-    std::vector<NeighborBond> bonds;
+    // Collect the block location of every particle with one serial sweep of
+    // the container so that the cells themselves can be computed in parallel
+    // afterwards. Only the loop bookkeeping runs serially here; no cells are
+    // computed.
+    struct CellLocation
+    {
+        int ijk, q, i, j, k;
+        int pid;
+        double x, y, z;
+    };
+    std::vector<CellLocation> locations;
+    locations.reserve(n_points);
 
+    voro::c_loop_all_periodic voronoi_loop(container);
     if (voronoi_loop.start())
     {
         do
         {
-            container.compute_cell(cell, voronoi_loop);
+            CellLocation loc;
+            loc.ijk = voronoi_loop.ijk;
+            loc.q = voronoi_loop.q;
+            loc.i = voronoi_loop.i;
+            loc.j = voronoi_loop.j;
+            loc.k = voronoi_loop.k;
+            loc.pid = voronoi_loop.pid();
+            voronoi_loop.pos(loc.x, loc.y, loc.z);
+            locations.push_back(loc);
+        } while (voronoi_loop.inc());
+    }
+
+    // Compute the cells in parallel. The container is read-only from here on,
+    // and each worker uses its own voro_compute scratch space (the shared
+    // compute_cell entry point on the container is not thread-safe), so the
+    // per-particle work distributes cleanly over TBB workers. Bonds
+    // accumulate in thread-local buffers that are merged and sorted at the
+    // end; polytopes and volumes are written to disjoint per-particle slots.
+    using BondVector = tbb::enumerable_thread_specific<std::vector<NeighborBond>>;
+    BondVector bond_vectors;
+    util::forLoopWrapper(0, locations.size(), [&](size_t begin, size_t end) {
+        voro::voro_compute<voro::container_periodic> vc(container, 2 * container.nx + 1,
+                                                        2 * container.ey + 1, 2 * container.ez + 1);
+        voro::voronoicell_neighbor cell;
+        std::vector<double> face_areas;
+        std::vector<int> face_vertices;
+        std::vector<int> neighbors;
+        std::vector<double> normals;
+        std::vector<double> vertices;
+        BondVector::reference bonds(bond_vectors.local());
+
+        for (size_t location_index = begin; location_index != end; ++location_index)
+        {
+            const CellLocation& loc = locations[location_index];
+            if (!vc.compute_cell(cell, loc.ijk, loc.q, loc.i, loc.j, loc.k))
+            {
+                continue;
+            }
 
             // Get id and position of current particle
-            const int query_point_id(voronoi_loop.pid());
-            vec3<double> query_point(voronoi_loop.x(), voronoi_loop.y(), voronoi_loop.z());
+            const int query_point_id(loc.pid);
+            vec3<double> query_point(loc.x, loc.y, loc.z);
 
             // Get Voronoi cell properties
             cell.face_areas(face_areas);
-            cell.face_vertices(face_vertices);
             cell.neighbors(neighbors);
             cell.normals(normals);
-            cell.vertices(query_point.x, query_point.y, query_point.z, vertices);
 
-            // Compute polytope vertices in relative coordinates
-            std::vector<vec3<double>> relative_vertices;
-            auto vertex_iterator = vertices.begin();
-            while (vertex_iterator != vertices.end())
+            const vec3<double>& query_point_system_coords((*nq)[query_point_id]);
+
+            if (compute_polytopes)
             {
-                double vert_x = *vertex_iterator;
-                vertex_iterator++;
-                double vert_y = *vertex_iterator;
-                vertex_iterator++;
-                double vert_z = *vertex_iterator;
-                vertex_iterator++;
-
-                // In 2D systems, only use vertices from the upper plane
-                // to prevent double-counting, and set z=0 manually
-                if (box.is2D())
+                cell.face_vertices(face_vertices);
+                cell.vertices(query_point.x, query_point.y, query_point.z, vertices);
+
+                // Compute polytope vertices in relative coordinates
+                std::vector<vec3<double>> relative_vertices;
+                auto vertex_iterator = vertices.begin();
+                while (vertex_iterator != vertices.end())
                 {
-                    if (vert_z < 0)
+                    double vert_x = *vertex_iterator;
+                    vertex_iterator++;
+                    double vert_y = *vertex_iterator;
+                    vertex_iterator++;
+                    double vert_z = *vertex_iterator;
+                    vertex_iterator++;
+
+                    // In 2D systems, only use vertices from the upper plane
+                    // to prevent double-counting, and set z=0 manually
+                    if (box.is2D())
                     {
-                        continue;
+                        if (vert_z < 0)
+                        {
+                            continue;
+                        }
+                        vert_z = 0;
                     }
-                    vert_z = 0;
+                    vec3<double> delta = vec3<double>(vert_x, vert_y, vert_z) - query_point;
+                    relative_vertices.push_back(delta);
                 }
-                vec3<double> delta = vec3<double>(vert_x, vert_y, vert_z) - query_point;
-                relative_vertices.push_back(delta);
-            }
-
-            // Sort relative vertices by their angle in 2D systems
-            if (box.is2D())
-            {
-                std::sort(relative_vertices.begin(), relative_vertices.end(),
-                          [](const vec3<double>& a, const vec3<double>& b) {
-                              return std::atan2(a.y, a.x) < std::atan2(b.y, b.x);
-                          });
-            }
 
-            // Save polytope vertices in system coordinates
-            const vec3<double>& query_point_system_coords((*nq)[query_point_id]);
+                // Sort relative vertices by their angle in 2D systems
+                if (box.is2D())
+                {
+                    std::sort(relative_vertices.begin(), relative_vertices.end(),
+                              [](const vec3<double>& a, const vec3<double>& b) {
+                                  return std::atan2(a.y, a.x) < std::atan2(b.y, b.x);
+                              });
+                }
 
-            std::vector<vec3<double>> system_vertices;
-            system_vertices.reserve(relative_vertices.size());
-            std::transform(
-                relative_vertices.begin(), relative_vertices.end(), std::back_inserter(system_vertices),
-                [&](const auto& relative_vertex) { return relative_vertex + query_point_system_coords; });
-            m_polytopes[query_point_id] = system_vertices;
+                // Save polytope vertices in system coordinates
+                std::vector<vec3<double>> system_vertices;
+                system_vertices.reserve(relative_vertices.size());
+                std::transform(
+                    relative_vertices.begin(), relative_vertices.end(), std::back_inserter(system_vertices),
+                    [&](const auto& relative_vertex) { return relative_vertex + query_point_system_coords; });
+                m_polytopes[query_point_id] = system_vertices;
+            }
 
             // Save cell volume
             m_volumes[query_point_id] = cell.volume();
@@ -156,13 +212,16 @@ void Voronoi::compute(const freud::locality::NeighborQuery* nq)
 
                 bonds.emplace_back(query_point_id, point_id, distance, weight);
             }
+        }
+    });
 
-        } while (voronoi_loop.inc());
-    }
+    tbb::flattened2d<BondVector> flat_bonds = tbb::flatten2d(bond_vectors);
+    std::vector<NeighborBond> bonds(flat_bonds.begin(), flat_bonds.end());
 
-    tbb::parallel_sort(bonds.begin(), bonds.end(), [](const NeighborBond& n1, const NeighborBond& n2) {
-        return n1.less_id_ref_weight(n2);
-    });
+    // sortNeighborBonds orders by (query_point_idx, point_idx) with
+    // compareNeighborBond breaking ties, which refines the previous
+    // less_id_ref_weight ordering.
+    sortNeighborBonds(bonds);
 
     unsigned int num_bonds = bonds.size();
 
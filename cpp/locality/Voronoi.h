@@ -19,13 +19,23 @@ public:
     // default constructor
     Voronoi() : m_neighbor_list(std::make_shared<NeighborList>()) {}
 
-    void compute(const freud::locality::NeighborQuery* nq);
+    //! Compute the Voronoi diagram.
+    /*! \param nq NeighborQuery object holding the points and box.
+     *  \param compute_polytopes If false, skip vertex extraction entirely and
+     *         emit only face neighbors, face areas, and cell volumes. For
+     *         consumers that only need the weighted NeighborList (e.g.
+     *         Voronoi-based order parameters), this avoids storing a vector
+     *         of vertices per cell, which dominates memory and allocator time
+     *         on large systems.
+     */
+    void compute(const freud::locality::NeighborQuery* nq, bool compute_polytopes = true);
 
     std::shared_ptr<NeighborList> getNeighborList() const
     {
         return m_neighbor_list;
     }
 
+    //! Get the polytope vertices per cell (empty when computed with compute_polytopes = false).
     std::vector<std::vector<vec3<double>>> getPolytopes() const
     {
         return m_polytopes;
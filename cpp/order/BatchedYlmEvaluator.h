@@ -0,0 +1,319 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BATCHED_YLM_EVALUATOR_H
+#define BATCHED_YLM_EVALUATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+/*! \file BatchedYlmEvaluator.h
+    \brief Defines the batched spherical harmonics evaluator shared by the
+    order parameter and descriptor computations.
+*/
+
+namespace freud { namespace order {
+
+//! Ylm values or sums per requested l.
+using YlmsType = std::vector<std::vector<std::complex<float>>>;
+
+//! Number of bonds evaluated together by BatchedYlmEvaluator.
+constexpr size_t YLM_BATCH_SIZE = 8;
+
+//! Batched spherical harmonics evaluator for blocks of bond angles.
+/*! Evaluates Y_lm for every requested l over up to YLM_BATCH_SIZE (theta,
+ *  phi) pairs at a time using the standard upward recurrence for the
+ *  normalized associated Legendre functions. The recurrence coefficients
+ *  depend only on (l, m) and are precomputed on construction, each upward
+ *  pass in l serves every requested l at once, and the per-bond arithmetic
+ *  runs across SIMD lanes, so the recurrence work is amortized over both the
+ *  bonds of a block and the requested l values.
+ *
+ *  The output convention matches the per-bond fsph evaluation this replaces:
+ *  for each l the values are Y_lm for m = 0, 1, ..., l including the
+ *  Condon-Shortley phase, followed by Y_l,-1, ..., Y_l,-l.
+ */
+class BatchedYlmEvaluator
+{
+public:
+    explicit BatchedYlmEvaluator(const std::vector<unsigned int>& ls)
+        : m_max_l(*std::max_element(ls.begin(), ls.end())), m_l_index(m_max_l + 1, -1),
+          m_diagonal(m_max_l + 1), m_off_diagonal(m_max_l + 1),
+          m_alm((size_t(m_max_l) + 1) * (m_max_l + 2) / 2), m_blm(m_alm.size())
+    {
+        for (size_t l_index = 0; l_index < ls.size(); ++l_index)
+        {
+            m_l_index[ls[l_index]] = int(l_index);
+        }
+        for (unsigned int m = 1; m <= m_max_l; ++m)
+        {
+            // P_mm = -sqrt(1 + 1 / (2m)) * sin(theta) * P_(m-1)(m-1), where
+            // the minus sign supplies the Condon-Shortley phase.
+            m_diagonal[m] = -float(std::sqrt(1.0 + 0.5 / m));
+        }
+        for (unsigned int m = 0; m <= m_max_l; ++m)
+        {
+            // P_(m+1)m = sqrt(2m + 3) * cos(theta) * P_mm.
+            m_off_diagonal[m] = float(std::sqrt(2.0 * m + 3.0));
+        }
+        for (unsigned int l = 2; l <= m_max_l; ++l)
+        {
+            // P_lm = a_lm * cos(theta) * P_(l-1)m - b_lm * P_(l-2)m.
+            const double l2 = double(l) * l;
+            for (unsigned int m = 0; m + 2 <= l; ++m)
+            {
+                const double m2 = double(m) * m;
+                m_alm[coefficientIndex(l, m)] = float(std::sqrt((4.0 * l2 - 1.0) / (l2 - m2)));
+                m_blm[coefficientIndex(l, m)] = float(std::sqrt(
+                    (2.0 * l + 1.0) * (double(l - 1) * (l - 1) - m2) / ((l2 - m2) * (2.0 * l - 3.0))));
+            }
+        }
+    }
+
+    //! Accumulate the weighted spherical harmonics of a block of bonds.
+    /*! Adds sum_b weights[b] * Y_lm(thetas[b], phis[b]) over the count bonds
+     *  of the block into Ylm_sums, which is laid out per l like the Ylms of
+     *  the per-bond evaluation.
+     */
+    void accumulate(const float* thetas, const float* phis, const float* weights, size_t count,
+                    YlmsType& Ylm_sums) const
+    {
+#if defined(__AVX__)
+        if (count == YLM_BATCH_SIZE)
+        {
+            const __m256 w = _mm256_loadu_ps(weights);
+            computeBlock(thetas, phis,
+                         [&](int l_index, unsigned int /*l*/, unsigned int k, __m256 re, __m256 im) {
+                             Ylm_sums[l_index][k]
+                                 += std::complex<float>(horizontalSum(_mm256_mul_ps(w, re)),
+                                                        horizontalSum(_mm256_mul_ps(w, im)));
+                         });
+            return;
+        }
+#endif
+        for (size_t b = 0; b < count; ++b)
+        {
+            const float w = weights[b];
+            computeBond(thetas[b], phis[b],
+                        [&](int l_index, unsigned int /*l*/, unsigned int k, float re, float im) {
+                            Ylm_sums[l_index][k] += std::complex<float>(w * re, w * im);
+                        });
+        }
+    }
+
+    //! Evaluate the spherical harmonics of each bond of a block individually.
+    /*! Writes Y_lm of the block's bond b into Ylms[l_index][b * (2l + 1) + k]
+     *  for the count bonds; Ylms must already be sized for a full block.
+     */
+    void evaluate(const float* thetas, const float* phis, size_t count, YlmsType& Ylms) const
+    {
+        evaluateEach(thetas, phis, count,
+                     [&](size_t b, int l_index, unsigned int l, unsigned int k, float re, float im) {
+                         Ylms[l_index][b * (2 * size_t(l) + 1) + k] = std::complex<float>(re, im);
+                     });
+    }
+
+    //! Evaluate a block of bonds, handing every Y_lm value to a sink.
+    /*! The sink is called as sink(b, l_index, l, k, re, im) for every bond b
+     *  of the block, every requested l, and every index k of the per-l output
+     *  layout, letting callers scatter the values into their own storage.
+     */
+    template<typename PerBondSink>
+    void evaluateEach(const float* thetas, const float* phis, size_t count, const PerBondSink& sink) const
+    {
+#if defined(__AVX__)
+        if (count == YLM_BATCH_SIZE)
+        {
+            alignas(32) float res[YLM_BATCH_SIZE];
+            alignas(32) float ims[YLM_BATCH_SIZE];
+            computeBlock(thetas, phis,
+                         [&](int l_index, unsigned int l, unsigned int k, __m256 re, __m256 im) {
+                             _mm256_store_ps(res, re);
+                             _mm256_store_ps(ims, im);
+                             for (size_t b = 0; b < YLM_BATCH_SIZE; ++b)
+                             {
+                                 sink(b, l_index, l, k, res[b], ims[b]);
+                             }
+                         });
+            return;
+        }
+#endif
+        for (size_t b = 0; b < count; ++b)
+        {
+            computeBond(thetas[b], phis[b],
+                        [&](int l_index, unsigned int l, unsigned int k, float re, float im) {
+                            sink(b, l_index, l, k, re, im);
+                        });
+        }
+    }
+
+private:
+    //! The normalized Legendre function P_00, which is also Y_00: sqrt(1 / (4 pi)).
+    static constexpr float NORMALIZED_P00 = 0.28209479177387814F;
+
+#if defined(__AVX__)
+    //! Sum the eight lanes of an AVX register.
+    static inline float horizontalSum(__m256 v)
+    {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+        return _mm_cvtss_f32(sum);
+    }
+#endif
+
+    //! Index of the (l, m) recurrence coefficients in the triangular tables.
+    static size_t coefficientIndex(unsigned int l, unsigned int m)
+    {
+        return size_t(l) * (l + 1) / 2 + m;
+    }
+
+    //! Scalar recurrence over one bond, handing each Y_lm to the sink.
+    /*! The sink is called as sink(l_index, l, k, re, im) for every requested
+     *  l and every index k of the output layout.
+     */
+    template<typename Sink> void computeBond(float theta, float phi, const Sink& sink) const
+    {
+        const float x = std::cos(theta);
+        const float s = std::sin(theta);
+        const float cos_phi = std::cos(phi);
+        const float sin_phi = std::sin(phi);
+        float cos_m_phi = 1; // cos(m * phi)
+        float sin_m_phi = 0; // sin(m * phi)
+        float p_mm = NORMALIZED_P00;
+        float negative_m_sign = 1; // (-1)^m, relating Y_l,-m to conj(Y_lm)
+        for (unsigned int m = 0; m <= m_max_l; ++m)
+        {
+            if (m > 0)
+            {
+                p_mm *= m_diagonal[m] * s;
+                const float next_cos = cos_m_phi * cos_phi - sin_m_phi * sin_phi;
+                sin_m_phi = sin_m_phi * cos_phi + cos_m_phi * sin_phi;
+                cos_m_phi = next_cos;
+                negative_m_sign = -negative_m_sign;
+            }
+            const auto emit = [&](unsigned int l, float p) {
+                const int l_index = m_l_index[l];
+                if (l_index < 0)
+                {
+                    return;
+                }
+                sink(l_index, l, m, p * cos_m_phi, p * sin_m_phi);
+                if (m > 0)
+                {
+                    sink(l_index, l, l + m, negative_m_sign * p * cos_m_phi,
+                         -negative_m_sign * p * sin_m_phi);
+                }
+            };
+            float p_previous = p_mm;
+            emit(m, p_previous);
+            if (m == m_max_l)
+            {
+                break;
+            }
+            float p_current = m_off_diagonal[m] * x * p_mm;
+            emit(m + 1, p_current);
+            for (unsigned int l = m + 2; l <= m_max_l; ++l)
+            {
+                const size_t c = coefficientIndex(l, m);
+                const float p_next = m_alm[c] * x * p_current - m_blm[c] * p_previous;
+                p_previous = p_current;
+                p_current = p_next;
+                emit(l, p_current);
+            }
+        }
+    }
+
+#if defined(__AVX__)
+    //! SIMD recurrence over a full block, one bond per lane.
+    /*! The sink is called as sink(l_index, l, k, re, im) with one bond per
+     *  lane of re and im, in the same order as computeBond.
+     */
+    template<typename Sink>
+    void computeBlock(const float* thetas, const float* phis, const Sink& sink) const
+    {
+        alignas(32) float cos_thetas[YLM_BATCH_SIZE];
+        alignas(32) float sin_thetas[YLM_BATCH_SIZE];
+        alignas(32) float cos_phis[YLM_BATCH_SIZE];
+        alignas(32) float sin_phis[YLM_BATCH_SIZE];
+        for (size_t b = 0; b < YLM_BATCH_SIZE; ++b)
+        {
+            cos_thetas[b] = std::cos(thetas[b]);
+            sin_thetas[b] = std::sin(thetas[b]);
+            cos_phis[b] = std::cos(phis[b]);
+            sin_phis[b] = std::sin(phis[b]);
+        }
+        const __m256 x = _mm256_load_ps(cos_thetas);
+        const __m256 s = _mm256_load_ps(sin_thetas);
+        const __m256 cos_phi = _mm256_load_ps(cos_phis);
+        const __m256 sin_phi = _mm256_load_ps(sin_phis);
+        __m256 cos_m_phi = _mm256_set1_ps(1.0F);
+        __m256 sin_m_phi = _mm256_setzero_ps();
+        __m256 p_mm = _mm256_set1_ps(NORMALIZED_P00);
+        float negative_m_sign = 1; // (-1)^m, relating Y_l,-m to conj(Y_lm)
+        for (unsigned int m = 0; m <= m_max_l; ++m)
+        {
+            if (m > 0)
+            {
+                p_mm = _mm256_mul_ps(p_mm, _mm256_mul_ps(_mm256_set1_ps(m_diagonal[m]), s));
+                const __m256 next_cos = _mm256_sub_ps(_mm256_mul_ps(cos_m_phi, cos_phi),
+                                                      _mm256_mul_ps(sin_m_phi, sin_phi));
+                sin_m_phi = _mm256_add_ps(_mm256_mul_ps(sin_m_phi, cos_phi),
+                                          _mm256_mul_ps(cos_m_phi, sin_phi));
+                cos_m_phi = next_cos;
+                negative_m_sign = -negative_m_sign;
+            }
+            const auto emit = [&](unsigned int l, __m256 p) {
+                const int l_index = m_l_index[l];
+                if (l_index < 0)
+                {
+                    return;
+                }
+                const __m256 re = _mm256_mul_ps(p, cos_m_phi);
+                const __m256 im = _mm256_mul_ps(p, sin_m_phi);
+                sink(l_index, l, m, re, im);
+                if (m > 0)
+                {
+                    sink(l_index, l, l + m, _mm256_mul_ps(_mm256_set1_ps(negative_m_sign), re),
+                         _mm256_mul_ps(_mm256_set1_ps(-negative_m_sign), im));
+                }
+            };
+            __m256 p_previous = p_mm;
+            emit(m, p_previous);
+            if (m == m_max_l)
+            {
+                break;
+            }
+            __m256 p_current = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(m_off_diagonal[m]), x), p_mm);
+            emit(m + 1, p_current);
+            for (unsigned int l = m + 2; l <= m_max_l; ++l)
+            {
+                const size_t c = coefficientIndex(l, m);
+                const __m256 p_next
+                    = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(m_alm[c]), _mm256_mul_ps(x, p_current)),
+                                    _mm256_mul_ps(_mm256_set1_ps(m_blm[c]), p_previous));
+                p_previous = p_current;
+                p_current = p_next;
+                emit(l, p_current);
+            }
+        }
+    }
+#endif
+
+    unsigned int m_max_l;              //!< Largest requested l
+    std::vector<int> m_l_index;        //!< Map from l to its index among the requested ls (-1 if absent)
+    std::vector<float> m_diagonal;     //!< Diagonal recurrence factors, P_mm from P_(m-1)(m-1)
+    std::vector<float> m_off_diagonal; //!< First off-diagonal factors, P_(m+1)m from P_mm
+    std::vector<float> m_alm;          //!< General term coefficients a_lm
+    std::vector<float> m_blm;          //!< General term coefficients b_lm
+};
+
+}; }; // end namespace freud::order
+
+#endif // BATCHED_YLM_EVALUATOR_H
@@ -8,28 +8,53 @@
 #include "Cubatic.h"
 #include "utils.h"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 /*! \file Cubatic.h
     \brief Compute the cubatic order parameter for each particle.
 */
 
+namespace {
+
+#if defined(__AVX__)
+//! Sum the 8 lanes of an AVX register.
+inline float horizontalSum(__m256 v)
+{
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+    return _mm_cvtss_f32(lo);
+}
+#endif
+
+} // namespace
+
 namespace freud { namespace order {
 
 tensor4::tensor4(const vec3<float>& vector)
 {
+    // The tensor is the outer product of v (x) v with itself: element
+    // (i, j, k, l) is (v_i v_j)(v_k v_l). Building the 9 pair products first
+    // evaluates each element with two multiplies instead of three and leaves
+    // a dependence-free loop for the vectorizer.
+    std::array<float, 9> pair_products;
     unsigned int cnt = 0;
     std::array<float, 3> v = {vector.x, vector.y, vector.z};
     for (float vi : v)
     {
         for (float vj : v)
         {
-            for (float vk : v)
-            {
-                for (float vl : v)
-                {
-                    data[cnt] = vi * vj * vk * vl;
-                    cnt++;
-                }
-            }
+            pair_products[cnt] = vi * vj;
+            cnt++;
+        }
+    }
+    for (unsigned int i = 0; i < 9; i++)
+    {
+        for (unsigned int j = 0; j < 9; j++)
+        {
+            data[9 * i + j] = pair_products[i] * pair_products[j];
         }
     }
 }
@@ -82,12 +107,22 @@ void tensor4::copyToManagedArray(util::ManagedArray<float>& ma)
  */
 float dot(const tensor4& a, const tensor4& b)
 {
+#if defined(__AVX__)
+    __m256 acc = _mm256_setzero_ps();
+    for (unsigned int i = 0; i < 80; i += 8)
+    {
+        acc = _mm256_add_ps(acc,
+                            _mm256_mul_ps(_mm256_loadu_ps(&a.data[i]), _mm256_loadu_ps(&b.data[i])));
+    }
+    return horizontalSum(acc) + a.data[80] * b.data[80];
+#else
     float c = 0;
     for (unsigned int i = 0; i < 81; i++)
     {
         c += a.data[i] * b.data[i];
     }
     return c;
+#endif
 }
 
 //! Generate the r4 tensor.
@@ -168,8 +203,33 @@ tensor4 Cubatic::calcCubaticTensor(quat<float>& orientation)
 
 float Cubatic::calcCubaticOrderParameter(const tensor4& cubatic_tensor, const tensor4& global_tensor)
 {
-    tensor4 diff = global_tensor - cubatic_tensor;
-    return float(1.0) - dot(diff, diff) / dot(cubatic_tensor, cubatic_tensor);
+    // Both contractions of eq. 22 are reduced in a single pass over the 81
+    // elements, without materializing the difference tensor. This is the
+    // innermost operation of every annealing step.
+#if defined(__AVX__)
+    __m256 diff_acc = _mm256_setzero_ps();
+    __m256 self_acc = _mm256_setzero_ps();
+    for (unsigned int i = 0; i < 80; i += 8)
+    {
+        const __m256 c = _mm256_loadu_ps(&cubatic_tensor.data[i]);
+        const __m256 d = _mm256_sub_ps(_mm256_loadu_ps(&global_tensor.data[i]), c);
+        diff_acc = _mm256_add_ps(diff_acc, _mm256_mul_ps(d, d));
+        self_acc = _mm256_add_ps(self_acc, _mm256_mul_ps(c, c));
+    }
+    const float d_tail = global_tensor.data[80] - cubatic_tensor.data[80];
+    const float diff_sq = horizontalSum(diff_acc) + d_tail * d_tail;
+    const float self_sq = horizontalSum(self_acc) + cubatic_tensor.data[80] * cubatic_tensor.data[80];
+#else
+    float diff_sq = 0;
+    float self_sq = 0;
+    for (unsigned int i = 0; i < 81; i++)
+    {
+        const float d = global_tensor.data[i] - cubatic_tensor.data[i];
+        diff_sq += d * d;
+        self_sq += cubatic_tensor.data[i] * cubatic_tensor.data[i];
+    }
+#endif
+    return float(1.0) - diff_sq / self_sq;
 }
 
 template<typename T> quat<float> Cubatic::calcRandomQuaternion(T& dist, float angle_multiplier) const
@@ -3,6 +3,101 @@
 
 #include "HexaticTranslational.h"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+//! Number of bonds staged per call to the block evaluators.
+constexpr size_t BOND_BLOCK_SIZE = 8;
+
+#if defined(__AVX__)
+//! Sum the 8 lanes of an AVX register.
+inline float horizontalSum(__m256 v)
+{
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+    return _mm_cvtss_f32(lo);
+}
+#endif
+
+//! Accumulate weight * exp(i k theta(x, y)) over a block of bond vectors.
+/*! Rather than evaluating atan2 followed by sincos per bond, the vectorized
+ *  path forms the unit complex number (x + iy) / |(x, y)| and raises it to the
+ *  integer power k by repeated squaring, which equals exp(i k atan2(y, x))
+ *  without any transcendental function calls.
+ */
+inline void accumulateHexatic(unsigned int k, const float* xs, const float* ys, const float* weights,
+                              size_t count, std::complex<float>& psi)
+{
+#if defined(__AVX__)
+    if (count == BOND_BLOCK_SIZE)
+    {
+        const __m256 x = _mm256_loadu_ps(xs);
+        const __m256 y = _mm256_loadu_ps(ys);
+        const __m256 r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+        // One Newton-Raphson step refines rsqrt to nearly full float precision.
+        __m256 inv_r = _mm256_rsqrt_ps(r2);
+        inv_r = _mm256_mul_ps(
+            _mm256_mul_ps(_mm256_set1_ps(0.5F), inv_r),
+            _mm256_sub_ps(_mm256_set1_ps(3.0F), _mm256_mul_ps(r2, _mm256_mul_ps(inv_r, inv_r))));
+        // Zero-length bonds take theta = 0, matching atan2(0, 0).
+        const __m256 nonzero = _mm256_cmp_ps(r2, _mm256_setzero_ps(), _CMP_GT_OQ);
+        __m256 base_re = _mm256_blendv_ps(_mm256_set1_ps(1.0F), _mm256_mul_ps(x, inv_r), nonzero);
+        __m256 base_im = _mm256_blendv_ps(_mm256_setzero_ps(), _mm256_mul_ps(y, inv_r), nonzero);
+        __m256 res_re = _mm256_set1_ps(1.0F);
+        __m256 res_im = _mm256_setzero_ps();
+        for (unsigned int e = k; e != 0; e >>= 1U)
+        {
+            if ((e & 1U) != 0)
+            {
+                const __m256 tmp
+                    = _mm256_sub_ps(_mm256_mul_ps(res_re, base_re), _mm256_mul_ps(res_im, base_im));
+                res_im = _mm256_add_ps(_mm256_mul_ps(res_re, base_im), _mm256_mul_ps(res_im, base_re));
+                res_re = tmp;
+            }
+            if (e > 1)
+            {
+                const __m256 tmp
+                    = _mm256_sub_ps(_mm256_mul_ps(base_re, base_re), _mm256_mul_ps(base_im, base_im));
+                base_im = _mm256_mul_ps(_mm256_set1_ps(2.0F), _mm256_mul_ps(base_re, base_im));
+                base_re = tmp;
+            }
+        }
+        const __m256 w = _mm256_loadu_ps(weights);
+        psi += std::complex<float>(horizontalSum(_mm256_mul_ps(w, res_re)),
+                                   horizontalSum(_mm256_mul_ps(w, res_im)));
+        return;
+    }
+#endif
+    for (size_t b = 0; b < count; ++b)
+    {
+        const float theta_ij = std::atan2(ys[b], xs[b]);
+        psi += weights[b] * std::exp(std::complex<float>(0, static_cast<float>(k) * theta_ij));
+    }
+}
+
+//! Accumulate weight * (x + iy) over a block of bond vectors.
+/*! The loop carries no dependencies between lanes, so the compiler
+ *  vectorizes it directly; no intrinsics are needed here.
+ */
+inline void accumulateTranslational(const float* xs, const float* ys, const float* weights, size_t count,
+                                    std::complex<float>& psi)
+{
+    float sum_re = 0;
+    float sum_im = 0;
+    for (size_t b = 0; b < count; ++b)
+    {
+        sum_re += weights[b] * xs[b];
+        sum_im += weights[b] * ys[b];
+    }
+    psi += std::complex<float>(sum_re, sum_im);
+}
+
+} // namespace
+
 namespace freud { namespace order {
 
 //! Compute the order parameter
@@ -25,15 +120,31 @@ void HexaticTranslational<T>::computeGeneral(Func func, const freud::locality::N
             float total_weight(0);
             const vec3<float> ref((*points)[i]);
 
+            // Stage bonds in blocks so func can evaluate full SIMD widths.
+            float xs[BOND_BLOCK_SIZE];
+            float ys[BOND_BLOCK_SIZE];
+            float weights[BOND_BLOCK_SIZE];
+            size_t staged = 0;
+
             for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
             {
                 // Compute vector from query_point to point
                 const vec3<float> delta = box.wrap((*points)[nb.point_idx] - ref);
                 const float weight(m_weighted ? nb.weight : 1.0);
 
-                // Compute psi for this vector
-                m_psi_array[i] += weight * func(delta);
+                xs[staged] = delta.x;
+                ys[staged] = delta.y;
+                weights[staged] = weight;
                 total_weight += weight;
+                if (++staged == BOND_BLOCK_SIZE)
+                {
+                    func(xs, ys, weights, staged, m_psi_array[i]);
+                    staged = 0;
+                }
+            }
+            if (staged != 0)
+            {
+                func(xs, ys, weights, staged, m_psi_array[i]);
             }
             if (normalize_by_k)
             {
@@ -51,11 +162,10 @@ Hexatic::Hexatic(unsigned int k, bool weighted) : HexaticTranslational<unsigned
 void Hexatic::compute(const freud::locality::NeighborList* nlist,
                       const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
 {
+    const unsigned int k = m_k;
     computeGeneral(
-        [this](const vec3<float>& delta) {
-            const float theta_ij = std::atan2(delta.y, delta.x);
-            return std::exp(std::complex<float>(0, static_cast<float>(m_k) * theta_ij));
-        },
+        [k](const float* xs, const float* ys, const float* weights, size_t count,
+            std::complex<float>& psi) { accumulateHexatic(k, xs, ys, weights, count, psi); },
         nlist, points, qargs, false);
 }
 
@@ -64,8 +174,10 @@ Translational::Translational(float k, bool weighted) : HexaticTranslational<floa
 void Translational::compute(const freud::locality::NeighborList* nlist,
                             const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
 {
-    computeGeneral([](const vec3<float>& delta) { return std::complex<float>(delta.x, delta.y); }, nlist,
-                   points, qargs, true);
+    computeGeneral(
+        [](const float* xs, const float* ys, const float* weights, size_t count,
+           std::complex<float>& psi) { accumulateTranslational(xs, ys, weights, count, psi); },
+        nlist, points, qargs, true);
 }
 
 }; }; // namespace freud::order
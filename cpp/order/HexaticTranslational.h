@@ -49,6 +49,10 @@ public:
 
 protected:
     //! Compute the order parameter
+    /*! func is called with one staged block of bond vectors at a time,
+     *  as (xs, ys, weights, count, psi), and accumulates the weighted
+     *  per-bond contributions of the block into psi.
+     */
     template<typename Func>
     void computeGeneral(Func func, const freud::locality::NeighborList* nlist,
                         const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
@@ -4,6 +4,7 @@
 #include "RotationalAutocorrelation.h"
 
 #include "utils.h"
+#include <algorithm>
 #include <cmath>
 
 /*! \file RotationalAutocorrelation.cc
@@ -52,32 +53,56 @@ inline std::complex<float> RotationalAutocorrelation::hypersphere_harmonic(const
     return sum_tracker;
 }
 
-void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, const quat<float>* orientations,
-                                        unsigned int N)
+void RotationalAutocorrelation::buildTermTables()
 {
-    m_RA_array.prepare(N);
-
-    // Precompute the hyperspherical harmonics for the unit quaternion. The
-    // default quaternion constructor gives a unit quaternion. We will assume
-    // the same iteration order here as in the loop below to save ourselves
-    // from having to use a more expensive process (i.e. a map).
-    std::complex<float> xi = std::complex<float>(0, 0);
-    std::complex<float> zeta = std::complex<float>(0, 1);
-    std::vector<std::complex<float>> unit_harmonics;
-    std::vector<std::vector<float>> prefactors(m_l + 1, std::vector<float>(m_l + 1, float(0)));
+    // The per-particle autocorrelation is
+    // sum_{m1, m2} prefactor(m1, m2) * conj(Y(unit)) * Y(xi, zeta; m1, m2),
+    // and each harmonic Y is itself a sum over k of a factorial coefficient
+    // times powers of conj(xi), zeta, conj(zeta), and -xi. Everything except
+    // those powers depends only on l, so the whole loop nest is flattened
+    // here into one term table that compute just evaluates.
+    const std::complex<float> xi_unit(0, 0);
+    const std::complex<float> zeta_unit(0, 1);
     for (unsigned int a = 0; a <= m_l; a++)
     {
         for (unsigned int b = 0; b <= m_l; b++)
         {
-            unit_harmonics.push_back(std::conj(hypersphere_harmonic(xi, zeta, a, b)));
-            prefactors[a][b] = static_cast<float>(m_factorials[a] * m_factorials[m_l - a] * m_factorials[b]
-                                                  * m_factorials[m_l - b])
+            const std::complex<float> unit_factor = std::conj(hypersphere_harmonic(xi_unit, zeta_unit, a, b));
+            // Cast before multiplying: the product of four factorials
+            // overflows 32-bit integers already for l = 9.
+            const float prefactor = static_cast<float>(m_factorials[a]) * static_cast<float>(m_factorials[m_l - a])
+                * static_cast<float>(m_factorials[b]) * static_cast<float>(m_factorials[m_l - b])
                 / (static_cast<float>(m_l + 1));
+            for (unsigned int k = (a + b < m_l ? 0 : a + b - m_l); k <= std::min(a, b); k++)
+            {
+                const float fact_product = static_cast<float>(m_factorials[k])
+                    * static_cast<float>(m_factorials[m_l + k - a - b])
+                    * static_cast<float>(m_factorials[a - k]) * static_cast<float>(m_factorials[b - k]);
+                m_term_coeffs.push_back(unit_factor * prefactor / fact_product);
+                m_pow_xi_conj.push_back(k);
+                m_pow_zeta.push_back(b - k);
+                m_pow_zeta_conj.push_back(a - k);
+                m_pow_neg_xi.push_back(m_l + k - a - b);
+            }
         }
     }
+}
+
+void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, const quat<float>* orientations,
+                                        unsigned int N)
+{
+    m_RA_array.prepare(N);
+
+    const size_t num_terms = m_term_coeffs.size();
 
     // Parallel loop is over orientations (technically (ref_or, or) pairs).
     util::forLoopWrapper(0, N, [&](size_t begin, size_t end) {
+        // Power tables of the four complex bases, reused across particles.
+        std::vector<std::complex<float>> pow_xi_conj(m_l + 1);
+        std::vector<std::complex<float>> pow_zeta(m_l + 1);
+        std::vector<std::complex<float>> pow_zeta_conj(m_l + 1);
+        std::vector<std::complex<float>> pow_neg_xi(m_l + 1);
+
         for (size_t i = begin; i < end; ++i)
         {
             // Transform the orientation quaternions into Xi/Zeta coordinates;
@@ -85,19 +110,24 @@ void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, con
             std::complex<float> xi = std::complex<float>(qq_1.v.x, qq_1.v.y);
             std::complex<float> zeta = std::complex<float>(qq_1.v.z, qq_1.s);
 
-            // Loop through the valid quantum numbers.
-            m_RA_array[i] = std::complex<float>(0, 0);
-            unsigned int uh_index = 0;
-            for (unsigned int a = 0; a <= m_l; a++)
+            // All powers up to l of the four bases appearing in the terms.
+            pow_xi_conj[0] = pow_zeta[0] = pow_zeta_conj[0] = pow_neg_xi[0] = std::complex<float>(1, 0);
+            for (unsigned int p = 1; p <= m_l; p++)
+            {
+                pow_xi_conj[p] = pow_xi_conj[p - 1] * std::conj(xi);
+                pow_zeta[p] = pow_zeta[p - 1] * zeta;
+                pow_zeta_conj[p] = pow_zeta_conj[p - 1] * std::conj(zeta);
+                pow_neg_xi[p] = pow_neg_xi[p - 1] * (-xi);
+            }
+
+            // Accumulate the flattened (m1, m2, k) expansion.
+            std::complex<float> total(0, 0);
+            for (size_t t = 0; t < num_terms; t++)
             {
-                for (unsigned int b = 0; b <= m_l; b++)
-                {
-                    std::complex<float> combined_value
-                        = unit_harmonics[uh_index] * hypersphere_harmonic(xi, zeta, a, b);
-                    m_RA_array[i] += prefactors[a][b] * combined_value;
-                    uh_index += 1;
-                }
+                total += m_term_coeffs[t] * pow_xi_conj[m_pow_xi_conj[t]] * pow_zeta[m_pow_zeta[t]]
+                    * pow_zeta_conj[m_pow_zeta_conj[t]] * pow_neg_xi[m_pow_neg_xi[t]];
             }
+            m_RA_array[i] = total;
         }
     });
 
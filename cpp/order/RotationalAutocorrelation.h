@@ -5,6 +5,7 @@
 #define ROTATIONAL_AUTOCORRELATION_H
 
 #include <complex>
+#include <vector>
 
 #include "ManagedArray.h"
 #include "VectorMath.h"
@@ -60,6 +61,7 @@ public:
         {
             m_factorials[i] = i * m_factorials[i - 1];
         }
+        buildTermTables();
     }
 
     //! Destructor
@@ -117,11 +119,26 @@ private:
     std::complex<float> hypersphere_harmonic(const std::complex<float> xi, std::complex<float> zeta,
                                              const unsigned int m1, const unsigned int m2);
 
+    //! Precompute the coefficient and exponent of every expansion term.
+    /*! The autocorrelation of a particle is a triple sum over (m1, m2, k)
+     *  whose coefficients (factorial products and the harmonics of the unit
+     *  quaternion) depend only on l, so the loop nest is flattened once at
+     *  construction into flat term tables; compute then only evaluates powers
+     *  of the particle's (xi, zeta) coordinates and accumulates.
+     */
+    void buildTermTables();
+
     unsigned int m_l; //!< Order of the hyperspherical harmonic.
     float m_Ft {0};   //!< Real value of calculated RA function.
 
     util::ManagedArray<std::complex<float>> m_RA_array; //!< Array of RA values per particle
     util::ManagedArray<unsigned int> m_factorials;      //!< Array of cached factorials
+
+    std::vector<std::complex<float>> m_term_coeffs; //!< Coefficient of each expansion term
+    std::vector<unsigned int> m_pow_xi_conj;        //!< Exponent of conj(xi) for each term
+    std::vector<unsigned int> m_pow_zeta;           //!< Exponent of zeta for each term
+    std::vector<unsigned int> m_pow_zeta_conj;      //!< Exponent of conj(zeta) for each term
+    std::vector<unsigned int> m_pow_neg_xi;         //!< Exponent of -xi for each term
 };
 
 }; }; // end namespace freud::order
@@ -1,11 +1,56 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
 
 #include "NeighborComputeFunctional.h"
 #include "SolidLiquid.h"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#if defined(__AVX__)
+//! Sum the 8 lanes of an AVX register.
+inline float horizontalSum(__m256 v)
+{
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x55));
+    return _mm_cvtss_f32(lo);
+}
+#endif
+
+//! Real part of the complex inner product of two qlm rows.
+/*! Re(sum_m q_i(m) conj(q_j(m))) reduces to a plain dot product of the rows'
+ * interleaved (re, im) float storage, so the (2l+1)-component complex vectors
+ * are consumed eight floats at a time straight from the qlm array.
+ */
+inline float qlmBondDot(const float* row_i, const float* row_j, unsigned int n_floats)
+{
+    unsigned int k = 0;
+    float dot = 0;
+#if defined(__AVX__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; k + 8 <= n_floats; k += 8)
+    {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(row_i + k), _mm256_loadu_ps(row_j + k)));
+    }
+    dot = horizontalSum(acc);
+#endif
+    for (; k < n_floats; k++)
+    {
+        dot += row_i[k] * row_j[k];
+    }
+    return dot;
+}
+
+} // namespace
+
 namespace freud { namespace order {
 
 SolidLiquid::SolidLiquid(unsigned int l, float q_threshold, unsigned int solid_threshold, bool normalize_q)
@@ -25,56 +70,94 @@ void SolidLiquid::compute(const freud::locality::NeighborList* nlist,
     // This function requires a NeighborList object, so we always make one and store it locally.
     m_nlist = locality::makeDefaultNlist(points, nlist, points->getPoints(), points->getNPoints(), qargs);
 
-    const unsigned int num_query_points(m_nlist.getNumQueryPoints());
-
     // Compute Steinhardt using neighbor list (also gets ql for normalization)
     m_steinhardt.compute(&m_nlist, points, qargs);
     // SolidLiquid only has one l value so we index the 2D array from Steinhardt.
-    const auto& qlm = m_steinhardt.getQlm()[0];
-    const auto& ql = m_steinhardt.getQl();
+    computeWithQlm(points, qargs, m_steinhardt.getQlm()[0], m_steinhardt.getQl(), 1, 0);
+}
+
+void SolidLiquid::compute(const freud::locality::NeighborList* nlist,
+                          const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
+                          const Steinhardt& steinhardt)
+{
+    const auto ls = steinhardt.getL();
+    const auto iter = std::find(ls.begin(), ls.end(), m_l);
+    if (iter == ls.end())
+    {
+        throw std::invalid_argument("The provided Steinhardt does not include the l value of this "
+                                    "SolidLiquid among its computed qlm.");
+    }
+    if (steinhardt.isAverage())
+    {
+        throw std::invalid_argument("SolidLiquid cannot reuse an averaged Steinhardt because its qlm "
+                                    "and ql arrays describe different quantities.");
+    }
+    if (steinhardt.getNP() != points->getNPoints())
+    {
+        throw std::invalid_argument(
+            "The provided Steinhardt was computed for a different number of points.");
+    }
+    const auto l_index = size_t(iter - ls.begin());
+
+    // This function requires a NeighborList object, so we always make one and store it locally.
+    m_nlist = locality::makeDefaultNlist(points, nlist, points->getPoints(), points->getNPoints(), qargs);
+
+    computeWithQlm(points, qargs, steinhardt.getQlm()[l_index], steinhardt.getQl(), ls.size(), l_index);
+}
+
+void SolidLiquid::computeWithQlm(const freud::locality::NeighborQuery* points,
+                                 freud::locality::QueryArgs qargs,
+                                 const util::ManagedArray<std::complex<float>>& qlm,
+                                 const util::ManagedArray<float>& ql, size_t ql_stride, size_t ql_index)
+{
+    const unsigned int num_query_points(m_nlist.getNumQueryPoints());
+
+    // Keep a reference to the qlm backing the last compute for getQlm.
+    m_qlm = qlm;
 
     // Compute (normalized) dot products for each bond in the neighbor list
     const auto normalizationfactor = float(4.0 * M_PI / m_num_ms);
     const unsigned int num_bonds(m_nlist.getNumBonds());
     m_ql_ij.prepare(num_bonds);
 
+    // Only the real part of the dot product is ever used, so each bond is a
+    // dot product of two qlm rows read through their interleaved (re, im)
+    // float storage; see qlmBondDot. The solid-bond flags are written in the
+    // same pass so the threshold comparison is fused with the kernel (a plain
+    // bool array rather than vector<bool> so concurrent writes do not share
+    // bytes).
+    const auto* qlm_flat = reinterpret_cast<const float*>(qlm.get());
+    const unsigned int row_floats = 2 * m_num_ms;
+    const auto* neighbors = m_nlist.getNeighbors().get();
+    std::unique_ptr<bool[]> solid_filter(new bool[num_bonds]);
+
     util::forLoopWrapper(
-        0, num_query_points,
+        0, num_bonds,
         [&](size_t begin, size_t end) {
-            for (unsigned int i = begin; i != end; ++i)
+            for (size_t bond = begin; bond != end; ++bond)
             {
-                unsigned int bond(m_nlist.find_first_index(i));
-                for (; bond < num_bonds && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
+                const unsigned int i(neighbors[2 * bond]);
+                const unsigned int j(neighbors[2 * bond + 1]);
+
+                float bond_ql_ij = qlmBondDot(qlm_flat + size_t(i) * row_floats,
+                                              qlm_flat + size_t(j) * row_floats, row_floats);
+
+                // Optionally normalize dot products by points' ql values,
+                // accounting for the normalization of ql values
+                if (m_normalize_q)
                 {
-                    const unsigned int j(m_nlist.getNeighbors()(bond, 1));
-
-                    // Accumulate the dot product over m of qlmi and qlmj vectors
-                    std::complex<float> bond_ql_ij = 0;
-                    for (unsigned int k = 0; k < m_num_ms; k++)
-                    {
-                        bond_ql_ij += qlm(i, k) * std::conj(qlm(j, k));
-                    }
-
-                    // Optionally normalize dot products by points' ql values,
-                    // accounting for the normalization of ql values
-                    if (m_normalize_q)
-                    {
-                        bond_ql_ij *= normalizationfactor / (ql[i] * ql[j]);
-                    }
-                    m_ql_ij[bond] = bond_ql_ij.real();
+                    bond_ql_ij *= normalizationfactor
+                        / (ql[i * ql_stride + ql_index] * ql[j * ql_stride + ql_index]);
                 }
+                m_ql_ij[bond] = bond_ql_ij;
+                solid_filter[bond] = bond_ql_ij > m_q_threshold;
             }
         },
         true);
 
     // Filter neighbors to contain only solid-like bonds
-    std::vector<bool> solid_filter(num_bonds);
-    for (unsigned int bond(0); bond < num_bonds; bond++)
-    {
-        solid_filter[bond] = (m_ql_ij[bond] > m_q_threshold);
-    }
     freud::locality::NeighborList solid_nlist(m_nlist);
-    solid_nlist.filter(solid_filter.cbegin());
+    solid_nlist.filter(solid_filter.get());
 
     // Save the neighbor counts of solid-like bonds for each query point
     m_number_of_connections.prepare(num_query_points);
@@ -88,6 +88,19 @@ public:
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                  freud::locality::QueryArgs qargs);
 
+    //! Compute the Solid-Liquid Order Parameter from precomputed qlm.
+    /*! Reuses the qlm (and, when normalize_q is set, ql) arrays of a
+     *  Steinhardt object that was already computed for these points, so
+     *  pipelines that report both quantities evaluate the spherical
+     *  harmonics only once. The Steinhardt must include this object's l
+     *  among its requested values and must have been computed for the same
+     *  points with a matching neighbor specification; averaged Steinhardt
+     *  objects are rejected because their qlm and ql arrays describe
+     *  different quantities.
+     */
+    void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
+                 freud::locality::QueryArgs qargs, const Steinhardt& steinhardt);
+
     //! Returns largest cluster size.
     unsigned int getLargestClusterSize() const
     {
@@ -132,7 +145,7 @@ public:
     //! Get the last calculated qlm for each particle
     const util::ManagedArray<std::complex<float>>& getQlm() const
     {
-        return m_steinhardt.getQlm()[0];
+        return m_qlm;
     }
 
     //! Return the ql_ij values.
@@ -142,6 +155,15 @@ public:
     }
 
 private:
+    //! Shared implementation: bond dot products, filtering, and clustering.
+    /*! The ql used for normalization is read as ql[i * ql_stride + ql_index]
+     *  so both this object's own Steinhardt (one l) and a shared multi-l
+     *  Steinhardt can provide it.
+     */
+    void computeWithQlm(const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
+                        const util::ManagedArray<std::complex<float>>& qlm,
+                        const util::ManagedArray<float>& ql, size_t ql_stride, size_t ql_index);
+
     unsigned int m_l;               //!< Value of l for the spherical harmonic.
     unsigned int m_num_ms;          //!< The number of magnetic quantum numbers (2*m_l+1).
     float m_q_threshold;            //!< Dot product cutoff
@@ -152,6 +174,7 @@ private:
     freud::order::Steinhardt m_steinhardt; //!< Steinhardt class used to compute qlm
     freud::cluster::Cluster m_cluster;     //!< Cluster class used to cluster solid-like bonds
 
+    util::ManagedArray<std::complex<float>> m_qlm; //!< The qlm used in the last call to compute
     util::ManagedArray<float> m_ql_ij;                        //!< All of the qlmi dot qlmj's computed
     util::ManagedArray<unsigned int> m_number_of_connections; //! Number of connections for each particle with
                                                               //! dot product above q_threshold
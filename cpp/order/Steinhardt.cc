@@ -2,38 +2,46 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include "Steinhardt.h"
+#include "ArrayFile.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 /*! \file Steinhardt.cc
     \brief Computes variants of Steinhardt order parameters.
 */
 
-namespace freud { namespace order {
+namespace {
 
-// Calculating Ylm using fsph module
-void Steinhardt::computeYlm(fsph::PointSPHEvaluator<float>& sph_eval, const float theta, const float phi,
-                            YlmsType& Ylms) const
+//! Spherical angles of a bond vector.
+inline void bondAngles(const vec3<float>& delta, float distance, float& theta, float& phi)
 {
-    sph_eval.compute(theta, phi);
-
-    for (size_t i = 0; i < m_ls.size(); ++i)
+    // phi is usually in range 0..2Pi, but
+    // it only appears in Ylm as exp(im\phi),
+    // so range -Pi..Pi will give same results.
+    phi = std::atan2(delta.y, delta.x); // -Pi..Pi
+
+    // This value must be clamped in cases where the particles are
+    // aligned along z, otherwise due to floating point error we
+    // could get delta.z/distance = -1-eps, which is outside the
+    // valid range of std::acos.
+    theta = std::acos(freud::util::clamp(delta.z / distance, -1, 1)); // 0..Pi
+
+    // If the points are directly on top of each other,
+    // theta should be zero instead of nan.
+    if (distance == float(0))
     {
-        auto& Ylm = Ylms[i];
-        const auto l = m_ls[i];
-        size_t m_index(0);
-
-        const auto end_iter(sph_eval.begin_l(l + 1, 0, true));
-        for (auto iter(sph_eval.begin_l(l, 0, true)); iter != end_iter; ++iter, ++m_index)
-        {
-            // Manually add the Condon-Shortley phase, (-1)^m, to positive odd m
-            const float phase = (m_index <= l && m_index % 2 == 1) ? -1 : 1;
-            Ylm[m_index] = phase * (*iter);
-        }
+        theta = 0;
     }
 }
 
+} // namespace
+
+namespace freud { namespace order {
+
 void Steinhardt::reallocateArrays(unsigned int Np)
 {
     m_Np = Np;
@@ -65,6 +73,10 @@ void Steinhardt::reallocateArrays(unsigned int Np)
 void Steinhardt::compute(const freud::locality::NeighborList* nlist,
                          const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
 {
+    // Whether this call may reuse the per-bond cache of the previous call.
+    m_use_cache
+        = m_incremental_tolerance > 0 && m_cache_valid && m_cached_Np == points->getNPoints();
+
     // Allocate and zero out arrays as necessary.
     reallocateArrays(points->getNPoints());
 
@@ -94,6 +106,137 @@ void Steinhardt::compute(const freud::locality::NeighborList* nlist,
         }
     }
     m_norm = normalizeSystem();
+
+    m_cache_valid = m_incremental_tolerance > 0;
+    m_cached_Np = m_Np;
+}
+
+void Steinhardt::computeAsync(const freud::locality::NeighborList* nlist,
+                              const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
+{
+    m_async.launch([this, nlist, points, qargs]() { compute(nlist, points, qargs); });
+}
+
+namespace {
+//! Pack a complex array into a float array with a trailing axis of size 2.
+/*! The ArrayFile format has no complex dtype, so complex data travels as
+ * interleaved real and imaginary parts.
+ */
+util::ManagedArray<float> packComplex(const util::ManagedArray<std::complex<float>>& source)
+{
+    auto shape = source.shape();
+    shape.push_back(2);
+    util::ManagedArray<float> packed;
+    packed.prepare(shape);
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        packed[2 * i] = source[i].real();
+        packed[2 * i + 1] = source[i].imag();
+    }
+    return packed;
+}
+
+//! Unpack an interleaved float array back into an existing complex array.
+void unpackComplex(const util::ManagedArray<float>& packed, util::ManagedArray<std::complex<float>>& target)
+{
+    for (size_t i = 0; i < target.size(); ++i)
+    {
+        target[i] = std::complex<float>(packed[2 * i], packed[2 * i + 1]);
+    }
+}
+}; // namespace
+
+void Steinhardt::checkpoint(const std::string& path)
+{
+    m_async.wait();
+    util::ArrayFileWriter writer(path);
+
+    util::ManagedArray<unsigned int> meta;
+    meta.prepare(6);
+    meta[0] = m_Np;
+    meta[1] = static_cast<unsigned int>(m_ls.size());
+    meta[2] = m_average ? 1 : 0;
+    meta[3] = m_wl ? 1 : 0;
+    meta[4] = m_weighted ? 1 : 0;
+    meta[5] = m_wl_normalize ? 1 : 0;
+    writer.write("meta", meta);
+
+    util::ManagedArray<unsigned int> ls;
+    ls.prepare(m_ls.size());
+    std::copy(m_ls.begin(), m_ls.end(), ls.get());
+    writer.write("ls", ls);
+
+    for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+    {
+        writer.write("qlm" + std::to_string(l_index), packComplex(m_qlmi[l_index]));
+    }
+    writer.write("ql", m_qli);
+    if (m_average)
+    {
+        writer.write("qlave", m_qliAve);
+    }
+    if (m_wl)
+    {
+        writer.write("wl", m_wli);
+    }
+
+    util::ManagedArray<float> norm;
+    norm.prepare(m_norm.size());
+    std::copy(m_norm.begin(), m_norm.end(), norm.get());
+    writer.write("norm", norm);
+    writer.close();
+}
+
+void Steinhardt::restore(const std::string& path)
+{
+    m_async.wait();
+    const util::ArrayFileReader reader(path);
+    const auto meta = reader.read<unsigned int>("meta");
+    const auto ls = reader.read<unsigned int>("ls");
+    bool matches = meta.size() == 6 && meta[1] == m_ls.size() && (meta[2] != 0) == m_average
+        && (meta[3] != 0) == m_wl && (meta[4] != 0) == m_weighted && (meta[5] != 0) == m_wl_normalize
+        && ls.size() == m_ls.size();
+    for (size_t l_index = 0; matches && l_index < m_ls.size(); ++l_index)
+    {
+        matches = ls[l_index] == m_ls[l_index];
+    }
+    if (!matches)
+    {
+        throw std::runtime_error("Checkpoint was written by a Steinhardt compute with different parameters.");
+    }
+
+    reallocateArrays(meta[0]);
+    for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+    {
+        const auto packed = reader.read<float>("qlm" + std::to_string(l_index));
+        if (packed.size() != 2 * m_qlmi[l_index].size())
+        {
+            throw std::runtime_error("Checkpoint does not match this compute's array sizes.");
+        }
+        unpackComplex(packed, m_qlmi[l_index]);
+    }
+    const auto ql = reader.read<float>("ql");
+    if (ql.size() != m_qli.size())
+    {
+        throw std::runtime_error("Checkpoint does not match this compute's array sizes.");
+    }
+    std::copy(ql.get(), ql.get() + ql.size(), m_qli.get());
+    if (m_average)
+    {
+        const auto qlave = reader.read<float>("qlave");
+        std::copy(qlave.get(), qlave.get() + qlave.size(), m_qliAve.get());
+    }
+    if (m_wl)
+    {
+        const auto wl = reader.read<float>("wl");
+        std::copy(wl.get(), wl.get() + wl.size(), m_wli.get());
+    }
+    const auto norm = reader.read<float>("norm");
+    m_norm.assign(norm.get(), norm.get() + norm.size());
+
+    // The incremental Ylm cache belongs to the positions of the process that
+    // wrote the checkpoint; force a full evaluation on the next compute.
+    m_cache_valid = false;
 }
 
 void Steinhardt::baseCompute(const freud::locality::NeighborList* nlist,
@@ -111,63 +254,244 @@ void Steinhardt::baseCompute(const freud::locality::NeighborList* nlist,
         qlm_local.reset();
     }
 
+    // The recurrence coefficient tables depend only on the requested l
+    // values, so one read-only evaluator is shared by all threads.
+    const BatchedYlmEvaluator ylm_evaluator(m_ls);
+
+    const bool cache_bonds = m_incremental_tolerance > 0;
+    const bool reuse_cache = m_use_cache;
+    const float tolerance_sq = m_incremental_tolerance * m_incremental_tolerance;
+    if (cache_bonds)
+    {
+        m_bond_cache.resize(m_Np);
+        m_particle_changed.assign(m_Np, 1);
+    }
+
     freud::locality::loopOverNeighborsIterator(
         points, points->getPoints(), m_Np, qargs, nlist,
         [&](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
             float total_weight(0);
             const vec3<float> ref((*points)[i]);
-            // Construct PointSPHEvaluator outside loop since the construction is costly.
-            auto max_l = *std::max_element(m_ls.begin(), m_ls.end());
-            fsph::PointSPHEvaluator<float> sph_eval(max_l);
 
             // Alocate and instantiate this array before looping over particles to prevent N instantiations
-            // and N * m_l.size() allocations.
-            YlmsType Ylms(m_ls.size());
+            // and N * m_l.size() allocations. It accumulates the sum of
+            // weight * Ylm over all of this particle's bonds.
+            YlmsType Ylm_sums(m_ls.size());
             for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
             {
-                Ylms[l_index].resize(m_num_ms[l_index]);
+                Ylm_sums[l_index].assign(m_num_ms[l_index], 0);
             }
 
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
+            // Bond angles are staged into these blocks and evaluated a batch
+            // at a time so the spherical harmonics run across SIMD lanes.
+            float thetas[YLM_BATCH_SIZE];
+            float phis[YLM_BATCH_SIZE];
+            size_t batch_size = 0;
+
+            if (cache_bonds)
             {
-                const vec3<float> delta = points->getBox().wrap((*points)[nb.point_idx] - ref);
-                const float weight(m_weighted ? nb.weight : float(1.0));
-
-                // phi is usually in range 0..2Pi, but
-                // it only appears in Ylm as exp(im\phi),
-                // so range -Pi..Pi will give same results.
-                const float phi = std::atan2(delta.y, delta.x); // -Pi..Pi
-
-                // This value must be clamped in cases where the particles are
-                // aligned along z, otherwise due to floating point error we
-                // could get delta.z/nb.distance = -1-eps, which is outside the
-                // valid range of std::acos.
-                float theta = std::acos(util::clamp(delta.z / nb.distance, -1, 1)); // 0..Pi
-
-                // If the points are directly on top of each other,
-                // theta should be zero instead of nan.
-                if (nb.distance == float(0))
+                BondYlmCache& cached = m_bond_cache[i];
+
+                // Gather this call's bonds first; whether the bond set kept
+                // the cached order decides between the in-place fast path
+                // and a full row rebuild below.
+                std::vector<unsigned int> bond_points;
+                std::vector<vec3<float>> bond_deltas;
+                std::vector<float> bond_weights;
+                std::vector<float> bond_distances;
+                bond_points.reserve(cached.point_indices.size());
+                bond_deltas.reserve(cached.point_indices.size());
+                bond_weights.reserve(cached.point_indices.size());
+                bond_distances.reserve(cached.point_indices.size());
+                bool same_bonds = reuse_cache;
+                for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end();
+                     nb = ppiter->next())
                 {
-                    theta = 0;
-                }
+                    const vec3<float> delta = points->getBox().wrap((*points)[nb.point_idx] - ref);
+                    const float weight(m_weighted ? nb.weight : float(1.0));
+                    same_bonds = same_bonds && bond_points.size() < cached.point_indices.size()
+                        && cached.point_indices[bond_points.size()] == nb.point_idx;
+                    bond_points.push_back(nb.point_idx);
+                    bond_deltas.push_back(delta);
+                    bond_weights.push_back(weight);
+                    bond_distances.push_back(nb.distance);
+                    // Accumulate weight for normalization
+                    total_weight += weight;
+                } // End loop going over neighbor bonds
+                const size_t n_bonds = bond_points.size();
+                same_bonds = same_bonds && n_bonds == cached.point_indices.size();
+
+                // Scratch block that freshly evaluated bonds are written into
+                // before being scattered to their slots; allocated only when
+                // some bond actually needs re-evaluation.
+                YlmsType block;
+                size_t slots[YLM_BATCH_SIZE];
+                const auto flush = [&](YlmsType& ylms_out) {
+                    if (block.empty())
+                    {
+                        block.resize(m_ls.size());
+                        for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+                        {
+                            block[l_index].resize(YLM_BATCH_SIZE * m_num_ms[l_index]);
+                        }
+                    }
+                    ylm_evaluator.evaluate(thetas, phis, batch_size, block);
+                    for (size_t b = 0; b < batch_size; ++b)
+                    {
+                        for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+                        {
+                            const size_t num_ms = m_num_ms[l_index];
+                            std::copy(block[l_index].begin() + b * num_ms,
+                                      block[l_index].begin() + (b + 1) * num_ms,
+                                      ylms_out[l_index].begin() + slots[b] * num_ms);
+                        }
+                    }
+                    batch_size = 0;
+                };
 
-                computeYlm(sph_eval, theta, phi, Ylms); // Fill up Ylm
+                bool changed = true;
+                if (same_bonds)
+                {
+                    // Unchanged bond set: refresh only the rows of bonds that
+                    // moved beyond the tolerance, in place.
+                    changed = false;
+                    for (size_t slot = 0; slot < n_bonds; ++slot)
+                    {
+                        const vec3<float> moved = bond_deltas[slot] - cached.deltas[slot];
+                        if (dot(moved, moved) <= tolerance_sq)
+                        {
+                            continue;
+                        }
+                        changed = true;
+                        cached.deltas[slot] = bond_deltas[slot];
+                        bondAngles(bond_deltas[slot], bond_distances[slot], thetas[batch_size],
+                                   phis[batch_size]);
+                        slots[batch_size] = slot;
+                        if (++batch_size == YLM_BATCH_SIZE)
+                        {
+                            flush(cached.ylms);
+                        }
+                    }
+                    if (batch_size > 0)
+                    {
+                        flush(cached.ylms);
+                    }
+                }
+                else
+                {
+                    // The bond set changed: rebuild the cache row, copying
+                    // over the bonds that are still within tolerance of a
+                    // cached evaluation.
+                    BondYlmCache updated;
+                    updated.point_indices = bond_points;
+                    updated.deltas = bond_deltas;
+                    updated.ylms.resize(m_ls.size());
+                    for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+                    {
+                        updated.ylms[l_index].resize(n_bonds * m_num_ms[l_index]);
+                    }
+                    for (size_t slot = 0; slot < n_bonds; ++slot)
+                    {
+                        bool reused = false;
+                        if (reuse_cache)
+                        {
+                            const auto iter = std::find(cached.point_indices.begin(),
+                                                        cached.point_indices.end(), bond_points[slot]);
+                            if (iter != cached.point_indices.end())
+                            {
+                                const auto pos = size_t(iter - cached.point_indices.begin());
+                                const vec3<float> moved = bond_deltas[slot] - cached.deltas[pos];
+                                if (dot(moved, moved) <= tolerance_sq)
+                                {
+                                    // Keep the delta the cached values were
+                                    // evaluated at, so slow drift over many
+                                    // calls stays bounded by the tolerance
+                                    // instead of accumulating.
+                                    updated.deltas[slot] = cached.deltas[pos];
+                                    for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+                                    {
+                                        const size_t num_ms = m_num_ms[l_index];
+                                        std::copy(cached.ylms[l_index].begin() + pos * num_ms,
+                                                  cached.ylms[l_index].begin() + (pos + 1) * num_ms,
+                                                  updated.ylms[l_index].begin() + slot * num_ms);
+                                    }
+                                    reused = true;
+                                }
+                            }
+                        }
+                        if (!reused)
+                        {
+                            bondAngles(bond_deltas[slot], bond_distances[slot], thetas[batch_size],
+                                       phis[batch_size]);
+                            slots[batch_size] = slot;
+                            if (++batch_size == YLM_BATCH_SIZE)
+                            {
+                                flush(updated.ylms);
+                            }
+                        }
+                    }
+                    if (batch_size > 0)
+                    {
+                        flush(updated.ylms);
+                    }
+                    cached = std::move(updated);
+                }
 
+                // The weighted per-bond values feed the same accumulation as
+                // the non-caching path below. The complex rows are summed as
+                // flat float arrays so the loop vectorizes.
                 for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
                 {
-                    auto& qlmi = m_qlmi[l_index];
-                    const auto& Ylm = Ylms[l_index];
-                    // Get the initial index and iterate using ++ for faster iteration
-                    // Profiling showed using operator() to slow the code significantly.
-                    const size_t index = qlmi.getIndex({i, 0});
-                    for (size_t k = 0; k < m_num_ms[l_index]; ++k)
+                    const size_t num_floats = 2 * m_num_ms[l_index];
+                    auto* sums = reinterpret_cast<float*>(Ylm_sums[l_index].data());
+                    const auto* ylms = reinterpret_cast<const float*>(cached.ylms[l_index].data());
+                    for (size_t slot = 0; slot < n_bonds; ++slot)
                     {
-                        qlmi[index + k] += weight * Ylm[k];
+                        const float weight = bond_weights[slot];
+                        const float* row = ylms + slot * num_floats;
+                        for (size_t k = 0; k < num_floats; ++k)
+                        {
+                            sums[k] += weight * row[k];
+                        }
                     }
                 }
-                // Accumulate weight for normalization
-                total_weight += weight;
-            } // End loop going over neighbor bonds
+                m_particle_changed[i] = changed ? 1 : 0;
+            }
+            else
+            {
+                float weights[YLM_BATCH_SIZE];
+                for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end();
+                     nb = ppiter->next())
+                {
+                    const vec3<float> delta = points->getBox().wrap((*points)[nb.point_idx] - ref);
+                    const float weight(m_weighted ? nb.weight : float(1.0));
+
+                    bondAngles(delta, nb.distance, thetas[batch_size], phis[batch_size]);
+                    weights[batch_size] = weight;
+                    if (++batch_size == YLM_BATCH_SIZE)
+                    {
+                        ylm_evaluator.accumulate(thetas, phis, weights, batch_size, Ylm_sums);
+                        batch_size = 0;
+                    }
+                    // Accumulate weight for normalization
+                    total_weight += weight;
+                } // End loop going over neighbor bonds
+                // Evaluate any partial block left by the bond loop.
+                ylm_evaluator.accumulate(thetas, phis, weights, batch_size, Ylm_sums);
+            }
+
+            for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+            {
+                auto& qlmi = m_qlmi[l_index];
+                const auto& Ylm = Ylm_sums[l_index];
+                // Get the initial index and iterate using ++ for faster iteration
+                // Profiling showed using operator() to slow the code significantly.
+                const size_t index = qlmi.getIndex({i, 0});
+                for (size_t k = 0; k < m_num_ms[l_index]; ++k)
+                {
+                    qlmi[index + k] += Ylm[k];
+                }
+            }
 
             // Normalize!
             const size_t qli_i_start = m_qli.getIndex({i, 0});
@@ -214,12 +538,32 @@ void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
         normalizationfactor[l_index] = static_cast<float>(4.0 * M_PI / m_num_ms[l_index]);
     }
 
+    const bool cache_rows = m_incremental_tolerance > 0;
+    const bool reuse_rows = m_use_cache;
+    if (cache_rows)
+    {
+        m_qlmiAve_cache.resize(m_ls.size());
+        for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+        {
+            m_qlmiAve_cache[l_index].resize(size_t(m_Np) * m_num_ms[l_index]);
+        }
+        m_qliAve_cache.resize(size_t(m_Np) * m_ls.size());
+    }
+
     freud::locality::loopOverNeighborsIterator(
         points, points->getPoints(), m_Np, qargs, nlist,
         [&](size_t i, const std::shared_ptr<freud::locality::NeighborPerPointIterator>& ppiter) {
             unsigned int neighborcount(1);
+            // Dirty if this particle's qlm changed in baseCompute or any
+            // neighbor's did; only dirty particles get their average
+            // recomputed when the bond cache was reused.
+            bool dirty = !reuse_rows || m_particle_changed[i] != 0;
             for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
             {
+                if (reuse_rows && m_particle_changed[nb.point_idx] != 0)
+                {
+                    dirty = true;
+                }
                 for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
                 {
                     auto& qlmiAve = m_qlmiAve[l_index];
@@ -237,9 +581,30 @@ void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
                 neighborcount++;
             } // End loop over particle's bonds
 
+            const size_t qliAve_i_start = m_qliAve.getIndex({i, 0});
+            if (!dirty)
+            {
+                // Unchanged neighborhood: reuse the previous call's rows and
+                // still contribute them to the system average.
+                for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+                {
+                    auto& qlmiAve = m_qlmiAve[l_index];
+                    auto& qlm_local = m_qlm_local[l_index];
+                    const auto& row_cache = m_qlmiAve_cache[l_index];
+                    const size_t first_qlmi_index = qlmiAve.getIndex({i, 0});
+                    const size_t cache_index = i * m_num_ms[l_index];
+                    for (size_t k = 0; k < m_num_ms[l_index]; ++k)
+                    {
+                        qlmiAve[first_qlmi_index + k] = row_cache[cache_index + k];
+                        qlm_local.local()[k] += row_cache[cache_index + k] / float(m_Np);
+                    }
+                    m_qliAve[qliAve_i_start + l_index] = m_qliAve_cache[i * m_ls.size() + l_index];
+                }
+                return;
+            }
+
             // Normalize!
 
-            const size_t qliAve_i_start = m_qliAve.getIndex({i, 0});
             for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
             {
                 auto& qlmiAve = m_qlmiAve[l_index];
@@ -262,6 +627,23 @@ void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
                 m_qliAve[qliAve_index] *= normalizationfactor[l_index];
                 m_qliAve[qliAve_index] = std::sqrt(m_qliAve[qliAve_index]);
             }
+
+            if (cache_rows)
+            {
+                // Record the freshly computed rows for reuse by later calls.
+                for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
+                {
+                    const auto& qlmiAve = m_qlmiAve[l_index];
+                    auto& row_cache = m_qlmiAve_cache[l_index];
+                    const size_t first_qlmi_index = qlmiAve.getIndex({i, 0});
+                    const size_t cache_index = i * m_num_ms[l_index];
+                    for (size_t k = 0; k < m_num_ms[l_index]; ++k)
+                    {
+                        row_cache[cache_index + k] = qlmiAve[first_qlmi_index + k];
+                    }
+                    m_qliAve_cache[i * m_ls.size() + l_index] = m_qliAve[qliAve_i_start + l_index];
+                }
+            }
         });
 }
 
@@ -307,27 +689,39 @@ void Steinhardt::aggregatewl(util::ManagedArray<float>& target,
                              const std::vector<util::ManagedArray<std::complex<float>>>& source,
                              const util::ManagedArray<float>& normalization_source) const
 {
+    // Fetch the resolved term lists once per l; the first fetch for each l
+    // builds and caches the list, which must not happen inside the loop.
+    std::vector<const Wigner3jTerms*> terms_per_l;
+    terms_per_l.reserve(m_ls.size());
+    for (const auto l : m_ls)
+    {
+        terms_per_l.push_back(&getWigner3jTerms(l));
+    }
+
     util::forLoopWrapper(0, m_Np, [&](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+        // The qlm rows of a particle range are contiguous per l, so each l
+        // contracts the whole range through the blocked kernel and the
+        // invariants are scattered into the interleaved per-particle layout
+        // afterwards.
+        std::vector<float> invariants(end - begin);
+        for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
         {
-            const auto target_particle_index = target.getIndex({i, 0});
-            const auto norm_particle_index = normalization_source.getIndex({i, 0});
-            for (size_t l_index = 0; l_index < m_ls.size(); ++l_index)
-            {
-                const auto l = m_ls[l_index];
-                const auto& source_l = source[l_index];
+            const auto& source_l = source[l_index];
+            const auto num_ms = m_num_ms[l_index];
+            const auto normalizationfactor = static_cast<float>(4.0 * M_PI / num_ms);
 
-                const auto normalizationfactor = static_cast<float>(4.0 * M_PI / m_num_ms[l_index]);
-                const auto wigner3j_values = getWigner3j(l);
-
-                target[target_particle_index + l_index]
-                    = reduceWigner3j(&(source_l({i, 0})), l, wigner3j_values);
+            reduceWigner3jBlock(&(source_l({begin, 0})), num_ms, end - begin, *terms_per_l[l_index],
+                                invariants.data());
+            for (size_t i = begin; i < end; ++i)
+            {
+                float wli = invariants[i - begin];
                 if (m_wl_normalize)
                 {
                     const float normalization = std::sqrt(normalizationfactor)
-                        / normalization_source[norm_particle_index + l_index];
-                    target[target_particle_index + l_index] *= normalization * normalization * normalization;
+                        / normalization_source[normalization_source.getIndex({i, 0}) + l_index];
+                    wli *= normalization * normalization * normalization;
                 }
+                target[target.getIndex({i, 0}) + l_index] = wli;
             }
         }
     });
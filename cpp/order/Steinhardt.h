@@ -6,7 +6,10 @@
 
 #include <algorithm>
 #include <complex>
+#include <string>
+#include <vector>
 
+#include "BatchedYlmEvaluator.h"
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
@@ -14,7 +17,7 @@
 #include "ThreadStorage.h"
 #include "VectorMath.h"
 #include "Wigner3j.h"
-#include "fsph/src/spherical_harmonics.hpp"
+#include "async_dispatch.h"
 
 /*! \file Steinhardt.h
     \brief Computes variants of Steinhardt order parameters.
@@ -22,8 +25,6 @@
 
 namespace freud { namespace order {
 
-using YlmsType = std::vector<std::vector<std::complex<float>>>;
-
 //! Compute the Steinhardt local rotationally invariant ql or wl order parameter for a set of points
 /*!
  * Implements the rotationally invariant ql or wl order parameter described
@@ -62,12 +63,23 @@ public:
     //! Steinhardt Class Constructor
     /*! Constructor for Steinhardt analysis class.
      *  \param ls Spherical harmonic numbers l. Must be non-negative integers.
+     *  \param incremental_tolerance If positive, enables incremental
+     *         recomputation across calls to compute: the Ylm of each bond is
+     *         cached, and a bond whose vector has moved by less than this
+     *         distance since its last evaluation reuses the cached values
+     *         instead of re-evaluating the spherical harmonics. On
+     *         slowly-evolving trajectories only the bonds that actually moved
+     *         are recomputed. The reused values are exact for the position at
+     *         which they were evaluated, so the tolerance bounds the error;
+     *         zero (the default) recomputes every bond each call.
      */
     explicit Steinhardt(const std::vector<unsigned int>& ls, bool average = false, bool wl = false,
-                        bool weighted = false, bool wl_normalize = false)
+                        bool weighted = false, bool wl_normalize = false,
+                        float incremental_tolerance = 0)
         : m_ls(ls), m_num_ms(m_ls.size()), m_average(average), m_wl(wl), m_weighted(weighted),
-          m_wl_normalize(wl_normalize), m_qlm_local(m_ls.size()), m_qlmi(ls.size()), m_qlm(ls.size()),
-          m_qlmiAve(ls.size()), m_qlmAve(ls.size())
+          m_wl_normalize(wl_normalize), m_incremental_tolerance(incremental_tolerance),
+          m_qlm_local(m_ls.size()), m_qlmi(ls.size()), m_qlm(ls.size()), m_qlmiAve(ls.size()),
+          m_qlmAve(ls.size())
 
     {
         std::transform(m_ls.cbegin(), m_ls.cend(), m_num_ms.begin(), [](const auto& l) { return 2 * l + 1; });
@@ -80,8 +92,9 @@ public:
      *  \param l Spherical harmonic number l. Must be non-negative integers.
      */
     explicit Steinhardt(const unsigned int l, bool average = false, bool wl = false, bool weighted = false,
-                        bool wl_normalize = false)
-        : Steinhardt(std::vector<unsigned int> {l}, average, wl, weighted, wl_normalize)
+                        bool wl_normalize = false, float incremental_tolerance = 0)
+        : Steinhardt(std::vector<unsigned int> {l}, average, wl, weighted, wl_normalize,
+                     incremental_tolerance)
     {}
 
     //! Empty destructor
@@ -90,12 +103,14 @@ public:
     //! Get the number of particles used in the last compute
     unsigned int getNP() const
     {
+        m_async.wait();
         return m_Np;
     }
 
     //! Get the last calculated order parameter for each l
     const util::ManagedArray<float>& getParticleOrder() const
     {
+        m_async.wait();
         if (m_wl)
         {
             return m_wli;
@@ -106,6 +121,7 @@ public:
     //! Get the last calculated ql for each l
     const util::ManagedArray<float>& getQl() const
     {
+        m_async.wait();
         if (m_average)
         {
             return m_qliAve;
@@ -116,12 +132,14 @@ public:
     //! Get the last calculated qlm for each particle and l
     const std::vector<util::ManagedArray<std::complex<float>>>& getQlm() const
     {
+        m_async.wait();
         return m_qlmi;
     }
 
     //! Get system-normalized order for each l
     std::vector<float> getOrder() const
     {
+        m_async.wait();
         return m_norm;
     }
 
@@ -149,22 +167,58 @@ public:
         return m_wl_normalize;
     }
 
+    //!< Bond displacement below which cached Ylm values are reused (0 if disabled)
+    float getIncrementalTolerance() const
+    {
+        return m_incremental_tolerance;
+    }
+
     //! Compute the order parameter
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
                  freud::locality::QueryArgs qargs);
 
+    //! Compute the order parameter asynchronously in the shared compute arena.
+    /*! Returns immediately; every getter blocks until the compute completes,
+     *  so results may be requested at any time. The caller must keep nlist
+     *  and points alive until then — typically until the next getter call or
+     *  synchronize().
+     */
+    void computeAsync(const freud::locality::NeighborList* nlist,
+                      const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs);
+
+    //! Block until any asynchronously enqueued compute has finished.
+    void synchronize() const
+    {
+        m_async.wait();
+    }
+
+    //! Write the last computed state to a checkpoint file.
+    /*! Steinhardt does not accumulate across frames, so the checkpoint holds
+     *  the results of the last compute: the per-particle qlm and the derived
+     *  order parameters. A restarted job can restore them and serve every
+     *  getter without recomputing the frame.
+     */
+    void checkpoint(const std::string& path);
+
+    //! Restore the last computed state from a checkpoint file.
+    /*! Throws if the checkpoint was written with different l values or
+     *  flags than this object's.
+     */
+    void restore(const std::string& path);
+
     std::vector<unsigned int> getL() const
     {
         return m_ls;
     }
 
 private:
-    //! \internal
-    //! Spherical harmonics calculation for Ylm filling a
-    //  std::vector<std::vector<std::complex<float> > > with values for m = 0, 1, ..., l, -1, ..., -l
-    //  for all l in m_ls
-    void computeYlm(fsph::PointSPHEvaluator<float>& sph_eval, const float theta, const float phi,
-                    YlmsType& Ylms) const;
+    //! Per-particle bond data cached by the incremental mode.
+    struct BondYlmCache
+    {
+        std::vector<unsigned int> point_indices; //!< Neighbor index of each cached bond
+        std::vector<vec3<float>> deltas;         //!< Bond vector at the last Ylm evaluation
+        YlmsType ylms; //!< Unweighted Ylm values per l, one block of 2l+1 per bond
+    };
 
     template<typename T> std::shared_ptr<T> makeArray(size_t size);
 
@@ -201,6 +255,20 @@ private:
     bool m_weighted;     //!< Whether to use neighbor weights in computing qlmi (default false)
     bool m_wl_normalize; //!< Whether to normalize the third-order invariant wl (default false)
 
+    // State for the incremental mode
+    //! Completion of an asynchronously enqueued compute; mutable so that
+    //! const getters can synchronize.
+    mutable parallel::AsyncHandle m_async;
+
+    float m_incremental_tolerance; //!< Bond displacement below which cached Ylm values are reused
+    bool m_cache_valid {false};    //!< Whether m_bond_cache holds the previous call's bonds
+    bool m_use_cache {false};      //!< Whether the current compute may reuse the cache
+    unsigned int m_cached_Np {0};  //!< Number of particles the cache was built for
+    std::vector<BondYlmCache> m_bond_cache; //!< Cached bonds of each particle
+    std::vector<char> m_particle_changed;   //!< Whether each particle's qlm changed in this call
+    std::vector<std::vector<std::complex<float>>> m_qlmiAve_cache; //!< Previous qlmiAve rows, per l
+    std::vector<float> m_qliAve_cache;                             //!< Previous qliAve values
+
     std::vector<util::ManagedArray<std::complex<float>>> m_qlmi; //!< qlm for each particle i
     std::vector<util::ManagedArray<std::complex<float>>> m_qlm;  //!< Normalized qlm(Ave) for the whole system
     std::vector<util::ThreadStorage<std::complex<float>>>
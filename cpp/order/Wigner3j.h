@@ -5,14 +5,55 @@
 #define WIGNER3J_H
 
 #include <complex>
+#include <cstddef>
 #include <vector>
 
 /*! \file Wigner3j.h
- *  \brief Stores and reduces over Wigner 3j coefficients for l from 0 to 20
+ *  \brief Stores and reduces over Wigner 3j coefficients
  */
 
 namespace freud { namespace order {
 
+//! Non-owning view of an immutable array of Wigner 3j coefficients.
+/*! The coefficients are stored once per process (in compile-time tables for
+ *  l up to 20, and in a cache of on-demand computed values beyond that), so
+ *  callers receive a cheap view instead of a copy of the table.
+ */
+class Wigner3jSpan
+{
+public:
+    constexpr Wigner3jSpan(const double* data, size_t size) : m_data(data), m_size(size) {}
+
+    constexpr const double* data() const
+    {
+        return m_data;
+    }
+
+    constexpr size_t size() const
+    {
+        return m_size;
+    }
+
+    constexpr const double* begin() const
+    {
+        return m_data;
+    }
+
+    constexpr const double* end() const
+    {
+        return m_data + m_size;
+    }
+
+    constexpr double operator[](size_t index) const
+    {
+        return m_data[index];
+    }
+
+private:
+    const double* m_data; //!< First coefficient of the viewed table
+    size_t m_size;        //!< Number of coefficients in the viewed table
+};
+
 //! Compute array index for m values, indexed like:
 //  [0, 1, ..., l, -1, -2, ..., -l]
 int lmIndex(int l, int m);
@@ -20,9 +61,54 @@ int lmIndex(int l, int m);
 //! Reduce an array using Wigner 3j coefficients to construct a
 //  third-order rotational invariant quantity.
 //  source array must be indexed by m, like [0, 1, ..., l, -1, -2, ..., -l].
-float reduceWigner3j(const std::complex<float>* source, unsigned int l_, const std::vector<double>& wigner3j);
+float reduceWigner3j(const std::complex<float>* source, unsigned int l_, Wigner3jSpan wigner3j);
 
-std::vector<double> getWigner3j(unsigned int l);
+//! Get a view of the Wigner 3j coefficients (l l l; m1 m2 m3) for one l.
+/*! Values for l up to 20 come from compile-time tables; larger l values are
+ *  computed on demand in double precision and cached for the lifetime of the
+ *  process, so repeated calls never copy or recompute the coefficients.
+ */
+Wigner3jSpan getWigner3j(unsigned int l);
+
+//! Flat term list for the wl contraction at one l, with the m indices resolved.
+/*! Each entry is one (m1, m2) pair of the reduction: the coefficient times
+ *  the triple product of the qlm values at the three stored indices. The
+ *  terms are kept in the iteration order of reduceWigner3j, so a reduction
+ *  walking this list accumulates in the same order and reproduces its result
+ *  exactly; resolving lmIndex and the loop bounds ahead of time leaves the
+ *  per-term work as pure loads and arithmetic, which the blocked kernel in
+ *  reduceWigner3jBlock needs. The index arrays are separate so each streams
+ *  contiguously.
+ */
+struct Wigner3jTerms
+{
+    std::vector<unsigned int> m1_index; //!< Index of the m1 qlm value per term.
+    std::vector<unsigned int> m2_index; //!< Index of the m2 qlm value per term.
+    std::vector<unsigned int> m3_index; //!< Index of the m3 qlm value per term.
+    std::vector<float> coefficient;     //!< Wigner 3j coefficient per term.
+
+    size_t size() const
+    {
+        return coefficient.size();
+    }
+};
+
+//! Get the resolved term list for one l.
+/*! Term lists are built once per process and served from a cache like the
+ *  large-l coefficient tables, so the returned references stay valid.
+ */
+const Wigner3jTerms& getWigner3jTerms(unsigned int l);
+
+//! Reduce a block of contiguous qlm rows with a resolved term list.
+/*! source points at the first of n_rows particle rows of num_ms complex
+ *  values each; out[i] receives the invariant of row i. Full blocks run the
+ *  terms with one particle per vector lane, staged through a transposed
+ *  scratch buffer so every term loads its three qlm values as contiguous
+ *  vectors; each lane accumulates its particle's terms in list order, so the
+ *  results are identical to calling reduceWigner3j on each row.
+ */
+void reduceWigner3jBlock(const std::complex<float>* source, size_t num_ms, size_t n_rows,
+                         const Wigner3jTerms& terms, float* out);
 // All Wigner 3j coefficients created using sympy
 /*
 
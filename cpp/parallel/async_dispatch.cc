@@ -0,0 +1,22 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include "async_dispatch.h"
+
+/*! \file async_dispatch.cc
+    \brief Run computes asynchronously in a dedicated TBB arena.
+*/
+
+namespace freud { namespace parallel {
+
+tbb::task_arena& getComputeArena()
+{
+    // Leaked intentionally (static storage): workers may still be draining
+    // the arena during interpreter shutdown, and tearing it down then races
+    // with them. The automatic concurrency defers to the global_control
+    // limit installed by setNumThreads.
+    static tbb::task_arena arena(tbb::task_arena::automatic);
+    return arena;
+}
+
+}; }; // end namespace freud::parallel
@@ -0,0 +1,100 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef ASYNC_DISPATCH_H
+#define ASYNC_DISPATCH_H
+
+#include <future>
+#include <memory>
+#include <tbb/task_arena.h>
+#include <utility>
+
+/*! \file async_dispatch.h
+    \brief Run computes asynchronously in a dedicated TBB arena.
+*/
+
+namespace freud { namespace parallel {
+
+//! Get the arena that asynchronous computes are enqueued into.
+/*! The arena is created on first use and shared by all computes; its
+    concurrency follows the global thread limit set via setNumThreads. Running
+    computes here rather than on the calling thread lets the caller (typically
+    the Python interpreter decoding the next trajectory frame) proceed while
+    the worker threads crunch the current one.
+*/
+tbb::task_arena& getComputeArena();
+
+//! Handle to a compute that may still be running in the arena.
+/*! Compute classes hold one of these and funnel their asynchronous entry
+    points through launch(). Calling wait() from the synchronous accessors
+    (reduce, getters, reset) makes results safe to read at any time: either no
+    compute is in flight and wait() returns immediately, or the caller blocks
+    until the enqueued work finishes. An exception thrown by the enqueued
+    compute is rethrown from the first wait() after it.
+
+    The handle is not itself thread safe; the intended pattern is a single
+    driving thread that enqueues work and later reads results, while the
+    parallelism lives inside the enqueued compute.
+*/
+class AsyncHandle
+{
+public:
+    AsyncHandle() = default;
+
+    //! Block on any in-flight compute before the handle goes away.
+    /*! The enqueued lambdas capture their compute object by pointer, so the
+        handle (a member of that object) must not be destroyed out from under
+        running work. A compute that threw has nowhere to rethrow to here, so
+        its exception is swallowed; callers that care must wait() themselves.
+    */
+    ~AsyncHandle()
+    {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {}
+    }
+
+    // Copying or moving the handle cannot transfer the pointer captured by
+    // the enqueued work, so neither is allowed.
+    AsyncHandle(const AsyncHandle&) = delete;
+    AsyncHandle& operator=(const AsyncHandle&) = delete;
+    AsyncHandle(AsyncHandle&&) = delete;
+    AsyncHandle& operator=(AsyncHandle&&) = delete;
+
+    //! Enqueue a callable into the compute arena.
+    /*! Any compute already in flight on this handle is waited for first, so
+        successive launches on one object run in order.
+    */
+    template<typename F> void launch(F&& f)
+    {
+        wait();
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(f));
+        m_future = task->get_future().share();
+        getComputeArena().enqueue([task]() { (*task)(); });
+    }
+
+    //! Block until the enqueued compute (if any) finishes.
+    /*! Rethrows the compute's exception, if it threw one, exactly once.
+     */
+    void wait()
+    {
+        if (m_future.valid())
+        {
+            // Clear before get() so a throwing compute does not rethrow from
+            // every subsequent accessor.
+            std::shared_future<void> future = std::move(m_future);
+            m_future = std::shared_future<void>();
+            future.get();
+        }
+    }
+
+private:
+    std::shared_future<void> m_future; //!< Completion of the last enqueued compute.
+};
+
+}; }; // end namespace freud::parallel
+
+#endif // ASYNC_DISPATCH_H
@@ -6,6 +6,7 @@
 
 #define TBB_PREVIEW_GLOBAL_CONTROL 1
 #include <tbb/global_control.h>
+#include <vector>
 
 /*! \file tbb_config.h
     \brief Helper functions to configure tbb
@@ -16,6 +17,9 @@ namespace freud { namespace parallel {
 //! Set the number of TBB threads
 void setNumThreads(unsigned int N);
 
+//! Pin freud's TBB threads to a set of CPU cores
+void setThreadAffinity(const std::vector<unsigned int>& cpus);
+
 }; }; // end namespace freud::parallel
 
 #endif // TBB_CONFIG_H
@@ -0,0 +1,401 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef PMFT_KERNELS_H
+#define PMFT_KERNELS_H
+
+#include <cmath>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "BatchTrig.h"
+#include "Box.h"
+#include "Histogram.h"
+#include "utils.h"
+
+/*! \file PMFTKernels.h
+    \brief Fused bond transform and binning kernels for the PMFT classes.
+
+    Each PMFT stages its per-bond inputs into a fixed-size block and hands the
+    full block to the kernel matching its geometry, which performs the
+    coordinate transform, every axis binning step, and the histogram updates
+    in one pass. This replaces the per-bond scalar trigonometry and the
+    generic N-dimensional histogram lookup with vectorized arithmetic over
+    eight bonds at a time; partially filled blocks fall through to a scalar
+    loop that reproduces the per-bond math exactly.
+*/
+
+namespace freud { namespace pmft {
+
+//! Number of bonds staged per thread before a fused binning kernel runs.
+constexpr size_t BOND_BLOCK_SIZE = 8;
+
+//! Axis parameters cached out of a RegularAxis for the fused kernels.
+struct AxisParams
+{
+    explicit AxisParams(const util::RegularAxis& axis)
+        : nbins(axis.size()), min(axis.getMin()), max(axis.getMax()),
+          inverse_bin_width(axis.getInverseBinWidth())
+    {}
+
+    //! Bin a value along this axis, mirroring RegularAxis::bin().
+    /*! Returns false for out-of-range values, which are dropped just as the
+     * histogram drops them via the overflow sentinel.
+     */
+    bool bin(float value, size_t& bin) const
+    {
+        if (value < min || value >= max)
+        {
+            return false;
+        }
+        bin = size_t((value - min) * inverse_bin_width);
+        // Avoid rounding leading to overflow.
+        if (bin == nbins)
+        {
+            --bin;
+        }
+        return true;
+    }
+
+    size_t nbins;
+    float min;
+    float max;
+    float inverse_bin_width;
+};
+
+//! Cache the parameters of one of a bond histogram's regular axes.
+inline AxisParams axisParams(const util::Histogram<unsigned int>& histogram, size_t axis)
+{
+    return AxisParams(dynamic_cast<const util::RegularAxis&>(*histogram.getAxes()[axis]));
+}
+
+//! Compile-time tag selecting the fused kernel for one PMFT geometry.
+enum PMFTGeometry
+{
+    r12,
+    xy,
+    xyt,
+    xyz
+};
+
+//! Per-thread staging buffer of bond inputs for one PMFT geometry.
+/*! Each specialization holds exactly the per-bond quantities its kernel
+ * consumes, laid out as one array per quantity so that the kernel can load
+ * whole lanes at once.
+ */
+template<PMFTGeometry Geometry> struct BondBlock;
+
+//! R12 bonds: the in-plane separation, its length, and both particle angles.
+template<> struct BondBlock<r12>
+{
+    float dx[BOND_BLOCK_SIZE];
+    float dy[BOND_BLOCK_SIZE];
+    float r[BOND_BLOCK_SIZE];
+    float orientation[BOND_BLOCK_SIZE];
+    float query_orientation[BOND_BLOCK_SIZE];
+    size_t count = 0;
+};
+
+//! XY bonds: the in-plane separation and the negated query orientation whose
+//! sine and cosine rotate it into the query particle's frame. The kernel
+//! evaluates both together, eight wide, rather than per staged bond.
+template<> struct BondBlock<xy>
+{
+    float dx[BOND_BLOCK_SIZE];
+    float dy[BOND_BLOCK_SIZE];
+    float angle[BOND_BLOCK_SIZE];
+    size_t count = 0;
+};
+
+//! XYT bonds: the XY inputs plus the point orientation for the torque angle.
+template<> struct BondBlock<xyt>
+{
+    float dx[BOND_BLOCK_SIZE];
+    float dy[BOND_BLOCK_SIZE];
+    float angle[BOND_BLOCK_SIZE];
+    float orientation[BOND_BLOCK_SIZE];
+    size_t count = 0;
+};
+
+//! XYZ bonds: separations already rotated into the query particle's frame.
+template<> struct BondBlock<xyz>
+{
+    float x[BOND_BLOCK_SIZE];
+    float y[BOND_BLOCK_SIZE];
+    float z[BOND_BLOCK_SIZE];
+    size_t count = 0;
+};
+
+#if defined(__AVX__)
+
+//! Bin eight values along one axis, folding the range check into a mask.
+/*! Out-of-range lanes are cleared from in_range rather than producing the
+ * overflow sentinel; the truncated indices of masked lanes are garbage and
+ * must not be committed.
+ */
+inline __m256i binAxisBlock(__m256 value, const AxisParams& axis, __m256& in_range)
+{
+    const __m256 v_min = _mm256_set1_ps(axis.min);
+    in_range = _mm256_and_ps(
+        in_range,
+        _mm256_and_ps(_mm256_cmp_ps(value, v_min, _CMP_GE_OQ),
+                      _mm256_cmp_ps(value, _mm256_set1_ps(axis.max), _CMP_LT_OQ)));
+    return _mm256_cvttps_epi32(
+        _mm256_mul_ps(_mm256_sub_ps(value, v_min), _mm256_set1_ps(axis.inverse_bin_width)));
+}
+
+//! Commit a block of two-axis bin indices to the histogram.
+/*! Increments to arbitrary bins cannot be vectorized without conflict
+ * detection, so the surviving lanes are committed serially. The top bin edge
+ * is clamped per axis exactly like RegularAxis::bin().
+ */
+inline void scatterBlock(const int* bins0, const int* bins1, int mask, const AxisParams* axes,
+                         util::Histogram<unsigned int>& hist)
+{
+    for (int lane = 0; lane < int(BOND_BLOCK_SIZE); ++lane)
+    {
+        if ((mask & (1 << lane)) != 0)
+        {
+            size_t bin0 = bins0[lane];
+            size_t bin1 = bins1[lane];
+            // Avoid rounding leading to overflow.
+            if (bin0 == axes[0].nbins)
+            {
+                --bin0;
+            }
+            if (bin1 == axes[1].nbins)
+            {
+                --bin1;
+            }
+            hist.increment(bin0 * axes[1].nbins + bin1);
+        }
+    }
+}
+
+//! Commit a block of three-axis bin indices to the histogram.
+inline void scatterBlock(const int* bins0, const int* bins1, const int* bins2, int mask,
+                         const AxisParams* axes, util::Histogram<unsigned int>& hist)
+{
+    for (int lane = 0; lane < int(BOND_BLOCK_SIZE); ++lane)
+    {
+        if ((mask & (1 << lane)) != 0)
+        {
+            size_t bin0 = bins0[lane];
+            size_t bin1 = bins1[lane];
+            size_t bin2 = bins2[lane];
+            // Avoid rounding leading to overflow.
+            if (bin0 == axes[0].nbins)
+            {
+                --bin0;
+            }
+            if (bin1 == axes[1].nbins)
+            {
+                --bin1;
+            }
+            if (bin2 == axes[2].nbins)
+            {
+                --bin2;
+            }
+            hist.increment((bin0 * axes[1].nbins + bin1) * axes[2].nbins + bin2);
+        }
+    }
+}
+
+#endif
+
+//! Transform and bin a staged block of bonds for one PMFT geometry.
+/*! The axes array caches one AxisParams per histogram axis, in axis order.
+ * Full blocks take the vectorized path when AVX is available; partial blocks
+ * and builds without AVX reproduce the original per-bond arithmetic. Only
+ * the float accuracy of the polynomial trigonometry in BatchTrig.h
+ * distinguishes the vectorized angles from the scalar ones.
+ */
+template<PMFTGeometry Geometry>
+void binBondBlock(const BondBlock<Geometry>& block, const AxisParams* axes,
+                  util::Histogram<unsigned int>& hist);
+
+template<>
+inline void binBondBlock<r12>(const BondBlock<r12>& block, const AxisParams* axes,
+                              util::Histogram<unsigned int>& hist)
+{
+    size_t b = 0;
+#if defined(__AVX__)
+    if (block.count == BOND_BLOCK_SIZE)
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.0F);
+        const __m256 two_pi = _mm256_set1_ps(constants::TWO_PI);
+        const __m256 dx = _mm256_loadu_ps(block.dx);
+        const __m256 dy = _mm256_loadu_ps(block.dy);
+        // t1 and t2 measure each particle's orientation against the bond
+        // direction seen from its own side, wrapped into 0..2*Pi.
+        const __m256 t1 = util::modulusPositiveBlock(
+            _mm256_sub_ps(_mm256_loadu_ps(block.orientation), util::atan2Block(dy, dx)), two_pi);
+        const __m256 t2 = util::modulusPositiveBlock(
+            _mm256_sub_ps(_mm256_loadu_ps(block.query_orientation),
+                          util::atan2Block(_mm256_xor_ps(dy, sign_mask), _mm256_xor_ps(dx, sign_mask))),
+            two_pi);
+        __m256 in_range = _mm256_cmp_ps(_mm256_setzero_ps(), _mm256_setzero_ps(), _CMP_EQ_OQ);
+        alignas(32) int r_bins[BOND_BLOCK_SIZE];
+        alignas(32) int t1_bins[BOND_BLOCK_SIZE];
+        alignas(32) int t2_bins[BOND_BLOCK_SIZE];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(r_bins),
+                           binAxisBlock(_mm256_loadu_ps(block.r), axes[0], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(t1_bins), binAxisBlock(t1, axes[1], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(t2_bins), binAxisBlock(t2, axes[2], in_range));
+        scatterBlock(r_bins, t1_bins, t2_bins, _mm256_movemask_ps(in_range), axes, hist);
+        b = block.count;
+    }
+#endif
+    for (; b < block.count; ++b)
+    {
+        const float d_theta1 = std::atan2(block.dy[b], block.dx[b]);
+        const float d_theta2 = std::atan2(-block.dy[b], -block.dx[b]);
+        float t1 = block.orientation[b] - d_theta1;
+        float t2 = block.query_orientation[b] - d_theta2;
+        // make sure that t1, t2 are bounded between 0 and 2PI
+        t1 = util::modulusPositive(t1, constants::TWO_PI);
+        t2 = util::modulusPositive(t2, constants::TWO_PI);
+        size_t bin_r = 0;
+        size_t bin_t1 = 0;
+        size_t bin_t2 = 0;
+        if (axes[0].bin(block.r[b], bin_r) && axes[1].bin(t1, bin_t1) && axes[2].bin(t2, bin_t2))
+        {
+            hist.increment((bin_r * axes[1].nbins + bin_t1) * axes[2].nbins + bin_t2);
+        }
+    }
+}
+
+template<>
+inline void binBondBlock<xy>(const BondBlock<xy>& block, const AxisParams* axes,
+                             util::Histogram<unsigned int>& hist)
+{
+    size_t b = 0;
+#if defined(__AVX__)
+    if (block.count == BOND_BLOCK_SIZE)
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.0F);
+        const __m256 dx = _mm256_loadu_ps(block.dx);
+        const __m256 dy = _mm256_loadu_ps(block.dy);
+        __m256 s;
+        __m256 c;
+        util::sinCosBlock(_mm256_loadu_ps(block.angle), s, c);
+        // Rotate the separation into the query particle's frame; the sum
+        // order matches the scalar rotation so the results agree bit for bit.
+        const __m256 rx
+            = _mm256_add_ps(_mm256_mul_ps(c, dx), _mm256_mul_ps(_mm256_xor_ps(s, sign_mask), dy));
+        const __m256 ry = _mm256_add_ps(_mm256_mul_ps(s, dx), _mm256_mul_ps(c, dy));
+        __m256 in_range = _mm256_cmp_ps(_mm256_setzero_ps(), _mm256_setzero_ps(), _CMP_EQ_OQ);
+        alignas(32) int x_bins[BOND_BLOCK_SIZE];
+        alignas(32) int y_bins[BOND_BLOCK_SIZE];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(x_bins), binAxisBlock(rx, axes[0], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(y_bins), binAxisBlock(ry, axes[1], in_range));
+        scatterBlock(x_bins, y_bins, _mm256_movemask_ps(in_range), axes, hist);
+        b = block.count;
+    }
+#endif
+    for (; b < block.count; ++b)
+    {
+        const float c = std::cos(block.angle[b]);
+        const float s = std::sin(block.angle[b]);
+        const float rx = c * block.dx[b] + (-s) * block.dy[b];
+        const float ry = s * block.dx[b] + c * block.dy[b];
+        size_t bin_x = 0;
+        size_t bin_y = 0;
+        if (axes[0].bin(rx, bin_x) && axes[1].bin(ry, bin_y))
+        {
+            hist.increment(bin_x * axes[1].nbins + bin_y);
+        }
+    }
+}
+
+template<>
+inline void binBondBlock<xyt>(const BondBlock<xyt>& block, const AxisParams* axes,
+                              util::Histogram<unsigned int>& hist)
+{
+    size_t b = 0;
+#if defined(__AVX__)
+    if (block.count == BOND_BLOCK_SIZE)
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.0F);
+        const __m256 dx = _mm256_loadu_ps(block.dx);
+        const __m256 dy = _mm256_loadu_ps(block.dy);
+        __m256 s;
+        __m256 c;
+        util::sinCosBlock(_mm256_loadu_ps(block.angle), s, c);
+        const __m256 rx
+            = _mm256_add_ps(_mm256_mul_ps(c, dx), _mm256_mul_ps(_mm256_xor_ps(s, sign_mask), dy));
+        const __m256 ry = _mm256_add_ps(_mm256_mul_ps(s, dx), _mm256_mul_ps(c, dy));
+        const __m256 t = util::modulusPositiveBlock(
+            _mm256_sub_ps(_mm256_loadu_ps(block.orientation),
+                          util::atan2Block(_mm256_xor_ps(dy, sign_mask), _mm256_xor_ps(dx, sign_mask))),
+            _mm256_set1_ps(constants::TWO_PI));
+        __m256 in_range = _mm256_cmp_ps(_mm256_setzero_ps(), _mm256_setzero_ps(), _CMP_EQ_OQ);
+        alignas(32) int x_bins[BOND_BLOCK_SIZE];
+        alignas(32) int y_bins[BOND_BLOCK_SIZE];
+        alignas(32) int t_bins[BOND_BLOCK_SIZE];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(x_bins), binAxisBlock(rx, axes[0], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(y_bins), binAxisBlock(ry, axes[1], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(t_bins), binAxisBlock(t, axes[2], in_range));
+        scatterBlock(x_bins, y_bins, t_bins, _mm256_movemask_ps(in_range), axes, hist);
+        b = block.count;
+    }
+#endif
+    for (; b < block.count; ++b)
+    {
+        const float c = std::cos(block.angle[b]);
+        const float s = std::sin(block.angle[b]);
+        const float rx = c * block.dx[b] + (-s) * block.dy[b];
+        const float ry = s * block.dx[b] + c * block.dy[b];
+        const float d_theta = std::atan2(-block.dy[b], -block.dx[b]);
+        float t = block.orientation[b] - d_theta;
+        // make sure that t is bounded between 0 and 2PI
+        t = util::modulusPositive(t, constants::TWO_PI);
+        size_t bin_x = 0;
+        size_t bin_y = 0;
+        size_t bin_t = 0;
+        if (axes[0].bin(rx, bin_x) && axes[1].bin(ry, bin_y) && axes[2].bin(t, bin_t))
+        {
+            hist.increment((bin_x * axes[1].nbins + bin_y) * axes[2].nbins + bin_t);
+        }
+    }
+}
+
+template<>
+inline void binBondBlock<xyz>(const BondBlock<xyz>& block, const AxisParams* axes,
+                              util::Histogram<unsigned int>& hist)
+{
+    size_t b = 0;
+#if defined(__AVX__)
+    if (block.count == BOND_BLOCK_SIZE)
+    {
+        __m256 in_range = _mm256_cmp_ps(_mm256_setzero_ps(), _mm256_setzero_ps(), _CMP_EQ_OQ);
+        alignas(32) int x_bins[BOND_BLOCK_SIZE];
+        alignas(32) int y_bins[BOND_BLOCK_SIZE];
+        alignas(32) int z_bins[BOND_BLOCK_SIZE];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(x_bins),
+                           binAxisBlock(_mm256_loadu_ps(block.x), axes[0], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(y_bins),
+                           binAxisBlock(_mm256_loadu_ps(block.y), axes[1], in_range));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(z_bins),
+                           binAxisBlock(_mm256_loadu_ps(block.z), axes[2], in_range));
+        scatterBlock(x_bins, y_bins, z_bins, _mm256_movemask_ps(in_range), axes, hist);
+        b = block.count;
+    }
+#endif
+    for (; b < block.count; ++b)
+    {
+        size_t bin_x = 0;
+        size_t bin_y = 0;
+        size_t bin_z = 0;
+        if (axes[0].bin(block.x[b], bin_x) && axes[1].bin(block.y[b], bin_y)
+            && axes[2].bin(block.z[b], bin_z))
+        {
+            hist.increment((bin_x * axes[1].nbins + bin_y) * axes[2].nbins + bin_z);
+        }
+    }
+}
+
+}; }; // end namespace freud::pmft
+
+#endif // PMFT_KERNELS_H
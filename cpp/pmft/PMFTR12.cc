@@ -2,7 +2,9 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
 
+#include "PMFTKernels.h"
 #include "PMFTR12.h"
 #include "utils.h"
 
@@ -80,19 +82,37 @@ void PMFTR12::accumulate(const locality::NeighborQuery* neighbor_query, const fl
                          freud::locality::QueryArgs qargs)
 {
     neighbor_query->getBox().enforce2D();
+    const AxisParams axes[3]
+        = {axisParams(m_histogram, 0), axisParams(m_histogram, 1), axisParams(m_histogram, 2)};
+    tbb::enumerable_thread_specific<BondBlock<r12>> blocks;
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [&](const freud::locality::NeighborBond& neighbor_bond) {
                           vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
-                          // calculate angles
-                          float d_theta1 = std::atan2(delta.y, delta.x);
-                          float d_theta2 = std::atan2(-delta.y, -delta.x);
-                          float t1 = orientations[neighbor_bond.point_idx] - d_theta1;
-                          float t2 = query_orientations[neighbor_bond.query_point_idx] - d_theta2;
-                          // make sure that t1, t2 are bounded between 0 and 2PI
-                          t1 = util::modulusPositive(t1, constants::TWO_PI);
-                          t2 = util::modulusPositive(t2, constants::TWO_PI);
-                          m_local_histograms(neighbor_bond.distance, t1, t2);
+                          // The angles t1 and t2 and all three binning steps
+                          // are evaluated by the fused kernel once a full
+                          // block of bonds is staged.
+                          BondBlock<r12>& block = blocks.local();
+                          block.dx[block.count] = delta.x;
+                          block.dy[block.count] = delta.y;
+                          block.r[block.count] = neighbor_bond.distance;
+                          block.orientation[block.count] = orientations[neighbor_bond.point_idx];
+                          block.query_orientation[block.count]
+                              = query_orientations[neighbor_bond.query_point_idx];
+                          if (++block.count == BOND_BLOCK_SIZE)
+                          {
+                              binBondBlock(block, axes, m_local_histograms.local());
+                              block.count = 0;
+                          }
                       });
+    // Drain the partially filled per-thread blocks. This runs serially after
+    // the parallel loop, and the reduction sums over every thread's local
+    // histogram, so the calling thread's copy is a valid target for all of
+    // the leftovers.
+    for (auto& block : blocks)
+    {
+        binBondBlock(block, axes, m_local_histograms.local());
+        block.count = 0;
+    }
 }
 
 }; }; // end namespace freud::pmft
@@ -1,8 +1,13 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <cmath>
+#include <memory>
 #include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
 
+#include "PMFTKernels.h"
 #include "PMFTXY.h"
 
 /*! \file PMFTXY.cc
@@ -60,18 +65,72 @@ void PMFTXY::accumulate(const locality::NeighborQuery* neighbor_query, const flo
                         const locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
 {
     neighbor_query->getBox().enforce2D();
+    const AxisParams axes[2] = {axisParams(m_histogram, 0), axisParams(m_histogram, 1)};
+    tbb::enumerable_thread_specific<BondBlock<xy>> blocks;
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [&](const freud::locality::NeighborBond& neighbor_bond) {
                           vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
 
-                          // rotate interparticle vector
-                          vec2<float> myVec(delta.x, delta.y);
-                          rotmat2<float> myMat
-                              = rotmat2<float>::fromAngle(-query_orientations[neighbor_bond.query_point_idx]);
-                          vec2<float> rotVec = myMat * myVec;
-
-                          m_local_histograms(rotVec.x, rotVec.y);
+                          // Stage the separation along with the negated
+                          // query orientation; the fused kernel evaluates the
+                          // rotation's sine and cosine, applies it, and runs
+                          // both binning steps once a full block is staged.
+                          BondBlock<xy>& block = blocks.local();
+                          block.dx[block.count] = delta.x;
+                          block.dy[block.count] = delta.y;
+                          block.angle[block.count] = -query_orientations[neighbor_bond.query_point_idx];
+                          if (++block.count == BOND_BLOCK_SIZE)
+                          {
+                              binBondBlock(block, axes, m_local_histograms.local());
+                              block.count = 0;
+                          }
                       });
+    // Drain the partially filled per-thread blocks. This runs serially after
+    // the parallel loop, and the reduction sums over every thread's local
+    // histogram, so the calling thread's copy is a valid target for all of
+    // the leftovers.
+    for (auto& block : blocks)
+    {
+        binBondBlock(block, axes, m_local_histograms.local());
+        block.count = 0;
+    }
+}
+
+locality::BondConsumer PMFTXY::makeBondConsumer(const locality::NeighborQuery* neighbor_query,
+                                                const float* query_orientations,
+                                                const vec3<float>* query_points)
+{
+    neighbor_query->getBox().enforce2D();
+    // The staging blocks and axis parameters are shared between the per-bond
+    // kernel and the drain, and must outlive this call; the consumer's
+    // lambdas keep them alive for the duration of the composite's traversal.
+    auto blocks = std::make_shared<tbb::enumerable_thread_specific<BondBlock<xy>>>();
+    auto axes = std::make_shared<std::vector<AxisParams>>(
+        std::vector<AxisParams> {axisParams(m_histogram, 0), axisParams(m_histogram, 1)});
+
+    locality::BondConsumer consumer;
+    consumer.compute = this;
+    consumer.bond = [this, blocks, axes, neighbor_query, query_orientations,
+                     query_points](const freud::locality::NeighborBond& neighbor_bond) {
+        vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+        BondBlock<xy>& block = blocks->local();
+        block.dx[block.count] = delta.x;
+        block.dy[block.count] = delta.y;
+        block.angle[block.count] = -query_orientations[neighbor_bond.query_point_idx];
+        if (++block.count == BOND_BLOCK_SIZE)
+        {
+            binBondBlock(block, axes->data(), m_local_histograms.local());
+            block.count = 0;
+        }
+    };
+    consumer.drain = [this, blocks, axes]() {
+        for (auto& block : *blocks)
+        {
+            binBondBlock(block, axes->data(), m_local_histograms.local());
+            block.count = 0;
+        }
+    };
+    return consumer;
 }
 
 }; }; // end namespace freud::pmft
@@ -4,6 +4,7 @@
 #ifndef PMFTXY_H
 #define PMFTXY_H
 
+#include "CompositeCompute.h"
 #include "PMFT.h"
 
 /*! \file PMFTXY.h
@@ -25,6 +26,17 @@ public:
                     const vec3<float>* query_points, unsigned int n_query_points,
                     const locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
 
+    //! Get this PMFT's per-bond kernel for a shared traversal.
+    /*! The returned consumer performs the same staged accumulation as
+     *  accumulate; registering it with a CompositeCompute lets the PMFT
+     *  share one neighbor traversal with other computes on the same frame.
+     *  The input arrays must stay alive until the composite's accumulate
+     *  call returns.
+     */
+    locality::BondConsumer makeBondConsumer(const locality::NeighborQuery* neighbor_query,
+                                            const float* query_orientations,
+                                            const vec3<float>* query_points);
+
 protected:
     //! \internal
     //! helper function to reduce the thread specific arrays into one array
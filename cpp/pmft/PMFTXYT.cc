@@ -1,8 +1,11 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <cmath>
 #include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
 
+#include "PMFTKernels.h"
 #include "PMFTXYT.h"
 #include "utils.h"
 
@@ -68,21 +71,37 @@ void PMFTXYT::accumulate(const locality::NeighborQuery* neighbor_query, const fl
                          freud::locality::QueryArgs qargs)
 {
     neighbor_query->getBox().enforce2D();
+    const AxisParams axes[3]
+        = {axisParams(m_histogram, 0), axisParams(m_histogram, 1), axisParams(m_histogram, 2)};
+    tbb::enumerable_thread_specific<BondBlock<xyt>> blocks;
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [&](const freud::locality::NeighborBond& neighbor_bond) {
                           vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
 
-                          // rotate interparticle vector
-                          vec2<float> myVec(delta.x, delta.y);
-                          rotmat2<float> myMat
-                              = rotmat2<float>::fromAngle(-query_orientations[neighbor_bond.query_point_idx]);
-                          vec2<float> rotVec = myMat * myVec;
-                          // calculate angle
-                          float d_theta = std::atan2(-delta.y, -delta.x);
-                          float t = orientations[neighbor_bond.point_idx] - d_theta;
-                          // make sure that t is bounded between 0 and 2PI
-                          t = util::modulusPositive(t, constants::TWO_PI);
-                          m_local_histograms(rotVec.x, rotVec.y, t);
+                          // Stage the separation, the negated query
+                          // orientation, and the point orientation; the fused
+                          // kernel evaluates and applies the rotation, finds
+                          // the torque angle t, and runs all three binning
+                          // steps once a full block is staged.
+                          BondBlock<xyt>& block = blocks.local();
+                          block.dx[block.count] = delta.x;
+                          block.dy[block.count] = delta.y;
+                          block.angle[block.count] = -query_orientations[neighbor_bond.query_point_idx];
+                          block.orientation[block.count] = orientations[neighbor_bond.point_idx];
+                          if (++block.count == BOND_BLOCK_SIZE)
+                          {
+                              binBondBlock(block, axes, m_local_histograms.local());
+                              block.count = 0;
+                          }
                       });
+    // Drain the partially filled per-thread blocks. This runs serially after
+    // the parallel loop, and the reduction sums over every thread's local
+    // histogram, so the calling thread's copy is a valid target for all of
+    // the leftovers.
+    for (auto& block : blocks)
+    {
+        binBondBlock(block, axes, m_local_histograms.local());
+        block.count = 0;
+    }
 }
 }; }; // end namespace freud::pmft
@@ -1,8 +1,11 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include "PMFTKernels.h"
 #include "PMFTXYZ.h"
+#include "utils.h"
 #include <stdexcept>
+#include <vector>
 
 /*! \file PMFTXYZ.cc
     \brief Routines for computing 3D potential of mean force in XYZ coordinates
@@ -11,8 +14,9 @@
 namespace freud { namespace pmft {
 
 PMFTXYZ::PMFTXYZ(float x_max, float y_max, float z_max, unsigned int n_x, unsigned int n_y, unsigned int n_z,
-                 const vec3<float>& shiftvec)
-    : PMFT(), m_shiftvec(shiftvec), m_num_equiv_orientations(0xffffffff)
+                 const vec3<float>& shiftvec, bool sparse, bool cache_rotations)
+    : PMFT(), m_shiftvec(shiftvec), m_num_equiv_orientations(0xffffffff), m_sparse(sparse),
+      m_cache_rotations(cache_rotations)
 {
     if (n_x < 1)
     {
@@ -85,6 +89,28 @@ void PMFTXYZ::reduce()
     float prefactor = inv_num_dens * norm_factor;
 
     float jacobian_factor = (float) 1.0 / m_jacobian;
+    if (m_sparse)
+    {
+        // Merge the per-thread sparse maps into the dense histogram, then
+        // normalize the occupied bins; prepare() above zeroed everything, so
+        // untouched bins keep the zero the dense reduction would give them.
+        for (auto& counts : m_local_sparse_counts)
+        {
+            for (const auto& entry : counts)
+            {
+                m_histogram.increment(entry.first, entry.second);
+            }
+        }
+        for (auto& counts : m_local_sparse_counts)
+        {
+            for (const auto& entry : counts)
+            {
+                m_pcf_array[entry.first]
+                    = static_cast<float>(m_histogram[entry.first]) * prefactor * jacobian_factor;
+            }
+        }
+        return;
+    }
     m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor, &jacobian_factor](size_t i) {
         m_pcf_array[i] = static_cast<float>(m_histogram[i]) * prefactor * jacobian_factor;
     });
@@ -94,6 +120,10 @@ void PMFTXYZ::reset()
 {
     BondHistogramCompute::reset();
     m_num_equiv_orientations = 0xffffffff;
+    for (auto& counts : m_local_sparse_counts)
+    {
+        counts.clear();
+    }
 }
 
 void PMFTXYZ::accumulate(const locality::NeighborQuery* neighbor_query, const quat<float>* query_orientations,
@@ -113,24 +143,105 @@ void PMFTXYZ::accumulate(const locality::NeighborQuery* neighbor_query, const qu
             "The number of equivalent orientations must be constant while accumulating data into PMFTXYZ.");
     }
     neighbor_query->getBox().enforce3D();
-    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
-                      [&](const freud::locality::NeighborBond& neighbor_bond) {
-                          // create the reference point quaternion
-                          quat<float> query_orientation(query_orientations[neighbor_bond.query_point_idx]);
-                          // make sure that the particles are wrapped into the box
-                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
-
-                          for (unsigned int k = 0; k < num_equiv_orientations; k++)
-                          {
-                              // create point vector
-                              vec3<float> v(delta);
-                              // rotate the vector
-                              v = rotate(conj(query_orientation), v);
-                              v = rotate(equiv_orientations[k], v);
-
-                              m_local_histograms(v.x, v.y, v.z);
-                          }
-                      });
+    // Cache the axis parameters for the fused kernel and the sparse path.
+    const AxisParams axes[3]
+        = {axisParams(m_histogram, 0), axisParams(m_histogram, 1), axisParams(m_histogram, 2)};
+    tbb::enumerable_thread_specific<BondBlock<xyz>> blocks;
+    // Stage or bin one fully rotated bond vector; shared by both rotation
+    // strategies below.
+    auto commit = [&](const vec3<float>& v) {
+        if (!m_sparse)
+        {
+            // Stage the rotated bond; the fused kernel runs all three
+            // binning steps once a full block is staged.
+            BondBlock<xyz>& block = blocks.local();
+            block.x[block.count] = v.x;
+            block.y[block.count] = v.y;
+            block.z[block.count] = v.z;
+            if (++block.count == BOND_BLOCK_SIZE)
+            {
+                binBondBlock(block, axes, m_local_histograms.local());
+                block.count = 0;
+            }
+            return;
+        }
+        size_t bin_x = 0;
+        size_t bin_y = 0;
+        size_t bin_z = 0;
+        if (axes[0].bin(v.x, bin_x) && axes[1].bin(v.y, bin_y) && axes[2].bin(v.z, bin_z))
+        {
+            ++m_local_sparse_counts.local()[(bin_x * axes[1].nbins + bin_y) * axes[2].nbins + bin_z];
+        }
+    };
+    if (m_cache_rotations)
+    {
+        // Compose every equivalent orientation with each query particle's
+        // conjugated orientation once per frame. Each bond then needs only
+        // matrix-vector products, at a memory cost of one matrix per
+        // particle per equivalent orientation.
+        std::vector<rotmat3<float>> cached_rotations(size_t(n_query_points) * num_equiv_orientations);
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const quat<float> query_conj = conj(query_orientations[i]);
+                for (unsigned int k = 0; k < num_equiv_orientations; k++)
+                {
+                    cached_rotations[i * num_equiv_orientations + k]
+                        = rotmat3<float>(equiv_orientations[k] * query_conj);
+                }
+            }
+        });
+        accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                          [&](const freud::locality::NeighborBond& neighbor_bond) {
+                              // make sure that the particles are wrapped into the box
+                              const vec3<float> delta(
+                                  bondVector(neighbor_bond, neighbor_query, query_points));
+                              const rotmat3<float>* rotations = cached_rotations.data()
+                                  + size_t(neighbor_bond.query_point_idx) * num_equiv_orientations;
+                              for (unsigned int k = 0; k < num_equiv_orientations; k++)
+                              {
+                                  commit(rotations[k] * delta);
+                              }
+                          });
+    }
+    else
+    {
+        // Each equivalent orientation rotates every bond vector, so convert
+        // each one to its rotation matrix once; applying the precomputed
+        // matrix per bond is much cheaper than the quaternion rotation
+        // identity.
+        std::vector<rotmat3<float>> equiv_rotations;
+        equiv_rotations.reserve(num_equiv_orientations);
+        for (unsigned int k = 0; k < num_equiv_orientations; k++)
+        {
+            equiv_rotations.emplace_back(rotmat3<float>(equiv_orientations[k]));
+        }
+        accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
+                          [&](const freud::locality::NeighborBond& neighbor_bond) {
+                              // create the reference point quaternion
+                              quat<float> query_orientation(
+                                  query_orientations[neighbor_bond.query_point_idx]);
+                              // make sure that the particles are wrapped into the box
+                              vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+
+                              // rotate the bond into the query particle's frame once, then
+                              // apply each equivalent orientation to the rotated vector
+                              delta = rotate(conj(query_orientation), delta);
+                              for (unsigned int k = 0; k < num_equiv_orientations; k++)
+                              {
+                                  commit(equiv_rotations[k] * delta);
+                              }
+                          });
+    }
+    // Drain the partially filled per-thread blocks. This runs serially after
+    // the parallel loop, and the reduction sums over every thread's local
+    // histogram, so the calling thread's copy is a valid target for all of
+    // the leftovers.
+    for (auto& block : blocks)
+    {
+        binBondBlock(block, axes, m_local_histograms.local());
+        block.count = 0;
+    }
 }
 
 }; }; // end namespace freud::pmft
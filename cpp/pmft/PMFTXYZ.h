@@ -4,6 +4,9 @@
 #ifndef PMFTXYZ_H
 #define PMFTXYZ_H
 
+#include <tbb/enumerable_thread_specific.h>
+#include <unordered_map>
+
 #include "PMFT.h"
 
 /*! \file PMFTXYZ.h
@@ -16,8 +19,23 @@ class PMFTXYZ : public PMFT
 {
 public:
     //! Constructor
+    /*! When sparse is true, bond counts accumulate into per-thread hash maps
+     *  keyed by linear bin index instead of per-thread dense copies of the
+     *  histogram, and the maps are merged into the single dense histogram
+     *  during the reduction. This trades a small per-sample cost for memory
+     *  proportional to the number of occupied bins per thread, which matters
+     *  at resolutions where thread-local dense copies do not fit in memory.
+     *
+     *  When cache_rotations is true, each call to accumulate composes every
+     *  equivalent orientation with every query particle's conjugated
+     *  orientation once, caching the combined rotation matrices for reuse
+     *  across all of that particle's bonds. This removes the per-bond
+     *  quaternion rotation entirely at a memory cost of nine floats per
+     *  particle per equivalent orientation, which pays off for high-symmetry
+     *  systems where each particle has many neighbors.
+     */
     PMFTXYZ(float x_max, float y_max, float z_max, unsigned int n_x, unsigned int n_y, unsigned int n_z,
-            const vec3<float>& shiftvec);
+            const vec3<float>& shiftvec, bool sparse = false, bool cache_rotations = false);
 
     /*! Compute the PCF for the passed in set of points. The function will be added to previous values
         of the pcf
@@ -41,6 +59,10 @@ protected:
     vec3<float> m_shiftvec;                //!< vector that points from [0,0,0] to the origin of the pmft
     unsigned int m_num_equiv_orientations; //!< The number of equivalent orientations used in the current
                                            //!< calls to compute.
+    bool m_sparse; //!< Whether bond counts accumulate into sparse per-thread maps.
+    bool m_cache_rotations; //!< Whether per-particle symmetrized rotations are cached per frame.
+    //! Per-thread bond counts by linear bin index, used when m_sparse is set.
+    tbb::enumerable_thread_specific<std::unordered_map<size_t, unsigned int>> m_local_sparse_counts;
 };
 
 }; }; // end namespace freud::pmft
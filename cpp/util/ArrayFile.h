@@ -0,0 +1,384 @@
+#ifndef ARRAY_FILE_H
+#define ARRAY_FILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ManagedArray.h"
+
+/*! \file ArrayFile.h
+    \brief Binary, memory-map-compatible serialization of ManagedArray data.
+
+    An array file holds any number of named sections, each a single
+    multidimensional array with an element type tag. Section data begins on a
+    64-byte boundary (matching ManagedArray::ALIGNMENT), so a reader can map
+    the whole file and hand out ManagedArray views that point straight into
+    the mapping: nothing is copied at load time and pages fault in lazily as
+    the arrays are actually touched. The mapping is private (copy-on-write),
+    so consumers that modify a loaded array dirty only their own pages and
+    never the file.
+*/
+
+namespace freud { namespace util {
+
+//! Element type tags stored in array file section headers.
+enum class ArrayDType : uint32_t
+{
+    uint32 = 0,
+    int32 = 1,
+    uint64 = 2,
+    float32 = 3,
+    float64 = 4
+};
+
+//! Map element types to their ArrayDType tag at compile time.
+template<typename T> struct ArrayDTypeOf;
+template<> struct ArrayDTypeOf<unsigned int>
+{
+    static constexpr ArrayDType value = ArrayDType::uint32;
+};
+template<> struct ArrayDTypeOf<int>
+{
+    static constexpr ArrayDType value = ArrayDType::int32;
+};
+template<> struct ArrayDTypeOf<uint64_t>
+{
+    static constexpr ArrayDType value = ArrayDType::uint64;
+};
+template<> struct ArrayDTypeOf<float>
+{
+    static constexpr ArrayDType value = ArrayDType::float32;
+};
+template<> struct ArrayDTypeOf<double>
+{
+    static constexpr ArrayDType value = ArrayDType::float64;
+};
+
+namespace detail {
+
+//! Fixed-layout file header; the section table lives at table_offset.
+struct ArrayFileHeader
+{
+    char magic[8];         //!< "FREUDARR"
+    uint32_t version;      //!< Format version, currently 1.
+    uint32_t num_sections; //!< Number of entries in the section table.
+    uint64_t table_offset; //!< Byte offset of the section table.
+};
+static_assert(sizeof(ArrayFileHeader) == 24, "ArrayFileHeader must have a fixed 24-byte layout.");
+
+//! Fixed-layout descriptor of one named array section.
+struct ArraySectionHeader
+{
+    char name[16];     //!< Null-terminated section name (at most 15 characters).
+    uint32_t dtype;    //!< Element type tag (an ArrayDType value).
+    uint32_t ndim;     //!< Number of dimensions used in shape.
+    uint64_t shape[4]; //!< Extent of each dimension; unused entries are zero.
+    uint64_t offset;   //!< Byte offset of the section data, 64-byte aligned.
+    uint64_t bytes;    //!< Byte length of the section data.
+};
+static_assert(sizeof(ArraySectionHeader) == 72, "ArraySectionHeader must have a fixed 72-byte layout.");
+
+constexpr size_t SECTION_ALIGNMENT = ManagedArray<float>::ALIGNMENT;
+constexpr uint32_t ARRAY_FILE_VERSION = 1;
+constexpr char ARRAY_FILE_MAGIC[8] = {'F', 'R', 'E', 'U', 'D', 'A', 'R', 'R'};
+
+}; // namespace detail
+
+//! Shared ownership of one memory-mapped (or, on Windows, fully read) file.
+/*! The mapping stays alive as long as any ManagedArray view into it exists;
+ *  ArrayFileReader hands this object to ManagedArray::wrap as the owner
+ *  handle. The map is private and writable, so views behave like ordinary
+ *  memory under modification without affecting the file.
+ */
+class MappedFile
+{
+public:
+    //! Map the given file, throwing std::runtime_error on failure.
+    static std::shared_ptr<const MappedFile> map(const std::string& path)
+    {
+        std::shared_ptr<MappedFile> file(new MappedFile());
+#ifdef _WIN32
+        // No mmap on Windows; fall back to reading the file into memory. The
+        // zero-copy property is lost but the format and API are unchanged.
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream)
+        {
+            throw std::runtime_error("Could not open array file " + path + ".");
+        }
+        file->m_size = static_cast<size_t>(stream.tellg());
+        file->m_buffer.reset(new char[file->m_size]);
+        stream.seekg(0);
+        stream.read(file->m_buffer.get(), static_cast<std::streamsize>(file->m_size));
+        file->m_data = file->m_buffer.get();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not open array file " + path + ".");
+        }
+        struct stat file_info = {};
+        if (::fstat(fd, &file_info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Could not stat array file " + path + ".");
+        }
+        file->m_size = static_cast<size_t>(file_info.st_size);
+        void* mapping = ::mmap(nullptr, file->m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error("Could not map array file " + path + ".");
+        }
+        file->m_data = static_cast<char*>(mapping);
+#endif
+        return file;
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (m_data != nullptr)
+        {
+            ::munmap(m_data, m_size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! Base address of the file contents.
+    /*! Mutable because the mapping is copy-on-write; writes land in private
+     *  pages, never in the file.
+     */
+    char* data() const
+    {
+        return m_data;
+    }
+
+    //! Length of the file in bytes.
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    MappedFile() = default;
+
+    char* m_data {nullptr}; //!< Mapped (or read) file contents.
+    size_t m_size {0};      //!< File length in bytes.
+#ifdef _WIN32
+    std::unique_ptr<char[]> m_buffer; //!< Backing storage for the read fallback.
+#endif
+};
+
+//! Write named ManagedArray sections into one array file.
+/*! Sections are appended in write order with their data aligned to 64 bytes;
+ *  the section table and final header are written on close (or destruction).
+ */
+class ArrayFileWriter
+{
+public:
+    explicit ArrayFileWriter(const std::string& path)
+        : m_stream(path, std::ios::binary | std::ios::trunc), m_path(path)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("Could not create array file " + path + ".");
+        }
+        // Placeholder header; rewritten with real values on close.
+        const detail::ArrayFileHeader header = {};
+        m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    ~ArrayFileWriter()
+    {
+        if (m_stream.is_open())
+        {
+            close();
+        }
+    }
+
+    ArrayFileWriter(const ArrayFileWriter&) = delete;
+    ArrayFileWriter& operator=(const ArrayFileWriter&) = delete;
+
+    //! Append one array as a named section.
+    template<typename T> void write(const std::string& name, const ManagedArray<T>& array)
+    {
+        const std::vector<size_t> shape = array.shape();
+        if (name.empty() || name.size() >= sizeof(detail::ArraySectionHeader::name))
+        {
+            throw std::invalid_argument("Array file section names must be 1 to 15 characters long.");
+        }
+        if (shape.size() > 4)
+        {
+            throw std::invalid_argument("Array files support at most 4 dimensions per section.");
+        }
+
+        detail::ArraySectionHeader section = {};
+        std::memcpy(section.name, name.c_str(), name.size());
+        section.dtype = static_cast<uint32_t>(ArrayDTypeOf<T>::value);
+        section.ndim = static_cast<uint32_t>(shape.size());
+        for (size_t i = 0; i < shape.size(); ++i)
+        {
+            section.shape[i] = shape[i];
+        }
+        section.bytes = array.size() * sizeof(T);
+        section.offset = padToAlignment();
+        m_sections.push_back(section);
+
+        m_stream.write(reinterpret_cast<const char*>(array.get()),
+                       static_cast<std::streamsize>(section.bytes));
+    }
+
+    //! Write the section table and header, then close the file.
+    void close()
+    {
+        detail::ArrayFileHeader header = {};
+        std::memcpy(header.magic, detail::ARRAY_FILE_MAGIC, sizeof(header.magic));
+        header.version = detail::ARRAY_FILE_VERSION;
+        header.num_sections = static_cast<uint32_t>(m_sections.size());
+        header.table_offset = padToAlignment();
+
+        for (const auto& section : m_sections)
+        {
+            m_stream.write(reinterpret_cast<const char*>(&section), sizeof(section));
+        }
+        m_stream.seekp(0);
+        m_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_stream.close();
+        if (!m_stream)
+        {
+            throw std::runtime_error("Failed to write array file " + m_path + ".");
+        }
+    }
+
+private:
+    //! Pad the stream to the next 64-byte boundary and return the new offset.
+    uint64_t padToAlignment()
+    {
+        const auto position = static_cast<uint64_t>(m_stream.tellp());
+        const uint64_t padded
+            = (position + detail::SECTION_ALIGNMENT - 1) / detail::SECTION_ALIGNMENT * detail::SECTION_ALIGNMENT;
+        for (uint64_t i = position; i < padded; ++i)
+        {
+            m_stream.put('\0');
+        }
+        return padded;
+    }
+
+    std::ofstream m_stream;                                //!< The file being written.
+    std::string m_path;                                    //!< Path, for error messages.
+    std::vector<detail::ArraySectionHeader> m_sections;    //!< Table written on close.
+};
+
+//! Read named ManagedArray sections from a mapped array file without copying.
+/*! The file is mapped once on construction; each read() returns a
+ *  ManagedArray viewing the mapped section directly, holding the mapping
+ *  alive for as long as the array (or any copy of it) exists. Untouched
+ *  sections are never paged in.
+ */
+class ArrayFileReader
+{
+public:
+    explicit ArrayFileReader(const std::string& path) : m_file(MappedFile::map(path))
+    {
+        detail::ArrayFileHeader header = {};
+        if (m_file->size() < sizeof(header))
+        {
+            throw std::runtime_error(path + " is not an array file.");
+        }
+        std::memcpy(&header, m_file->data(), sizeof(header));
+        if (std::memcmp(header.magic, detail::ARRAY_FILE_MAGIC, sizeof(header.magic)) != 0)
+        {
+            throw std::runtime_error(path + " is not an array file.");
+        }
+        if (header.version != detail::ARRAY_FILE_VERSION)
+        {
+            throw std::runtime_error(path + " uses an unsupported array file version.");
+        }
+        const uint64_t table_bytes = uint64_t(header.num_sections) * sizeof(detail::ArraySectionHeader);
+        if (header.table_offset + table_bytes > m_file->size())
+        {
+            throw std::runtime_error(path + " has a truncated section table.");
+        }
+        m_sections.resize(header.num_sections);
+        std::memcpy(m_sections.data(), m_file->data() + header.table_offset,
+                    static_cast<size_t>(table_bytes));
+        for (const auto& section : m_sections)
+        {
+            if (section.offset % detail::SECTION_ALIGNMENT != 0
+                || section.offset + section.bytes > m_file->size())
+            {
+                throw std::runtime_error(path + " has a corrupt section table.");
+            }
+        }
+    }
+
+    //! Whether a section with the given name exists.
+    bool contains(const std::string& name) const
+    {
+        return findSection(name) != nullptr;
+    }
+
+    //! Get a zero-copy view of the named section.
+    template<typename T> ManagedArray<T> read(const std::string& name) const
+    {
+        const detail::ArraySectionHeader* section = findSection(name);
+        if (section == nullptr)
+        {
+            throw std::invalid_argument("Array file has no section named " + name + ".");
+        }
+        if (section->dtype != static_cast<uint32_t>(ArrayDTypeOf<T>::value))
+        {
+            throw std::invalid_argument("Array file section " + name
+                                        + " does not hold the requested element type.");
+        }
+        std::vector<size_t> shape(section->ndim);
+        size_t size = 1;
+        for (uint32_t i = 0; i < section->ndim; ++i)
+        {
+            shape[i] = section->shape[i];
+            size *= shape[i];
+        }
+        if (size * sizeof(T) != section->bytes)
+        {
+            throw std::runtime_error("Array file section " + name + " has inconsistent shape and length.");
+        }
+        return ManagedArray<T>::wrap(reinterpret_cast<T*>(m_file->data() + section->offset), shape, m_file);
+    }
+
+private:
+    const detail::ArraySectionHeader* findSection(const std::string& name) const
+    {
+        for (const auto& section : m_sections)
+        {
+            if (name == section.name)
+            {
+                return &section;
+            }
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<const MappedFile> m_file;           //!< The mapped file, shared with views.
+    std::vector<detail::ArraySectionHeader> m_sections; //!< Parsed section table.
+};
+
+}; }; // namespace freud::util
+
+#endif // ARRAY_FILE_H
@@ -0,0 +1,146 @@
+#ifndef COMPUTE_PROFILE_H
+#define COMPUTE_PROFILE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
+
+/*! \file ComputeProfile.h
+    \brief Lightweight per-compute timing and counter instrumentation.
+*/
+
+namespace freud { namespace util {
+
+//! Per-compute phase timers and work counters.
+/*! Each compute object owns one profile that splits its wall time between
+ *  the accumulation phase (neighbor iteration plus per-bond work) and the
+ *  reduction phase, and counts the bonds processed. The instrumentation is
+ *  always compiled in: it costs two clock reads per phase and one
+ *  thread-local counter increment per bond, which is negligible next to the
+ *  per-bond work of any compute. The counters persist across frames until
+ *  the compute is reset, so production runs can be profiled by sampling the
+ *  totals without rerunning under an external profiler.
+ */
+class ComputeProfile
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    //! The phases a compute's wall time is split between.
+    enum Phase
+    {
+        accumulate_phase = 0,
+        reduce_phase = 1
+    };
+
+    //! Add the lifetime of this object to one phase of a profile.
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(ComputeProfile& profile, Phase phase)
+            : m_profile(profile), m_phase(phase), m_start(Clock::now())
+        {}
+
+        ~ScopedTimer()
+        {
+            m_profile.addTime(m_phase, std::chrono::duration<double>(Clock::now() - m_start).count());
+        }
+
+        // The timer is tied to one scope and may not be copied or moved.
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        ComputeProfile& m_profile;
+        Phase m_phase;
+        Clock::time_point m_start;
+    };
+
+    //! Count one processed bond on the calling thread.
+    /*! Looking up the calling thread's slot in the thread-local container
+     *  costs far more than the increment itself, so each thread caches the
+     *  slot of the profile it counted for last, keyed by an id that is never
+     *  reused. Computes run one at a time per process, so the cache hits on
+     *  every bond after the first and the common case is a single increment.
+     */
+    void countBond()
+    {
+        static thread_local uint64_t cached_id = 0;
+        static thread_local uint64_t* cached_count = nullptr;
+        if (cached_id != m_id)
+        {
+            cached_id = m_id;
+            cached_count = &m_bond_counts.local();
+        }
+        ++*cached_count;
+    }
+
+    //! Add elapsed seconds to one phase and count the call.
+    void addTime(Phase phase, double seconds)
+    {
+        m_seconds[phase] += seconds;
+        ++m_calls[phase];
+    }
+
+    //! Total seconds spent in one phase since the last reset.
+    double getSeconds(Phase phase) const
+    {
+        return m_seconds[phase];
+    }
+
+    //! Number of times one phase ran since the last reset.
+    uint64_t getCalls(Phase phase) const
+    {
+        return m_calls[phase];
+    }
+
+    //! Total bonds processed since the last reset, summed over threads.
+    uint64_t getBondCount() const
+    {
+        uint64_t total = 0;
+        for (const auto& count : m_bond_counts)
+        {
+            total += count;
+        }
+        return total;
+    }
+
+    //! Number of TBB threads the enclosing arena may use.
+    static unsigned int getMaxThreads()
+    {
+        return tbb::this_task_arena::max_concurrency();
+    }
+
+    //! Zero all timers and counters.
+    /*! Clearing the thread-local tallies invalidates any slot a thread may
+     *  have cached, so the profile also takes a fresh id.
+     */
+    void reset()
+    {
+        m_seconds[accumulate_phase] = 0;
+        m_seconds[reduce_phase] = 0;
+        m_calls[accumulate_phase] = 0;
+        m_calls[reduce_phase] = 0;
+        m_bond_counts.clear();
+        m_id = nextId();
+    }
+
+private:
+    //! Hand out process-unique profile ids; 0 is reserved for "no cache".
+    static uint64_t nextId()
+    {
+        static std::atomic<uint64_t> counter {0};
+        return ++counter;
+    }
+
+    double m_seconds[2] {0, 0};   //!< Wall seconds per phase.
+    uint64_t m_calls[2] {0, 0};   //!< Completed runs per phase.
+    uint64_t m_id {nextId()};     //!< Never-reused id keying the per-thread slot caches.
+    tbb::enumerable_thread_specific<uint64_t> m_bond_counts; //!< Per-thread bond tallies.
+};
+
+}; }; // namespace freud::util
+
+#endif // COMPUTE_PROFILE_H
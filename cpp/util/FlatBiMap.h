@@ -0,0 +1,259 @@
+#ifndef FLAT_BIMAP_H
+#define FLAT_BIMAP_H
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/* Flat, small-size-optimized replacement for BiMap.
+ *
+ * BiMap stores each relation as a separately heap-allocated pair indexed by
+ * two node-based std::sets, so every emplace costs three allocations. The
+ * environment-matching code builds and throws away one of these maps per
+ * candidate pair of environments, deep inside the innermost matching loops,
+ * and the maps it builds are tiny (one entry per environment vector, so
+ * typically no more than the neighbor count). FlatBiMap instead keeps the
+ * pairs contiguously in a fixed-capacity inline array, spilling to a heap
+ * vector only for environments larger than InlineCapacity, and resolves
+ * lookups on either side by linear scan, which at these sizes is faster than
+ * any tree traversal. Building, copying, and destroying a FlatBiMap that fits
+ * inline performs no allocations at all.
+ *
+ * The interface mirrors the subset of BiMap that the matching code uses:
+ *
+ *     bool emplace(Value_A, Value_B)  -- rejects duplicates on either side
+ *     void insert (const std::pair<Value_A, Value_B>&)
+ *     left[a]  -> b for the unique pair (a, b), throws if absent
+ *     right[b] -> a for the unique pair (a, b), throws if absent
+ *     asMap(), size(), empty(), clear(), iteration over std::pair values
+ *
+ * Unlike BiMap, the left/right subscript operators are lookups only and never
+ * insert a default-constructed entry, and iteration yields pair references
+ * rather than pointers.
+ */
+
+template<typename T, typename U, std::size_t InlineCapacity = 16> class FlatBiMap
+{
+public:
+    using Pair = std::pair<T, U>;
+    using iterator = Pair*;
+    using const_iterator = const Pair*;
+
+private:
+    std::array<Pair, InlineCapacity> m_inline;
+    std::vector<Pair> m_overflow;
+    std::size_t m_size {0};
+
+    //! All pairs live inline until the capacity is exceeded, after which they
+    //  all live in the overflow vector.
+    const Pair* data() const
+    {
+        return m_overflow.empty() ? m_inline.data() : m_overflow.data();
+    }
+
+    Pair* data()
+    {
+        return m_overflow.empty() ? m_inline.data() : m_overflow.data();
+    }
+
+public:
+    FlatBiMap() = default;
+
+    template<typename I, typename J> bool emplace(I&& Arg1_in, J&& Arg2_in)
+    {
+        const Pair* pairs = data();
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            if (pairs[i].first == Arg1_in || pairs[i].second == Arg2_in)
+            {
+                return false;
+            }
+        }
+        Pair pair(std::forward<I>(Arg1_in), std::forward<J>(Arg2_in));
+        if (!m_overflow.empty())
+        {
+            m_overflow.emplace_back(std::move(pair));
+        }
+        else if (m_size < InlineCapacity)
+        {
+            m_inline[m_size] = std::move(pair);
+        }
+        else
+        {
+            // Spill everything to the heap; from here on the inline array is
+            // dead storage.
+            m_overflow.assign(m_inline.begin(), m_inline.end());
+            m_overflow.emplace_back(std::move(pair));
+        }
+        ++m_size;
+        return true;
+    }
+
+    void insert(const Pair& Pair_in)
+    {
+        this->emplace(Pair_in.first, Pair_in.second);
+    }
+
+    // Return a std::map equivalent to this object.
+    std::map<T, U> asMap() const
+    {
+        std::map<T, U> ret;
+        const Pair* pairs = data();
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            ret[pairs[i].first] = pairs[i].second;
+        }
+        return ret;
+    }
+
+    class left_view
+    {
+        friend FlatBiMap;
+
+    private:
+        const FlatBiMap& b() const
+        {
+            FlatBiMap t;
+            return *reinterpret_cast<const FlatBiMap*>(
+                reinterpret_cast<const char*>((const void*) this)
+                - (((size_t) (&(&t)->left) - ((size_t) &t))));
+        }
+
+    public:
+        const U& at(const T& Key_in) const
+        {
+            const FlatBiMap& parent = b();
+            const Pair* pairs = parent.data();
+            for (std::size_t i = 0; i < parent.m_size; ++i)
+            {
+                if (pairs[i].first == Key_in)
+                {
+                    return pairs[i].second;
+                }
+            }
+            throw std::out_of_range {"Key not found"};
+        }
+
+        const U& operator[](const T& Key_in) const
+        {
+            return at(Key_in);
+        }
+
+        bool has(const T& Key_in) const
+        {
+            const FlatBiMap& parent = b();
+            const Pair* pairs = parent.data();
+            for (std::size_t i = 0; i < parent.m_size; ++i)
+            {
+                if (pairs[i].first == Key_in)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } left;
+
+    friend class left_view;
+
+    class right_view
+    {
+        friend FlatBiMap;
+
+    private:
+        const FlatBiMap& b() const
+        {
+            FlatBiMap t;
+            return *reinterpret_cast<const FlatBiMap*>(
+                reinterpret_cast<const char*>((const void*) this)
+                - (((size_t) (&(&t)->right) - ((size_t) &t))));
+        }
+
+    public:
+        const T& at(const U& Key_in) const
+        {
+            const FlatBiMap& parent = b();
+            const Pair* pairs = parent.data();
+            for (std::size_t i = 0; i < parent.m_size; ++i)
+            {
+                if (pairs[i].second == Key_in)
+                {
+                    return pairs[i].first;
+                }
+            }
+            throw std::out_of_range {"Key not found"};
+        }
+
+        const T& operator[](const U& Key_in) const
+        {
+            return at(Key_in);
+        }
+
+        bool has(const U& Key_in) const
+        {
+            const FlatBiMap& parent = b();
+            const Pair* pairs = parent.data();
+            for (std::size_t i = 0; i < parent.m_size; ++i)
+            {
+                if (pairs[i].second == Key_in)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } right;
+
+    friend class right_view;
+
+    void clear()
+    {
+        m_overflow.clear();
+        m_size = 0;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + m_size;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + m_size;
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+};
+
+#endif // FLAT_BIMAP_H
@@ -1,13 +1,18 @@
 #ifndef HISTOGRAM_H
 #define HISTOGRAM_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
 #include <sstream>
+#include <stdexcept>
 #include <tbb/enumerable_thread_specific.h>
 #include <utility>
 
@@ -167,13 +172,158 @@ public:
         return bin;
     }
 
+    //! Return the precomputed inverse bin width.
+    /*! Exposed so that Histogram can replicate the binning arithmetic of this
+     * axis exactly (including its rounding behavior) in an inlined fast path.
+     */
+    float getInverseBinWidth() const
+    {
+        return m_inverse_bin_width;
+    }
+
 protected:
     float m_bin_width;         //!< Bin width
     float m_inverse_bin_width; //!< Inverse of bin width
 };
 
+//! An axis of arbitrarily spaced bins with constant-time binning.
+/*! Nonuniform spacings (e.g. logarithmic bins covering several decades in one
+ * histogram) cannot use RegularAxis's scale-and-truncate arithmetic, and a
+ * binary search per sample would make binning the per-bond bottleneck. This
+ * axis instead precomputes a uniform lookup table over [min, max): a sample
+ * is scaled into a table cell with one multiply, the cell stores the bin of
+ * its left edge, and a short walk over the true bin edges lands in the
+ * containing bin. The table is sized so that each cell spans at most one bin
+ * boundary (one multiply, one load, and at most one edge comparison per
+ * sample), capped at MAX_TABLE_SIZE entries for pathologically skewed
+ * spacings, where the walk may take a few extra steps.
+ */
+class LookupTableAxis : public Axis
+{
+public:
+    //! Cap on lookup table entries (4 MiB of bin indices).
+    static constexpr size_t MAX_TABLE_SIZE = size_t(1) << 20;
+
+    //! Construct from a strictly increasing vector of nbins + 1 bin edges.
+    explicit LookupTableAxis(const std::vector<float>& bin_edges)
+        : Axis(bin_edges.size() < 2 ? 0 : bin_edges.size() - 1, bin_edges.empty() ? 0 : bin_edges.front(),
+               bin_edges.empty() ? 0 : bin_edges.back())
+    {
+        if (bin_edges.size() < 2)
+        {
+            throw std::invalid_argument("LookupTableAxis requires at least two bin edges.");
+        }
+        float min_width = bin_edges[1] - bin_edges[0];
+        for (size_t i = 0; i < m_nbins; i++)
+        {
+            if (bin_edges[i + 1] <= bin_edges[i])
+            {
+                throw std::invalid_argument("LookupTableAxis requires strictly increasing bin edges.");
+            }
+            min_width = std::min(min_width, bin_edges[i + 1] - bin_edges[i]);
+        }
+        m_bin_edges = bin_edges;
+
+        // One cell per smallest bin width guarantees that no cell spans more
+        // than one bin boundary.
+        const float range = m_max - m_min;
+        auto table_size = static_cast<size_t>(std::ceil(range / min_width));
+        table_size = std::min(std::max(table_size, size_t(4) * m_nbins), MAX_TABLE_SIZE);
+        m_inverse_cell_width = static_cast<float>(table_size) / range;
+        m_table.resize(table_size);
+        size_t current = 0;
+        for (size_t cell = 0; cell < table_size; ++cell)
+        {
+            const float left = m_min + static_cast<float>(cell) / m_inverse_cell_width;
+            while (current + 1 < m_nbins && bin_edges[current + 1] <= left)
+            {
+                ++current;
+            }
+            m_table[cell] = static_cast<unsigned int>(current);
+        }
+    }
+
+    ~LookupTableAxis() override = default;
+
+    //! Build logarithmically spaced bin edges over [min, max].
+    static std::vector<float> logSpacedEdges(size_t nbins, float min, float max)
+    {
+        if (nbins == 0 || min <= 0 || max <= min)
+        {
+            throw std::invalid_argument(
+                "logSpacedEdges requires a nonzero number of bins and 0 < min < max.");
+        }
+        std::vector<float> edges(nbins + 1);
+        const double log_min = std::log(static_cast<double>(min));
+        const double step = (std::log(static_cast<double>(max)) - log_min) / static_cast<double>(nbins);
+        for (size_t i = 0; i <= nbins; i++)
+        {
+            edges[i] = static_cast<float>(std::exp(log_min + static_cast<double>(i) * step));
+        }
+        // Pin the boundaries so range checks use the requested limits exactly.
+        edges.front() = min;
+        edges.back() = max;
+        return edges;
+    }
+
+    //! Find the bin of a value along this axis.
+    /*! The table provides the bin of the sample's cell left edge; the forward
+     * walk crosses the at most one boundary inside the cell, and the backward
+     * walk guards against the cell index rounding up.
+     *
+     * \param value The value to bin
+     *
+     * \return The index of the bin the value falls into.
+     */
+    size_t bin(const float& value) const override
+    {
+        if (value < m_min || value >= m_max)
+        {
+            return OVERFLOW_BIN;
+        }
+        float val = (value - m_min) * m_inverse_cell_width;
+        // fast float to int conversion with truncation
+#ifdef __SSE2__
+        size_t cell = _mm_cvtt_ss2si(_mm_load_ss(&val));
+#else
+        size_t cell = (size_t) (val);
+#endif
+        // Avoid rounding leading to overflow.
+        if (cell >= m_table.size())
+        {
+            cell = m_table.size() - 1;
+        }
+        size_t bin_i = m_table[cell];
+        while (bin_i + 1 < m_nbins && value >= m_bin_edges[bin_i + 1])
+        {
+            ++bin_i;
+        }
+        while (bin_i > 0 && value < m_bin_edges[bin_i])
+        {
+            --bin_i;
+        }
+        return bin_i;
+    }
+
+protected:
+    std::vector<unsigned int> m_table; //!< Bin of each table cell's left edge.
+    float m_inverse_cell_width;        //!< Inverse width of a table cell.
+};
+
 using Axes = std::vector<std::shared_ptr<Axis>>;
 
+//! Compile-time check that every type in a pack is a plain float value.
+/*! Used to select the inlined binning fast path in Histogram::operator(),
+ * which only applies when no Weight is interleaved with the values.
+ */
+template<typename... Ts> struct AllFloatValues : std::true_type
+{};
+
+template<typename T, typename... Ts>
+struct AllFloatValues<T, Ts...>
+    : std::integral_constant<bool, std::is_convertible<T, float>::value && AllFloatValues<Ts...>::value>
+{};
+
 //! An n-dimensional histogram class.
 /*! The Histogram is designed to simplify the most common use of histograms in
  * C++ code, which is looping over a series of values and then binning them. To
@@ -187,6 +337,10 @@ using Axes = std::vector<std::shared_ptr<Axis>>;
 template<typename T> class Histogram
 {
 public:
+    //! Granularity of touched-page tracking, in bins (see enableTouchedTracking).
+    static constexpr size_t TRACK_PAGE_SHIFT = 12;
+    static constexpr size_t TRACK_PAGE_BINS = size_t(1) << TRACK_PAGE_SHIFT;
+
     //! A container for thread-local copies of a provided histogram.
     /*! This container implements the simplest method of enabling parallel-safe
      * accumulation, namely the creation of separate instances on each thread.
@@ -201,10 +355,36 @@ public:
     class ThreadLocalHistogram
     {
     public:
+        //! Bin count above which thread-local copies default to sparse mode.
+        /*! Fine-binned histograms (e.g. PMFTXYZ with 100^3 bins) multiplied
+         * across many threads are mostly zeros, so dense per-frame resets and
+         * reductions dominate. A million bins is roughly where that overhead
+         * starts to matter.
+         */
+        static constexpr size_t SPARSE_THRESHOLD = size_t(1) << 20;
+
         ThreadLocalHistogram() = default;
 
         explicit ThreadLocalHistogram(const Histogram& histogram)
-            : m_local_histograms([histogram]() { return Histogram(histogram.m_axes); })
+            : ThreadLocalHistogram(histogram, histogram.size() >= SPARSE_THRESHOLD)
+        {}
+
+        //! Construct with an explicit choice of dense or sparse local copies.
+        /*! In sparse mode each thread-local copy tracks which pages of bins it
+         * has touched, so reset and reduction costs scale with the bins a
+         * thread actually hit rather than the full histogram size, and pages
+         * no thread writes are never faulted in.
+         */
+        ThreadLocalHistogram(const Histogram& histogram, bool sparse)
+            : m_local_histograms([histogram, sparse]() {
+                  Histogram local(histogram.m_axes);
+                  if (sparse)
+                  {
+                      local.enableTouchedTracking();
+                  }
+                  return local;
+              }),
+              m_sparse(sparse)
         {}
 
         using const_iterator = typename tbb::enumerable_thread_specific<Histogram<T>>::const_iterator;
@@ -256,16 +436,62 @@ public:
             m_local_histograms.local().increment(value_bin, weight);
         }
 
+        //! Number of bins reduced per tile in reduceInto.
+        /*! Each worker streams every thread-local copy through a tile of the
+         * output before moving on, so the tile (and the matching slice of each
+         * local copy) stays cache resident. 8192 bins of a 4-byte type fill
+         * half of a typical 64 KiB L1 cache, leaving room for the local slice
+         * being streamed in.
+         */
+        static constexpr size_t REDUCE_TILE_SIZE = 8192;
+
         // Reduce over histograms into the result array.
         void reduceInto(ManagedArray<T>& result)
         {
             result.reset();
+            // Gather the flat storage of each local copy up front so the hot
+            // loop is raw pointer arithmetic instead of repeated traversal of
+            // the thread-specific container (and bounds-checked indexing) for
+            // every bin.
+            std::vector<const T*> local_counts;
+            for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
+            {
+                local_counts.push_back(hist->m_bin_counts.get());
+            }
+            T* result_counts = result.get();
+            if (m_sparse)
+            {
+                // Only touched pages hold nonzero counts. Different pages of
+                // one copy cover disjoint output ranges, so parallelizing over
+                // each copy's page list in turn is race-free.
+                for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
+                {
+                    const T* counts = hist->m_bin_counts.get();
+                    const std::vector<size_t>& pages = hist->m_touched_pages;
+                    util::forLoopWrapper(0, pages.size(), [&](size_t begin, size_t end) {
+                        for (size_t p = begin; p < end; ++p)
+                        {
+                            const size_t start = pages[p] << TRACK_PAGE_SHIFT;
+                            const size_t stop = std::min(result.size(), start + TRACK_PAGE_BINS);
+                            for (size_t i = start; i < stop; ++i)
+                            {
+                                result_counts[i] += counts[i];
+                            }
+                        }
+                    });
+                }
+                return;
+            }
             util::forLoopWrapper(0, result.size(), [&](size_t begin, size_t end) {
-                for (size_t i = begin; i < end; ++i)
+                for (size_t tile_begin = begin; tile_begin < end; tile_begin += REDUCE_TILE_SIZE)
                 {
-                    for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
+                    const size_t tile_end = std::min(end, tile_begin + REDUCE_TILE_SIZE);
+                    for (const T* counts : local_counts)
                     {
-                        result[i] += hist->m_bin_counts[i];
+                        for (size_t i = tile_begin; i < tile_end; ++i)
+                        {
+                            result_counts[i] += counts[i];
+                        }
                     }
                 }
             });
@@ -273,7 +499,8 @@ public:
 
     protected:
         tbb::enumerable_thread_specific<Histogram<T>>
-            m_local_histograms; //!< The thread-local copies of m_histogram.
+            m_local_histograms;  //!< The thread-local copies of m_histogram.
+        bool m_sparse {false};   //!< Whether local copies track touched pages.
     };
 
     //! Default constructor
@@ -286,6 +513,20 @@ public:
         std::transform(m_axes.begin(), m_axes.end(), sizes.begin(),
                        [](const auto& ax) { return ax->size(); });
         m_bin_counts = ManagedArray<T>(sizes);
+        // Cache the parameters of regularly spaced axes once so that
+        // operator() can bin without a virtual call per axis. Any
+        // non-regular axis disables the fast path for the whole histogram.
+        for (const auto& ax : m_axes)
+        {
+            const auto* regular = dynamic_cast<const RegularAxis*>(ax.get());
+            if (regular == nullptr)
+            {
+                m_regular_axes.clear();
+                break;
+            }
+            m_regular_axes.push_back({regular->getMin(), regular->getMax(), regular->getInverseBinWidth(),
+                                      regular->size()});
+        }
     }
 
     //! Simple convenience for 1D arrays that calls through to the shape based `prepare` function.
@@ -310,15 +551,14 @@ public:
     ~Histogram() = default;
 
     //! Bin value and update the histogram count.
+    /*! When all arguments are plain floats and every axis is a RegularAxis,
+     * binning is dispatched to an inlined path whose dimensionality is fixed
+     * at compile time by the size of the argument pack, avoiding the
+     * per-sample value vector and the virtual bin() call per axis.
+     */
     template<typename... FloatsOrWeight> void operator()(FloatsOrWeight... values)
     {
-        std::pair<std::vector<float>, Weight<T>> value_vector = getValueVector(values...);
-        size_t value_bin = bin(value_vector.first);
-        // Check for sentinel to avoid overflow.
-        if (value_bin != Axis::OVERFLOW_BIN)
-        {
-            m_bin_counts[value_bin] += value_vector.second.value;
-        }
+        accumulate(std::integral_constant<bool, AllFloatValues<FloatsOrWeight...>::value>(), values...);
     }
 
     //! Increment specified linear bin (with a specified weight if desired).
@@ -328,6 +568,7 @@ public:
         if (value_bin != Axis::OVERFLOW_BIN)
         {
             m_bin_counts[value_bin] += weight;
+            markTouched(value_bin);
         }
     }
 
@@ -379,9 +620,36 @@ public:
         return m_bin_counts.shape();
     }
 
+    //! Enable tracking of which pages of bins have been modified.
+    /*! Must be enabled while the bin counts are all zero (e.g. on a freshly
+     * constructed histogram), since only modifications made afterwards are
+     * tracked. With tracking enabled, reset() clears only the touched pages,
+     * so per-frame reset cost scales with the bins actually hit rather than
+     * the histogram size, and never-touched pages are never faulted in.
+     */
+    void enableTouchedTracking()
+    {
+        m_track_touched = true;
+        m_page_touched.assign((m_bin_counts.size() + TRACK_PAGE_BINS - 1) / TRACK_PAGE_BINS, 0);
+        m_touched_pages.clear();
+    }
+
     //! Reset the histogram.
     void reset()
     {
+        if (m_track_touched)
+        {
+            T* counts = m_bin_counts.get();
+            for (size_t page : m_touched_pages)
+            {
+                const size_t start = page << TRACK_PAGE_SHIFT;
+                const size_t stop = std::min(m_bin_counts.size(), start + TRACK_PAGE_BINS);
+                memset((void*) (counts + start), 0, sizeof(T) * (stop - start));
+                m_page_touched[page] = 0;
+            }
+            m_touched_pages.clear();
+            return;
+        }
         m_bin_counts.reset();
     }
 
@@ -486,8 +754,102 @@ public:
     }
 
 protected:
+    //! Cached parameters of a RegularAxis for inlined binning.
+    struct RegularAxisParams
+    {
+        float min;               //!< Lowest value allowed.
+        float max;               //!< Highest value allowed.
+        float inverse_bin_width; //!< Inverse of bin width.
+        size_t nbins;            //!< Number of bins.
+    };
+
+    //! Fast path: all arguments are floats matching the axis count.
+    template<typename... Floats> void accumulate(std::true_type, Floats... values)
+    {
+        if (m_regular_axes.size() == sizeof...(Floats))
+        {
+            const size_t value_bin = binRegular(values...);
+            // Check for sentinel to avoid overflow.
+            if (value_bin != Axis::OVERFLOW_BIN)
+            {
+                m_bin_counts[value_bin] += 1;
+                markTouched(value_bin);
+            }
+            return;
+        }
+        accumulate(std::false_type(), values...);
+    }
+
+    //! General path: assemble a value vector and bin through the Axis objects.
+    template<typename... FloatsOrWeight> void accumulate(std::false_type, FloatsOrWeight... values)
+    {
+        std::pair<std::vector<float>, Weight<T>> value_vector = getValueVector(values...);
+        size_t value_bin = bin(value_vector.first);
+        // Check for sentinel to avoid overflow.
+        if (value_bin != Axis::OVERFLOW_BIN)
+        {
+            m_bin_counts[value_bin] += value_vector.second.value;
+            markTouched(value_bin);
+        }
+    }
+
+    //! Compute the linear bin of a fixed-size set of values on regular axes.
+    /*! This replicates the arithmetic of RegularAxis::bin() exactly (using the
+     * axis's own precomputed inverse bin width) folded with the row-major
+     * linearization of ManagedArray::getIndex, so it produces bit-identical
+     * bins to the general path. The value array lives on the stack and the
+     * loop bound is the pack size, so the compiler can unroll it fully.
+     */
+    template<typename... Floats> size_t binRegular(Floats... values) const
+    {
+        const float vals[sizeof...(Floats)] = {static_cast<float>(values)...};
+        size_t idx = 0;
+        for (size_t ax = 0; ax < sizeof...(Floats); ++ax)
+        {
+            const RegularAxisParams& params = m_regular_axes[ax];
+            const float value = vals[ax];
+            if (value < params.min || value >= params.max)
+            {
+                return Axis::OVERFLOW_BIN;
+            }
+            float val = (value - params.min) * params.inverse_bin_width;
+            // fast float to int conversion with truncation
+#ifdef __SSE2__
+            size_t bin_i = _mm_cvtt_ss2si(_mm_load_ss(&val));
+#else
+            size_t bin_i = (size_t) (val);
+#endif
+            // Avoid rounding leading to overflow.
+            if (bin_i == params.nbins)
+            {
+                --bin_i;
+            }
+            idx = idx * params.nbins + bin_i;
+        }
+        return idx;
+    }
+
     std::vector<std::shared_ptr<Axis>> m_axes; //!< The axes.
+    std::vector<RegularAxisParams> m_regular_axes; //!< Cached axis parameters (empty if any axis is not regular).
     ManagedArray<T> m_bin_counts;              //!< Counts for each bin
+    bool m_track_touched {false};              //!< Whether touched-page tracking is enabled.
+    std::vector<unsigned char> m_page_touched; //!< Per-page touched flag (tracking only).
+    std::vector<size_t> m_touched_pages;       //!< Pages touched since the last reset.
+
+    //! Record the page a modified bin belongs to when tracking is enabled.
+    void markTouched(size_t value_bin)
+    {
+        if (!m_track_touched)
+        {
+            return;
+        }
+        const size_t page = value_bin >> TRACK_PAGE_SHIFT;
+        if (m_page_touched[page] == 0)
+        {
+            m_page_touched[page] = 1;
+            m_touched_pages.push_back(page);
+        }
+    }
 
     //! The base case for type float when constructing a vector of values provided to operator().
     /*! This function and the accompanying recursive function below employ
@@ -528,6 +890,150 @@ protected:
     }
 };
 
+//! Online per-bin moments of the per-frame contributions to a histogram.
+/*! Error bars on accumulated histograms are usually obtained by reanalyzing
+ * the trajectory several times over frame subsets; this class instead tracks
+ * the mean and variance of each bin's per-frame increment in a single pass
+ * using Welford's algorithm. Accumulation proceeds cumulatively in the
+ * thread-local copies, so the tracker reduces them after each frame and
+ * differences consecutive snapshots to recover the frame's own contribution.
+ * Consecutive trajectory frames are correlated, so frames can be gathered
+ * into fixed-size blocks whose means serve as the (approximately
+ * independent) samples; with a block size of one every frame is its own
+ * sample. Enable before the first frame accumulates, since the first
+ * snapshot is differenced against zero.
+ */
+template<typename T> class HistogramMoments
+{
+public:
+    HistogramMoments() = default;
+
+    //! Start tracking for a histogram of the given shape.
+    /*! \param shape The histogram's bin shape.
+     *  \param block_size Number of frames averaged into each sample.
+     */
+    void prepare(const std::vector<size_t>& shape, unsigned int block_size)
+    {
+        if (block_size == 0)
+        {
+            throw std::invalid_argument("HistogramMoments requires a positive block size.");
+        }
+        m_block_size = block_size;
+        m_block_fill = 0;
+        m_n_samples = 0;
+        m_prev.prepare(shape);
+        m_scratch.prepare(shape);
+        m_block_sum.prepare(shape);
+        m_mean.prepare(shape);
+        m_m2.prepare(shape);
+        m_variance.prepare(shape);
+    }
+
+    //! Whether tracking has been enabled.
+    bool enabled() const
+    {
+        return m_block_size != 0;
+    }
+
+    //! Number of complete blocks folded into the moments so far.
+    unsigned int getNumSamples() const
+    {
+        return m_n_samples;
+    }
+
+    //! Record one frame from the given thread-local histogram container.
+    /*! Reduces the container's cumulative counts and updates the running
+     *  block sum with this frame's contribution; when a block completes, its
+     *  mean is folded into the running moments.
+     */
+    template<typename LocalHistograms> void recordFrame(LocalHistograms& local_histograms)
+    {
+        local_histograms.reduceInto(m_scratch);
+        const T* cumulative = m_scratch.get();
+        const T* previous = m_prev.get();
+        float* block_sum = m_block_sum.get();
+        forLoopWrapper(0, m_scratch.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                block_sum[i] += float(cumulative[i]) - float(previous[i]);
+            }
+        });
+        std::swap(m_prev, m_scratch);
+
+        if (++m_block_fill == m_block_size)
+        {
+            m_block_fill = 0;
+            ++m_n_samples;
+            const float inv_block = float(1.0) / float(m_block_size);
+            const float inv_n = float(1.0) / float(m_n_samples);
+            float* mean = m_mean.get();
+            float* m2 = m_m2.get();
+            forLoopWrapper(0, m_mean.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const float sample = block_sum[i] * inv_block;
+                    const float delta = sample - mean[i];
+                    mean[i] += delta * inv_n;
+                    m2[i] += delta * (sample - mean[i]);
+                    block_sum[i] = float(0.0);
+                }
+            });
+        }
+    }
+
+    //! Mean per-sample contribution to each bin.
+    const ManagedArray<float>& getMean() const
+    {
+        return m_mean;
+    }
+
+    //! Sample variance of the per-sample contribution to each bin.
+    /*! Zero everywhere until at least two samples have completed. */
+    const ManagedArray<float>& getVariance()
+    {
+        m_variance.reset();
+        if (m_n_samples > 1)
+        {
+            const float inv_dof = float(1.0) / float(m_n_samples - 1);
+            const float* m2 = m_m2.get();
+            float* variance = m_variance.get();
+            forLoopWrapper(0, m_variance.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    variance[i] = m2[i] * inv_dof;
+                }
+            });
+        }
+        return m_variance;
+    }
+
+    //! Discard all tracked state, keeping the shape and block size.
+    void reset()
+    {
+        if (!enabled())
+        {
+            return;
+        }
+        m_block_fill = 0;
+        m_n_samples = 0;
+        m_prev.reset();
+        m_block_sum.reset();
+        m_mean.reset();
+        m_m2.reset();
+    }
+
+private:
+    unsigned int m_block_size {0}; //!< Frames per sample (0 until prepared).
+    unsigned int m_block_fill {0}; //!< Frames folded into the current block.
+    unsigned int m_n_samples {0};  //!< Number of complete blocks seen.
+    ManagedArray<T> m_prev;        //!< Cumulative counts after the previous frame.
+    ManagedArray<T> m_scratch;     //!< Reduction target for the current frame.
+    ManagedArray<float> m_block_sum; //!< Contributions of the current block so far.
+    ManagedArray<float> m_mean;      //!< Running mean per bin.
+    ManagedArray<float> m_m2;        //!< Running sum of squared deviations per bin.
+    ManagedArray<float> m_variance;  //!< Sample variance, filled on demand.
+};
+
 }; }; // namespace freud::util
 
 #endif
@@ -1,19 +1,119 @@
 #ifndef MANAGED_ARRAY_H
 #define MANAGED_ARRAY_H
 
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
+#include "utils.h"
+
 /*! \file ManagedArray.h
     \brief Defines the standard array class to be used throughout freud.
 */
 
 namespace freud { namespace util {
 
+//! Recycling pool for the buffers backing ManagedArray.
+/*! Computes that output fixed-shape arrays reallocate them every frame
+ *  because Python-side references keep the previous frame's buffer alive at
+ *  prepare() time. When enabled, released buffers are kept in size-keyed free
+ *  lists and handed back to subsequent allocations of the same size instead
+ *  of going through the allocator each frame. The pool is off by default and
+ *  bounded, so enabling it trades a fixed amount of held memory for
+ *  allocation churn.
+ */
+class AlignedBufferPool
+{
+public:
+    //! Maximum total bytes retained in free lists.
+    static constexpr size_t MAX_HELD_BYTES = size_t(1) << 28;
+
+    static AlignedBufferPool& instance()
+    {
+        // Intentionally leaked so that arrays destroyed during program
+        // teardown can still release their buffers safely.
+        static AlignedBufferPool* pool = new AlignedBufferPool();
+        return *pool;
+    }
+
+    //! Enable or disable recycling; disabling frees all held buffers.
+    void setEnabled(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled = enabled;
+        if (!enabled)
+        {
+            clearFreeLists();
+        }
+    }
+
+    bool getEnabled() const
+    {
+        return m_enabled;
+    }
+
+    //! Obtain a buffer of exactly the requested size.
+    char* acquire(size_t bytes)
+    {
+        if (m_enabled)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_free_lists.find(bytes);
+            if (it != m_free_lists.end() && !it->second.empty())
+            {
+                char* buffer = it->second.back();
+                it->second.pop_back();
+                m_held_bytes -= bytes;
+                return buffer;
+            }
+        }
+        return new char[bytes];
+    }
+
+    //! Return a buffer to the pool (or free it if the pool is full or off).
+    void release(char* buffer, size_t bytes)
+    {
+        if (m_enabled)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_enabled && m_held_bytes + bytes <= MAX_HELD_BYTES)
+            {
+                m_free_lists[bytes].push_back(buffer);
+                m_held_bytes += bytes;
+                return;
+            }
+        }
+        delete[] buffer;
+    }
+
+private:
+    AlignedBufferPool() = default;
+
+    void clearFreeLists()
+    {
+        for (auto& entry : m_free_lists)
+        {
+            for (char* buffer : entry.second)
+            {
+                delete[] buffer;
+            }
+        }
+        m_free_lists.clear();
+        m_held_bytes = 0;
+    }
+
+    std::mutex m_mutex;                                        //!< Guards the free lists.
+    std::unordered_map<size_t, std::vector<char*>> m_free_lists; //!< Buffers keyed by byte size.
+    size_t m_held_bytes {0};                                   //!< Total bytes currently held.
+    bool m_enabled {false};                                    //!< Whether recycling is active.
+};
+
 //! Class to handle the storage of all arrays of numerical data used in freud.
 /*! The purpose of this class is to handle standard memory management, and to
  *  provide an abstraction around the implementation-specific choice of
@@ -75,19 +175,38 @@ public:
         prepare(std::vector<size_t> {new_size});
     }
 
+    //! Alignment (in bytes) of the underlying data pointer.
+    /*! Allocations are padded and adjusted so that SIMD kernels can assume
+     *  aligned loads from get().
+     */
+    static constexpr size_t ALIGNMENT = 64;
+
     //! Prepare for writing new data.
-    /*! This function always resets the array to contain zeros, but it will
-     * also reallocate if there are other ManagedArrays pointing to the data in
-     * order to ensure that those array references are not invalidated when
-     * this function clears the data.
+    /*! By default this function resets the array to contain zeros, but it
+     * will also reallocate if there are other ManagedArrays pointing to the
+     * data in order to ensure that those array references are not invalidated
+     * when this function clears the data.
+     *
+     * When the shape is unchanged and this array is the sole owner of its
+     * buffer, prepare() is guaranteed not to touch the allocator: per-frame
+     * calls with a stable shape only zero the existing storage. Frame loops
+     * can therefore call prepare() unconditionally; reallocation happens only
+     * on a real shape change or when outstanding references (typically
+     * Python-side views of the previous frame) must be preserved.
      *
      *  \param new_shape Shape of the array to allocate.
      *  \param force Reallocate regardless of whether anything changed or needs to be persisted.
+     *  \param zero Whether to zero the data. Callers that overwrite every
+     *              element before reading may pass false to skip the fill
+     *              (the contents are unspecified until written).
      */
-    void prepare(const std::vector<size_t>& new_shape, bool force = false)
+    void prepare(const std::vector<size_t>& new_shape, bool force = false, bool zero = true)
     {
-        // If we resized, or if there are outstanding references, we create a new array. No matter what,
-        // reset.
+        // Every prepare() call marks the start of a new output: bump the
+        // shared generation counter so snapshots taken earlier (typically
+        // Python-side views) can tell they no longer reflect this array.
+        ++(*m_generation);
+        // If we resized, or if there are outstanding references, we create a new array.
         if (force || (m_data.use_count() > 1) || (new_shape != shape()))
         {
             m_shape = std::make_shared<std::vector<size_t>>(new_shape);
@@ -98,23 +217,43 @@ public:
                 (*m_size) *= (*m_shape)[i];
             }
 
-            // We make use of C-style arrays here rather than any alternative
+            // We make use of raw storage here rather than any alternative
             // because we need the underlying data representation to be
             // compatible with numpy on the Python side. We _could_ do this
             // with a different data structure like std::vector, but it would
             // require writing additional gymnastics to ensure proper reference
             // management and should be carefully considered before any rewrite.
-            m_data = std::shared_ptr<std::shared_ptr<T>>(new std::shared_ptr<T>(
-                new T[size()], std::default_delete<T[]>())); // NOLINT(modernize-avoid-c-arrays)
+            m_data = std::shared_ptr<std::shared_ptr<T>>(new std::shared_ptr<T>(allocate(size())));
+        }
+        if (zero)
+        {
+            reset();
         }
-        reset();
     }
 
+    //! Array size (in bytes) above which reset() zeroes in parallel.
+    static constexpr size_t PARALLEL_RESET_BYTES = size_t(1) << 20;
+
     //! Reset the contents of array to be 0.
+    /*! Large arrays are zeroed in parallel chunks. Besides the bandwidth win,
+     *  on NUMA machines this spreads the first touch of freshly allocated
+     *  pages across the worker threads, so subsequent parallel access hits
+     *  memory interleaved over the nodes the workers run on rather than
+     *  concentrated on the calling thread's node.
+     */
     void reset()
     {
+        ++(*m_generation);
         if (size() != 0)
         {
+            if (size() * sizeof(T) >= PARALLEL_RESET_BYTES)
+            {
+                T* data = get();
+                util::forLoopWrapper(0, size(), [data](size_t begin, size_t end) {
+                    memset((void*) (data + begin), 0, sizeof(T) * (end - begin));
+                });
+                return;
+            }
             memset((void*) get(), 0, sizeof(T) * size());
         }
     }
@@ -172,6 +311,22 @@ public:
         return *m_size;
     }
 
+    //! Generation counter of this array's contents.
+    /*! The counter increments whenever a compute starts overwriting the
+     *  array (prepare() or a direct reset()), and is shared between all
+     *  ManagedArray handles of the same data -- including the copies the
+     *  Python bindings hold to keep buffers alive. A consumer holding such a
+     *  zero-copy view can therefore record the generation it captured and
+     *  compare against the current value to decide whether the view is still
+     *  the array's latest output: because prepare() forks a fresh buffer
+     *  whenever outside references exist, a stale view's data stays valid and
+     *  unchanged, it just no longer reflects the newest compute.
+     */
+    uint64_t getGeneration() const
+    {
+        return *m_generation;
+    }
+
     //! Get the shape of the current array.
     std::vector<size_t> shape() const
     {
@@ -327,6 +482,34 @@ public:
         return getIndex(*m_shape, indices);
     }
 
+    //! Wrap externally owned memory without copying.
+    /*! The returned array points directly at data; no allocation or copy is
+     *  performed. The owner handle is held for the lifetime of the wrapping
+     *  data pointer (and any arrays copy-assigned from it), keeping the
+     *  backing storage -- typically a memory-mapped file -- alive. Callers
+     *  must ensure data meets any alignment their consumers assume and should
+     *  treat wrapped arrays as read-mostly: prepare() on a wrapped array
+     *  zeroes or replaces the view like any other array, it does not write
+     *  through to the original backing store's source.
+     *
+     *  \param data Pointer to size() elements laid out row-major per shape.
+     *  \param shape Shape of the wrapped array.
+     *  \param owner Opaque handle kept alive as long as the data is referenced.
+     */
+    static ManagedArray wrap(T* data, const std::vector<size_t>& shape, std::shared_ptr<const void> owner)
+    {
+        ManagedArray array;
+        array.m_shape = std::make_shared<std::vector<size_t>>(shape);
+        array.m_size = std::make_shared<size_t>(1);
+        for (const size_t dim : shape)
+        {
+            (*array.m_size) *= dim;
+        }
+        array.m_data = std::shared_ptr<std::shared_ptr<T>>(
+            new std::shared_ptr<T>(data, [owner](T*) mutable { owner.reset(); }));
+        return array;
+    }
+
     //! Return a copy of this array.
     /*! The returned object is a deep copy in the sense that it will copy every
      * element of the stored array. However, if the stored elements are
@@ -344,6 +527,24 @@ public:
     }
 
 private:
+    //! Allocate 64-byte-aligned storage for n elements.
+    /*! The buffer is over-allocated by ALIGNMENT bytes and the data pointer
+     *  adjusted up to the next boundary; the deleter hands the original
+     *  buffer back to the AlignedBufferPool (which frees it unless recycling
+     *  is enabled). The types stored in ManagedArrays are trivially copyable
+     *  (scalars, vector math types, std::complex) -- reset() already relies
+     *  on this by zeroing with memset -- so element construction is skipped.
+     */
+    static std::shared_ptr<T> allocate(size_t n)
+    {
+        const size_t bytes = n * sizeof(T) + ALIGNMENT;
+        char* raw = AlignedBufferPool::instance().acquire(bytes);
+        const size_t offset = ALIGNMENT - (reinterpret_cast<std::uintptr_t>(raw) % ALIGNMENT);
+        T* data = reinterpret_cast<T*>(raw + offset);
+        return std::shared_ptr<T>(data,
+                                  [raw, bytes](T*) { AlignedBufferPool::instance().release(raw, bytes); });
+    }
+
     //! The base case for building up the index.
     /*! These argument building functions are templated on two types, one that
      *  encapsulates the current object being operated on and the other being
@@ -369,6 +570,10 @@ private:
     std::shared_ptr<std::shared_ptr<T>> m_data;   //!< Pointer to array.
     std::shared_ptr<std::vector<size_t>> m_shape; //!< Shape of array.
     std::shared_ptr<size_t> m_size;               //!< Size of array.
+    //! Contents generation counter. Shared across copies like the data
+    //! pointers (and unlike them, never replaced), so every handle of an
+    //! array observes the bumps from every other handle.
+    std::shared_ptr<uint64_t> m_generation {std::make_shared<uint64_t>(0)};
 };
 
 }; }; // end namespace freud::util
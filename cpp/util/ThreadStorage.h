@@ -10,6 +10,10 @@ namespace freud { namespace util {
 
 //! Wrapper class for enumerable_thread_specific<T*>
 /*! It is expected that default value for T is 0.
+ *
+ *  Each thread's array is created (and zeroed) lazily by the first local()
+ *  call on that thread, so on NUMA machines first-touch policy places each
+ *  copy on the memory node of the thread that uses it.
  */
 template<typename T> class ThreadStorage
 {
@@ -28,8 +32,9 @@ public:
     /*! \param shape Vector of sizes in each dimension of the thread local arrays
      */
     explicit ThreadStorage(const std::vector<size_t>& shape)
-        : arrays(
-            tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); }))
+        : m_shape(shape),
+          arrays(
+              tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); }))
     {}
 
     //! Destructor
@@ -44,10 +49,23 @@ public:
     }
 
     //! Update size of the thread local arrays
-    /*! \param size New size of the thread local arrays
+    /*! A shape-stable resize zeroes the existing thread-local arrays in
+     *  place rather than discarding and reconstructing them, so a compute
+     *  that keeps its ThreadStorage as a member and resizes it every frame
+     *  allocates nothing once the shape has settled (and each thread's copy
+     *  stays on the NUMA node where it was first touched). Only a genuine
+     *  shape change rebuilds the container.
+     *
+     *  \param shape New shape of the thread local arrays
      */
     void resize(std::vector<size_t> shape)
     {
+        if (shape == m_shape)
+        {
+            reset();
+            return;
+        }
+        m_shape = shape;
         arrays
             = tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); });
     }
@@ -115,9 +133,73 @@ public:
     }
 
 private:
+    std::vector<size_t> m_shape {0}; //!< Shape of the thread local arrays (matches ManagedArray's default).
     tbb::enumerable_thread_specific<ManagedArray<T>> arrays; //!< thread local arrays
 };
 
+//! Reusable pool of growable per-thread buffers.
+/*! Unlike ThreadStorage, whose arrays have a fixed shape and are reset to
+ *  zero, this pool hands out per-thread std::vectors meant for appending an
+ *  unknown number of elements (e.g. neighbor bonds generated by query
+ *  iterators). clear() resets every buffer's size without releasing its
+ *  capacity, so a pool that outlives a single compute reaches a steady state
+ *  where the append path performs no heap allocations at all from one frame
+ *  to the next.
+ */
+template<typename T> class ThreadBufferPool
+{
+public:
+    using Buffer = std::vector<T>;
+    using reference = typename tbb::enumerable_thread_specific<Buffer>::reference;
+
+    //! Default constructor
+    ThreadBufferPool() = default;
+
+    //! Get the calling thread's buffer.
+    reference local()
+    {
+        return m_buffers.local();
+    }
+
+    //! Empty all buffers while keeping their capacity for reuse.
+    void clear()
+    {
+        for (auto& buffer : m_buffers)
+        {
+            buffer.clear();
+        }
+    }
+
+    //! Get the total number of elements across all buffers.
+    size_t size() const
+    {
+        size_t total(0);
+        for (const auto& buffer : m_buffers)
+        {
+            total += buffer.size();
+        }
+        return total;
+    }
+
+    //! Concatenate all buffers into the given vector, reusing its capacity.
+    /*! The output vector is cleared but not shrunk, so repeated gathers into
+     *  the same vector also stop allocating once its capacity has grown to
+     *  the steady-state total.
+     */
+    void gatherInto(std::vector<T>& out) const
+    {
+        out.clear();
+        out.reserve(size());
+        for (const auto& buffer : m_buffers)
+        {
+            out.insert(out.end(), buffer.begin(), buffer.end());
+        }
+    }
+
+private:
+    tbb::enumerable_thread_specific<Buffer> m_buffers; //!< thread local buffers
+};
+
 }; }; // end namespace freud::util
 
 #endif
@@ -1,35 +1,239 @@
+#include <algorithm>
+#include <cmath>
+
+#include "VectorMath.h"
 #include "diagonalize.h"
+#include "utils.h"
 
-namespace freud { namespace util {
+namespace {
 
-void diagonalize33SymmetricMatrix(const util::ManagedArray<float>& mat, util::ManagedArray<float>& eigen_vals,
-                                  util::ManagedArray<float>& eigen_vecs)
+/* Analytic eigensolver for symmetric 3x3 matrices, following the
+ * non-iterative algorithm of Eberly ("A Robust Eigensolver for 3x3 Symmetric
+ * Matrices"). The eigenvalues come from the trigonometric solution of the
+ * characteristic cubic; eigenvectors are built from cross products of the
+ * rows of A - eval * I, with the degenerate (repeated eigenvalue) cases
+ * handled through an orthogonal complement. All intermediate math is done in
+ * double precision so the float results are accurate to roundoff.
+ */
+
+//! Eigenvector for an eigenvalue known to have multiplicity 1.
+vec3<double> computeEigenvector0(double a00, double a01, double a02, double a11, double a12, double a22,
+                                 double eval)
+{
+    const vec3<double> row0(a00 - eval, a01, a02);
+    const vec3<double> row1(a01, a11 - eval, a12);
+    const vec3<double> row2(a02, a12, a22 - eval);
+    const vec3<double> r0xr1 = cross(row0, row1);
+    const vec3<double> r0xr2 = cross(row0, row2);
+    const vec3<double> r1xr2 = cross(row1, row2);
+    const double d0 = dot(r0xr1, r0xr1);
+    const double d1 = dot(r0xr2, r0xr2);
+    const double d2 = dot(r1xr2, r1xr2);
+
+    if (d0 >= d1 && d0 >= d2)
+    {
+        return r0xr1 / std::sqrt(d0);
+    }
+    if (d1 >= d2)
+    {
+        return r0xr2 / std::sqrt(d1);
+    }
+    return r1xr2 / std::sqrt(d2);
+}
+
+//! Eigenvector orthogonal to evec0, valid even if its eigenvalue repeats.
+vec3<double> computeEigenvector1(double a00, double a01, double a02, double a11, double a12, double a22,
+                                 double eval, const vec3<double>& evec0)
+{
+    // Orthonormal basis {u, v} of the plane orthogonal to evec0.
+    vec3<double> u;
+    if (std::abs(evec0.x) > std::abs(evec0.y))
+    {
+        u = vec3<double>(-evec0.z, 0.0, evec0.x) / std::sqrt(evec0.x * evec0.x + evec0.z * evec0.z);
+    }
+    else
+    {
+        u = vec3<double>(0.0, evec0.z, -evec0.y) / std::sqrt(evec0.y * evec0.y + evec0.z * evec0.z);
+    }
+    const vec3<double> v = cross(evec0, u);
+
+    // Project A - eval * I onto that plane and find the null direction of the
+    // resulting 2x2 matrix.
+    const vec3<double> au(a00 * u.x + a01 * u.y + a02 * u.z, a01 * u.x + a11 * u.y + a12 * u.z,
+                          a02 * u.x + a12 * u.y + a22 * u.z);
+    const vec3<double> av(a00 * v.x + a01 * v.y + a02 * v.z, a01 * v.x + a11 * v.y + a12 * v.z,
+                          a02 * v.x + a12 * v.y + a22 * v.z);
+    double m00 = dot(u, au) - eval;
+    double m01 = dot(u, av);
+    double m11 = dot(v, av) - eval;
+
+    const double abs_m00 = std::abs(m00);
+    const double abs_m01 = std::abs(m01);
+    const double abs_m11 = std::abs(m11);
+    if (abs_m00 >= abs_m11)
+    {
+        if (std::max(abs_m00, abs_m01) == 0.0)
+        {
+            // The projected matrix vanishes: the eigenvalue repeats and any
+            // direction in the plane works.
+            return u;
+        }
+        if (abs_m00 >= abs_m01)
+        {
+            m01 /= m00;
+            m00 = 1.0 / std::sqrt(1.0 + m01 * m01);
+            m01 *= m00;
+        }
+        else
+        {
+            m00 /= m01;
+            m01 = 1.0 / std::sqrt(1.0 + m00 * m00);
+            m00 *= m01;
+        }
+        return u * m01 - v * m00;
+    }
+    if (std::max(abs_m11, abs_m01) == 0.0)
+    {
+        return u;
+    }
+    if (abs_m11 >= abs_m01)
+    {
+        m01 /= m11;
+        m11 = 1.0 / std::sqrt(1.0 + m01 * m01);
+        m01 *= m11;
+    }
+    else
+    {
+        m11 /= m01;
+        m01 = 1.0 / std::sqrt(1.0 + m11 * m11);
+        m11 *= m01;
+    }
+    return u * m11 - v * m01;
+}
+
+//! Solve one matrix: mat is the row-major 3x3 input, vals and vecs the
+//  (ascending) eigenvalues and row-wise eigenvectors.
+void solve33Symmetric(const float* mat, float* vals, float* vecs)
 {
-    const Eigen::Matrix3f m = Eigen::Map<const Eigen::Matrix3f>(mat.get());
+    double a00(mat[0]);
+    double a01(mat[1]);
+    double a02(mat[2]);
+    double a11(mat[4]);
+    double a12(mat[5]);
+    double a22(mat[8]);
+
+    // Scale to unit maximum element so the shifted matrix is well conditioned.
+    const double max_abs
+        = std::max({std::abs(a00), std::abs(a01), std::abs(a02), std::abs(a11), std::abs(a12),
+                    std::abs(a22)});
+    std::fill(vecs, vecs + 9, 0.0F);
+    if (max_abs == 0.0)
+    {
+        // Zero matrix: all eigenvalues vanish and any basis diagonalizes it.
+        vals[0] = vals[1] = vals[2] = 0.0F;
+        vecs[0] = vecs[4] = vecs[8] = 1.0F;
+        return;
+    }
+    const double inv_max_abs = 1.0 / max_abs;
+    a00 *= inv_max_abs;
+    a01 *= inv_max_abs;
+    a02 *= inv_max_abs;
+    a11 *= inv_max_abs;
+    a12 *= inv_max_abs;
+    a22 *= inv_max_abs;
+
+    const double q = (a00 + a11 + a22) / 3.0;
+    const double b00 = a00 - q;
+    const double b11 = a11 - q;
+    const double b22 = a22 - q;
+    const double p = std::sqrt(
+        (b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * (a01 * a01 + a02 * a02 + a12 * a12)) / 6.0);
+
+    if (p == 0.0)
+    {
+        // Scalar multiple of the identity.
+        vals[0] = vals[1] = vals[2] = float(q * max_abs);
+        vecs[0] = vecs[4] = vecs[8] = 1.0F;
+        return;
+    }
 
-    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> es;
-    es.compute(m);
+    // half_det is det((A - q I) / p) / 2, clamped into the domain of acos
+    // against roundoff.
+    const double inv_p = 1.0 / p;
+    const double c00 = b00 * inv_p;
+    const double c11 = b11 * inv_p;
+    const double c22 = b22 * inv_p;
+    const double c01 = a01 * inv_p;
+    const double c02 = a02 * inv_p;
+    const double c12 = a12 * inv_p;
+    double half_det = (c00 * (c11 * c22 - c12 * c12) - c01 * (c01 * c22 - c12 * c02)
+                       + c02 * (c01 * c12 - c11 * c02))
+        * 0.5;
+    half_det = std::min(std::max(half_det, -1.0), 1.0);
 
-    if (es.info() != Eigen::Success)
+    const double angle = std::acos(half_det) / 3.0;
+    const double two_thirds_pi = 2.0943951023931953;
+    const double beta2 = std::cos(angle) * 2.0;
+    const double beta0 = std::cos(angle + two_thirds_pi) * 2.0;
+    const double beta1 = -(beta0 + beta2);
+    const double eval0 = q + p * beta0;
+    const double eval1 = q + p * beta1;
+    const double eval2 = q + p * beta2;
+
+    // The eigenvalue farthest from the others has multiplicity 1, so compute
+    // its eigenvector by the cross-product method and the next one through
+    // the orthogonal complement; the last is just their cross product.
+    vec3<double> evec0;
+    vec3<double> evec1;
+    vec3<double> evec2;
+    if (half_det >= 0.0)
     {
-        // numerical issue, return identity matrix
-        Eigen::Matrix3f id = Eigen::Matrix3f::Identity();
-        Eigen::Map<Eigen::Matrix3f>(eigen_vecs.get(), 3, 3) = id;
-        // set eigenvalues to zero so it's easily detectable
-        eigen_vals[0] = eigen_vals[1] = eigen_vals[2] = 0.0;
+        evec2 = computeEigenvector0(a00, a01, a02, a11, a12, a22, eval2);
+        evec1 = computeEigenvector1(a00, a01, a02, a11, a12, a22, eval1, evec2);
+        evec0 = cross(evec1, evec2);
     }
     else
     {
-        // Note that Eigen by default stores matrices in column-major order,
-        // whereas everything we do in freud uses row major ordering. As a
-        // result, this operation here transposes the matrix, which is why
-        // eigenvectors are returned as rows rather than columns of the
-        // outputmatrix eigen_vecs.
-        // See here for information:
-        // https://eigen.tuxfamily.org/dox/group__TopicStorageOrders.html
-        Eigen::Map<Eigen::Matrix3f>(eigen_vecs.get(), 3, 3) = es.eigenvectors();
-        Eigen::Map<Eigen::Vector3f>(eigen_vals.get(), 3) = es.eigenvalues();
+        evec0 = computeEigenvector0(a00, a01, a02, a11, a12, a22, eval0);
+        evec1 = computeEigenvector1(a00, a01, a02, a11, a12, a22, eval1, evec0);
+        evec2 = cross(evec0, evec1);
     }
+
+    vals[0] = float(eval0 * max_abs);
+    vals[1] = float(eval1 * max_abs);
+    vals[2] = float(eval2 * max_abs);
+    vecs[0] = float(evec0.x);
+    vecs[1] = float(evec0.y);
+    vecs[2] = float(evec0.z);
+    vecs[3] = float(evec1.x);
+    vecs[4] = float(evec1.y);
+    vecs[5] = float(evec1.z);
+    vecs[6] = float(evec2.x);
+    vecs[7] = float(evec2.y);
+    vecs[8] = float(evec2.z);
+}
+
+} // namespace
+
+namespace freud { namespace util {
+
+void diagonalize33SymmetricMatrix(const util::ManagedArray<float>& mat, util::ManagedArray<float>& eigen_vals,
+                                  util::ManagedArray<float>& eigen_vecs)
+{
+    solve33Symmetric(mat.get(), eigen_vals.get(), eigen_vecs.get());
+}
+
+void diagonalize33SymmetricMatrices(const util::ManagedArray<float>& mats,
+                                    util::ManagedArray<float>& eigen_vals,
+                                    util::ManagedArray<float>& eigen_vecs)
+{
+    const size_t n_matrices = mats.shape()[0];
+    util::forLoopWrapper(0, n_matrices, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            solve33Symmetric(&mats[9 * i], &eigen_vals[3 * i], &eigen_vecs[9 * i]);
+        }
+    });
 }
 
 }; }; // namespace freud::util
@@ -1,7 +1,6 @@
 #ifndef DIAGONALIZE_H
 #define DIAGONALIZE_H
 
-#include "Eigen/Eigen/Dense"
 #include "ManagedArray.h"
 
 namespace freud { namespace util {
@@ -12,16 +11,36 @@ namespace freud { namespace util {
  * eigen_vecs(0, 1), eigen_vecs(0, 2)]. The eigenvalues are returned in
  * increasing order, with the eigenvectors in the corresponding order.
  *
+ * The decomposition is computed with a closed-form analytic solver rather
+ * than an iterative one, so the cost per matrix is small and fixed.
+ *
  * Note that no checks are performed to check if the matrix is symmetric. It is
  * the responsibility of calling code to only use this function for symmetric
  * matrices.
  *
  *  \param mat The matrix to diagonalize.
- *  \param eigen_vals The eigenvalues (set to 0 if the solver fails).
- *  \param eigen_vecs Matrix with eigenvectors as the rows (set to the identity if the solver fails).
+ *  \param eigen_vals The eigenvalues.
+ *  \param eigen_vecs Matrix with eigenvectors as the rows.
  */
 void diagonalize33SymmetricMatrix(const util::ManagedArray<float>& mat, util::ManagedArray<float>& eigen_vals,
                                   util::ManagedArray<float>& eigen_vecs);
 
+//! Compute eigenvalues and eigenvectors of a batch of self-adjoint 3x3 matrices.
+/*! Diagonalizes all matrices in one parallel pass, which is much cheaper than
+ * calling diagonalize33SymmetricMatrix in a loop when many small tensors (one
+ * per cluster, particle, or match) must be decomposed per frame.
+ *
+ * mats must have shape (N, 3, 3), eigen_vals shape (N, 3), and eigen_vecs
+ * shape (N, 3, 3); each row of the outputs follows the conventions of
+ * diagonalize33SymmetricMatrix.
+ *
+ *  \param mats The matrices to diagonalize.
+ *  \param eigen_vals The eigenvalues of each matrix.
+ *  \param eigen_vecs The eigenvectors of each matrix, as rows.
+ */
+void diagonalize33SymmetricMatrices(const util::ManagedArray<float>& mats,
+                                    util::ManagedArray<float>& eigen_vals,
+                                    util::ManagedArray<float>& eigen_vecs);
+
 }; }; // namespace freud::util
 #endif
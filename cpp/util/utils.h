@@ -2,10 +2,12 @@
 #define UTILS_H
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <tbb/blocked_range.h>
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 namespace freud { namespace util {
 
@@ -60,6 +62,133 @@ inline void forLoopWrapper(size_t begin, size_t end, const Body& body, bool para
     }
 }
 
+//! Per-callsite scheduling policy for forLoopWrapper.
+/*! The plain forLoopWrapper overload lets TBB's auto partitioner choose
+ *  chunk sizes, which undersplits loops with tiny per-element work (the
+ *  scheduling overhead swamps the work) and can load-imbalance loops whose
+ *  per-element cost is heavy and skewed. A LoopPolicy gives one call site
+ *  explicit control over three things:
+ *
+ *    - a fixed grain size (elements per chunk, scheduled with a simple
+ *      partitioner),
+ *    - automatic grain selection (pass AUTO_GRAIN): the first call times a
+ *      pilot chunk serially, derives the per-element cost, and sizes chunks
+ *      to roughly TARGET_CHUNK_SECONDS of work each; the measured grain is
+ *      cached on the policy for all later calls, and
+ *    - an affinity partitioner, which replays the previous call's
+ *      chunk-to-thread assignment so per-frame loops over same-sized ranges
+ *      revisit warm caches.
+ *
+ *  The policy is stateful (cached grain, partitioner history), so a call
+ *  site should keep one instance alive across calls -- typically as a member
+ *  of the compute class -- and must not run two loops with the same instance
+ *  concurrently.
+ */
+class LoopPolicy
+{
+public:
+    //! Grain value requesting pilot-chunk measurement on first use.
+    static constexpr size_t AUTO_GRAIN = static_cast<size_t>(-1);
+    //! Target wall time for one chunk when measuring automatically.
+    static constexpr double TARGET_CHUNK_SECONDS = 100e-6;
+    //! Elements executed serially to estimate the per-element cost.
+    static constexpr size_t PILOT_CHUNK_SIZE = 1024;
+
+    /*! \param grain Elements per chunk: AUTO_GRAIN to measure, 0 for TBB's
+     *               default partitioning, any other value used as-is.
+     *  \param use_affinity Whether to reuse the chunk-to-thread assignment
+     *                      across calls on this policy.
+     */
+    explicit LoopPolicy(size_t grain = 0, bool use_affinity = false)
+        : m_grain(grain), m_use_affinity(use_affinity)
+    {}
+
+    //! Current grain (AUTO_GRAIN until the first measured call resolves it).
+    size_t grain() const
+    {
+        return m_grain;
+    }
+
+    //! Record the measured per-element cost and cache the resulting grain.
+    size_t calibrate(double seconds_per_element)
+    {
+        // Guard against costs below the clock's resolution.
+        const double cost = std::max(seconds_per_element, 1e-10);
+        const auto grain = static_cast<size_t>(TARGET_CHUNK_SECONDS / cost);
+        m_grain = std::min(std::max(grain, size_t(1)), size_t(1) << 22);
+        return m_grain;
+    }
+
+    bool useAffinity() const
+    {
+        return m_use_affinity;
+    }
+
+    tbb::affinity_partitioner& partitioner()
+    {
+        return m_partitioner;
+    }
+
+private:
+    size_t m_grain;                          //!< Elements per chunk (or AUTO_GRAIN / 0).
+    bool m_use_affinity;                     //!< Whether to replay chunk placement across calls.
+    tbb::affinity_partitioner m_partitioner; //!< Placement history when affinity is enabled.
+};
+
+//! forLoopWrapper overload scheduled according to a per-callsite policy.
+/*! See LoopPolicy for the scheduling options. When the policy requests
+ *  automatic grain selection, the pilot chunk runs serially on the calling
+ *  thread before the remainder of the range is scheduled in parallel, so the
+ *  body sees every index exactly once either way.
+ */
+template<typename Body>
+inline void forLoopWrapper(size_t begin, size_t end, const Body& body, LoopPolicy& policy,
+                           bool parallel = true)
+{
+    if (!parallel)
+    {
+        body(begin, end);
+        return;
+    }
+    size_t grain = policy.grain();
+    if (grain == LoopPolicy::AUTO_GRAIN)
+    {
+        const size_t pilot = std::min(end - begin, LoopPolicy::PILOT_CHUNK_SIZE);
+        if (pilot == 0)
+        {
+            body(begin, end);
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        body(begin, begin + pilot);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        begin += pilot;
+        grain = policy.calibrate(seconds / double(pilot));
+    }
+    if (begin >= end)
+    {
+        return;
+    }
+    // Keep at least a few chunks per thread available for load balancing.
+    const auto threads = static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+    grain = std::min(grain, std::max((end - begin) / (4 * threads), size_t(1)));
+
+    auto chunk = [&body](const tbb::blocked_range<size_t>& r) { body(r.begin(), r.end()); };
+    if (policy.useAffinity())
+    {
+        tbb::parallel_for(tbb::blocked_range<size_t>(begin, end, std::max(grain, size_t(1))), chunk,
+                          policy.partitioner());
+    }
+    else if (grain > 0)
+    {
+        tbb::parallel_for(tbb::blocked_range<size_t>(begin, end, grain), chunk, tbb::simple_partitioner());
+    }
+    else
+    {
+        tbb::parallel_for(tbb::blocked_range<size_t>(begin, end), chunk);
+    }
+}
+
 //! Wrapper for 2D nested for loops to allow the execution in parallel or not.
 /*! \param begin_row Beginning index of outer loop.
  *  \param end_row Ending index of outer loop.
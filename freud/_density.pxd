@@ -26,9 +26,11 @@ cdef extern from "GaussianDensity.h" namespace "freud::density":
         GaussianDensity(vec3[unsigned int], float, float) except +
         const freud._box.Box & getBox() const
         void reset()
+        void accumulate(const freud._locality.NeighborQuery*,
+                        const float*) except +
         void compute(const freud._locality.NeighborQuery*,
                      const float*) except +
-        const freud.util.ManagedArray[float] &getDensity() const
+        const freud.util.ManagedArray[float] &getDensity()
         vec3[unsigned int] getWidth() const
         float getSigma() const
         float getRMax() const
@@ -27,6 +27,7 @@ cdef extern from "ManagedArray.h" namespace "freud::util":
         T *get()
         size_t size() const
         vector[size_t] shape() const
+        unsigned long long getGeneration() const
 
 
 cdef extern from "numpy/arrayobject.h":
@@ -238,7 +238,7 @@ cdef class GaussianDensity(_Compute):
         """:class:`freud.box.Box`: Box used in the calculation."""
         return freud.box.BoxFromCPP(self.thisptr.getBox())
 
-    def compute(self, system, values=None):
+    def compute(self, system, values=None, reset=True):
         r"""Calculates the Gaussian blur for the specified points.
 
         Args:
@@ -250,7 +250,14 @@ cdef class GaussianDensity(_Compute):
                 convolution. Calculates Gaussian blur (equivalent to providing
                 a value of 1 for every point) if :code:`None`. (Default value
                 = :code:`None`).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
         """
+        if reset:
+            self._reset()
+
         cdef freud.locality.NeighborQuery nq = \
             freud.locality.NeighborQuery.from_system(system)
 
@@ -261,10 +268,13 @@ cdef class GaussianDensity(_Compute):
                 values, shape=(nq.points.shape[0], ))
             l_values_ptr = &l_values[0]
 
-        self.thisptr.compute(nq.get_ptr(),
-                             l_values_ptr)
+        self.thisptr.accumulate(nq.get_ptr(),
+                                l_values_ptr)
         return self
 
+    def _reset(self):
+        self.thisptr.reset()
+
     @_Compute._computed_property
     def density(self):
         """(:math:`w_x`, :math:`w_y`, :math:`w_z`) :class:`numpy.ndarray`: The
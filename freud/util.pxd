@@ -41,9 +41,11 @@ cdef class _ManagedArrayContainer:
     cdef int var_typenum
     cdef arr_ptr_t thisptr
     cdef arr_type_t data_type
+    cdef unsigned long long _generation
 
     cdef void set_as_base(self, arr)
     cdef void *get(self)
+    cdef unsigned long long _current_generation(self)
 
     @staticmethod
     cdef inline _ManagedArrayContainer init(
@@ -81,6 +83,10 @@ cdef class _ManagedArrayContainer:
             obj.thisptr.bool_ptr = new ManagedArray[bool](
                 dereference(<const ManagedArray[bool] *>array))
 
+        # Record the generation of the array we captured so is_current can
+        # later tell whether the compute has started a newer output.
+        obj._generation = obj._current_generation()
+
         return obj
 
 
@@ -94,3 +100,4 @@ cdef inline make_managed_numpy_array(
 
 cdef class _Compute:
     cdef public bool _called_compute
+    cdef public dict _array_cache
@@ -46,6 +46,7 @@ cdef class _ManagedArrayContainer:
         self.data_type = arr_type
         self.var_typenum = typenum
         self.thisptr.null_ptr = NULL
+        self._generation = 0
 
     @property
     def shape(self):
@@ -101,6 +102,33 @@ cdef class _ManagedArrayContainer:
         elif self.data_type == arr_type_t.BOOL:
             return self.thisptr.bool_ptr.get()
 
+    cdef unsigned long long _current_generation(self):
+        """Return the current generation counter of the wrapped array."""
+        if self.data_type == arr_type_t.UNSIGNED_INT:
+            return self.thisptr.uint_ptr.getGeneration()
+        elif self.data_type == arr_type_t.FLOAT:
+            return self.thisptr.float_ptr.getGeneration()
+        elif self.data_type == arr_type_t.DOUBLE:
+            return self.thisptr.double_ptr.getGeneration()
+        elif self.data_type == arr_type_t.COMPLEX_FLOAT:
+            return self.thisptr.complex_float_ptr.getGeneration()
+        elif self.data_type == arr_type_t.COMPLEX_DOUBLE:
+            return self.thisptr.complex_double_ptr.getGeneration()
+        elif self.data_type == arr_type_t.BOOL:
+            return self.thisptr.bool_ptr.getGeneration()
+
+    def is_current(self):
+        """Whether this container still holds the array's latest output.
+
+        The generation counter of a ManagedArray increments whenever a compute
+        starts overwriting it, and is shared between the compute's instance and
+        the copy held here. Comparing the current counter against the value
+        recorded when this container was created therefore tells whether the
+        data viewed here is still the newest result or a preserved copy of an
+        older frame.
+        """
+        return self._current_generation() == self._generation
+
     def __array__(self):
         """Convert the underlying data array into a read-only numpy array.
 
@@ -123,6 +151,18 @@ cdef class _ManagedArrayContainer:
             else self.shape + (self.element_size, ))
 
 
+cdef _find_managed_container(value):
+    """Walk the base chain of a computed property's result down to the
+    :class:`_ManagedArrayContainer` keeping its data alive, or return None if
+    the result is not backed by one (e.g. a freshly allocated array)."""
+    base = value
+    while base is not None:
+        if isinstance(base, _ManagedArrayContainer):
+            return base
+        base = getattr(base, 'base', None)
+    return None
+
+
 cdef class _Compute(object):
     r"""Parent class for all compute classes in freud.
 
@@ -143,13 +183,25 @@ cdef class _Compute(object):
             def cluster_idx(self):
                 return ...
 
+    This class also caches the NumPy arrays produced by computed properties.
+    Every access to a computed property ordinarily heap-copies a ManagedArray
+    into a new container and wraps it in a new array; since the returned
+    arrays are read-only views, the same object can be served for repeated
+    accesses as long as the underlying data is unchanged. The cache is
+    invalidated when a new compute runs and, via the generation counter of
+    :class:`_ManagedArrayContainer`, whenever the C++ side starts a new
+    output.
+
     Attributes:
         _called_compute (bool):
             Flag representing whether the compute method has been called.
+        _array_cache (dict):
+            Cached computed property results keyed by property name.
     """
 
     def __cinit__(self):
         self._called_compute = False
+        self._array_cache = {}
 
     def __getattribute__(self, attr):
         """Compute methods set a flag to indicate that quantities have been
@@ -163,6 +215,11 @@ cdef class _Compute(object):
             @wraps(compute)
             def compute_wrapper(*args, **kwargs):
                 return_value = compute(*args, **kwargs)
+                # Drop all cached property arrays. Lazily reduced outputs do
+                # not bump their generation counters until their getters run,
+                # so the counters alone cannot detect that this compute made
+                # the cached arrays stale.
+                self._array_cache.clear()
                 self._called_compute = True
                 return return_value
             return compute_wrapper
@@ -189,7 +246,16 @@ cdef class _Compute(object):
             if not self._called_compute:
                 raise AttributeError(
                     "Property not computed. Call compute first.")
-            return prop(self, *args, **kwargs)
+            cached = self._array_cache.get(prop.__name__)
+            if cached is not None:
+                if cached[0].is_current():
+                    return cached[1]
+                del self._array_cache[prop.__name__]
+            value = prop(self, *args, **kwargs)
+            container = _find_managed_container(value)
+            if container is not None:
+                self._array_cache[prop.__name__] = (container, value)
+            return value
         return wrapper
 
     def __str__(self):